@@ -0,0 +1,276 @@
+#pragma once
+
+/**
+ * @file BehaviorTree.h
+ * @brief Declares flat, shared behaviour tree definitions and batched per-agent execution.
+ */
+
+#include "../Prerequisites.h"
+#include <memory>
+
+class JobSystem;
+class BehaviorTreeBatch;
+
+/**
+ * @enum BTStatus
+ * @brief Result of ticking a node.
+ */
+enum class BTStatus : uint8_t {
+    Success, ///< The node finished and succeeded.
+    Failure, ///< The node finished and failed.
+    Running  ///< The node needs more ticks; it resumes there next tick.
+};
+
+/**
+ * @enum BTNodeType
+ * @brief Kind of a node in the flat node array.
+ */
+enum class BTNodeType : uint8_t {
+    Sequence,  ///< Runs children in order until one does not succeed.
+    Selector,  ///< Runs children in order until one does not fail.
+    Inverter,  ///< Swaps Success and Failure of its single child.
+    Succeeder, ///< Turns its single child's Failure into Success.
+    Action,    ///< Calls a BTAction.
+    Wait       ///< Runs for a fixed number of seconds, then succeeds.
+};
+
+/**
+ * @struct BTContext
+ * @brief What a leaf action sees of the agent being ticked.
+ */
+struct BTContext {
+    BehaviorTreeBatch& batch; ///< Batch of the agent.
+    uint32_t agent;           ///< Agent index in the batch.
+    uint32_t userId;          ///< Id given to BehaviorTreeBatch::addAgent().
+    float* blackboard;        ///< The agent's blackboard slots.
+    float deltaTime;          ///< Time since the previous tick.
+    float runningTime;        ///< Time this leaf has been running (0 on its first tick).
+    float argument;           ///< Argument stored in the node.
+};
+
+/**
+ * @brief Leaf behaviour: plain function, no per-call allocation or virtual dispatch.
+ */
+using BTAction = BTStatus(*)(BTContext& context);
+
+/**
+ * @struct BTNode
+ * @brief One node of the flat tree, in pre-order.
+ *
+ * The first child of a composite is the next node; the next sibling of a node starts
+ * at its end index. Nothing else links the nodes.
+ */
+struct BTNode {
+    BTNodeType type;        ///< Node kind.
+    uint8_t unused = 0;     ///< Padding.
+    uint16_t end = 0;       ///< Index one past the last node of this subtree.
+    uint16_t action = 0;    ///< Index in the action table (Action nodes).
+    float argument = 0.f;   ///< Wait duration or action argument.
+};
+
+/**
+ * @class BehaviorTree
+ * @brief Immutable tree definition, built by BehaviorTreeBuilder and shared by every
+ * agent that runs it.
+ */
+class BehaviorTree {
+public:
+    static constexpr size_t MaxDepth = 16; ///< Deepest supported node path.
+
+    /**
+     * @brief Returns the nodes in pre-order; node 0 is the root.
+     */
+    const std::vector<BTNode>& getNodes() const { return m_nodes; }
+
+    /**
+     * @brief Returns the action called by an Action node.
+     */
+    BTAction getAction(uint16_t index) const { return m_actions[index]; }
+
+    /**
+     * @brief Returns the name given to a node by the builder.
+     */
+    const std::string& getNodeName(size_t node) const { return m_names[node]; }
+
+    /**
+     * @brief Returns the number of blackboard slots every agent gets.
+     */
+    uint32_t getBlackboardSize() const { return m_blackboardSize; }
+
+private:
+    friend class BehaviorTreeBuilder;
+
+    std::vector<BTNode> m_nodes;     ///< Nodes in pre-order.
+    std::vector<BTAction> m_actions; ///< Action table.
+    std::vector<std::string> m_names; ///< Debug name per node.
+    uint32_t m_blackboardSize = 0;   ///< Float slots per agent.
+};
+
+/**
+ * @class BehaviorTreeBuilder
+ * @brief Builds a BehaviorTree with nested calls.
+ *
+ * Usage:
+ * @code
+ * BehaviorTreeBuilder builder;
+ * builder.selector()
+ *            .sequence().action("see target", &seeTarget).action("chase", &chase).end()
+ *            .sequence().action("patrol", &patrol).wait(1.f).end()
+ *        .end();
+ * std::shared_ptr<const BehaviorTree> tree = builder.build(4);
+ * @endcode
+ */
+class BehaviorTreeBuilder {
+public:
+    /**
+     * @brief Opens a Sequence; close it with end().
+     */
+    BehaviorTreeBuilder& sequence(const std::string& name = "sequence");
+
+    /**
+     * @brief Opens a Selector; close it with end().
+     */
+    BehaviorTreeBuilder& selector(const std::string& name = "selector");
+
+    /**
+     * @brief Opens an Inverter; give it exactly one child, then end().
+     */
+    BehaviorTreeBuilder& inverter(const std::string& name = "inverter");
+
+    /**
+     * @brief Opens a Succeeder; give it exactly one child, then end().
+     */
+    BehaviorTreeBuilder& succeeder(const std::string& name = "succeeder");
+
+    /**
+     * @brief Adds an Action leaf.
+     * @param name Debug name.
+     * @param action Function called on every tick of the leaf.
+     * @param argument Value passed in BTContext::argument.
+     */
+    BehaviorTreeBuilder& action(const std::string& name, BTAction action, float argument = 0.f);
+
+    /**
+     * @brief Adds a leaf that keeps running for @p seconds.
+     */
+    BehaviorTreeBuilder& wait(float seconds);
+
+    /**
+     * @brief Closes the last opened composite or decorator.
+     */
+    BehaviorTreeBuilder& end();
+
+    /**
+     * @brief Finishes the tree. Unclosed nodes or an empty tree are fatal errors.
+     * @param blackboardSize Float slots per agent.
+     */
+    std::shared_ptr<const BehaviorTree> build(uint32_t blackboardSize);
+
+private:
+    /**
+     * @brief Appends a node under the open parent.
+     */
+    uint16_t addNode(BTNodeType type, const std::string& name);
+
+    std::shared_ptr<BehaviorTree> m_tree = std::make_shared<BehaviorTree>(); ///< Tree being built.
+    std::vector<uint16_t> m_open; ///< Nodes opened and not closed yet.
+};
+
+/**
+ * @class BehaviorTreeBatch
+ * @brief Every agent running one tree, ticked together.
+ *
+ * Agent state lives in parallel arrays: the path of running nodes (at most
+ * BehaviorTree::MaxDepth 16-bit indices), the running time of the current leaf and
+ * the blackboard. A tick resumes each agent at its running leaf instead of walking
+ * the tree from the root, and the tree itself is read-only and shared, so ticking
+ * all agents in one loop keeps the nodes hot in cache.
+ */
+class BehaviorTreeBatch {
+public:
+    /**
+     * @brief Creates an empty batch for @p tree.
+     */
+    explicit BehaviorTreeBatch(std::shared_ptr<const BehaviorTree> tree);
+
+    /**
+     * @brief Adds an agent and returns its index.
+     * @param userId Value handed to actions (an actor index, an entity id...).
+     */
+    uint32_t addAgent(uint32_t userId);
+
+    /**
+     * @brief Removes an agent; the last agent takes its index.
+     */
+    void removeAgent(uint32_t agent);
+
+    /**
+     * @brief Returns the number of agents.
+     */
+    uint32_t getAgentCount() const { return static_cast<uint32_t>(m_userIds.size()); }
+
+    /**
+     * @brief Returns an agent's blackboard.
+     */
+    float* getBlackboard(uint32_t agent) { return &m_blackboards[static_cast<size_t>(agent) * m_blackboardSize]; }
+
+    /**
+     * @brief Returns the status of an agent's last tick.
+     */
+    BTStatus getLastStatus(uint32_t agent) const { return m_lastStatus[agent]; }
+
+    /**
+     * @brief Returns the node an agent is running, or -1 if it is between runs.
+     */
+    int getRunningNode(uint32_t agent) const;
+
+    /**
+     * @brief Drops the running path of an agent; its next tick starts at the root.
+     */
+    void reset(uint32_t agent) { m_depths[agent] = 0; }
+
+    /**
+     * @brief Ticks every agent once on the calling thread.
+     */
+    void tick(float deltaTime);
+
+    /**
+     * @brief Ticks every agent once, spread over @p jobs. Actions must only touch
+     * their own agent.
+     */
+    void tick(float deltaTime, JobSystem& jobs);
+
+    /**
+     * @brief Accumulates @p deltaTime and ticks at @p rate Hz (at most once per call).
+     * @return true if a tick ran.
+     */
+    bool update(float deltaTime, float rate);
+
+    /**
+     * @brief Returns the bytes of state kept per agent.
+     */
+    size_t getBytesPerAgent() const;
+
+private:
+    /**
+     * @brief Ticks agents [begin, end).
+     */
+    void tickRange(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Runs one agent until it finishes or a leaf returns Running.
+     */
+    BTStatus tickAgent(uint32_t agent, float deltaTime);
+
+    std::shared_ptr<const BehaviorTree> m_tree; ///< Shared definition.
+    const BTNode* m_nodes = nullptr;            ///< m_tree's nodes.
+    uint32_t m_blackboardSize = 0;              ///< Slots per agent.
+
+    std::vector<uint16_t> m_stacks;      ///< MaxDepth running-node indices per agent.
+    std::vector<uint8_t> m_depths;       ///< Used stack entries per agent (0 = start at root).
+    std::vector<float> m_runningTimes;   ///< Running time of each agent's current leaf.
+    std::vector<BTStatus> m_lastStatus;  ///< Status of each agent's last tick.
+    std::vector<float> m_blackboards;    ///< m_blackboardSize slots per agent.
+    std::vector<uint32_t> m_userIds;     ///< Id per agent.
+    float m_accumulator = 0.f;           ///< Time not ticked yet by update().
+};
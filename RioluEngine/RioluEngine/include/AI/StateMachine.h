@@ -0,0 +1,257 @@
+#pragma once
+
+/**
+ * @file StateMachine.h
+ * @brief Declares table-driven finite state machines that group agents by state.
+ */
+
+#include "../Prerequisites.h"
+#include <memory>
+
+class StateMachine;
+
+/**
+ * @brief Index of a state or an event in a StateMachineDefinition.
+ */
+using FSMId = uint16_t;
+
+/**
+ * @brief Marks a missing transition or state.
+ */
+constexpr FSMId InvalidFSMId = 0xFFFF;
+
+/**
+ * @struct FSMUpdate
+ * @brief One state's update call: every agent currently in that state.
+ */
+struct FSMUpdate {
+    StateMachine& machine;     ///< Machine being ticked (raise events on it).
+    FSMId state;               ///< State being updated.
+    const uint32_t* agents;    ///< Agents in the state, contiguous.
+    const uint32_t* userIds;   ///< User id of each agent.
+    const double* enteredAt;   ///< Machine time at which each agent entered the state.
+    size_t count;              ///< Number of agents.
+    double time;               ///< Machine time before this tick.
+    float deltaTime;           ///< Tick length.
+
+    /**
+     * @brief Returns how long the @p k th agent has been in the state.
+     */
+    float getTimeInState(size_t k) const { return static_cast<float>(time - enteredAt[k]); }
+};
+
+/**
+ * @brief Updates every agent of a state at once.
+ */
+using FSMStateUpdate = void(*)(const FSMUpdate& update);
+
+/**
+ * @brief Called for one agent when it leaves or enters a state.
+ */
+using FSMStateHook = void(*)(StateMachine& machine, uint32_t agent);
+
+/**
+ * @class StateMachineDefinition
+ * @brief States, events and the transition table, shared by every machine using them.
+ *
+ * The table has one row per state and one column per event; a cell holds the target
+ * state or InvalidFSMId when the event is ignored in that state.
+ */
+class StateMachineDefinition {
+public:
+    /**
+     * @brief Adds a state.
+     * @param name Debug name.
+     * @param update Batch update, may be null.
+     * @param onEnter Called per agent entering the state, may be null.
+     * @param onExit Called per agent leaving the state, may be null.
+     */
+    FSMId addState(const std::string& name, FSMStateUpdate update,
+                   FSMStateHook onEnter = nullptr, FSMStateHook onExit = nullptr);
+
+    /**
+     * @brief Adds an event.
+     */
+    FSMId addEvent(const std::string& name);
+
+    /**
+     * @brief Makes @p event move agents in @p from to @p to.
+     */
+    void addTransition(FSMId from, FSMId event, FSMId to);
+
+    /**
+     * @brief Returns the target of @p event in @p state, or InvalidFSMId.
+     */
+    FSMId getTransition(FSMId state, FSMId event) const {
+        return m_table[static_cast<size_t>(state) * m_events.size() + event];
+    }
+
+    size_t getStateCount() const { return m_states.size(); }
+    size_t getEventCount() const { return m_events.size(); }
+    const std::string& getStateName(FSMId state) const { return m_states[state].name; }
+    const std::string& getEventName(FSMId event) const { return m_events[event]; }
+
+private:
+    friend class StateMachine;
+
+    /**
+     * @struct State
+     * @brief Row of the state table.
+     */
+    struct State {
+        std::string name;      ///< Debug name.
+        FSMStateUpdate update; ///< Batch update.
+        FSMStateHook onEnter;  ///< Per-agent enter hook.
+        FSMStateHook onExit;   ///< Per-agent exit hook.
+    };
+
+    std::vector<State> m_states;       ///< State table.
+    std::vector<std::string> m_events; ///< Event names.
+    std::vector<FSMId> m_table;        ///< Transitions, m_states.size() x m_events.size().
+};
+
+/**
+ * @class StateMachine
+ * @brief Runs a StateMachineDefinition for many agents.
+ *
+ * Agents are kept in one list per state, so tick() calls each state's update once
+ * over contiguous arrays (agent, user id, entry time) instead of dispatching per
+ * agent. Events raised during the
+ * tick are queued and applied after every state has updated, in the order they were
+ * raised: an agent changes list at most once per tick and never while its list is
+ * being iterated. If an agent raises several events that lead somewhere, the first
+ * one wins.
+ */
+class StateMachine {
+public:
+    /**
+     * @brief Creates an empty machine. The definition must not change afterwards.
+     */
+    explicit StateMachine(std::shared_ptr<const StateMachineDefinition> definition);
+
+    /**
+     * @brief Adds an agent in @p state (its enter hook runs) and returns its id.
+     * Ids of removed agents are reused. Not allowed during tick().
+     * @param userId Value kept for the state functions (an actor index...).
+     */
+    uint32_t addAgent(uint32_t userId, FSMId state);
+
+    /**
+     * @brief Removes an agent (its exit hook runs). Not allowed during tick().
+     */
+    void removeAgent(uint32_t agent);
+
+    /**
+     * @brief Queues @p event for @p agent; it is applied at the end of the tick, or by
+     * the next tick when raised outside one.
+     */
+    void
+    raise(uint32_t agent, FSMId event) {
+        if (agent >= m_agents.size() || event >= m_definition->getEventCount()) {
+            ERROR("StateMachine", "raise", "Unknown agent or event");
+        }
+        m_pending.push_back({ agent, event });
+    }
+
+    /**
+     * @brief Updates every state, then applies the queued events.
+     */
+    void tick(float deltaTime);
+
+    /**
+     * @brief Returns the agent's current state.
+     */
+    FSMId getState(uint32_t agent) const { return m_agents[agent].state; }
+
+    /**
+     * @brief Returns how long the agent has been in its current state.
+     */
+    float getTimeInState(uint32_t agent) const {
+        const Agent& record = m_agents[agent];
+        return static_cast<float>(m_time - m_byState[record.state].enteredAt[record.slot]);
+    }
+
+    /**
+     * @brief Returns the id given to addAgent().
+     */
+    uint32_t getUserId(uint32_t agent) const {
+        const Agent& record = m_agents[agent];
+        return m_byState[record.state].userIds[record.slot];
+    }
+
+    /**
+     * @brief Returns the agents currently in @p state.
+     */
+    const std::vector<uint32_t>& getAgentsInState(FSMId state) const { return m_byState[state].agents; }
+
+    /**
+     * @brief Returns the number of live agents.
+     */
+    size_t getAgentCount() const { return m_agents.size() - m_freeAgents.size(); }
+
+    /**
+     * @brief Returns the transitions applied by the last tick.
+     */
+    size_t getLastTransitionCount() const { return m_lastTransitions; }
+
+    /**
+     * @brief Returns the definition.
+     */
+    const StateMachineDefinition& getDefinition() const { return *m_definition; }
+
+private:
+    /**
+     * @struct Agent
+     * @brief Per-agent record.
+     */
+    struct Agent {
+        FSMId state = InvalidFSMId; ///< Current state (InvalidFSMId when free).
+        uint32_t slot = 0;          ///< Index in m_byState[state].
+        uint64_t lastTick = 0;      ///< Tick of the last transition, so only one applies per tick.
+    };
+
+    /**
+     * @struct StateList
+     * @brief Agents of one state, in parallel arrays.
+     */
+    struct StateList {
+        std::vector<uint32_t> agents;  ///< Agent ids.
+        std::vector<uint32_t> userIds; ///< User id per agent.
+        std::vector<double> enteredAt; ///< Entry time per agent.
+    };
+
+    /**
+     * @struct PendingEvent
+     * @brief Event waiting for the end of the tick.
+     */
+    struct PendingEvent {
+        uint32_t agent; ///< Target agent.
+        FSMId event;    ///< Raised event.
+    };
+
+    /**
+     * @brief Puts an agent at the end of a state's list.
+     */
+    void link(uint32_t agent, FSMId state, uint32_t userId);
+
+    /**
+     * @brief Swap-removes an agent from its state's list and returns its user id.
+     */
+    uint32_t unlink(uint32_t agent);
+
+    /**
+     * @brief Applies the queued events.
+     */
+    void applyTransitions();
+
+    std::shared_ptr<const StateMachineDefinition> m_definition; ///< Shared tables.
+    std::vector<Agent> m_agents;                  ///< Indexed by agent id.
+    std::vector<uint32_t> m_freeAgents;           ///< Removed ids to reuse.
+    std::vector<StateList> m_byState;             ///< Agents per state.
+    std::vector<PendingEvent> m_pending;          ///< Events raised since the last apply.
+    std::vector<PendingEvent> m_applying;         ///< Events being applied (hooks may raise more).
+    double m_time = 0.0;                          ///< Total ticked time.
+    uint64_t m_tickCount = 1;                     ///< Current tick number.
+    size_t m_lastTransitions = 0;                 ///< Transitions in the last tick.
+    bool m_ticking = false;                       ///< True inside tick().
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+/**
+ * @file UtilityAI.h
+ * @brief Declares utility-based action scoring evaluated four agents at a time.
+ */
+
+#include "../Prerequisites.h"
+#include <memory>
+
+class JobSystem;
+
+/**
+ * @enum UtilityCurveType
+ * @brief Shape of a response curve, x being the normalized input in [0, 1].
+ */
+enum class UtilityCurveType : uint8_t {
+    Linear,    ///< slope * (x - shift) + offset
+    Quadratic, ///< slope * (x - shift)^2 + offset
+    Logistic,  ///< height / (1 + e^(-slope * (x - shift))) + offset
+    Step       ///< x >= shift ? height + offset : offset
+};
+
+/**
+ * @struct UtilityCurve
+ * @brief Maps a normalized input to a score; the result is clamped to [0, 1].
+ */
+struct UtilityCurve {
+    UtilityCurveType type = UtilityCurveType::Linear; ///< Shape.
+    float slope = 1.f;  ///< Slope or steepness (negative to invert).
+    float height = 1.f; ///< Amplitude of Logistic and Step.
+    float shift = 0.f;  ///< Horizontal shift.
+    float offset = 0.f; ///< Vertical shift.
+
+    /**
+     * @brief Evaluates the curve for one value (tools and reference code; batches use
+     * the four-lane path).
+     */
+    float evaluate(float x) const;
+};
+
+/**
+ * @brief Returned for ranks that hold no action (fewer actions than kept slots).
+ */
+constexpr uint32_t InvalidUtilityAction = 0xFFFFFFFFu;
+
+/**
+ * @class UtilityModel
+ * @brief Inputs, actions and their considerations, shared by every batch using them.
+ *
+ * An action's score is its weight times the product of its considerations, each one
+ * being a curve applied to an input normalized over [inputMin, inputMax].
+ */
+class UtilityModel {
+public:
+    /**
+     * @brief Declares an input channel (distance to target, health...).
+     */
+    uint32_t addInput(const std::string& name);
+
+    /**
+     * @brief Declares an action.
+     */
+    uint32_t addAction(const std::string& name, float weight = 1.f);
+
+    /**
+     * @brief Multiplies @p action's score by @p curve applied to @p input.
+     */
+    void addConsideration(uint32_t action, uint32_t input, float inputMin, float inputMax,
+                          const UtilityCurve& curve);
+
+    size_t getInputCount() const { return m_inputs.size(); }
+    size_t getActionCount() const { return m_actions.size(); }
+    const std::string& getInputName(uint32_t input) const { return m_inputs[input]; }
+    const std::string& getActionName(uint32_t action) const { return m_actions[action].name; }
+
+    /**
+     * @brief Scores one action for one agent (reference path).
+     * @param inputs One value per input channel.
+     */
+    float score(uint32_t action, const float* inputs) const;
+
+private:
+    friend class UtilityBatch;
+
+    /**
+     * @struct Consideration
+     * @brief One factor of an action's score.
+     */
+    struct Consideration {
+        uint32_t input;     ///< Input channel.
+        float inputMin;     ///< Input mapped to 0.
+        float inputScale;   ///< 1 / (inputMax - inputMin).
+        UtilityCurve curve; ///< Response curve.
+    };
+
+    /**
+     * @struct Action
+     * @brief Scored action.
+     */
+    struct Action {
+        std::string name;                          ///< Debug name.
+        float weight;                              ///< Score multiplier.
+        std::vector<Consideration> considerations; ///< Factors.
+    };
+
+    std::vector<std::string> m_inputs; ///< Input names.
+    std::vector<Action> m_actions;     ///< Actions.
+};
+
+/**
+ * @class UtilityBatch
+ * @brief Inputs and decisions of many agents sharing a UtilityModel.
+ *
+ * Inputs are stored per channel (structure of arrays, padded to a multiple of four
+ * agents) so a consideration loads four agents' inputs at once and evaluates its
+ * curve on four lanes. evaluate() scores every action and keeps the best
+ * getKeptCount() actions of each agent, best first, with a four-lane insertion; the
+ * full score table is never stored.
+ */
+class UtilityBatch {
+public:
+    static constexpr size_t MaxKept = 8; ///< Most actions kept per agent.
+
+    /**
+     * @brief Creates an empty batch keeping the @p keep (1 to MaxKept) best actions
+     * per agent.
+     */
+    UtilityBatch(std::shared_ptr<const UtilityModel> model, size_t keep = 1);
+
+    /**
+     * @brief Sets the number of agents; inputs of new agents are 0.
+     */
+    void resize(size_t agentCount);
+
+    /**
+     * @brief Returns the number of agents.
+     */
+    size_t getAgentCount() const { return m_agentCount; }
+
+    /**
+     * @brief Returns the values of @p input, one per agent.
+     */
+    float* getInputs(uint32_t input) { return &m_inputs[input * m_stride]; }
+
+    /**
+     * @brief Scores every agent on the calling thread.
+     */
+    void evaluate();
+
+    /**
+     * @brief Scores every agent, spread over @p jobs.
+     */
+    void evaluate(JobSystem& jobs);
+
+    /**
+     * @brief Returns the action of rank @p rank (0 = best) for @p agent, or
+     * InvalidUtilityAction.
+     */
+    uint32_t getBestAction(size_t agent, size_t rank = 0) const;
+
+    /**
+     * @brief Returns the score of rank @p rank for @p agent (-1 for an empty rank).
+     */
+    float getBestScore(size_t agent, size_t rank = 0) const { return m_topScores[rank * m_stride + agent]; }
+
+    /**
+     * @brief Returns the number of actions kept per agent.
+     */
+    size_t getKeptCount() const { return m_keep; }
+
+    /**
+     * @brief Returns the model.
+     */
+    const UtilityModel& getModel() const { return *m_model; }
+
+private:
+    /**
+     * @brief Scores agents [begin, end), begin being a multiple of four.
+     */
+    void evaluateRange(size_t begin, size_t end);
+
+    std::shared_ptr<const UtilityModel> m_model; ///< Shared model.
+    size_t m_keep;                   ///< Actions kept per agent.
+    size_t m_agentCount = 0;         ///< Agents.
+    size_t m_stride = 0;             ///< m_agentCount rounded up to four.
+    std::vector<float> m_inputs;     ///< Input channels, m_stride each.
+    std::vector<float> m_topScores;  ///< m_keep ranks, m_stride each.
+    std::vector<float> m_topActions; ///< Action per rank, as floats so they move in the same lanes (-1 = none).
+};
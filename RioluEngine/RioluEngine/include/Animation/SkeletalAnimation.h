@@ -0,0 +1,346 @@
+#pragma once
+
+/**
+ * @file SkeletalAnimation.h
+ * @brief Declares 2D skeletons, compressed skeletal clips, skinned meshes and the
+ * batched skeletal animation system.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/Transform.h"
+#include <memory>
+
+class JobSystem;
+
+/**
+ * @brief Parent index of a root bone.
+ */
+constexpr uint16_t NoParentBone = 0xFFFF;
+
+/**
+ * @struct BonePose
+ * @brief Local transform of a bone relative to its parent.
+ */
+struct BonePose {
+    float x = 0.f;        ///< Translation.
+    float y = 0.f;        ///< Translation.
+    float rotation = 0.f; ///< Degrees, like Transform.
+    float scaleX = 1.f;   ///< Scale along the bone.
+    float scaleY = 1.f;   ///< Scale across the bone.
+};
+
+/**
+ * @struct BoneMatrix
+ * @brief 2D affine transform: p' = (a * x + c * y + tx, b * x + d * y + ty).
+ */
+struct BoneMatrix {
+    float a = 1.f;  ///< First column.
+    float b = 0.f;  ///< First column.
+    float c = 0.f;  ///< Second column.
+    float d = 1.f;  ///< Second column.
+    float tx = 0.f; ///< Translation.
+    float ty = 0.f; ///< Translation.
+
+    /**
+     * @brief Builds the matrix of a pose (scale, then rotation, then translation).
+     */
+    static BoneMatrix fromPose(const BonePose& pose);
+
+    /**
+     * @brief Returns this * child.
+     */
+    BoneMatrix operator*(const BoneMatrix& child) const;
+
+    /**
+     * @brief Returns the inverse transform.
+     */
+    BoneMatrix inverse() const;
+
+    /**
+     * @brief Transforms a point.
+     */
+    sf::Vector2f apply(const sf::Vector2f& point) const {
+        return sf::Vector2f(a * point.x + c * point.y + tx, b * point.x + d * point.y + ty);
+    }
+};
+
+/**
+ * @class Skeleton
+ * @brief Bone hierarchy with its bind pose, shared by every character using it.
+ *
+ * Bones are stored parents first, so a single forward walk computes world poses.
+ */
+class Skeleton {
+public:
+    static constexpr size_t MaxBones = 256; ///< Bones a skeleton may have.
+
+    /**
+     * @brief Adds a bone; @p parent must already exist (or be NoParentBone).
+     */
+    uint16_t addBone(const std::string& name, uint16_t parent, const BonePose& bindPose);
+
+    /**
+     * @brief Returns the bone called @p name, or NoParentBone.
+     */
+    uint16_t findBone(const std::string& name) const;
+
+    size_t getBoneCount() const { return m_parents.size(); }
+    uint16_t getParent(uint16_t bone) const { return m_parents[bone]; }
+    const std::string& getBoneName(uint16_t bone) const { return m_names[bone]; }
+    const BonePose& getBindPose(uint16_t bone) const { return m_bindPoses[bone]; }
+
+    /**
+     * @brief Returns the model-space matrix of a bone in the bind pose.
+     */
+    const BoneMatrix& getBindWorld(uint16_t bone) const { return m_bindWorld[bone]; }
+
+private:
+    friend class SkeletalAnimationSystem;
+
+    std::vector<std::string> m_names;      ///< Bone names.
+    std::vector<uint16_t> m_parents;       ///< Parent per bone.
+    std::vector<BonePose> m_bindPoses;     ///< Local bind pose per bone.
+    std::vector<BoneMatrix> m_bindWorld;   ///< Model-space bind matrix per bone.
+    std::vector<BoneMatrix> m_inverseBind; ///< Inverse of m_bindWorld.
+};
+
+/**
+ * @class SkeletalClip
+ * @brief Bone poses sampled at a fixed rate and quantized to 16 bits.
+ *
+ * Every channel (x, y, rotation, scaleX, scaleY) of every bone is stored as an
+ * unsigned 16-bit fraction of the channel's range over the clip. Keys are laid out
+ * frame, then channel, then bone (padded to four bones), so sampling one channel of
+ * four bones is one 8-byte load per key frame. Rotations are unwrapped before
+ * quantization, and looping clips repeat their first frame at the end, so
+ * interpolation never crosses a wrap.
+ */
+class SkeletalClip {
+public:
+    static constexpr size_t Channels = 5; ///< x, y, rotation (radians), scaleX, scaleY.
+
+    /**
+     * @brief Compresses @p poses, frame after frame, getBoneCount() poses per frame.
+     * @param sampleRate Frames per second of @p poses.
+     * @param loop Play frame 0 again after the last frame.
+     */
+    static std::shared_ptr<const SkeletalClip> compress(const Skeleton& skeleton, float sampleRate,
+                                                        const std::vector<BonePose>& poses, bool loop);
+
+    float getDuration() const { return m_duration; }
+    bool isLooping() const { return m_loop; }
+    size_t getBoneCount() const { return m_boneCount; }
+
+    /**
+     * @brief Returns the bytes used by the keys and their ranges.
+     */
+    size_t getByteSize() const;
+
+private:
+    friend class SkeletalAnimationSystem;
+
+    size_t m_boneCount = 0;          ///< Bones per frame.
+    size_t m_stride = 0;             ///< m_boneCount rounded up to four.
+    size_t m_frameCount = 0;         ///< Stored frames (looping clips include the repeated first frame).
+    float m_sampleRate = 30.f;       ///< Frames per second.
+    float m_duration = 0.f;          ///< Seconds.
+    bool m_loop = true;              ///< Wraps instead of holding the last frame.
+    std::vector<float> m_minimum;    ///< Channel minimum, Channels * m_stride.
+    std::vector<float> m_step;       ///< Channel range / 65535, Channels * m_stride.
+    std::vector<uint16_t> m_keys;    ///< m_frameCount * Channels * m_stride quantized values.
+};
+
+/**
+ * @struct SkinnedVertex
+ * @brief Mesh vertex bound to up to two bones.
+ */
+struct SkinnedVertex {
+    sf::Vector2f position;  ///< Model-space position in the bind pose.
+    sf::Vector2f texCoords; ///< Texture coordinates.
+    uint16_t bones[2] = { 0, 0 }; ///< Influencing bones.
+    float weight = 1.f;     ///< Weight of bones[0]; bones[1] gets 1 - weight.
+};
+
+/**
+ * @class SkinnedMesh
+ * @brief Triangles skinned to a skeleton, shared by every character using it.
+ */
+class SkinnedMesh {
+public:
+    /**
+     * @brief Adds a vertex and returns its index.
+     */
+    uint32_t addVertex(const SkinnedVertex& vertex);
+
+    /**
+     * @brief Adds a triangle of existing vertices.
+     */
+    void addTriangle(uint32_t first, uint32_t second, uint32_t third);
+
+    size_t getVertexCount() const { return m_vertices.size(); }
+    size_t getTriangleCount() const { return m_indices.size() / 3; }
+    const SkinnedVertex& getVertex(uint32_t vertex) const { return m_vertices[vertex]; }
+    const std::vector<uint32_t>& getIndices() const { return m_indices; }
+
+private:
+    std::vector<SkinnedVertex> m_vertices; ///< Vertices.
+    std::vector<uint32_t> m_indices;       ///< Three per triangle.
+};
+
+/**
+ * @brief Index of a clip in a SkeletalAnimationSystem.
+ */
+using SkeletalClipId = uint16_t;
+
+/**
+ * @brief Layer of a character that plays nothing.
+ */
+constexpr SkeletalClipId InvalidSkeletalClip = 0xFFFF;
+
+/**
+ * @class SkeletalAnimationSystem
+ * @brief Animates and skins every character that shares one skeleton and mesh.
+ *
+ * Each character plays up to two clips blended by a weight (cross-fades ramp it).
+ * update() runs, per character: sampling of both clips four bones at a time from
+ * the 16-bit keys, four-lane blending, four-lane local matrices, a forward walk
+ * for world matrices (rooted at the character's Transform), blending of the two skin
+ * matrices of four vertices at a time, and the write of the skinned positions into
+ * one vertex array holding every character's triangles, ready to be drawn in a single
+ * call. Bones bound to Transforms (weapons, effects) drive them afterwards.
+ *
+ * Characters are independent, so the JobSystem overload spreads them over threads;
+ * temporary poses live in the worker's scratch allocator.
+ */
+class SkeletalAnimationSystem {
+public:
+    /**
+     * @brief Creates a system for characters made of @p skeleton and @p mesh.
+     */
+    SkeletalAnimationSystem(std::shared_ptr<const Skeleton> skeleton, std::shared_ptr<const SkinnedMesh> mesh);
+
+    /**
+     * @brief Registers a clip (it must match the skeleton).
+     */
+    SkeletalClipId addClip(std::shared_ptr<const SkeletalClip> clip);
+
+    /**
+     * @brief Adds a character placed by @p root (null keeps it at the origin) and
+     * returns its index.
+     */
+    size_t addCharacter(const EngineUtilities::TSharedPointer<Transform>& root);
+
+    /**
+     * @brief Removes a character; the last character takes its index.
+     */
+    void removeCharacter(size_t character);
+
+    /**
+     * @brief Plays @p clip from its start, cross-fading from the current clip over
+     * @p fadeTime seconds.
+     */
+    void play(size_t character, SkeletalClipId clip, float fadeTime = 0.f);
+
+    /**
+     * @brief Blends @p clip over the current one with a fixed @p weight (0 to 1);
+     * InvalidSkeletalClip removes the blend.
+     */
+    void setBlend(size_t character, SkeletalClipId clip, float weight);
+
+    /**
+     * @brief Makes @p target follow @p bone of @p character.
+     */
+    void attach(size_t character, uint16_t bone, const EngineUtilities::TSharedPointer<Transform>& target);
+
+    /**
+     * @brief Advances, poses and skins every character on the calling thread.
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief Advances, poses and skins every character, spread over @p jobs.
+     */
+    void update(float deltaTime, JobSystem& jobs);
+
+    size_t getCharacterCount() const { return m_characters.size(); }
+
+    /**
+     * @brief Returns the world matrix of @p bone after the last update().
+     */
+    const BoneMatrix& getBoneWorld(size_t character, uint16_t bone) const {
+        return m_worlds[character * m_skeleton->getBoneCount() + bone];
+    }
+
+    /**
+     * @brief Returns the triangles of every character (sf::Triangles), in character order.
+     */
+    const std::vector<sf::Vertex>& getVertices() const { return m_vertices; }
+
+    /**
+     * @brief Returns the number of vertices of one character in getVertices().
+     */
+    size_t getVerticesPerCharacter() const { return m_mesh->getIndices().size(); }
+
+private:
+    /**
+     * @struct Layer
+     * @brief A clip being played by a character.
+     */
+    struct Layer {
+        SkeletalClipId clip = InvalidSkeletalClip; ///< Clip, or InvalidSkeletalClip.
+        float time = 0.f;                          ///< Seconds into the clip.
+    };
+
+    /**
+     * @struct Character
+     * @brief Playback state of a character.
+     */
+    struct Character {
+        EngineUtilities::TSharedPointer<Transform> root; ///< Placement, may be null.
+        Layer layers[2];       ///< Base clip and blended clip.
+        float weight = 0.f;    ///< Weight of layers[1].
+        float fadeRate = 0.f;  ///< Change of weight per second (negative during a cross-fade).
+    };
+
+    /**
+     * @struct Attachment
+     * @brief A Transform following a bone.
+     */
+    struct Attachment {
+        size_t character;                                  ///< Character.
+        uint16_t bone;                                     ///< Bone followed.
+        EngineUtilities::TSharedPointer<Transform> target; ///< Transform driven.
+    };
+
+    /**
+     * @brief Advances, poses and skins characters [begin, end).
+     */
+    void updateRange(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Writes the attached Transforms.
+     */
+    void applyAttachments();
+
+    /**
+     * @brief Decodes @p layer of a clip into a structure-of-arrays local pose.
+     */
+    void sample(const Layer& layer, float* pose) const;
+
+    std::shared_ptr<const Skeleton> m_skeleton;            ///< Shared skeleton.
+    std::shared_ptr<const SkinnedMesh> m_mesh;             ///< Shared mesh.
+    size_t m_boneStride = 0;                               ///< Bone count rounded up to four.
+    size_t m_vertexStride = 0;                             ///< Mesh vertex count rounded up to four.
+    std::vector<std::shared_ptr<const SkeletalClip>> m_clips; ///< Registered clips.
+    std::vector<Character> m_characters;                   ///< Characters.
+    std::vector<BoneMatrix> m_worlds;                      ///< World matrix per character and bone.
+    std::vector<Attachment> m_attachments;                 ///< Bones driving Transforms.
+    std::vector<sf::Vertex> m_vertices;                    ///< Skinned triangles of every character.
+    std::vector<float> m_bindPose;                         ///< Bind pose in clip channel layout, for characters without a clip.
+
+    // Mesh as padded structure of arrays, for four-lane skinning.
+    std::vector<float> m_bindX;        ///< Bind position x per vertex.
+    std::vector<float> m_bindY;        ///< Bind position y per vertex.
+    std::vector<float> m_weights;      ///< Weight of the first bone per vertex.
+    std::vector<uint16_t> m_bones;     ///< Two bones per vertex.
+};
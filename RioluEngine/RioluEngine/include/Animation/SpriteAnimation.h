@@ -0,0 +1,320 @@
+#pragma once
+
+/**
+ * @file SpriteAnimation.h
+ * @brief Declares shared sprite-sheet clips and the dense sprite animator storage.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/ComponentStorage.h"
+#include "ECS/Reflection.h"
+
+/**
+ * @brief Index of a clip in a SpriteClipLibrary.
+ */
+using SpriteClipId = uint16_t;
+
+/**
+ * @brief Clip of an animator that plays nothing.
+ */
+constexpr SpriteClipId InvalidSpriteClip = 0xFFFF;
+
+/**
+ * @brief Identifier of an animator in a SpriteAnimatorStorage: slot index in the low
+ * 24 bits, slot generation in the high 8.
+ */
+using SpriteAnimatorId = uint32_t;
+
+/**
+ * @brief Animator id that refers to nothing.
+ */
+constexpr SpriteAnimatorId InvalidSpriteAnimator = 0xFFFFFFFFu;
+
+/**
+ * @struct SpriteFrame
+ * @brief One frame of a clip: where it is in the sheet and how long it shows.
+ */
+struct SpriteFrame {
+    sf::IntRect rect;      ///< Texture rectangle in the sprite sheet.
+    float duration = 0.1f; ///< Seconds on screen.
+};
+
+/**
+ * @struct SpriteClipEvent
+ * @brief Event fired when a clip's time passes @p time (footstep, hit frame...).
+ */
+struct SpriteClipEvent {
+    float time = 0.f;   ///< Seconds from the start of the clip.
+    uint32_t event = 0; ///< Game-defined event id.
+};
+
+/**
+ * @struct SpriteClipDesc
+ * @brief Everything needed to add a clip to a library.
+ */
+struct SpriteClipDesc {
+    std::string name;                    ///< Debug name.
+    std::vector<SpriteFrame> frames;     ///< Frames in order.
+    std::vector<SpriteClipEvent> events; ///< Events, in any order.
+    bool loop = true;                    ///< Restart at the end instead of holding the last frame.
+};
+
+/**
+ * @struct SpriteAnimationEvent
+ * @brief An event emitted by SpriteAnimatorStorage::advanceAll().
+ */
+struct SpriteAnimationEvent {
+    static constexpr uint32_t Finished = 0xFFFFFFFFu; ///< Event of a non-looping clip reaching its end.
+
+    SpriteAnimatorId animator; ///< Animator that fired it.
+    SpriteClipId clip;         ///< Clip that fired it.
+    uint32_t event;            ///< Clip event id, or Finished.
+};
+
+/**
+ * @class SpriteClipLibrary
+ * @brief Frames and events of every clip, stored once and shared by all animators.
+ *
+ * Clips are flattened into contiguous arrays: each clip is a range of frames (rect
+ * and end time from the clip start) and a range of events sorted by time.
+ */
+class SpriteClipLibrary {
+public:
+    /**
+     * @brief Adds a clip and returns its id.
+     */
+    SpriteClipId addClip(const SpriteClipDesc& desc);
+
+    /**
+     * @brief Returns the id of the clip called @p name, or InvalidSpriteClip.
+     */
+    SpriteClipId findClip(const std::string& name) const;
+
+    size_t getClipCount() const { return m_clips.size(); }
+    const std::string& getClipName(SpriteClipId clip) const { return m_clips[clip].name; }
+    float getClipLength(SpriteClipId clip) const { return m_clips[clip].length; }
+    uint16_t getFrameCount(SpriteClipId clip) const { return m_clips[clip].frameCount; }
+
+    /**
+     * @brief Returns the texture rectangle of frame @p frame of @p clip.
+     */
+    const sf::IntRect& getFrameRect(SpriteClipId clip, uint16_t frame) const {
+        return m_frameRects[m_clips[clip].firstFrame + frame];
+    }
+
+    /**
+     * @brief Returns the bytes used by all clips.
+     */
+    size_t getByteSize() const;
+
+private:
+    friend class SpriteAnimatorStorage;
+
+    /**
+     * @struct Clip
+     * @brief Ranges of a clip in the flat arrays.
+     */
+    struct Clip {
+        std::string name;    ///< Debug name.
+        uint32_t firstFrame; ///< First entry in m_frameRects / m_frameEnds.
+        uint16_t frameCount; ///< Frames.
+        uint16_t eventCount; ///< Events.
+        uint32_t firstEvent; ///< First entry in m_eventTimes / m_eventIds.
+        float length;        ///< Sum of the frame durations.
+        bool loop;           ///< Restart at the end.
+    };
+
+    std::vector<Clip> m_clips;            ///< Clips.
+    std::vector<sf::IntRect> m_frameRects; ///< Frame rectangles of every clip.
+    std::vector<float> m_frameEnds;       ///< End time of each frame from its clip start.
+    std::vector<float> m_eventTimes;      ///< Event times of every clip, sorted per clip.
+    std::vector<uint32_t> m_eventIds;     ///< Event ids matching m_eventTimes.
+};
+
+/**
+ * @struct SpriteAnimationData
+ * @brief Plain state of one animator in a SpriteAnimatorStorage.
+ */
+struct SpriteAnimationData {
+    SpriteClipId clip; ///< Playing clip, InvalidSpriteClip before play() and in free slots.
+    uint16_t frame;    ///< Frame shown by the target, NotShown until the next pass writes it.
+    float time;        ///< Seconds from the clip start.
+    float speed;       ///< Playback rate (0 pauses).
+
+    static constexpr uint16_t NotShown = 0xFFFF; ///< Frame of an animator whose target is out of date.
+};
+
+/**
+ * @brief Reflection of SpriteAnimationData. The frame follows from the clip and time,
+ * so it is neither saved nor sent.
+ */
+template<>
+struct Reflect<SpriteAnimationData> {
+    static constexpr const char* name = "SpriteAnimator";
+    static constexpr auto fields = std::make_tuple(
+        RIOLU_FIELD(SpriteAnimationData, clip, FieldSaved | FieldReplicated | FieldEditable | FieldScripted),
+        RIOLU_FIELD(SpriteAnimationData, frame, FieldScripted),
+        RIOLU_FIELD(SpriteAnimationData, time, FieldSaved | FieldReplicated | FieldScripted),
+        RIOLU_FIELD(SpriteAnimationData, speed, FieldSaved | FieldReplicated | FieldEditable | FieldScripted));
+};
+
+/**
+ * @class SpriteAnimatorStorage
+ * @brief Every sprite animator of a scene as plain entries, advanced in one linear pass.
+ *
+ * An animator is not a Component object: it is a 12-byte SpriteAnimationData, the
+ * sf::Shape it animates and a one-byte generation, in three parallel arrays. Ids are
+ * stable slot indices, so nothing has to be patched and compact() never moves slots;
+ * freed slots are reused by create(). advanceAll() writes the texture rect of a frame
+ * straight into the target shape when the frame changes, and appends clip events to a
+ * per-frame buffer instead of calling callbacks.
+ *
+ * The states are registered like any component storage, so world snapshots save and
+ * restore them. The shapes are not part of the snapshot: call invalidateTargets()
+ * after a restore so the next pass rewrites their rects.
+ */
+class SpriteAnimatorStorage : public IComponentStorage {
+public:
+    /**
+     * @brief Largest number of slots (the index has 24 bits).
+     */
+    static constexpr uint32_t MaxAnimators = 1u << 24;
+
+    /**
+     * @brief Creates an empty storage.
+     * @param name Storage name for reports.
+     */
+    explicit SpriteAnimatorStorage(const char* name = "SpriteAnimator") : IComponentStorage(name) {}
+
+    /**
+     * @brief Preallocates slots for @p count animators.
+     */
+    void
+        reserve(size_t count);
+
+    /**
+     * @brief Adds an animator that plays nothing until play().
+     * @param target Shape whose texture rect follows the animation (may be null).
+     */
+    SpriteAnimatorId
+        create(sf::Shape* target = nullptr);
+
+    /**
+     * @brief Removes an animator; its id and events already emitted become stale.
+     */
+    void
+        destroy(SpriteAnimatorId id);
+
+    /**
+     * @brief Returns true if @p id refers to a live animator of this storage.
+     */
+    bool
+        isAlive(SpriteAnimatorId id) const {
+        const uint32_t index = id & IndexMask;
+        return index < m_states.size() && m_live[index] != 0 && m_generations[index] == (id >> IndexBits);
+    }
+
+    /**
+     * @brief Plays @p clip from its start.
+     */
+    void
+        play(SpriteAnimatorId id, SpriteClipId clip, float speed = 1.f);
+
+    /**
+     * @brief Sets the playback rate (0 pauses, must not be negative).
+     */
+    void
+        setSpeed(SpriteAnimatorId id, float speed);
+
+    /**
+     * @brief Changes the shape animated by @p id; the next pass writes its rect.
+     */
+    void
+        setTarget(SpriteAnimatorId id, sf::Shape* target);
+
+    SpriteClipId
+        getClip(SpriteAnimatorId id) const {
+        return m_states[slotOf(id, "getClip")].clip;
+    }
+
+    /**
+     * @brief Returns the current frame (0 before the first pass after play()).
+     */
+    uint16_t
+        getFrame(SpriteAnimatorId id) const {
+        const uint16_t frame = m_states[slotOf(id, "getFrame")].frame;
+        return frame == SpriteAnimationData::NotShown ? 0 : frame;
+    }
+
+    float
+        getTime(SpriteAnimatorId id) const {
+        return m_states[slotOf(id, "getTime")].time;
+    }
+
+    float
+        getSpeed(SpriteAnimatorId id) const {
+        return m_states[slotOf(id, "getSpeed")].speed;
+    }
+
+    /**
+     * @brief Returns the texture rectangle to draw, or an empty one before play().
+     */
+    sf::IntRect
+        getTextureRect(const SpriteClipLibrary& library, SpriteAnimatorId id) const;
+
+    /**
+     * @brief Advances every animator by @p deltaTime and updates the rects of their targets.
+     * @param library Clips the animators play.
+     * @param events Receives this frame's events (cleared first).
+     */
+    void
+        advanceAll(const SpriteClipLibrary& library, float deltaTime, std::vector<SpriteAnimationEvent>& events);
+
+    /**
+     * @brief Makes the next pass rewrite the rect of every target (paused ones too),
+     * for instance after a snapshot restore.
+     */
+    void
+        invalidateTargets();
+
+    /**
+     * @brief Returns the heap bytes held by the storage (every array, free slots included).
+     */
+    size_t
+        getAllocatedBytes() const;
+
+    sf::Uint8* getBytes() override { return reinterpret_cast<sf::Uint8*>(m_states.data()); }
+    size_t getByteSize() const override { return m_states.size() * sizeof(SpriteAnimationData); }
+    size_t getSlotCount() const override { return m_states.size(); }
+    size_t getLiveCount() const override { return m_liveCount; }
+
+    /**
+     * @brief Does nothing: ids are slot indices, so slots never move.
+     */
+    size_t compact(const std::chrono::steady_clock::time_point& /*deadline*/) override { return 0; }
+
+    StorageFragmentation
+        getFragmentation() const override;
+
+private:
+    static constexpr int IndexBits = 24;                           ///< Bits of the slot index in an id.
+    static constexpr uint32_t IndexMask = (1u << IndexBits) - 1u; ///< Slot index of an id.
+
+    /**
+     * @brief Returns the slot of a live id; exits with an error otherwise.
+     */
+    uint32_t
+        slotOf(SpriteAnimatorId id, const char* method) const {
+        if (!isAlive(id)) {
+            ERROR("SpriteAnimatorStorage", method, "Unknown or destroyed animator " << id);
+        }
+        return id & IndexMask;
+    }
+
+    std::vector<SpriteAnimationData> m_states; ///< Animation state per slot.
+    std::vector<sf::Shape*> m_targets;         ///< Animated shape per slot (null if none).
+    std::vector<uint8_t> m_generations;        ///< Bumped on destroy so stale ids stay dead.
+    std::vector<uint8_t> m_live;               ///< 1 for live slots.
+    std::vector<uint32_t> m_freeSlots;         ///< Free slots, reused last-in first-out.
+    size_t m_liveCount = 0;                    ///< Live animators.
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+/**
+ * @file TweenSystem.h
+ * @brief Declares batch tweening of Transform and CShape properties.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/Transform.h"
+#include "CShape.h"
+
+/**
+ * @enum TweenProperty
+ * @brief Property animated by a tween.
+ */
+enum class TweenProperty : uint8_t {
+    Position, ///< Transform position (2 channels).
+    Rotation, ///< Transform rotation angle (1 channel).
+    Scale,    ///< Transform scale (2 channels).
+    Color,    ///< CShape fill colour, 0-255 per channel (4 channels).
+    Count
+};
+
+/**
+ * @enum TweenEasing
+ * @brief Easing curve applied to the normalized time.
+ */
+enum class TweenEasing : uint8_t {
+    Linear,
+    QuadIn,
+    QuadOut,
+    QuadInOut,
+    CubicIn,
+    CubicOut,
+    CubicInOut,
+    SmoothStep,
+    Count
+};
+
+/**
+ * @struct TweenId
+ * @brief Handle of a playing tween or sequence.
+ */
+struct TweenId {
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = InvalidIndex; ///< Slot in the system's id table.
+    uint32_t generation = 0;       ///< Generation of the slot when issued.
+};
+
+/**
+ * @struct TweenTrack
+ * @brief One property animation: target, start and end values, duration and easing.
+ */
+struct TweenTrack {
+    TweenProperty property = TweenProperty::Position;  ///< Animated property.
+    TweenEasing easing = TweenEasing::Linear;          ///< Easing curve.
+    float duration = 1.f;                              ///< Seconds from start to end value.
+    float from[4] = { 0.f, 0.f, 0.f, 0.f };            ///< Start value per channel.
+    float to[4] = { 0.f, 0.f, 0.f, 0.f };              ///< End value per channel.
+    EngineUtilities::TSharedPointer<Transform> transform; ///< Target of Transform properties.
+    EngineUtilities::TSharedPointer<CShape> shape;        ///< Target of Color.
+
+    /**
+     * @brief Moves a Transform from @p from to @p to.
+     */
+    static TweenTrack position(const EngineUtilities::TSharedPointer<Transform>& transform,
+                               const sf::Vector2f& from, const sf::Vector2f& to,
+                               float duration, TweenEasing easing = TweenEasing::Linear);
+
+    /**
+     * @brief Turns a Transform from @p from to @p to degrees.
+     */
+    static TweenTrack rotation(const EngineUtilities::TSharedPointer<Transform>& transform,
+                               float from, float to, float duration, TweenEasing easing = TweenEasing::Linear);
+
+    /**
+     * @brief Scales a Transform from @p from to @p to.
+     */
+    static TweenTrack scale(const EngineUtilities::TSharedPointer<Transform>& transform,
+                            const sf::Vector2f& from, const sf::Vector2f& to,
+                            float duration, TweenEasing easing = TweenEasing::Linear);
+
+    /**
+     * @brief Fades a CShape's fill colour from @p from to @p to.
+     */
+    static TweenTrack color(const EngineUtilities::TSharedPointer<CShape>& shape,
+                            const sf::Color& from, const sf::Color& to,
+                            float duration, TweenEasing easing = TweenEasing::Linear);
+};
+
+/**
+ * @class TweenSequence
+ * @brief Tracks played one after another.
+ *
+ * then() starts a new stage after everything before it; with() adds a track to the
+ * current stage; wait() delays the next stage.
+ */
+class TweenSequence {
+public:
+    /**
+     * @brief Adds a stage that starts when the previous one has finished.
+     */
+    TweenSequence& then(const TweenTrack& track);
+
+    /**
+     * @brief Adds a track to the last stage (starts a stage after a wait()).
+     */
+    TweenSequence& with(const TweenTrack& track);
+
+    /**
+     * @brief Delays the next stage; at the end of the sequence, delays its end.
+     */
+    TweenSequence& wait(float seconds);
+
+private:
+    friend class TweenSystem;
+
+    /**
+     * @struct Stage
+     * @brief Tracks started together.
+     */
+    struct Stage {
+        float delay = 0.f;              ///< Wait before the stage starts.
+        std::vector<TweenTrack> tracks; ///< Tracks of the stage.
+    };
+
+    std::vector<Stage> m_stages; ///< Stages in order.
+    float m_pendingDelay = 0.f;  ///< Delay for the next then().
+};
+
+/**
+ * @class TweenSystem
+ * @brief Plays every tween of the game in one pass per frame.
+ *
+ * Playing tweens are grouped by property and easing, and each group stores its
+ * tweens as a structure of arrays. update() advances all of them with four-lane
+ * arithmetic (time, loops, yoyo, easing, interpolation) into a result array, then
+ * writes the results to their targets one property at a time. Targets are kept
+ * alive by the tween; a finished tween is removed at the end of update().
+ *
+ * A sequence keeps only its current stage in the groups; when every tween of the
+ * stage finishes, the next stage starts with the leftover time, so two stages
+ * animating the same property never write in the same frame.
+ */
+class TweenSystem {
+public:
+    static constexpr int Forever = -1; ///< Loop count that never ends.
+
+    /**
+     * @brief Plays one track.
+     * @param loops Extra repetitions (0 plays once, Forever repeats).
+     * @param yoyo Play every other repetition backwards.
+     * @param delay Seconds before the tween starts writing.
+     */
+    TweenId play(const TweenTrack& track, int loops = 0, bool yoyo = false, float delay = 0.f);
+
+    /**
+     * @brief Plays a sequence.
+     * @param loops Extra repetitions of the whole sequence (0 plays once, Forever repeats).
+     */
+    TweenId play(const TweenSequence& sequence, int loops = 0);
+
+    /**
+     * @brief Stops a tween or sequence where it is.
+     */
+    void cancel(TweenId id);
+
+    /**
+     * @brief Returns true while a tween or sequence is playing.
+     */
+    bool isPlaying(TweenId id) const;
+
+    /**
+     * @brief Advances and applies every tween.
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief Returns the number of tweens being evaluated.
+     */
+    size_t getActiveCount() const;
+
+private:
+    /**
+     * @struct Group
+     * @brief Tweens of one property and easing, as a structure of arrays.
+     *
+     * Arrays are padded to a multiple of four so the pass never needs a scalar tail.
+     */
+    struct Group {
+        size_t count = 0;                 ///< Tweens in the group.
+        std::vector<uint32_t> ids;        ///< Id slot per tween.
+        std::vector<float> elapsed;       ///< Time since start (negative during a delay).
+        std::vector<float> duration;      ///< Length of one repetition.
+        std::vector<float> invDuration;   ///< 1 / duration.
+        std::vector<float> lastCycle;     ///< Index of the last repetition (huge for Forever).
+        std::vector<float> yoyo;          ///< 1 to reverse odd repetitions, else 0.
+        std::vector<float> from[4];       ///< Start value per channel.
+        std::vector<float> delta[4];      ///< End minus start per channel.
+        std::vector<float> value[4];      ///< Result of the last pass per channel.
+        std::vector<uint8_t> flags;       ///< Result flags of the last pass (Writes, Finished).
+        std::vector<EngineUtilities::TSharedPointer<Transform>> transforms; ///< Transform targets.
+        std::vector<EngineUtilities::TSharedPointer<CShape>> shapes;        ///< CShape targets.
+    };
+
+    /**
+     * @struct Slot
+     * @brief Id table entry: where a tween lives, or which sequence an id names.
+     */
+    struct Slot {
+        uint32_t generation = 0;               ///< Bumped when the slot is freed.
+        bool used = false;                     ///< True while the id is playing.
+        bool isSequence = false;               ///< Names a sequence instead of a tween.
+        uint16_t group = 0;                    ///< Group of a tween.
+        uint32_t position = 0;                 ///< Index in the group, or in m_sequences.
+        uint32_t sequence = TweenId::InvalidIndex; ///< Sequence running this tween, if any.
+    };
+
+    /**
+     * @struct SequenceState
+     * @brief A playing sequence.
+     */
+    struct SequenceState {
+        TweenSequence sequence;        ///< Stages (copied at play()).
+        size_t stage = 0;              ///< Stage being played.
+        int loopsLeft = 0;             ///< Remaining repetitions (Forever repeats).
+        std::vector<uint32_t> running; ///< Id slots of the current stage's tweens.
+        uint32_t slot = 0;             ///< Id slot of the sequence.
+    };
+
+    static constexpr uint8_t Writes = 1;   ///< The tween wrote a value this frame.
+    static constexpr uint8_t Finished = 2; ///< The tween played its last repetition.
+
+    /**
+     * @brief Group index of a property and easing.
+     */
+    static size_t groupIndex(TweenProperty property, TweenEasing easing) {
+        return static_cast<size_t>(property) * static_cast<size_t>(TweenEasing::Count) + static_cast<size_t>(easing);
+    }
+
+    /**
+     * @brief Returns a free id slot.
+     */
+    uint32_t allocateSlot();
+
+    /**
+     * @brief Releases an id slot.
+     */
+    void freeSlot(uint32_t slot);
+
+    /**
+     * @brief Adds a tween to its group and returns its id slot.
+     */
+    uint32_t startTween(const TweenTrack& track, int loops, bool yoyo, float elapsed, uint32_t sequence);
+
+    /**
+     * @brief Swap-removes a tween from its group and frees its id slot.
+     */
+    void removeTween(uint32_t slot);
+
+    /**
+     * @brief Starts the current stage of a sequence.
+     * @param elapsed Time already spent in the stage.
+     */
+    void startStage(uint32_t sequence, float elapsed);
+
+    /**
+     * @brief Called when a sequence tween finishes; advances the sequence when its
+     * stage is done.
+     */
+    void onSequenceTweenFinished(uint32_t sequence, uint32_t slot, float overshoot);
+
+    /**
+     * @brief Moves a sequence to its next stage (or repetition, or end).
+     * @param overshoot Time already spent past the end of the finished stage.
+     */
+    void finishStage(uint32_t sequence, float overshoot);
+
+    /**
+     * @brief Runs the four-lane pass over one group.
+     */
+    void evaluate(Group& group, TweenEasing easing, size_t channels, float deltaTime);
+
+    /**
+     * @brief Writes a group's results to its targets.
+     */
+    void apply(Group& group, TweenProperty property);
+
+    Group m_groups[static_cast<size_t>(TweenProperty::Count) * static_cast<size_t>(TweenEasing::Count)]; ///< Groups by property and easing.
+    std::vector<Slot> m_slots;                          ///< Id table.
+    std::vector<uint32_t> m_freeSlots;                  ///< Free id slots.
+    std::vector<SequenceState> m_sequences;             ///< Sequences, indexed by Slot::position.
+    std::vector<uint32_t> m_freeSequences;              ///< Free sequence entries.
+    std::vector<std::pair<uint32_t, float>> m_waits;    ///< Sequence and time left of stages without tracks.
+    std::vector<std::pair<uint32_t, float>> m_finished; ///< Id slot and overshoot of tweens finished this frame.
+};
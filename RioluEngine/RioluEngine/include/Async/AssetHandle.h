@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * @file AssetHandle.h
+ * @brief Declares asynchronous loading of file-backed assets on the job system.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/JobSystem.h"
+
+/**
+ * @class AssetHandle
+ * @brief Asset loaded in the background; usable once isReady() is true.
+ *
+ * T is any type with `bool loadFromFile(const std::string&)` that can be loaded off
+ * the main thread (sf::Image, sf::Font, sf::SoundBuffer...). GPU resources such as
+ * sf::Texture need the main thread's context: load an sf::Image, await it, then
+ * upload the texture.
+ *
+ * @tparam T Asset type.
+ */
+template<typename T>
+class AssetHandle {
+public:
+    /**
+     * @brief Empty handle.
+     */
+    AssetHandle() = default;
+
+    /**
+     * @brief Starts loading @p path on @p jobs.
+     */
+    static AssetHandle
+    load(JobSystem& jobs, const std::string& path) {
+        AssetHandle handle;
+        handle.m_state = std::make_shared<State>();
+        handle.m_state->path = path;
+        std::shared_ptr<State> state = handle.m_state;
+        handle.m_state->job = jobs.schedule([state] {
+            state->loaded = state->asset.loadFromFile(state->path);
+        });
+        return handle;
+    }
+
+    /**
+     * @brief Returns true once the load finished, successfully or not.
+     */
+    bool isReady() const { return m_state && m_state->job->isDone(); }
+
+    /**
+     * @brief Returns true if the load finished and succeeded.
+     */
+    bool isLoaded() const { return isReady() && m_state->loaded; }
+
+    /**
+     * @brief Returns the asset. Only valid once isReady() is true.
+     */
+    T& get() const { return m_state->asset; }
+
+    /**
+     * @brief Returns the loading job, completed when the asset is ready.
+     */
+    JobHandle getJob() const { return m_state ? m_state->job : JobHandle(); }
+
+    /**
+     * @brief Returns the file being loaded.
+     */
+    const std::string& getPath() const { return m_state->path; }
+
+private:
+    /**
+     * @brief Data shared with the loading job.
+     */
+    struct State {
+        T asset;            ///< Loaded asset.
+        bool loaded = false; ///< Result of loadFromFile.
+        std::string path;   ///< Source file.
+        JobHandle job;      ///< Loading job.
+    };
+
+    std::shared_ptr<State> m_state; ///< Shared with the loading job.
+};
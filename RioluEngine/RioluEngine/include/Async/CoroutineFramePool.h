@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * @file CoroutineFramePool.h
+ * @brief Declares the size-class pool that coroutine frames are allocated from.
+ */
+
+#include "../Prerequisites.h"
+#include <memory>
+#include <mutex>
+
+/**
+ * @struct CoroutineFramePoolStats
+ * @brief Usage counters of the frame pool.
+ */
+struct CoroutineFramePoolStats {
+    size_t liveFrames = 0;    ///< Frames currently allocated.
+    size_t peakFrames = 0;    ///< Highest liveFrames value seen.
+    size_t chunks = 0;        ///< Chunks requested from the heap.
+    size_t heapFallbacks = 0; ///< Frames too large for the pool, served by the heap.
+};
+
+/**
+ * @class CoroutineFramePool
+ * @brief Recycles coroutine frames by size class instead of going to the heap.
+ *
+ * Frames are rounded up to a multiple of Granularity and served from per-class free
+ * lists, refilled from large chunks. Memory is never returned to the heap before the
+ * pool dies, so after warm-up creating and finishing a coroutine does not allocate.
+ * Frames larger than MaxPooledSize use the global operator new.
+ */
+class CoroutineFramePool {
+public:
+    static const size_t Granularity = 64;     ///< Size class step in bytes.
+    static const size_t MaxPooledSize = 2048; ///< Largest pooled frame.
+    static const size_t ChunkSize = 64 * 1024; ///< Bytes requested from the heap per refill.
+
+    /**
+     * @brief Returns the pool used by Task frames.
+     */
+    static CoroutineFramePool& get();
+
+    CoroutineFramePool() = default;
+    CoroutineFramePool(const CoroutineFramePool&) = delete;
+    CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+    /**
+     * @brief Allocates a frame of @p size bytes.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Returns a frame allocated with the same @p size.
+     */
+    void deallocate(void* frame, size_t size);
+
+    /**
+     * @brief Returns a copy of the usage counters.
+     */
+    CoroutineFramePoolStats getStats();
+
+private:
+    /**
+     * @brief Node of a free list, stored inside the free frame.
+     */
+    struct FreeFrame {
+        FreeFrame* next; ///< Next free frame of the same class.
+    };
+
+    static const size_t ClassCount = MaxPooledSize / Granularity; ///< Number of size classes.
+
+    std::mutex m_mutex;                                  ///< Frames may finish on any thread.
+    FreeFrame* m_freeLists[ClassCount] = {};             ///< Free frames per size class.
+    std::vector<std::unique_ptr<sf::Uint8[]>> m_chunks;  ///< Memory the frames are carved from.
+    sf::Uint8* m_cursor = nullptr;                       ///< Next unused byte of the last chunk.
+    sf::Uint8* m_chunkEnd = nullptr;                     ///< End of the last chunk.
+    CoroutineFramePoolStats m_stats;                     ///< Usage counters.
+};
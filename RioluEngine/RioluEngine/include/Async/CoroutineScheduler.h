@@ -0,0 +1,198 @@
+#pragma once
+
+/**
+ * @file CoroutineScheduler.h
+ * @brief Declares the main-loop scheduler that resumes Task coroutines.
+ */
+
+#include "../Prerequisites.h"
+#include "Async/AssetHandle.h"
+#include "Async/Task.h"
+#include "Jobs/JobSystem.h"
+#include <atomic>
+#include <mutex>
+#include <queue>
+
+/**
+ * @enum ResumePoint
+ * @brief Places in BaseApp::run where suspended coroutines are resumed.
+ */
+enum class ResumePoint {
+    Update,     ///< Start of BaseApp::update, once deltaTime is known.
+    LateUpdate, ///< After the actors updated, before rendering.
+    Count       ///< Number of resume points.
+};
+
+/**
+ * @struct CoroutineSchedulerStats
+ * @brief Counters of the scheduler.
+ */
+struct CoroutineSchedulerStats {
+    uint64_t resumed = 0;       ///< Coroutines resumed since creation.
+    uint64_t resumedLastFrame = 0; ///< Coroutines resumed by the last Update and LateUpdate.
+};
+
+/**
+ * @class CoroutineScheduler
+ * @brief Owns top-level coroutines and resumes them at fixed points of the frame.
+ *
+ * Coroutines suspend on awaitables returned by nextFrame(), delay() and waitFor().
+ * A suspended coroutine is only stored in the list of the event it waits for, so it
+ * costs nothing per frame until that event fires: delays sit in a min-heap, job and
+ * asset completions are posted by the finishing thread, and only the coroutines
+ * waiting for the next frame are walked each frame.
+ *
+ * Everything is resumed on the thread calling resume() (the main thread). Coroutines
+ * due at the same point resume in a fixed order (spawn / wait order, then due time),
+ * so a replay with the same deltaTimes resumes them identically, except for job
+ * completions, whose order depends on the workers.
+ */
+class CoroutineScheduler {
+public:
+    /**
+     * @brief Awaitable returned by nextFrame().
+     */
+    struct NextFrameAwaiter {
+        CoroutineScheduler& scheduler; ///< Scheduler to resume from.
+        ResumePoint point;             ///< Point to resume at.
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler.m_waiting[static_cast<int>(point)].push_back(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Awaitable returned by delay().
+     */
+    struct DelayAwaiter {
+        CoroutineScheduler& scheduler; ///< Scheduler to resume from.
+        float seconds;                 ///< Time to wait.
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler.addTimer(seconds, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Awaitable returned by waitFor().
+     */
+    struct JobAwaiter {
+        CoroutineScheduler& scheduler; ///< Scheduler to resume from.
+        JobHandle job;                 ///< Job waited for.
+
+        bool await_ready() const noexcept { return !job || job->isDone(); }
+        void await_suspend(std::coroutine_handle<> handle) {
+            CoroutineScheduler* target = &scheduler;
+            job->onComplete([target, handle] { target->post(handle); });
+        }
+        void await_resume() const noexcept {}
+    };
+
+    CoroutineScheduler() = default;
+
+    /**
+     * @brief Destroys the coroutines that have not finished.
+     *
+     * Jobs awaited by those coroutines must be finished (their JobSystem destroyed)
+     * before the scheduler, since completing them posts to the scheduler.
+     */
+    ~CoroutineScheduler();
+
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    /**
+     * @brief Takes ownership of a coroutine and starts it at the next Update point.
+     */
+    void spawn(Task<> task);
+
+    /**
+     * @brief Advances the scheduler clock used by delay().
+     */
+    void advance(float deltaTime) { m_time += deltaTime; }
+
+    /**
+     * @brief Resumes the coroutines due at @p point.
+     *
+     * At Update this also resumes the expired delays and the finished jobs and assets.
+     */
+    void resume(ResumePoint point);
+
+    /**
+     * @brief Suspends until the next @p point.
+     */
+    NextFrameAwaiter nextFrame(ResumePoint point = ResumePoint::Update) { return { *this, point }; }
+
+    /**
+     * @brief Suspends for at least @p seconds of scheduler time (resumes at Update).
+     */
+    DelayAwaiter delay(float seconds) { return { *this, seconds }; }
+
+    /**
+     * @brief Suspends until @p job is done (resumes at Update).
+     */
+    JobAwaiter waitFor(JobHandle job) { return { *this, std::move(job) }; }
+
+    /**
+     * @brief Suspends until @p asset finished loading (resumes at Update).
+     */
+    template<typename T>
+    JobAwaiter waitFor(const AssetHandle<T>& asset) { return { *this, asset.getJob() }; }
+
+    /**
+     * @brief Schedules @p handle for the next Update point. Safe from any thread.
+     */
+    void post(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Returns the scheduler clock in seconds.
+     */
+    double getTime() const { return m_time; }
+
+    /**
+     * @brief Returns the number of spawned coroutines that have not finished.
+     */
+    size_t getLiveCount() const { return m_roots.count; }
+
+    /**
+     * @brief Returns the counters.
+     */
+    const CoroutineSchedulerStats& getStats() const { return m_stats; }
+
+private:
+    /**
+     * @brief Coroutine waiting in the delay heap.
+     */
+    struct Timer {
+        double due;                     ///< Scheduler time to resume at.
+        uint64_t sequence;              ///< Tie breaker: earlier delays resume first.
+        std::coroutine_handle<> handle; ///< Waiting coroutine.
+
+        bool operator>(const Timer& other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * @brief Adds @p handle to the delay heap.
+     */
+    void addTimer(float seconds, std::coroutine_handle<> handle);
+
+    /**
+     * @brief Resumes every handle of m_resuming, then clears it.
+     */
+    void resumeBatch();
+
+    TaskDetail::RootList m_roots;   ///< Spawned coroutines not yet finished.
+    std::vector<std::coroutine_handle<>> m_waiting[static_cast<int>(ResumePoint::Count)]; ///< nextFrame() waiters.
+    std::vector<std::coroutine_handle<>> m_resuming; ///< Batch being resumed.
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers; ///< delay() waiters.
+    uint64_t m_timerSequence = 0;   ///< Next Timer::sequence.
+    double m_time = 0.0;            ///< Sum of the advanced deltaTimes.
+
+    std::mutex m_postedMutex;                     ///< Guards m_posted.
+    std::vector<std::coroutine_handle<>> m_posted; ///< Handles posted by other threads.
+    std::atomic<bool> m_hasPosted{ false };       ///< Lets resume() skip the lock when nothing was posted.
+
+    CoroutineSchedulerStats m_stats; ///< Counters.
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+/**
+ * @file Task.h
+ * @brief Declares Task<T>, the coroutine type of the engine.
+ */
+
+#include "../Prerequisites.h"
+#include "Async/CoroutineFramePool.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template<typename T>
+class Task;
+
+namespace TaskDetail {
+    struct PromiseBase;
+
+    /**
+     * @brief Intrusive list of the detached coroutines owned by a scheduler.
+     */
+    struct RootList {
+        PromiseBase* head = nullptr; ///< First root, or nullptr.
+        size_t count = 0;            ///< Number of roots.
+
+        void link(PromiseBase* promise);
+        void unlink(PromiseBase* promise);
+    };
+
+    /**
+     * @brief Promise state shared by every Task<T>.
+     *
+     * Frames come from CoroutineFramePool. A Task starts suspended and runs when it is
+     * awaited or handed to a scheduler. When it finishes it resumes the coroutine that
+     * awaited it; a detached root (see CoroutineScheduler::spawn) destroys itself.
+     */
+    struct PromiseBase {
+        std::coroutine_handle<> continuation; ///< Coroutine awaiting this one.
+        std::coroutine_handle<> self;         ///< Own frame, set when detached.
+        RootList* roots = nullptr;            ///< Owner list when detached.
+        PromiseBase* previousRoot = nullptr;  ///< Links of the owner list.
+        PromiseBase* nextRoot = nullptr;      ///< Links of the owner list.
+
+        static void*
+        operator new(size_t size) {
+            return CoroutineFramePool::get().allocate(size);
+        }
+
+        static void
+        operator delete(void* frame, size_t size) {
+            CoroutineFramePool::get().deallocate(frame, size);
+        }
+
+        /**
+         * @brief Hands control to the awaiting coroutine, or frees a finished root.
+         */
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            template<typename Promise>
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                PromiseBase& promise = handle.promise();
+                if (promise.continuation) {
+                    return promise.continuation;
+                }
+                if (promise.roots != nullptr) {
+                    promise.roots->unlink(&promise);
+                    handle.destroy();
+                }
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        /**
+         * @brief The engine does not use exceptions: an escaping one is a bug.
+         */
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    inline void
+    RootList::link(PromiseBase* promise) {
+        promise->roots = this;
+        promise->previousRoot = nullptr;
+        promise->nextRoot = head;
+        if (head != nullptr) {
+            head->previousRoot = promise;
+        }
+        head = promise;
+        ++count;
+    }
+
+    inline void
+    RootList::unlink(PromiseBase* promise) {
+        if (promise->previousRoot != nullptr) {
+            promise->previousRoot->nextRoot = promise->nextRoot;
+        }
+        else {
+            head = promise->nextRoot;
+        }
+        if (promise->nextRoot != nullptr) {
+            promise->nextRoot->previousRoot = promise->previousRoot;
+        }
+        promise->roots = nullptr;
+        --count;
+    }
+
+    /**
+     * @brief Promise of a Task producing a T.
+     */
+    template<typename T>
+    struct Promise : PromiseBase {
+        std::optional<T> value; ///< Result, set by co_return.
+
+        Task<T> get_return_object();
+
+        template<typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    };
+
+    /**
+     * @brief Promise of a Task<void>.
+     */
+    template<>
+    struct Promise<void> : PromiseBase {
+        Task<void> get_return_object();
+
+        void return_void() const noexcept {}
+    };
+}
+
+/**
+ * @class Task
+ * @brief Lazily started coroutine returning a T, awaitable with co_await.
+ *
+ * A Task owns its frame: destroying an unfinished Task destroys the coroutine.
+ * `co_await task` starts it and suspends the caller until it finishes, without going
+ * through the scheduler (symmetric transfer). Top-level tasks are handed to a
+ * CoroutineScheduler, which owns them until they finish.
+ *
+ * Tasks are meant to be created and resumed on the main thread, where the scheduler
+ * runs; only completion notifications cross threads.
+ *
+ * @tparam T Result type (void for none).
+ */
+template<typename T = void>
+class Task {
+public:
+    using promise_type = TaskDetail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief Empty task.
+     */
+    Task() = default;
+
+    /**
+     * @brief Takes ownership of a coroutine frame (used by the promise).
+     */
+    explicit Task(Handle handle) : m_handle(handle) {}
+
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    Task&
+    operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @brief Destroys the coroutine if it is still owned.
+     */
+    ~Task() { reset(); }
+
+    /**
+     * @brief Returns true if the task holds a coroutine.
+     */
+    bool isValid() const { return static_cast<bool>(m_handle); }
+
+    /**
+     * @brief Returns true once the coroutine ran to completion.
+     */
+    bool isDone() const { return !m_handle || m_handle.done(); }
+
+    /**
+     * @brief Gives up ownership of the frame.
+     */
+    Handle release() { return std::exchange(m_handle, nullptr); }
+
+    bool await_ready() const noexcept { return isDone(); }
+
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+
+    T
+    await_resume() {
+        if constexpr (!std::is_void<T>::value) {
+            return std::move(*m_handle.promise().value);
+        }
+    }
+
+private:
+    void
+    reset() {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    Handle m_handle; ///< Owned coroutine frame.
+};
+
+template<typename T>
+Task<T>
+TaskDetail::Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void>
+TaskDetail::Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
@@ -9,6 +9,11 @@
 #include <Window.h>
 #include "CShape.h"  ///< Included to match the instructor's code
 #include "ECS/Actor.h"
+#include "ECS/ActorUpdater.h"
+#include "ECS/ActorNameIndex.h"
+#include "Events/EventBus.h"
+#include "Async/CoroutineScheduler.h"
+#include "Jobs/JobSystem.h"
 
  /**
   * @class BaseApp
@@ -59,8 +64,83 @@ public:
      */
     void destroy();
 
+    /**
+     * @brief Records the input and deltaTime of the next run() into @p path.
+     *
+     * Must be called before run().
+     */
+    void recordTo(const std::string& path) { m_recordPath = path; }
+
+    /**
+     * @brief Drives the next run() from a log written by recordTo().
+     *
+     * The log's deltaTimes replace the real frame times, so the simulation follows
+     * the recorded run exactly. A headless replay creates no window, does not wait
+     * for vsync and therefore runs as fast as the CPU allows.
+     *
+     * @param path Log to replay.
+     * @param headless If false the replay is also rendered (at the normal frame limit).
+     */
+    void replayFrom(const std::string& path, bool headless = true) {
+        m_replayPath = path;
+        m_replayHeadless = headless;
+    }
+
+    /**
+     * @brief Scheduler of the coroutines driven by the main loop.
+     *
+     * Spawned tasks are resumed at ResumePoint::Update (start of update(), after the
+     * frame's deltaTime is known) and ResumePoint::LateUpdate (before render()).
+     */
+    CoroutineScheduler& getScheduler() { return m_scheduler; }
+
+    /**
+     * @brief Worker pool for background jobs and asset loads.
+     */
+    JobSystem& getJobSystem() { return m_jobs; }
+
+    /**
+     * @brief Updater of the scene's actors.
+     *
+     * Parallel by default; run() switches it to ActorUpdateMode::Deterministic while
+     * recording or replaying.
+     */
+    ActorUpdater& getActorUpdater() { return m_actorUpdater; }
+
+    /**
+     * @brief Index of the scene's actors by name, e.g.
+     * `getActorNames().find(StringId("Circle Actor"))`.
+     */
+    const ActorNameIndex& getActorNames() const { return m_actorNames; }
+
+    /**
+     * @brief Event bus of the scene.
+     *
+     * Events published during a frame are dispatched once, after the actors updated
+     * and before ResumePoint::LateUpdate.
+     */
+    EventBus& getEvents() { return m_events; }
+
 private:
+    static constexpr double CompactionBudgetMicroseconds = 200.0; ///< Component storage compaction per frame.
+
     EngineUtilities::TSharedPointer<Window> m_windowPtr; ///< Pointer to the main window (Window class).
     EngineUtilities::TSharedPointer<CShape> m_shapePtr;  ///< Pointer to the shape component (CShape).
     EngineUtilities::TSharedPointer<Actor>  m_ACircle;   ///< Actor representing a circular shape.
+    ActorUpdater::ActorList m_actors;                    ///< Every actor updated each frame.
+    ActorNameIndex m_actorNames;                         ///< m_actors by name.
+    EventBus m_events;                                   ///< Events between components (outlives m_jobs).
+
+    std::vector<sf::Vector2f> m_waypoints; ///< Positions the actor follows.
+    int m_currentWaypointIndex = 0;        ///< Index of the current waypoint.
+
+    std::string m_recordPath;       ///< Log written by run(), empty if not recording.
+    std::string m_replayPath;       ///< Log replayed by run(), empty if live.
+    bool m_replayHeadless = true;   ///< Whether the replay creates a window.
+
+    // Declared in this order so the jobs finish (and post their completions) before
+    // the scheduler destroys the coroutines that may be waiting for them.
+    CoroutineScheduler m_scheduler; ///< Coroutines resumed by the main loop.
+    JobSystem m_jobs;               ///< Background workers.
+    ActorUpdater m_actorUpdater{ m_jobs }; ///< Updates m_actors on m_jobs.
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file AllocationCounter.h
+ * @brief Declares the heap allocation counter used by benchmarks.
+ */
+
+#include "Prerequisites.h"
+
+/**
+ * @class AllocationCounter
+ * @brief Counts calls to the global operator new while enabled.
+ *
+ * In builds that define RIOLU_COUNT_ALLOCATIONS (the Bench configuration) the
+ * global allocation operators are replaced in AllocationCounter.cpp. They forward
+ * to malloc/free and only bump the counters while a benchmark has enabled
+ * counting. Other builds keep the default allocator and count nothing, so
+ * benchmarks check Available before reporting allocations.
+ */
+class AllocationCounter {
+public:
+    /**
+     * @brief True if this build counts allocations.
+     */
+#ifdef RIOLU_COUNT_ALLOCATIONS
+    static constexpr bool Available = true;
+#else
+    static constexpr bool Available = false;
+#endif
+
+    /**
+     * @brief Turns counting on or off.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief Returns the number of allocations counted so far.
+     */
+    static uint64_t getAllocations();
+
+    /**
+     * @brief Returns the number of bytes requested by the counted allocations.
+     */
+    static uint64_t getBytes();
+};
+
+/**
+ * @class AllocationScope
+ * @brief Counts the allocations made during its lifetime.
+ */
+class AllocationScope {
+public:
+    AllocationScope()
+        : m_startAllocations(AllocationCounter::getAllocations()),
+          m_startBytes(AllocationCounter::getBytes()) {
+        AllocationCounter::setEnabled(true);
+    }
+
+    ~AllocationScope() {
+        AllocationCounter::setEnabled(false);
+    }
+
+    /**
+     * @brief Allocations made since the scope was opened.
+     */
+    uint64_t getAllocations() const { return AllocationCounter::getAllocations() - m_startAllocations; }
+
+    /**
+     * @brief Bytes allocated since the scope was opened.
+     */
+    uint64_t getBytes() const { return AllocationCounter::getBytes() - m_startBytes; }
+
+private:
+    uint64_t m_startAllocations; ///< Counter value when the scope opened.
+    uint64_t m_startBytes;       ///< Byte counter value when the scope opened.
+};
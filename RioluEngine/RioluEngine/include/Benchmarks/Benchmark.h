@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @file Benchmark.h
+ * @brief Declares the lightweight benchmark registry used by the engine's `--bench` mode.
+ */
+
+#include "Prerequisites.h"
+#include <chrono>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @class BenchmarkReport
+ * @brief Collects benchmark measurements and prints them as CSV lines.
+ *
+ * Every measurement is written as `benchmark,metric,value,unit` so results can be
+ * stored and compared across commits.
+ */
+class BenchmarkReport {
+public:
+    /**
+     * @brief Creates a report that writes to the given stream.
+     * @param output Stream that receives the CSV lines.
+     */
+    explicit BenchmarkReport(std::ostream& output);
+
+    /**
+     * @brief Sets the benchmark name used as the first column of every metric.
+     * @param name Name of the running benchmark.
+     */
+    void setBenchmark(const std::string& name);
+
+    /**
+     * @brief Writes a single measurement.
+     * @param metric Name of the measured quantity.
+     * @param value Measured value.
+     * @param unit Unit of the value (ns, us, ms, bytes, count...).
+     */
+    void metric(const std::string& metric, double value, const std::string& unit);
+
+private:
+    std::ostream& m_output;  ///< Destination of the CSV lines.
+    std::string m_benchmark; ///< Name of the running benchmark.
+};
+
+/**
+ * @brief Signature of a benchmark entry point.
+ */
+using BenchmarkFunction = void(*)(BenchmarkReport& report);
+
+/**
+ * @class BenchmarkRegistry
+ * @brief Global list of benchmarks, filled at static initialization by RIOLU_BENCHMARK.
+ */
+class BenchmarkRegistry {
+public:
+    /**
+     * @brief Registers a benchmark.
+     * @param name Unique benchmark name.
+     * @param function Entry point of the benchmark.
+     */
+    static void add(const char* name, BenchmarkFunction function);
+
+    /**
+     * @brief Runs every benchmark whose name contains one of the filters.
+     * @param filters Substrings to match; an empty list runs everything.
+     * @param output Stream that receives the CSV report.
+     * @return Number of benchmarks that were run.
+     */
+    static int run(const std::vector<std::string>& filters, std::ostream& output);
+
+    /**
+     * @brief Entry point for `RioluEngine --bench [filter...]`.
+     * @param argc Argument count received by main.
+     * @param argv Argument values received by main.
+     * @return Process exit code.
+     */
+    static int runFromCommandLine(int argc, char* argv[]);
+
+private:
+    /**
+     * @brief Registered benchmark.
+     */
+    struct Entry {
+        const char* name;           ///< Benchmark name.
+        BenchmarkFunction function; ///< Benchmark entry point.
+    };
+
+    /**
+     * @brief Returns the registered benchmarks (constructed on first use).
+     */
+    static std::vector<Entry>& entries();
+};
+
+/**
+ * @brief Helper whose constructor registers a benchmark.
+ */
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, BenchmarkFunction function) {
+        BenchmarkRegistry::add(name, function);
+    }
+};
+
+/**
+ * @brief Defines and registers a benchmark function.
+ *
+ * Usage: `RIOLU_BENCHMARK(MyBenchmark) { report.metric("time", 1.0, "ms"); }`
+ */
+#define RIOLU_BENCHMARK(name)                                                  \
+    static void name##_Benchmark(BenchmarkReport& report);                     \
+    static BenchmarkRegistrar name##_Registrar(#name, &name##_Benchmark);      \
+    static void name##_Benchmark(BenchmarkReport& report)
+
+/**
+ * @class BenchmarkTimer
+ * @brief High resolution stopwatch for benchmarks.
+ */
+class BenchmarkTimer {
+public:
+    BenchmarkTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Restarts the stopwatch.
+     */
+    void restart() { m_start = std::chrono::steady_clock::now(); }
+
+    /**
+     * @brief Returns the elapsed time in nanoseconds.
+     */
+    double elapsedNanoseconds() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    /**
+     * @brief Returns the elapsed time in microseconds.
+     */
+    double elapsedMicroseconds() const { return elapsedNanoseconds() / 1000.0; }
+
+    /**
+     * @brief Returns the elapsed time in milliseconds.
+     */
+    double elapsedMilliseconds() const { return elapsedNanoseconds() / 1000000.0; }
+
+private:
+    std::chrono::steady_clock::time_point m_start; ///< Time of the last restart.
+};
+
+/**
+ * @brief Prevents the optimizer from discarding a value computed by a benchmark.
+ * @param value Value to keep alive.
+ */
+template<typename T>
+inline void
+benchmarkKeep(const T& value) {
+    static const void* volatile sink;
+    sink = &value;
+    (void)sink;
+}
+
+/**
+ * @brief Compiler barrier: memory written before the call is treated as read after it.
+ *
+ * Stops the optimizer from merging or removing paired operations inside a timed loop
+ * (for example a reference count increment followed by a decrement).
+ */
+inline void
+benchmarkClobber() {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
@@ -23,7 +23,7 @@ public:
     /**
      * @brief Default constructor.
      */
-    CShape() = default;
+    CShape() : Component(ComponentType::SHAPE) {}
 
     /**
      * @brief Constructs a shape component with a specific shape type.
@@ -4,6 +4,7 @@
 #include "Entity.h"
 #include "CShape.h"
 #include "Transform.h"
+#include "Utilities/StringId.h"
 
 /**
  * @file Actor.h
@@ -24,10 +25,16 @@ public:
 
     /**
      * @brief Constructor that initializes the Actor with a name.
-     * @param actorName Name to assign to the actor.
+     * @param actorName Name to assign to the actor; interned in the StringTable.
      */
     Actor(const std::string& actorName);
 
+    /**
+     * @brief Constructor that initializes the Actor with an already interned name.
+     * @param actorName Name to assign to the actor.
+     */
+    Actor(StringId actorName);
+
     /**
      * @brief Default virtual destructor for Actor.
      */
@@ -40,10 +47,28 @@ public:
 
     /**
      * @brief Method called every frame to update the Actor's state.
+     *
+     * Updates every component in order, then copies the Transform into the shape.
+     * ActorUpdater performs the same steps split in passes over many actors.
      * @param deltaTime Time elapsed since last update.
      */
     void update(float deltaTime) override;
 
+    /**
+     * @brief Updates only the components whose isParallelUpdateSafe() equals @p parallelSafe.
+     * @param deltaTime Time elapsed since last update.
+     * @param parallelSafe Which kind of component to update.
+     * @return true if the actor also has components of the other kind.
+     */
+    bool updateComponents(float deltaTime, bool parallelSafe);
+
+    /**
+     * @brief Copies the Transform's position, rotation and scale into the CShape.
+     *
+     * Only touches this actor, so it is safe to run for several actors at once.
+     */
+    void syncShapeWithTransform();
+
     /**
      * @brief Renders the Actor to the provided window.
      * @param window Shared pointer reference to the window where the actor is rendered.
@@ -63,11 +88,21 @@ public:
     template <typename T>
     EngineUtilities::TSharedPointer<T> getComponent();
 
+    /**
+     * @brief Returns the name of the actor (text through StringId::c_str()).
+     */
+    StringId getName() const { return m_name; }
+
 private:
     /**
-     * @brief Name of the actor.
+     * @brief Name given to actors built without one, interned once.
+     */
+    static StringId defaultName();
+
+    /**
+     * @brief Name of the actor: 8 bytes, the text is shared through the StringTable.
      */
-    std::string m_name = "Actor";
+    StringId m_name = defaultName();
 };
 
 /**
@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file ActorNameIndex.h
+ * @brief Declares the hash index from actor names to actors.
+ */
+
+#include "../Prerequisites.h"
+#include "Utilities/StringId.h"
+
+class Actor;
+
+/**
+ * @class ActorNameIndex
+ * @brief Finds actors by StringId name in constant time.
+ *
+ * An open-addressing table (linear probing, kept at most half full) holds one slot
+ * per distinct name; the actors of a name are chained in a pool of entries. Adding
+ * and finding are O(1) even when thousands of actors share a name; removing walks
+ * the chain of that name. find() returns the most recently added actor of a name
+ * and forEach() visits all. The index does not own the actors; remove them before
+ * they are destroyed.
+ */
+class ActorNameIndex {
+public:
+    /**
+     * @brief Creates an index sized for @p expected actors.
+     */
+    explicit ActorNameIndex(size_t expected = 0);
+
+    /**
+     * @brief Indexes @p actor under @p name.
+     */
+    void add(StringId name, Actor* actor);
+
+    /**
+     * @brief Removes the entry of @p actor under @p name.
+     * @return false if it was not indexed.
+     */
+    bool remove(StringId name, const Actor* actor);
+
+    /**
+     * @brief Returns an actor called @p name, or nullptr.
+     */
+    Actor* find(StringId name) const;
+
+    /**
+     * @brief Calls @p function with every actor called @p name.
+     */
+    template<typename Function>
+    void
+    forEach(StringId name, Function&& function) const {
+        const size_t slot = probe(name.getHash());
+        for (uint32_t entry = m_slots[slot].head; entry != InvalidEntry; entry = m_entries[entry].next) {
+            function(m_entries[entry].actor);
+        }
+    }
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of indexed actors.
+     */
+    size_t size() const { return m_count; }
+
+    /**
+     * @brief Returns the number of distinct names.
+     */
+    size_t getNameCount() const { return m_names; }
+
+    /**
+     * @brief Returns the bytes held by the table and the entry pool.
+     */
+    size_t getByteSize() const { return m_slots.capacity() * sizeof(Slot) + m_entries.capacity() * sizeof(Entry); }
+
+private:
+    static constexpr uint32_t InvalidEntry = 0xFFFFFFFFu; ///< End of a chain.
+
+    /**
+     * @struct Slot
+     * @brief One distinct name; hash 0 marks a free slot (whose head is InvalidEntry).
+     */
+    struct Slot {
+        uint64_t hash; ///< Name hash.
+        uint32_t head; ///< First entry of the chain.
+    };
+
+    /**
+     * @struct Entry
+     * @brief One indexed actor.
+     */
+    struct Entry {
+        Actor* actor;  ///< Indexed actor (null when free).
+        uint32_t next; ///< Next entry with the same name, or next free entry.
+    };
+
+    /**
+     * @brief First slot probed for @p hash (Fibonacci hashing).
+     */
+    size_t
+    home(uint64_t hash) const {
+        return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+    }
+
+    /**
+     * @brief Returns the slot of @p hash, or the free slot where it belongs.
+     */
+    size_t
+    probe(uint64_t hash) const {
+        size_t slot = home(hash);
+        while (m_slots[slot].hash != 0 && m_slots[slot].hash != hash) {
+            slot = (slot + 1) & m_mask;
+        }
+        return slot;
+    }
+
+    /**
+     * @brief Rebuilds the table with @p slots slots (a power of two).
+     */
+    void rehash(size_t slots);
+
+    /**
+     * @brief Frees slot @p slot, shifting the rest of its cluster back.
+     */
+    void eraseSlot(size_t slot);
+
+    std::vector<Slot> m_slots;           ///< Open-addressing table of names.
+    std::vector<Entry> m_entries;        ///< Chained actors.
+    uint32_t m_freeEntry = InvalidEntry; ///< Head of the free entry list.
+    size_t m_mask = 0;                   ///< Slot count - 1.
+    size_t m_names = 0;                  ///< Used slots.
+    size_t m_count = 0;                  ///< Indexed actors.
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file ActorUpdater.h
+ * @brief Declares the system that updates many actors across the job system.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/Actor.h"
+#include "Jobs/JobSystem.h"
+
+/**
+ * @enum ActorUpdateMode
+ * @brief How ActorUpdater runs the actors of a frame.
+ */
+enum class ActorUpdateMode {
+    Parallel,     ///< Thread-safe components on every worker, the rest on the calling thread.
+    Deterministic ///< Actor::update for each actor, in list order, on the calling thread.
+};
+
+/**
+ * @class ActorUpdater
+ * @brief Updates a list of actors, splitting the work across a JobSystem.
+ *
+ * In Parallel mode the list is cut into chunks that the workers and the calling
+ * thread take in turn. For each actor the chunk updates the components that report
+ * isParallelUpdateSafe() and copies the Transform into the shape. Actors that also
+ * own serial components are set aside and finished afterwards on the calling thread,
+ * in list order: serial components, then the Transform copy.
+ *
+ * With correctly flagged components both modes produce the same state. Deterministic
+ * mode does not rely on the flags at all and is used while recording and replaying,
+ * so a replay cannot diverge because of a component that wrongly claims to be safe,
+ * whatever the core count of the machine playing it back.
+ */
+class ActorUpdater {
+public:
+    /**
+     * @brief Actor list as kept by the application.
+     */
+    using ActorList = std::vector<EngineUtilities::TSharedPointer<Actor>>;
+
+    /**
+     * @brief Creates an updater using @p jobs for the parallel passes.
+     */
+    explicit ActorUpdater(JobSystem& jobs) : m_jobs(jobs) {}
+
+    /**
+     * @brief Updates every non-null actor of @p actors.
+     * @param actors Actors to update; the list must not change during the call.
+     * @param deltaTime Time elapsed since last update.
+     */
+    void update(ActorList& actors, float deltaTime);
+
+    /**
+     * @brief Selects parallel or deterministic updates.
+     */
+    void setMode(ActorUpdateMode mode) { m_mode = mode; }
+
+    /**
+     * @brief Returns the current mode.
+     */
+    ActorUpdateMode getMode() const { return m_mode; }
+
+    /**
+     * @brief Sets the number of actors per chunk; 0 picks it from the worker count.
+     */
+    void setGrainSize(size_t grain) { m_grain = grain; }
+
+    /**
+     * @brief Returns the number of actors finished on the calling thread by the last
+     * parallel update because they own serial components.
+     */
+    size_t getSerialActorCount() const { return m_serialActorCount; }
+
+private:
+    /**
+     * @brief Smallest automatic chunk, so dispatch cost stays small next to the work.
+     */
+    static constexpr size_t MinimumGrain = 256;
+
+    JobSystem& m_jobs;                                 ///< Pool running the chunks.
+    ActorUpdateMode m_mode = ActorUpdateMode::Parallel; ///< Current mode.
+    size_t m_grain = 0;                                ///< Actors per chunk, 0 = automatic.
+    std::vector<std::vector<uint32_t>> m_serialActors; ///< Per chunk, actors with serial components.
+    size_t m_serialActorCount = 0;                     ///< Sum of m_serialActors sizes.
+};
@@ -72,6 +72,17 @@ public:
 	 */
 	virtual void destroy() = 0;
 
+	/**
+	 * @brief Tells whether update() may run on a worker thread.
+	 *
+	 * ActorUpdater updates the safe components of different actors concurrently, so a
+	 * safe component may only touch its own actor. Components that read or write other
+	 * actors or global systems return false and are updated on the main thread after
+	 * the parallel pass, in actor order.
+	 * @return true by default.
+	 */
+	virtual bool isParallelUpdateSafe() const { return true; }
+
 	/**
 	 * @brief Gets the type of the component.
 	 * @return The component type (enum value).
@@ -79,5 +90,5 @@ public:
 	ComponentType getType() const { return m_type; }
 
 protected:
-	ComponentType m_type; ///< The specific type of the component.
+	ComponentType m_type = None; ///< The specific type of the component.
 };
\ No newline at end of file
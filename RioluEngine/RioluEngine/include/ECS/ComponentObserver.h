@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file ComponentObserver.h
+ * @brief Declares the observers that collect component add/remove events per ComponentType.
+ */
+
+#include "../Prerequisites.h"
+#include "Component.h"
+
+class Entity;
+
+/**
+ * @enum ComponentChange
+ * @brief Structural change of an entity.
+ */
+enum class ComponentChange : uint8_t {
+    Added,  ///< The entity gained the component.
+    Removed ///< The entity lost the component (removed, or the entity was destroyed).
+};
+
+/**
+ * @struct ComponentChangeRecord
+ * @brief One structural change, in the order it happened.
+ *
+ * For Removed records the entity and the component may already be destroyed when
+ * the record is read: use the pointers as keys only.
+ */
+struct ComponentChangeRecord {
+    Entity* entity;         ///< Entity that changed.
+    Component* component;   ///< Component added or removed.
+    ComponentChange change; ///< Kind of change.
+};
+
+/**
+ * @class ComponentObserver
+ * @brief Change list of one ComponentType, owned by a system that consumes it once per frame.
+ *
+ * While an observer exists, every Entity::addComponent(), Entity::removeComponent()
+ * and entity destruction involving a component of its type appends a record to it,
+ * so systems that track "every entity with a CShape" update their sets from the
+ * changes instead of rescanning every entity. Each observer has its own list, so
+ * several systems can watch the same type. An add followed by a remove in the same
+ * frame yields both records, in order.
+ *
+ * Records are appended on the thread that changes the entity: add and remove
+ * components on the main thread (or while no observer of that type is consumed).
+ */
+class ComponentObserver {
+public:
+    /**
+     * @brief Starts recording the changes of components of @p type.
+     */
+    explicit ComponentObserver(ComponentType type);
+
+    /**
+     * @brief Stops recording.
+     */
+    ~ComponentObserver();
+
+    ComponentObserver(const ComponentObserver&) = delete;
+    ComponentObserver& operator=(const ComponentObserver&) = delete;
+
+    /**
+     * @brief Returns the observed type.
+     */
+    ComponentType getType() const { return m_type; }
+
+    /**
+     * @brief Returns the changes recorded since the last consume().
+     */
+    const std::vector<ComponentChangeRecord>& getChanges() const { return m_changes; }
+
+    /**
+     * @brief Calls @p function with every recorded change, in order, then clears the list.
+     */
+    template<typename Function>
+    void
+    consume(Function&& function) {
+        for (const ComponentChangeRecord& record : m_changes) {
+            function(record);
+        }
+        m_changes.clear();
+    }
+
+private:
+    friend class ComponentObserverRegistry;
+
+    ComponentType m_type;                        ///< Observed type.
+    std::vector<ComponentChangeRecord> m_changes; ///< Changes not consumed yet.
+};
+
+/**
+ * @class ComponentObserverRegistry
+ * @brief Observers per ComponentType; Entity reports its structural changes here.
+ */
+class ComponentObserverRegistry {
+public:
+    /**
+     * @brief Number of ComponentType values that can be observed.
+     */
+    static constexpr size_t TypeCount = 16;
+
+    /**
+     * @brief Returns the observers of @p type.
+     */
+    static std::vector<ComponentObserver*>& getObservers(ComponentType type);
+
+    /**
+     * @brief Appends a change to the observers of the component's type.
+     *
+     * Only looks the type up when nobody observes it.
+     */
+    static void record(Entity* entity, Component* component, ComponentChange change);
+};
@@ -0,0 +1,422 @@
+#pragma once
+
+/**
+ * @file ComponentStorage.h
+ * @brief Declares dense, handle-addressed storage for plain component data.
+ */
+
+#include "../Prerequisites.h"
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+
+/**
+ * @struct ComponentHandle
+ * @brief Index of a component's data inside its storage.
+ *
+ * The storage keeps a pointer to every live handle, so it can rewrite the index
+ * when compaction moves the data.
+ */
+struct ComponentHandle {
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = InvalidIndex; ///< Slot in the storage.
+    uint32_t generation = 0;       ///< Generation of the slot when the handle was issued.
+
+    /**
+     * @brief Returns true if the handle refers to a slot.
+     */
+    bool isValid() const { return index != InvalidIndex; }
+};
+
+/**
+ * @struct StorageFragmentation
+ * @brief How sparse a storage is, counted per dirty-tracking page ("chunk").
+ */
+struct StorageFragmentation {
+    size_t liveSlots = 0;        ///< Slots holding a component.
+    size_t totalSlots = 0;       ///< Slots iterated by passes over the storage.
+    size_t chunks = 0;           ///< Pages spanned by the slots.
+    size_t fragmentedChunks = 0; ///< Pages with at least one free slot.
+    size_t holes = 0;            ///< Free slots.
+    size_t maxChunkHoles = 0;    ///< Free slots of the emptiest page.
+
+    /**
+     * @brief Returns live / total slots (1 when empty).
+     */
+    double getLiveRatio() const { return totalSlots > 0 ? static_cast<double>(liveSlots) / totalSlots : 1.0; }
+
+    /**
+     * @brief Returns the average number of free slots per page.
+     */
+    double getHolesPerChunk() const { return chunks > 0 ? static_cast<double>(holes) / chunks : 0.0; }
+};
+
+/**
+ * @class IComponentStorage
+ * @brief Type-erased view of a component storage, used by world-wide operations.
+ *
+ * The raw bytes of a storage are split in fixed pages. Every write goes through
+ * markDirty(), which stamps the touched pages with the current epoch. Snapshots
+ * compare those stamps with the epoch at which they were taken to know which pages
+ * changed since.
+ */
+class IComponentStorage {
+public:
+    /**
+     * @brief Size of a dirty-tracking page in bytes.
+     */
+    static constexpr size_t PageSize = 4096;
+
+    /**
+     * @brief Registers the storage in the ComponentStorageRegistry.
+     * @param name Human readable name (for reports).
+     */
+    explicit IComponentStorage(const char* name);
+
+    /**
+     * @brief Unregisters the storage.
+     */
+    virtual ~IComponentStorage();
+
+    IComponentStorage(const IComponentStorage&) = delete;
+    IComponentStorage& operator=(const IComponentStorage&) = delete;
+
+    /**
+     * @brief Returns the storage name.
+     */
+    const char* getName() const { return m_name; }
+
+    /**
+     * @brief Returns the raw bytes of every slot, live or not.
+     */
+    virtual sf::Uint8* getBytes() = 0;
+
+    /**
+     * @brief Returns the size of getBytes() in bytes.
+     */
+    virtual size_t getByteSize() const = 0;
+
+    /**
+     * @brief Returns the number of slots (live and free).
+     */
+    virtual size_t getSlotCount() const = 0;
+
+    /**
+     * @brief Returns the number of live slots.
+     */
+    virtual size_t getLiveCount() const = 0;
+
+    /**
+     * @brief Moves live slots into holes until the storage is dense or @p deadline passes.
+     * @return Number of components moved.
+     */
+    virtual size_t compact(const std::chrono::steady_clock::time_point& deadline) = 0;
+
+    /**
+     * @brief Counts live slots and holes per page (walks every slot).
+     */
+    virtual StorageFragmentation getFragmentation() const = 0;
+
+    /**
+     * @brief Returns the number of dirty-tracking pages.
+     */
+    size_t getPageCount() const { return m_pageStamps.size(); }
+
+    /**
+     * @brief Returns the epoch of the last write to a page.
+     * @param page Page index.
+     */
+    uint32_t getPageStamp(size_t page) const { return m_pageStamps[page]; }
+
+    /**
+     * @brief Marks a page as written in the current epoch.
+     * @param page Page index.
+     */
+    void stampPage(size_t page);
+
+protected:
+    /**
+     * @brief Stamps the pages covering a byte range with the current epoch.
+     *
+     * Safe to call from several threads at once (for different slots).
+     * @param offset First byte written.
+     * @param size Number of bytes written.
+     */
+    void markDirty(size_t offset, size_t size);
+
+    /**
+     * @brief Grows or shrinks the page table after the byte size changed.
+     *
+     * New pages are stamped with the current epoch.
+     */
+    void resizePages();
+
+private:
+    const char* m_name;                 ///< Storage name.
+    std::vector<uint32_t> m_pageStamps; ///< Epoch of the last write per page.
+};
+
+/**
+ * @class ComponentStorageRegistry
+ * @brief Global list of component storages plus the epoch and structure counters.
+ *
+ * The epoch advances on every snapshot save. The structure version changes every
+ * time a slot is created, destroyed or moved, so snapshots can tell whether the
+ * set of live components is still the one they captured.
+ */
+class ComponentStorageRegistry {
+public:
+    /**
+     * @brief Returns every registered storage.
+     */
+    static std::vector<IComponentStorage*>& getStorages();
+
+    /**
+     * @brief Returns the current epoch.
+     */
+    static uint32_t getEpoch() { return s_epoch; }
+
+    /**
+     * @brief Starts a new epoch and returns the one that just ended.
+     */
+    static uint32_t advanceEpoch() { return s_epoch++; }
+
+    /**
+     * @brief Returns the structure version.
+     */
+    static uint64_t getStructureVersion() { return s_structureVersion; }
+
+    /**
+     * @brief Records a structural change (slot created, destroyed or moved).
+     */
+    static void bumpStructureVersion() { ++s_structureVersion; }
+
+    /**
+     * @brief Hashes (FNV-1a) the bytes of every storage.
+     *
+     * Two runs that end with the same component data produce the same hash, which is
+     * how a replay checks that it reproduced the recorded run.
+     */
+    static uint64_t hashState();
+
+    /**
+     * @brief Compacts the storages in turn for at most @p budgetMicroseconds.
+     *
+     * Call it between frames, when no reference into a storage is held. Compaction
+     * order depends on timing, so runs that must be reproduced (recording, replays)
+     * should not call it.
+     * @return Number of components moved.
+     */
+    static size_t compact(double budgetMicroseconds);
+
+private:
+    static uint32_t s_epoch;            ///< Current epoch, starts at 1.
+    static uint64_t s_structureVersion; ///< Structural change counter.
+};
+
+/**
+ * @class TComponentStorage
+ * @brief Dense array of plain component data addressed through ComponentHandle.
+ *
+ * T must be trivially copyable so the whole array can be saved and restored with
+ * memcpy. Slots of destroyed components are reused by later creations.
+ * References returned by get()/edit()/editAll() are invalidated by create() and compact().
+ *
+ * After a despawn wave the array stays as long as its peak and passes over it
+ * walk the holes. compact() drops free slots off the end and moves the last live
+ * slot into a hole taken from the free list, patching the owner handle of every
+ * moved component, until the storage is dense or its time budget runs out. Work
+ * is proportional to the holes, not the storage size, so it can run every frame.
+ *
+ * @tparam T Plain data type of the component.
+ */
+template<typename T>
+class TComponentStorage : public IComponentStorage {
+    static_assert(std::is_trivially_copyable<T>::value, "Component data must be trivially copyable");
+
+public:
+    /**
+     * @brief Creates an empty storage.
+     * @param name Storage name for reports.
+     */
+    explicit TComponentStorage(const char* name) : IComponentStorage(name) {}
+
+    /**
+     * @brief Allocates a slot for a component.
+     * @param owner Handle inside the owning component; it receives the slot index.
+     * @param value Initial data.
+     */
+    void create(ComponentHandle* owner, const T& value) {
+        // Compaction fills and drops slots without editing the free list; skip those.
+        uint32_t index = ComponentHandle::InvalidIndex;
+        while (!m_freeSlots.empty() && index == ComponentHandle::InvalidIndex) {
+            const uint32_t free = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            if (free < m_data.size() && m_owners[free] == nullptr) {
+                index = free;
+            }
+        }
+        if (index != ComponentHandle::InvalidIndex) {
+            m_data[index] = value;
+        }
+        else {
+            index = static_cast<uint32_t>(m_data.size());
+            m_data.push_back(value);
+            m_owners.push_back(nullptr);
+            // Generations of dropped slots are kept so their stale handles stay dead.
+            if (m_generations.size() < m_data.size()) {
+                m_generations.push_back(0);
+            }
+            resizePages();
+        }
+
+        m_owners[index] = owner;
+        ++m_liveCount;
+        owner->index = index;
+        owner->generation = m_generations[index];
+        markDirty(static_cast<size_t>(index) * sizeof(T), sizeof(T));
+        ComponentStorageRegistry::bumpStructureVersion();
+    }
+
+    /**
+     * @brief Frees the slot of a component and invalidates its handle.
+     * @param handle Handle of the component.
+     */
+    void destroy(ComponentHandle& handle) {
+        if (!isAlive(handle)) {
+            return;
+        }
+        m_owners[handle.index] = nullptr;
+        ++m_generations[handle.index];
+        m_freeSlots.push_back(handle.index);
+        --m_liveCount;
+        handle.index = ComponentHandle::InvalidIndex;
+        ComponentStorageRegistry::bumpStructureVersion();
+    }
+
+    /**
+     * @brief Returns true if the handle refers to a live slot of this storage.
+     */
+    bool isAlive(const ComponentHandle& handle) const {
+        return handle.index < m_data.size() &&
+               m_owners[handle.index] != nullptr &&
+               m_generations[handle.index] == handle.generation;
+    }
+
+    /**
+     * @brief Read-only access to component data.
+     */
+    const T& get(const ComponentHandle& handle) const { return m_data[handle.index]; }
+
+    /**
+     * @brief Writable access to component data; marks its page dirty.
+     *
+     * Different handles may be edited from different threads at the same time.
+     */
+    T& edit(const ComponentHandle& handle) {
+        markDirty(static_cast<size_t>(handle.index) * sizeof(T), sizeof(T));
+        return m_data[handle.index];
+    }
+
+    /**
+     * @brief Writable access to every slot, free ones included, for passes over the
+     * whole storage; marks every page dirty.
+     *
+     * Free slots hold stale data, so T needs a way to tell them apart.
+     */
+    T* editAll() {
+        if (!m_data.empty()) {
+            markDirty(0, m_data.size() * sizeof(T));
+        }
+        return m_data.data();
+    }
+
+    sf::Uint8* getBytes() override { return reinterpret_cast<sf::Uint8*>(m_data.data()); }
+    size_t getByteSize() const override { return m_data.size() * sizeof(T); }
+    size_t getSlotCount() const override { return m_data.size(); }
+    size_t getLiveCount() const override { return m_liveCount; }
+
+    size_t
+    compact(const std::chrono::steady_clock::time_point& deadline) override {
+        const size_t oldSize = m_data.size();
+        size_t moved = 0;
+        size_t steps = 0;
+        for (;; ++steps) {
+            if (m_liveCount == m_data.size() || m_freeSlots.empty()) {
+                // Dense; whatever is left in the free list is stale.
+                m_freeSlots.clear();
+                break;
+            }
+            // Reading the clock costs about as much as a few moves.
+            if (steps >= CompactionClockStride) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                steps = 0;
+            }
+            if (m_owners.back() == nullptr) {
+                m_data.pop_back();
+                m_owners.pop_back();
+                continue;
+            }
+
+            // Every hole is in the free list; entries dropped with the tail or refilled are skipped.
+            const uint32_t hole = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            if (hole >= m_data.size() || m_owners[hole] != nullptr) {
+                continue;
+            }
+            const uint32_t last = static_cast<uint32_t>(m_data.size() - 1);
+            ComponentHandle* owner = m_owners[last];
+            m_data[hole] = m_data[last];
+            m_owners[hole] = owner;
+            owner->index = hole;
+            owner->generation = m_generations[hole];
+            // The vacated slot is never in the free list; drop it now or it would be
+            // left behind, unreachable, once the free list runs out.
+            ++m_generations[last];
+            m_data.pop_back();
+            m_owners.pop_back();
+            markDirty(static_cast<size_t>(hole) * sizeof(T), sizeof(T));
+            ++moved;
+        }
+
+        if (m_data.size() != oldSize) {
+            resizePages();
+        }
+        if (moved > 0 || m_data.size() != oldSize) {
+            ComponentStorageRegistry::bumpStructureVersion();
+        }
+        return moved;
+    }
+
+    StorageFragmentation
+    getFragmentation() const override {
+        StorageFragmentation fragmentation;
+        const size_t slotsPerChunk = std::max<size_t>(1, PageSize / sizeof(T));
+        fragmentation.totalSlots = m_owners.size();
+        fragmentation.liveSlots = m_liveCount;
+        for (size_t begin = 0; begin < m_owners.size(); begin += slotsPerChunk) {
+            const size_t end = std::min(m_owners.size(), begin + slotsPerChunk);
+            size_t holes = 0;
+            for (size_t i = begin; i < end; ++i) {
+                holes += m_owners[i] == nullptr ? 1 : 0;
+            }
+            ++fragmentation.chunks;
+            fragmentation.fragmentedChunks += holes > 0 ? 1 : 0;
+            fragmentation.holes += holes;
+            fragmentation.maxChunkHoles = std::max(fragmentation.maxChunkHoles, holes);
+        }
+        return fragmentation;
+    }
+
+private:
+    static constexpr size_t CompactionClockStride = 64; ///< Steps between deadline checks.
+
+    std::vector<T> m_data;                 ///< Component data, one entry per slot.
+    std::vector<ComponentHandle*> m_owners; ///< Handle owning each slot, nullptr when free.
+    std::vector<uint32_t> m_generations;   ///< Generation of each slot, dropped slots included.
+    std::vector<uint32_t> m_freeSlots;     ///< Free slots, reused first (may hold stale entries).
+    size_t m_liveCount = 0;                ///< Live slots.
+};
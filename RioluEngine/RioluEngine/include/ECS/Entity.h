@@ -1,6 +1,7 @@
 #pragma once
 #include "../Prerequisites.h"
 #include "Component.h"
+#include "ComponentObserver.h"
 
 class Window;
 
@@ -12,7 +13,14 @@ class Window;
  */
 class Entity {
 public:
-    virtual ~Entity() = default;
+    /**
+     * @brief Reports the loss of every component to the ComponentObservers.
+     */
+    virtual ~Entity() {
+        for (auto& component : components) {
+            ComponentObserverRegistry::record(this, component.get(), ComponentChange::Removed);
+        }
+    }
 
     /**
      * @brief Initialize the entity.
@@ -45,6 +53,24 @@ public:
     void addComponent(EngineUtilities::TSharedPointer<T> component) {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
         components.push_back(component.template dynamic_pointer_cast<Component>());
+        ComponentObserverRegistry::record(this, components.back().get(), ComponentChange::Added);
+    }
+
+    /**
+     * @brief Remove the first component of the specified type.
+     * @tparam T Component type to remove.
+     * @return true if the entity had one.
+     */
+    template<typename T>
+    bool removeComponent() {
+        for (size_t i = 0; i < components.size(); ++i) {
+            if (dynamic_cast<T*>(components[i].get()) != nullptr) {
+                ComponentObserverRegistry::record(this, components[i].get(), ComponentChange::Removed);
+                components.erase(components.begin() + i);
+                return true;
+            }
+        }
+        return false;
     }
 
     /**
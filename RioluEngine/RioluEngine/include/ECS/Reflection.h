@@ -0,0 +1,267 @@
+#pragma once
+
+/**
+ * @file Reflection.h
+ * @brief Declares compile-time descriptions of component data fields.
+ */
+
+#include "../Prerequisites.h"
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @enum FieldType
+ * @brief Value types a reflected field may have.
+ */
+enum class FieldType : uint8_t {
+    Bool,     ///< bool, one bit on the wire.
+    UInt8,    ///< uint8_t.
+    UInt16,   ///< uint16_t.
+    UInt32,   ///< uint32_t.
+    Int32,    ///< int32_t.
+    Float,    ///< float.
+    Vector2f, ///< sf::Vector2f, two floats.
+    Color     ///< sf::Color, four bytes.
+};
+
+/**
+ * @enum FieldFlags
+ * @brief What a field takes part in. Tools select fields with a mask of these.
+ */
+enum FieldFlags : uint32_t {
+    FieldNone = 0,             ///< Described only.
+    FieldSaved = 1u << 0,      ///< Written to save files.
+    FieldReplicated = 1u << 1, ///< Sent to clients.
+    FieldEditable = 1u << 2,   ///< Shown in editors.
+    FieldScripted = 1u << 3,   ///< Readable and writable from scripts.
+    FieldQuantized = 1u << 4   ///< Floats are sent quantized to [min, max] with `bits` bits.
+};
+
+/**
+ * @struct FieldTraits
+ * @brief Maps a C++ type to its FieldType and its unquantized size in bits.
+ */
+template<typename T>
+struct FieldTraits;
+
+template<> struct FieldTraits<bool> { static constexpr FieldType type = FieldType::Bool; static constexpr uint32_t bits = 1; };
+template<> struct FieldTraits<uint8_t> { static constexpr FieldType type = FieldType::UInt8; static constexpr uint32_t bits = 8; };
+template<> struct FieldTraits<uint16_t> { static constexpr FieldType type = FieldType::UInt16; static constexpr uint32_t bits = 16; };
+template<> struct FieldTraits<uint32_t> { static constexpr FieldType type = FieldType::UInt32; static constexpr uint32_t bits = 32; };
+template<> struct FieldTraits<int32_t> { static constexpr FieldType type = FieldType::Int32; static constexpr uint32_t bits = 32; };
+template<> struct FieldTraits<float> { static constexpr FieldType type = FieldType::Float; static constexpr uint32_t bits = 32; };
+template<> struct FieldTraits<sf::Vector2f> { static constexpr FieldType type = FieldType::Vector2f; static constexpr uint32_t bits = 64; };
+template<> struct FieldTraits<sf::Color> { static constexpr FieldType type = FieldType::Color; static constexpr uint32_t bits = 32; };
+
+/**
+ * @struct Field
+ * @brief Compile-time description of one field of @p Owner.
+ *
+ * Holds a member pointer, so generated code reads the field directly; the name is
+ * only for tools.
+ */
+template<typename Owner, typename Value>
+struct Field {
+    using OwnerType = Owner; ///< Reflected type.
+    using ValueType = Value; ///< Field type.
+    static constexpr FieldType type = FieldTraits<Value>::type; ///< Field type tag.
+
+    const char* name;        ///< Member name.
+    Value Owner::* member;   ///< Member pointer.
+    uint32_t offset;         ///< Byte offset in Owner.
+    uint32_t flags;          ///< FieldFlags.
+    float min = 0.f;         ///< Quantization range (FieldQuantized).
+    float max = 0.f;         ///< Quantization range (FieldQuantized).
+    uint8_t bits = 0;        ///< Bits per float when quantized.
+
+    /**
+     * @brief Returns the field inside @p owner.
+     */
+    constexpr const Value& get(const Owner& owner) const { return owner.*member; }
+    constexpr Value& get(Owner& owner) const { return owner.*member; }
+
+    /**
+     * @brief Bits the field takes when serialized (per float component when quantized).
+     */
+    constexpr uint32_t
+    serializedBits() const {
+        if ((flags & FieldQuantized) != 0) {
+            return type == FieldType::Vector2f ? 2u * bits : bits;
+        }
+        return FieldTraits<Value>::bits;
+    }
+};
+
+/**
+ * @struct NestedField
+ * @brief Compile-time description of a member of a member of @p Owner, such as the
+ * angle in TransformData::rotation.x.
+ *
+ * Lets a tool select part of a member: the rest of the member is not written. Has
+ * the same interface as Field.
+ */
+template<typename Owner, typename Member, typename Value>
+struct NestedField {
+    using OwnerType = Owner; ///< Reflected type.
+    using ValueType = Value; ///< Field type.
+    static constexpr FieldType type = FieldTraits<Value>::type; ///< Field type tag.
+
+    const char* name;        ///< "member.inner".
+    Member Owner::* member;  ///< Member holding the field.
+    Value Member::* inner;   ///< Field inside the member.
+    uint32_t offset;         ///< Byte offset in Owner.
+    uint32_t flags;          ///< FieldFlags.
+    float min = 0.f;         ///< Quantization range (FieldQuantized).
+    float max = 0.f;         ///< Quantization range (FieldQuantized).
+    uint8_t bits = 0;        ///< Bits per float when quantized.
+
+    /**
+     * @brief Returns the field inside @p owner.
+     */
+    constexpr const Value& get(const Owner& owner) const { return (owner.*member).*inner; }
+    constexpr Value& get(Owner& owner) const { return (owner.*member).*inner; }
+
+    /**
+     * @brief Bits the field takes when serialized.
+     */
+    constexpr uint32_t
+    serializedBits() const {
+        return (flags & FieldQuantized) != 0 ? bits : FieldTraits<Value>::bits;
+    }
+};
+
+/**
+ * @brief Builds a Field; used by RIOLU_FIELD.
+ */
+template<typename Owner, typename Value>
+constexpr Field<Owner, Value>
+makeField(const char* name, Value Owner::* member, size_t offset, uint32_t flags,
+          float min = 0.f, float max = 0.f, uint8_t bits = 0) {
+    return Field<Owner, Value>{ name, member, static_cast<uint32_t>(offset), flags, min, max, bits };
+}
+
+/**
+ * @brief Builds a NestedField; used by RIOLU_NESTED_FIELD.
+ */
+template<typename Owner, typename Member, typename Value>
+constexpr NestedField<Owner, Member, Value>
+makeNestedField(const char* name, Member Owner::* member, Value Member::* inner, size_t offset, uint32_t flags) {
+    return NestedField<Owner, Member, Value>{ name, member, inner, static_cast<uint32_t>(offset), flags };
+}
+
+/**
+ * @brief Describes `Owner::member` with FieldFlags @p flags.
+ */
+#define RIOLU_FIELD(Owner, member, flags) \
+    makeField(#member, &Owner::member, offsetof(Owner, member), (flags))
+
+/**
+ * @brief Describes a float or Vector2f member sent quantized to [min, max] with @p bits bits.
+ */
+#define RIOLU_QUANTIZED_FIELD(Owner, member, flags, min, max, bits) \
+    makeField(#member, &Owner::member, offsetof(Owner, member), (flags) | FieldQuantized, (min), (max), (bits))
+
+/**
+ * @brief Describes `Owner::member.inner` alone, e.g. one component of a vector.
+ */
+#define RIOLU_NESTED_FIELD(Owner, member, inner, flags) \
+    makeNestedField(#member "." #inner, &Owner::member, &decltype(Owner::member)::inner, \
+                    offsetof(Owner, member) + offsetof(decltype(Owner::member), inner), (flags))
+
+/**
+ * @struct Reflect
+ * @brief Specialize for a component data type, next to its declaration:
+ *
+ *     template<> struct Reflect<TransformData> {
+ *         static constexpr const char* name = "Transform";
+ *         static constexpr auto fields = std::make_tuple(
+ *             RIOLU_FIELD(TransformData, position, FieldSaved | FieldReplicated), ...);
+ *     };
+ */
+template<typename T>
+struct Reflect;
+
+/**
+ * @brief Types with a Reflect specialization.
+ */
+template<typename T>
+concept Reflected = requires {
+    { Reflect<T>::name } -> std::convertible_to<const char*>;
+    std::tuple_size<std::remove_cv_t<decltype(Reflect<T>::fields)>>::value;
+};
+
+/**
+ * @brief Number of reflected fields of @p T.
+ */
+template<Reflected T>
+constexpr size_t FieldCount = std::tuple_size_v<std::remove_cv_t<decltype(Reflect<T>::fields)>>;
+
+/**
+ * @brief Calls @p function with every field description of @p T, in declaration order.
+ */
+template<Reflected T, typename Function>
+constexpr void
+forEachField(Function&& function) {
+    std::apply([&function](const auto&... field) { (function(field), ...); }, Reflect<T>::fields);
+}
+
+/**
+ * @brief Bits taken by the fields of @p T whose flags match @p mask.
+ */
+template<Reflected T>
+constexpr uint32_t
+serializedBits(uint32_t mask) {
+    uint32_t bits = 0;
+    forEachField<T>([&bits, mask](const auto& field) {
+        if ((field.flags & mask) != 0) {
+            bits += field.serializedBits();
+        }
+    });
+    return bits;
+}
+
+/**
+ * @struct FieldInfo
+ * @brief Type-erased field description for tools (editors, inspectors, script bindings).
+ */
+struct FieldInfo {
+    const char* name;  ///< Member name.
+    FieldType type;    ///< Value type.
+    uint32_t offset;   ///< Byte offset.
+    uint32_t size;     ///< sizeof the member.
+    uint32_t flags;    ///< FieldFlags.
+    float min;         ///< Quantization range.
+    float max;         ///< Quantization range.
+    uint8_t bits;      ///< Quantization bits.
+};
+
+/**
+ * @brief Field table of @p T, built at compile time.
+ */
+template<Reflected T>
+constexpr std::array<FieldInfo, FieldCount<T>> FieldTable = std::apply([](const auto&... field) {
+    return std::array<FieldInfo, FieldCount<T>>{ FieldInfo{
+        field.name, field.type, field.offset,
+        static_cast<uint32_t>(sizeof(typename std::remove_cvref_t<decltype(field)>::ValueType)),
+        field.flags, field.min, field.max, field.bits }... };
+}, Reflect<T>::fields);
+
+/**
+ * @brief Returns the description of the field of @p T called @p name, or nullptr.
+ * For tools; generated code uses member pointers instead.
+ */
+template<Reflected T>
+const FieldInfo*
+findField(const char* name) {
+    for (const FieldInfo& field : FieldTable<T>) {
+        if (std::strcmp(field.name, name) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
@@ -1,9 +0,0 @@
-#include "Transform.h"
-
-/**
- * @brief Initialization logic for the Transform component.
- * Currently empty but can be extended later.
- */
-void Transform::start() {
-	// No initialization logic needed at this time.
-}
@@ -7,14 +7,44 @@
 
 #include "..//Prerequisites.h"
 #include "ECS/Component.h"
-#include "WIndow.h"
+#include "ECS/ComponentStorage.h"
+#include "ECS/Reflection.h"
+#include "Window.h"
+#include <cmath>
 
 
 class Window;
 
+/**
+ * @struct TransformData
+ * @brief Plain data of a Transform, stored densely in Transform::storage().
+ */
+struct TransformData {
+    sf::Vector2f position; ///< Position in world units.
+    sf::Vector2f rotation; ///< Rotation (x holds the angle in degrees).
+    sf::Vector2f scale;    ///< Scale factors.
+};
+
+/**
+ * @brief Reflection of TransformData. Only the angle of the rotation is replicated;
+ * scale is not.
+ */
+template<>
+struct Reflect<TransformData> {
+    static constexpr const char* name = "Transform";
+    static constexpr auto fields = std::make_tuple(
+        RIOLU_FIELD(TransformData, position, FieldSaved | FieldReplicated | FieldEditable | FieldScripted),
+        RIOLU_FIELD(TransformData, rotation, FieldSaved | FieldEditable | FieldScripted),
+        RIOLU_FIELD(TransformData, scale, FieldSaved | FieldEditable | FieldScripted),
+        RIOLU_NESTED_FIELD(TransformData, rotation, x, FieldReplicated));
+};
+
 /**
  * @class Transform
  * @brief Component that holds position, rotation, and scale for an entity.
+ *
+ * The values live in a shared TComponentStorage instead of the component object,
+ * so the state of every Transform can be saved and restored in bulk.
  */
 class Transform : public Component {
 public:
@@ -22,17 +52,31 @@ public:
      * @brief Default constructor.
      */
     Transform()
-        : Component(ComponentType::TRANFORM),
-        m_position(0.f, 0.f),
-        m_rotation(0.f, 0.f),
-        m_scale(1.f, 1.f) {
+        : Component(ComponentType::TRANFORM) {
+        storage().create(&m_handle, TransformData{ sf::Vector2f(0.f, 0.f),
+                                                   sf::Vector2f(0.f, 0.f),
+                                                   sf::Vector2f(1.f, 1.f) });
     }
 
     /**
-     * @brief Destructor.
+     * @brief Destructor. Releases the slot in the storage.
      */
     virtual
-        ~Transform() = default;
+        ~Transform() {
+        storage().destroy(m_handle);
+    }
+
+    Transform(const Transform&) = delete;
+    Transform& operator=(const Transform&) = delete;
+
+    /**
+     * @brief Storage shared by every Transform.
+     */
+    static TComponentStorage<TransformData>&
+        storage() {
+        static TComponentStorage<TransformData> transforms("Transform");
+        return transforms;
+    }
 
     // M�todos override del sistema ECS
 
@@ -57,29 +101,49 @@ public:
             float speed,
             float deltaTime,
             float range) {
-        sf::Vector2f direction = targetPosition - m_position;
+        const sf::Vector2f position = storage().get(m_handle).position;
+        const sf::Vector2f next = seekStep(position, targetPosition, speed, deltaTime, range);
+        if (next != position) {
+            storage().edit(m_handle).position = next;
+        }
+    }
+
+    /**
+     * @brief Pure version of seek: returns where @p position ends up after one step.
+     *
+     * Has no side effects, so the same inputs always produce the same output. Client
+     * prediction and the authoritative server both run movement through it.
+     */
+    static sf::Vector2f
+        seekStep(const sf::Vector2f& position,
+            const sf::Vector2f& targetPosition,
+            float speed,
+            float deltaTime,
+            float range) {
+        sf::Vector2f direction = targetPosition - position;
         float lenght = std::sqrt(direction.x * direction.x + direction.y * direction.y);
 
         if (lenght > range) {
             direction /= lenght;
-            m_position += direction * speed * deltaTime;
+            return position + direction * speed * deltaTime;
         }
+        return position;
     }
 
     // Setters
     void
         setPosition(const sf::Vector2f& _position) {
-        m_position = _position;
+        storage().edit(m_handle).position = _position;
     }   //Se supone que es para que actualice el valor de la clase 
 
     void
         setRotation(const sf::Vector2f& _rotation) {
-        m_rotation = _rotation;
+        storage().edit(m_handle).rotation = _rotation;
     }
 
     void
         setScale(const sf::Vector2f& _scale) {
-        m_scale = _scale;
+        storage().edit(m_handle).scale = _scale;
     }
 
 
@@ -87,23 +151,30 @@ public:
     sf::Vector2f
         getPosition() const
     {
-        return m_position;
+        return storage().get(m_handle).position;
     }
 
     sf::Vector2f
         getRotation() const
     {
-        return m_rotation;
+        return storage().get(m_handle).rotation;
     }
 
     sf::Vector2f
         getScale() const
     {
-        return m_scale;
+        return storage().get(m_handle).scale;
+    }
+
+    /**
+     * @brief Returns every value of this Transform (for reflected serializers).
+     */
+    const TransformData&
+        getData() const
+    {
+        return storage().get(m_handle);
     }
 
 private:
-    sf::Vector2f m_position;
-    sf::Vector2f m_rotation;
-    sf::Vector2f m_scale;
+    ComponentHandle m_handle; ///< Slot of this Transform in storage().
 };
\ No newline at end of file
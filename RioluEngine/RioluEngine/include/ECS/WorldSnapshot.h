@@ -0,0 +1,126 @@
+#pragma once
+
+/**
+ * @file WorldSnapshot.h
+ * @brief Declares a ring of preallocated snapshots of every component storage.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/ComponentStorage.h"
+
+/**
+ * @enum SnapshotMode
+ * @brief How a WorldSnapshotRing copies storage bytes.
+ */
+enum class SnapshotMode {
+    Full,      ///< Copy every storage in one memcpy on save and restore.
+    DirtyPages ///< Copy only the pages written since the snapshot being overwritten / restored.
+};
+
+/**
+ * @struct SnapshotStats
+ * @brief Counters of the last save and restore.
+ */
+struct SnapshotStats {
+    size_t lastSaveBytes = 0;    ///< Bytes copied by the last save.
+    size_t lastRestoreBytes = 0; ///< Bytes copied by the last restore.
+    uint64_t reallocations = 0;  ///< Times a slot buffer had to grow after construction.
+    uint64_t rejectedRestores = 0; ///< Restores refused because live components or storages changed.
+};
+
+/**
+ * @class WorldSnapshotRing
+ * @brief Saves and restores the data of every component storage, many times per frame.
+ *
+ * The ring keeps the last N snapshots in buffers allocated up front. A snapshot is
+ * identified by the frame number returned by save().
+ *
+ * In DirtyPages mode a slot is only patched with the pages that changed since the
+ * snapshot it previously held, and a restore only copies back the pages written
+ * after the restored snapshot. This relies on the page stamps kept by every storage
+ * (see IComponentStorage).
+ *
+ * Snapshots hold component values, not the set of live components: if a component
+ * was created or destroyed after a snapshot, restore() refuses it and returns false.
+ *
+ * Every storage registered with ComponentStorageRegistry is captured (Transform,
+ * SpriteAnimatorStorage, ...), including storages registered after the ring was built.
+ * State kept outside the storages is not rolled back: CShape (held by sf::Shape),
+ * skeletons, tweens, behaviour trees, state machines and UI.
+ */
+class WorldSnapshotRing {
+public:
+    /**
+     * @brief Creates the ring and preallocates its buffers for the current storages.
+     * @param capacity Number of snapshots kept.
+     * @param mode Copy strategy.
+     * @param headroom Extra fraction of bytes reserved per storage for later growth.
+     */
+    WorldSnapshotRing(size_t capacity, SnapshotMode mode = SnapshotMode::Full, float headroom = 0.25f);
+
+    /**
+     * @brief Preallocates the slot buffers for the current storage sizes plus headroom.
+     */
+    void reserve();
+
+    /**
+     * @brief Captures the current state into the oldest slot.
+     * @return Frame number of the new snapshot.
+     */
+    uint32_t save();
+
+    /**
+     * @brief Copies a snapshot back into the storages.
+     * @param frame Frame number returned by save().
+     * @return false if the snapshot is no longer in the ring, or the live components or storages changed.
+     */
+    bool restore(uint32_t frame);
+
+    /**
+     * @brief Returns true if the snapshot of @p frame is still in the ring.
+     */
+    bool contains(uint32_t frame) const;
+
+    /**
+     * @brief Returns the counters.
+     */
+    const SnapshotStats& getStats() const { return m_stats; }
+
+private:
+    /**
+     * @brief Copy of one storage.
+     */
+    struct StorageImage {
+        const IComponentStorage* storage = nullptr; ///< Storage the bytes were copied from.
+        std::vector<sf::Uint8> bytes;                ///< Preallocated buffer.
+        size_t size = 0;                             ///< Bytes used by the image.
+    };
+
+    /**
+     * @brief One snapshot of every storage.
+     */
+    struct Slot {
+        bool valid = false;             ///< False until the slot has been saved once.
+        uint32_t frame = 0;             ///< Frame number of the snapshot.
+        uint32_t epoch = 0;             ///< Epoch in which the snapshot was taken.
+        uint64_t structureVersion = 0;  ///< Structure version when taken.
+        std::vector<StorageImage> images; ///< One image per registered storage.
+    };
+
+    /**
+     * @brief Finds the slot holding @p frame, or nullptr.
+     */
+    Slot* findSlot(uint32_t frame);
+
+    /**
+     * @brief Makes sure an image can hold @p size bytes.
+     */
+    void ensureCapacity(StorageImage& image, size_t size);
+
+    SnapshotMode m_mode;          ///< Copy strategy.
+    float m_headroom;             ///< Growth fraction reserved by reserve().
+    std::vector<Slot> m_slots;    ///< The ring.
+    size_t m_next = 0;            ///< Slot overwritten by the next save.
+    uint32_t m_nextFrame = 1;     ///< Frame number of the next save.
+    SnapshotStats m_stats;        ///< Counters.
+};
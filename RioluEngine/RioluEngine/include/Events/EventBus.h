@@ -0,0 +1,377 @@
+#pragma once
+
+/**
+ * @file EventBus.h
+ * @brief Declares the event bus: typed channels buffered during the frame and dispatched in batches.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/CacheLine.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @struct EventSubscription
+ * @brief Handle of a subscriber, returned by subscribe() and given back to unsubscribe().
+ *
+ * The generation makes a stale handle harmless once its slot is reused.
+ */
+struct EventSubscription {
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t channel = InvalidIndex; ///< Type id of the channel.
+    uint32_t index = InvalidIndex;   ///< Subscriber slot in the channel.
+    uint32_t generation = 0;         ///< Generation of the slot when subscribed.
+
+    /**
+     * @brief Returns true if the handle refers to a subscriber.
+     */
+    bool isValid() const { return index != InvalidIndex; }
+};
+
+/**
+ * @class IEventChannel
+ * @brief Type-erased view of a channel, used by EventBus::dispatch().
+ */
+class IEventChannel {
+public:
+    virtual ~IEventChannel() = default;
+
+    /**
+     * @brief Delivers the buffered events to the subscribers.
+     */
+    virtual void dispatch() = 0;
+
+    /**
+     * @brief Removes a subscriber; ignored if the handle is stale.
+     */
+    virtual void unsubscribe(uint32_t index, uint32_t generation) = 0;
+
+    /**
+     * @brief Returns the number of events waiting for the next dispatch.
+     */
+    virtual size_t getPendingCount() const = 0;
+};
+
+/**
+ * @class TEventChannel
+ * @brief Events of one type, appended during the frame and delivered in batches.
+ *
+ * The main thread appends with publish() to a vector. Worker threads append with
+ * publishConcurrent(): a fetch_add claims an index in a list of fixed blocks, and a
+ * missing block is installed with a compare-exchange, so producers never lock. The
+ * blocks are kept between frames, so appends stop allocating after the first frames.
+ * Workers must be done publishing (their jobs waited for) before dispatch() runs.
+ *
+ * Subscribers are a function pointer and a context, called with contiguous runs of
+ * up to BatchSize events: one indirect call per subscriber and batch rather than a
+ * std::function call per event. Every subscriber sees a batch before the next one is
+ * delivered, so the batch stays in cache.
+ *
+ * Events published while dispatching (main thread or concurrent) are buffered for
+ * the next dispatch(). A subscriber removed while dispatching gets no further
+ * batches; one added while dispatching first hears of the next dispatch().
+ *
+ * @tparam T Event type (trivially copyable).
+ */
+template<typename T>
+class TEventChannel : public IEventChannel {
+    static_assert(std::is_trivially_copyable_v<T>, "Events are copied as bytes");
+
+public:
+    static constexpr size_t BatchSize = 1024;     ///< Events per concurrent block and per delivered batch.
+    static constexpr size_t MaxBlocks = 1024;     ///< Concurrent blocks per frame (1M events).
+
+    /**
+     * @brief Subscriber callback: @p count events starting at @p events.
+     */
+    using Callback = void(*)(void* context, const T* events, size_t count);
+
+    /**
+     * @brief Creates an empty channel.
+     * @param id Type id of T in the EventBus.
+     */
+    explicit TEventChannel(uint32_t id) : m_id(id) {
+        for (ConcurrentBuffer& buffer : m_concurrent) {
+            buffer.blocks.reset(new std::atomic<Block*>[MaxBlocks]);
+            for (size_t i = 0; i < MaxBlocks; ++i) {
+                buffer.blocks[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Frees the concurrent blocks.
+     */
+    ~TEventChannel() override {
+        for (ConcurrentBuffer& buffer : m_concurrent) {
+            for (size_t i = 0; i < MaxBlocks; ++i) {
+                delete buffer.blocks[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    TEventChannel(const TEventChannel&) = delete;
+    TEventChannel& operator=(const TEventChannel&) = delete;
+
+    /**
+     * @brief Buffers an event. Main thread only.
+     */
+    void publish(const T& event) { m_events.push_back(event); }
+
+    /**
+     * @brief Buffers an event. Any thread, lock-free.
+     */
+    void
+    publishConcurrent(const T& event) {
+        ConcurrentBuffer& buffer = m_concurrent[m_active.load(std::memory_order_acquire)];
+        const size_t index = buffer.count.value.fetch_add(1, std::memory_order_relaxed);
+        const size_t blockIndex = index / BatchSize;
+        if (blockIndex >= MaxBlocks) {
+            ERROR("TEventChannel", "publishConcurrent", "More than " << MaxBlocks * BatchSize << " events in one frame");
+        }
+
+        Block* block = buffer.blocks[blockIndex].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            // Several producers may reach a new block at once; one installs its copy.
+            Block* fresh = new Block;
+            if (buffer.blocks[blockIndex].compare_exchange_strong(block, fresh, std::memory_order_acq_rel)) {
+                block = fresh;
+            }
+            else {
+                delete fresh;
+            }
+        }
+        std::memcpy(block->bytes + (index % BatchSize) * sizeof(T), &event, sizeof(T));
+    }
+
+    /**
+     * @brief Adds a subscriber. Main thread only.
+     */
+    EventSubscription
+    subscribe(Callback callback, void* context) {
+        if (callback == nullptr) {
+            ERROR("TEventChannel", "subscribe", "Null callback");
+        }
+        uint32_t index;
+        if (!m_freeSubscribers.empty() && !m_dispatching) {
+            index = m_freeSubscribers.back();
+            m_freeSubscribers.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(m_subscribers.size());
+            m_subscribers.push_back(Subscriber());
+        }
+        Subscriber& subscriber = m_subscribers[index];
+        subscriber.callback = callback;
+        subscriber.context = context;
+        return EventSubscription{ m_id, index, subscriber.generation };
+    }
+
+    /**
+     * @brief Adds @p object as subscriber through its member function
+     * `void Method(const T* events, size_t count)`.
+     */
+    template<auto Method, typename Object>
+    EventSubscription
+    subscribe(Object& object) {
+        return subscribe([](void* context, const T* events, size_t count) {
+            (static_cast<Object*>(context)->*Method)(events, count);
+        }, &object);
+    }
+
+    void
+    unsubscribe(uint32_t index, uint32_t generation) override {
+        if (index >= m_subscribers.size() || m_subscribers[index].generation != generation ||
+            m_subscribers[index].callback == nullptr) {
+            return;
+        }
+        m_subscribers[index].callback = nullptr;
+        ++m_subscribers[index].generation;
+        m_freeSubscribers.push_back(index);
+    }
+
+    void
+    dispatch() override {
+        if (m_dispatching) {
+            ERROR("TEventChannel", "dispatch", "Channel dispatched from one of its subscribers");
+        }
+        m_dispatching = true;
+        std::swap(m_events, m_delivering);
+        const uint32_t active = m_active.load(std::memory_order_relaxed);
+        m_active.store(active ^ 1u, std::memory_order_release);
+        ConcurrentBuffer& concurrent = m_concurrent[active];
+        const size_t subscribers = m_subscribers.size();
+
+        for (size_t offset = 0; offset < m_delivering.size(); offset += BatchSize) {
+            deliver(m_delivering.data() + offset, std::min(BatchSize, m_delivering.size() - offset), subscribers);
+        }
+        const size_t concurrentCount = std::min(concurrent.count.value.load(std::memory_order_acquire), MaxBlocks * BatchSize);
+        for (size_t offset = 0; offset < concurrentCount; offset += BatchSize) {
+            const Block* block = concurrent.blocks[offset / BatchSize].load(std::memory_order_acquire);
+            deliver(std::launder(reinterpret_cast<const T*>(block->bytes)), std::min(BatchSize, concurrentCount - offset),
+                    subscribers);
+        }
+
+        m_dispatched += m_delivering.size() + concurrentCount;
+        m_delivering.clear();
+        concurrent.count.value.store(0, std::memory_order_relaxed);
+        m_dispatching = false;
+    }
+
+    size_t
+    getPendingCount() const override {
+        return m_events.size() + m_concurrent[m_active.load(std::memory_order_acquire)].count.value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of events dispatched since the channel was created.
+     */
+    uint64_t getDispatchedCount() const { return m_dispatched; }
+
+private:
+    /**
+     * @struct Subscriber
+     * @brief One subscriber slot; a null callback marks a free slot.
+     */
+    struct Subscriber {
+        Callback callback = nullptr; ///< Function called with each batch.
+        void* context = nullptr;     ///< First argument of callback.
+        uint32_t generation = 0;     ///< Bumped when the slot is freed.
+    };
+
+    /**
+     * @struct Block
+     * @brief BatchSize events appended by worker threads.
+     */
+    struct Block {
+        alignas(T) unsigned char bytes[sizeof(T) * BatchSize]; ///< Event bytes.
+    };
+
+    /**
+     * @struct ConcurrentBuffer
+     * @brief Blocks of one frame; the count sits alone on its cache line.
+     */
+    struct ConcurrentBuffer {
+        struct alignas(CacheLineSize) PaddedCount {
+            std::atomic<size_t> value{ 0 }; ///< Claimed event indices.
+        };
+
+        PaddedCount count;                          ///< Events appended.
+        std::unique_ptr<std::atomic<Block*>[]> blocks; ///< MaxBlocks block pointers (null until used).
+    };
+
+    /**
+     * @brief Calls every subscriber of the first @p subscribers slots with one batch.
+     */
+    void
+    deliver(const T* events, size_t count, size_t subscribers) {
+        for (size_t i = 0; i < subscribers; ++i) {
+            // Copied: a callback may subscribe and grow the vector.
+            const Subscriber subscriber = m_subscribers[i];
+            if (subscriber.callback != nullptr) {
+                subscriber.callback(subscriber.context, events, count);
+            }
+        }
+    }
+
+    uint32_t m_id;                              ///< Type id in the EventBus.
+    std::vector<T> m_events;                    ///< Main thread events of the frame.
+    std::vector<T> m_delivering;                ///< Events being dispatched.
+    ConcurrentBuffer m_concurrent[2];           ///< Worker events; one buffer fills while the other is dispatched.
+    std::atomic<uint32_t> m_active{ 0 };        ///< Buffer workers append to.
+    std::vector<Subscriber> m_subscribers;      ///< Subscriber slots.
+    std::vector<uint32_t> m_freeSubscribers;    ///< Free subscriber slots.
+    bool m_dispatching = false;                 ///< Inside dispatch().
+    uint64_t m_dispatched = 0;                  ///< Events dispatched so far.
+};
+
+/**
+ * @class EventBus
+ * @brief Set of typed channels through which components talk without knowing each other.
+ *
+ * A channel is created on first use of its type; create the channels that worker
+ * threads publish to on the main thread (getChannel()) before the jobs run, and keep
+ * the reference. dispatch() delivers every channel in creation order; BaseApp calls
+ * it once per frame, after the actors updated.
+ */
+class EventBus {
+public:
+    /**
+     * @brief Returns the channel of T, creating it if needed. Main thread only.
+     */
+    template<typename T>
+    TEventChannel<T>&
+    getChannel() {
+        const uint32_t id = typeId<T>();
+        if (id >= m_channels.size()) {
+            m_channels.resize(id + 1);
+        }
+        if (!m_channels[id]) {
+            m_channels[id].reset(new TEventChannel<T>(id));
+            m_order.push_back(m_channels[id].get());
+        }
+        return static_cast<TEventChannel<T>&>(*m_channels[id]);
+    }
+
+    /**
+     * @brief Buffers an event for the next dispatch(). Main thread only.
+     */
+    template<typename T>
+    void publish(const T& event) { getChannel<T>().publish(event); }
+
+    /**
+     * @brief Subscribes a function to the events of type T.
+     */
+    template<typename T>
+    EventSubscription
+    subscribe(typename TEventChannel<T>::Callback callback, void* context) {
+        return getChannel<T>().subscribe(callback, context);
+    }
+
+    /**
+     * @brief Subscribes `object.Method(const T* events, size_t count)` to the events of type T.
+     */
+    template<typename T, auto Method, typename Object>
+    EventSubscription
+    subscribe(Object& object) {
+        return getChannel<T>().template subscribe<Method>(object);
+    }
+
+    /**
+     * @brief Removes a subscriber and invalidates its handle.
+     */
+    void unsubscribe(EventSubscription& subscription);
+
+    /**
+     * @brief Delivers the events buffered in every channel.
+     */
+    void dispatch();
+
+    /**
+     * @brief Returns the number of channels.
+     */
+    size_t getChannelCount() const { return m_order.size(); }
+
+private:
+    /**
+     * @brief Returns a new process-wide event type id.
+     */
+    static uint32_t nextTypeId();
+
+    /**
+     * @brief Returns the id of event type T (the same in every bus).
+     */
+    template<typename T>
+    static uint32_t
+    typeId() {
+        static const uint32_t id = nextTypeId();
+        return id;
+    }
+
+    std::vector<std::unique_ptr<IEventChannel>> m_channels; ///< Channels by type id (null if unused).
+    std::vector<IEventChannel*> m_order;                    ///< Channels in creation order.
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+/**
+ * @file BlockingQueue.h
+ * @brief Declares a wrapper adding blocking push/pop to the lock-free queues.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/CacheLine.h"
+#include <atomic>
+
+/**
+ * @class TBlockingQueue
+ * @brief Blocks on an empty or full lock-free queue instead of spinning.
+ *
+ * Waiting threads first retry briefly, then park with std::atomic::wait, which is a futex on Linux and
+ * WaitOnAddress on Windows: no mutex is involved and a push or pop only makes a
+ * system call when a thread is actually parked on the other side.
+ *
+ * Each side keeps an event counter (pushes, pops) and a count of parked threads.
+ * A thread parks on the counter value it read before its last failed attempt, so a
+ * push or pop that slips in between makes the wait return immediately.
+ *
+ * @tparam Queue TSPSCQueue<T> or TMPMCQueue<T> (the SPSC one keeps its one-producer
+ *         one-consumer restriction).
+ * @tparam T Element type of the queue.
+ */
+template<typename Queue, typename T>
+class TBlockingQueue {
+public:
+    /**
+     * @brief Creates the underlying queue.
+     * @param capacity Maximum number of elements.
+     */
+    explicit TBlockingQueue(size_t capacity) : m_queue(capacity) {}
+
+    TBlockingQueue(const TBlockingQueue&) = delete;
+    TBlockingQueue& operator=(const TBlockingQueue&) = delete;
+
+    /**
+     * @brief Adds an element without blocking.
+     * @return false if the queue is full or closed.
+     */
+    template<typename U>
+    bool
+    tryPush(U&& value) {
+        if (m_closed.load(std::memory_order_acquire) || !m_queue.tryPush(std::forward<U>(value))) {
+            return false;
+        }
+        signal(m_pushes);
+        return true;
+    }
+
+    /**
+     * @brief Removes an element without blocking.
+     * @return false if the queue is empty.
+     */
+    bool
+    tryPop(T& value) {
+        if (!m_queue.tryPop(value)) {
+            return false;
+        }
+        signal(m_pops);
+        return true;
+    }
+
+    /**
+     * @brief Adds an element, parking while the queue is full.
+     * @return false if the queue was closed.
+     */
+    template<typename U>
+    bool
+    push(U&& value) {
+        for (;;) {
+            for (int spin = 0; spin < SpinCount; ++spin) {
+                if (tryPush(std::forward<U>(value))) {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+            if (m_closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (park(m_pops, [&] { return m_queue.tryPush(std::forward<U>(value)); }, m_pushes)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Removes an element, parking while the queue is empty.
+     * @return false once the queue is closed and empty.
+     */
+    bool
+    pop(T& value) {
+        for (;;) {
+            for (int spin = 0; spin < SpinCount; ++spin) {
+                if (tryPop(value)) {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+            if (m_closed.load(std::memory_order_acquire)) {
+                // Elements pushed before close() are still handed out.
+                return tryPop(value);
+            }
+            if (park(m_pushes, [&] { return m_queue.tryPop(value); }, m_pops)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Rejects further pushes and wakes every parked thread.
+     */
+    void
+    close() {
+        m_closed.store(true, std::memory_order_release);
+        m_pushes.events.fetch_add(1, std::memory_order_seq_cst);
+        m_pushes.events.notify_all();
+        m_pops.events.fetch_add(1, std::memory_order_seq_cst);
+        m_pops.events.notify_all();
+    }
+
+    /**
+     * @brief Returns true once close() was called.
+     */
+    bool isClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the underlying queue.
+     */
+    Queue& getQueue() { return m_queue; }
+
+private:
+    /**
+     * @brief Failed attempts (each followed by a yield) before a thread parks.
+     *
+     * Short waits are common under load and cheaper to ride out than a futex round
+     * trip on both sides.
+     */
+    static constexpr int SpinCount = 16;
+
+    /**
+     * @brief Event counter and parked-thread count of one side, on its own cache line.
+     */
+    struct alignas(CacheLineSize) Side {
+        std::atomic<uint32_t> events{ 0 }; ///< Incremented after every push (or pop).
+        std::atomic<uint32_t> waiters{ 0 }; ///< Threads parked on events.
+    };
+
+    /**
+     * @brief Publishes an event and wakes one parked thread if there is any.
+     */
+    static void
+    signal(Side& side) {
+        side.events.fetch_add(1, std::memory_order_seq_cst);
+        if (side.waiters.load(std::memory_order_seq_cst) != 0) {
+            side.events.notify_one();
+        }
+    }
+
+    /**
+     * @brief Parks on @p side until it changes, unless @p attempt succeeds first.
+     *
+     * Registering as a waiter before reading the counter, and signal() bumping the
+     * counter before reading the waiters (all sequentially consistent), guarantees
+     * that either the attempt sees the new element / free slot or the signal sees the
+     * waiter and wakes it.
+     *
+     * @return true if the attempt succeeded (the other side has been signalled).
+     */
+    template<typename Attempt>
+    bool
+    park(Side& side, Attempt attempt, Side& succeeded) {
+        side.waiters.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t seen = side.events.load(std::memory_order_seq_cst);
+        const bool done = attempt();
+        if (!done && !m_closed.load(std::memory_order_acquire)) {
+            side.events.wait(seen, std::memory_order_seq_cst);
+        }
+        side.waiters.fetch_sub(1, std::memory_order_seq_cst);
+        if (done) {
+            signal(succeeded);
+        }
+        return done;
+    }
+
+    Queue m_queue;                     ///< Lock-free storage.
+    Side m_pushes;                     ///< Consumers park here while empty.
+    Side m_pops;                       ///< Producers park here while full.
+    std::atomic<bool> m_closed{ false }; ///< Set by close().
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @file CacheLine.h
+ * @brief Cache line size used to keep data written by different threads apart.
+ */
+
+#include <cstddef>
+
+/**
+ * @brief Assumed cache line size in bytes (x86-64 and most ARM cores).
+ *
+ * std::hardware_destructive_interference_size is not used because its value may
+ * differ between compilers, which would change class layouts.
+ */
+constexpr size_t CacheLineSize = 64;
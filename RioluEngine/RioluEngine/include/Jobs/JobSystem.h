@@ -0,0 +1,158 @@
+#pragma once
+
+/**
+ * @file JobSystem.h
+ * @brief Declares the worker thread pool that runs engine jobs.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/BlockingQueue.h"
+#include "Jobs/MPMCQueue.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * @class JobState
+ * @brief Completion state of one scheduled job, shared between threads.
+ *
+ * Held through std::shared_ptr (JobHandle) rather than TSharedPointer because the
+ * handle is copied and released on several threads and needs an atomic count.
+ */
+class JobState {
+public:
+    /**
+     * @brief Returns true once the job function returned.
+     */
+    bool isDone() const { return m_done.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Calls @p callback once the job is done.
+     *
+     * The callback runs on the thread that finishes the job, or immediately on the
+     * calling thread if the job is already done. It must be short and thread-safe.
+     */
+    void onComplete(std::function<void()> callback);
+
+private:
+    friend class JobSystem;
+
+    /**
+     * @brief Marks the job done and runs the registered callbacks.
+     */
+    void complete();
+
+    std::atomic<bool> m_done{ false };               ///< Set when the job finished.
+    std::mutex m_mutex;                              ///< Guards m_callbacks against complete().
+    std::vector<std::function<void()>> m_callbacks;  ///< Called on completion.
+};
+
+/**
+ * @brief Handle used to wait for or observe a scheduled job.
+ */
+using JobHandle = std::shared_ptr<JobState>;
+
+/**
+ * @class JobSystem
+ * @brief Fixed pool of worker threads consuming a shared job queue.
+ *
+ * The queue is a bounded lock-free MPMC ring; idle workers park on it without a
+ * mutex and are only woken when a job is pushed.
+ *
+ * Jobs are plain functions. schedule() returns a JobHandle; wait() blocks until the
+ * job is done, running queued jobs on the calling thread in the meantime so the
+ * caller never idles while work is pending.
+ */
+class JobSystem {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param workerCount Number of threads (0 runs every job inside wait() / the caller).
+     */
+    explicit JobSystem(unsigned workerCount = getDefaultWorkerCount());
+
+    /**
+     * @brief Runs the jobs still queued, then stops and joins the workers.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Queues a job.
+     *
+     * If the queue is full the calling thread runs queued jobs until a slot frees up.
+     * Once the destructor has closed the queue the job runs on the calling thread.
+     * @param job Function run on a worker.
+     * @return Handle completed when the function returns.
+     */
+    JobHandle schedule(std::function<void()> job);
+
+    /**
+     * @brief Queues a job nobody waits for.
+     *
+     * Same as schedule() without the JobHandle allocation; completion has to be
+     * tracked by the job itself (TaskGraph counts finished tasks).
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * @brief Blocks until @p job is done, helping with queued jobs meanwhile.
+     */
+    void wait(const JobHandle& job);
+
+    /**
+     * @brief Runs one queued job on the calling thread.
+     * @return false if the queue was empty.
+     */
+    bool runPendingJob();
+
+    /**
+     * @brief Returns the number of worker threads.
+     */
+    unsigned getWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * @brief Returns 1..N on worker threads of any JobSystem, 0 on other threads.
+     */
+    static unsigned getCurrentWorkerIndex();
+
+    /**
+     * @brief One worker per hardware thread, minus the main thread.
+     */
+    static unsigned getDefaultWorkerCount();
+
+private:
+    /**
+     * @brief Queued job with its completion state.
+     */
+    struct QueuedJob {
+        std::function<void()> function; ///< Work to do.
+        JobHandle state;                ///< Completed after the function, may be null.
+    };
+
+    /**
+     * @brief Body of every worker thread.
+     */
+    void workerLoop(unsigned index);
+
+    /**
+     * @brief Queues @p job, helping with queued jobs while the queue is full.
+     */
+    void push(QueuedJob job);
+
+    /**
+     * @brief Runs a job and completes its handle.
+     */
+    static void execute(QueuedJob& job);
+
+    /**
+     * @brief Maximum number of queued jobs before schedule() starts helping.
+     */
+    static constexpr size_t QueueCapacity = 4096;
+
+    TBlockingQueue<TMPMCQueue<QueuedJob>, QueuedJob> m_queue{ QueueCapacity }; ///< Jobs waiting for a thread.
+    std::vector<std::thread> m_workers; ///< Worker threads.
+};
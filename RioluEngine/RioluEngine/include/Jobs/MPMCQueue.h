@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file MPMCQueue.h
+ * @brief Declares a bounded lock-free multi-producer multi-consumer ring queue.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/CacheLine.h"
+#include <atomic>
+#include <memory>
+#include <new>
+
+/**
+ * @class TMPMCQueue
+ * @brief Bounded ring queue usable by any number of producer and consumer threads.
+ *
+ * Every slot carries a sequence number telling whether it is ready to be written
+ * (sequence == position) or read (sequence == position + 1). Producers and consumers
+ * claim positions with a compare-exchange on their own index and then only touch the
+ * claimed slot, so there is no lock and a stalled thread only blocks its own slot.
+ * The two indices live on separate cache lines.
+ *
+ * @tparam T Element type (movable).
+ */
+template<typename T>
+class TMPMCQueue {
+public:
+    /**
+     * @brief Creates the queue.
+     * @param capacity Maximum number of elements, rounded up to a power of two.
+     */
+    explicit TMPMCQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_mask = rounded - 1;
+        m_slots.reset(new Slot[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Destroys the elements still queued.
+     */
+    ~TMPMCQueue() {
+        const size_t tail = m_tail.value.load(std::memory_order_acquire);
+        for (size_t i = m_head.value.load(std::memory_order_relaxed); i != tail; ++i) {
+            std::launder(reinterpret_cast<T*>(m_slots[i & m_mask].storage))->~T();
+        }
+    }
+
+    TMPMCQueue(const TMPMCQueue&) = delete;
+    TMPMCQueue& operator=(const TMPMCQueue&) = delete;
+
+    /**
+     * @brief Adds an element. Any thread.
+     * @return false if the queue is full (the value is left untouched).
+     */
+    template<typename U>
+    bool
+    tryPush(U&& value) {
+        size_t position = m_tail.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[position & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (m_tail.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    new (slot.storage) T(std::forward<U>(value));
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                // The slot still holds the element of the previous lap: full.
+                return false;
+            }
+            else {
+                position = m_tail.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest available element. Any thread.
+     * @return false if the queue is empty.
+     */
+    bool
+    tryPop(T& value) {
+        size_t position = m_head.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[position & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (m_head.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    T* element = std::launder(reinterpret_cast<T*>(slot.storage));
+                    value = std::move(*element);
+                    element->~T();
+                    // Ready for the producer of the next lap.
+                    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = m_head.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the maximum number of elements.
+     */
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief Returns an approximate element count.
+     */
+    size_t
+    sizeApprox() const {
+        const size_t tail = m_tail.value.load(std::memory_order_acquire);
+        const size_t head = m_head.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    /**
+     * @brief Element storage with its sequence number.
+     */
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 };           ///< Lap / readiness marker.
+        alignas(T) unsigned char storage[sizeof(T)]; ///< Element bytes.
+    };
+
+    /**
+     * @brief Index alone on its cache line.
+     */
+    struct alignas(CacheLineSize) PaddedIndex {
+        std::atomic<size_t> value{ 0 }; ///< Monotonic position.
+    };
+
+    std::unique_ptr<Slot[]> m_slots; ///< Ring storage.
+    size_t m_mask = 0;               ///< capacity - 1.
+    PaddedIndex m_head;              ///< Next position to pop.
+    PaddedIndex m_tail;              ///< Next position to push.
+};
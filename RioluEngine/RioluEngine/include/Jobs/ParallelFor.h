@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file ParallelFor.h
+ * @brief Declares parallelFor, which splits an index range across the job system.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @brief Calls @p function(begin, end) for consecutive chunks of [0, count) on the
+ * workers of @p jobs and the calling thread, and returns when every chunk is done.
+ *
+ * Chunks are [k * grain, min(count, (k + 1) * grain)), so their boundaries only
+ * depend on @p grain, never on the number of threads; chunk k can index per-chunk
+ * results with begin / grain. Threads claim chunks from a shared counter, so a slow
+ * chunk does not hold back the others. With one chunk or no workers everything runs
+ * inline, in order.
+ *
+ * @param jobs Pool providing the helper threads.
+ * @param count Number of indices.
+ * @param grain Indices per chunk (at least 1).
+ * @param function Callable as function(size_t begin, size_t end); must be thread-safe.
+ */
+template<typename Function>
+void
+parallelFor(JobSystem& jobs, size_t count, size_t grain, const Function& function) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    const size_t helpers = std::min<size_t>(jobs.getWorkerCount(), chunks - 1);
+    if (helpers == 0) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            function(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextChunk{ 0 };
+    std::atomic<size_t> exitedHelpers{ 0 };
+    auto work = [&]() {
+        for (;;) {
+            const size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunks) {
+                return;
+            }
+            function(chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+    };
+    for (size_t i = 0; i < helpers; ++i) {
+        jobs.submit([&work, &exitedHelpers]() {
+            work();
+            // Last access to this stack frame: the caller may return right after.
+            exitedHelpers.fetch_add(1, std::memory_order_release);
+        });
+    }
+    work();
+    // Every helper job must have finished, not just every chunk, before the shared
+    // state above goes out of scope.
+    while (exitedHelpers.load(std::memory_order_acquire) != helpers) {
+        if (!jobs.runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+ * @file SPSCQueue.h
+ * @brief Declares a bounded lock-free single-producer single-consumer ring queue.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/CacheLine.h"
+#include <atomic>
+#include <memory>
+#include <new>
+
+/**
+ * @class TSPSCQueue
+ * @brief Bounded ring queue for exactly one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head, each on
+ * its own cache line. Each side also keeps a cached copy of the other side's index
+ * and only reloads it when the queue looks full (producer) or empty (consumer), so
+ * in steady state a push or pop touches no cache line owned by the other thread.
+ *
+ * @tparam T Element type (movable).
+ */
+template<typename T>
+class TSPSCQueue {
+public:
+    /**
+     * @brief Creates the queue.
+     * @param capacity Maximum number of elements, rounded up to a power of two.
+     */
+    explicit TSPSCQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_mask = rounded - 1;
+        m_slots.reset(new Slot[rounded]);
+    }
+
+    /**
+     * @brief Destroys the elements still queued.
+     */
+    ~TSPSCQueue() {
+        const size_t tail = m_producer.tail.load(std::memory_order_acquire);
+        for (size_t i = m_consumer.head.load(std::memory_order_relaxed); i != tail; ++i) {
+            std::launder(reinterpret_cast<T*>(m_slots[i & m_mask].storage))->~T();
+        }
+    }
+
+    TSPSCQueue(const TSPSCQueue&) = delete;
+    TSPSCQueue& operator=(const TSPSCQueue&) = delete;
+
+    /**
+     * @brief Adds an element. Producer thread only.
+     * @return false if the queue is full (the value is left untouched).
+     */
+    template<typename U>
+    bool
+    tryPush(U&& value) {
+        const size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        if (tail - m_producer.cachedHead >= capacity()) {
+            m_producer.cachedHead = m_consumer.head.load(std::memory_order_acquire);
+            if (tail - m_producer.cachedHead >= capacity()) {
+                return false;
+            }
+        }
+        new (m_slots[tail & m_mask].storage) T(std::forward<U>(value));
+        m_producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element. Consumer thread only.
+     * @return false if the queue is empty.
+     */
+    bool
+    tryPop(T& value) {
+        const size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        if (head == m_consumer.cachedTail) {
+            m_consumer.cachedTail = m_producer.tail.load(std::memory_order_acquire);
+            if (head == m_consumer.cachedTail) {
+                return false;
+            }
+        }
+        T* element = std::launder(reinterpret_cast<T*>(m_slots[head & m_mask].storage));
+        value = std::move(*element);
+        element->~T();
+        m_consumer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns the maximum number of elements.
+     */
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief Returns an approximate element count (exact if both threads are idle).
+     */
+    size_t
+    sizeApprox() const {
+        return m_producer.tail.load(std::memory_order_acquire) - m_consumer.head.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * @brief Uninitialized storage for one element.
+     */
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)]; ///< Element bytes.
+    };
+
+    /**
+     * @brief Fields written by the consumer, alone on their cache line.
+     */
+    struct alignas(CacheLineSize) ConsumerSide {
+        std::atomic<size_t> head{ 0 }; ///< Next slot to pop.
+        size_t cachedTail = 0;         ///< Last tail seen by the consumer.
+    };
+
+    /**
+     * @brief Fields written by the producer, alone on their cache line.
+     */
+    struct alignas(CacheLineSize) ProducerSide {
+        std::atomic<size_t> tail{ 0 }; ///< Next slot to fill.
+        size_t cachedHead = 0;         ///< Last head seen by the producer.
+    };
+
+    std::unique_ptr<Slot[]> m_slots; ///< Ring storage.
+    size_t m_mask = 0;               ///< capacity - 1.
+    ConsumerSide m_consumer;         ///< Consumer state.
+    ProducerSide m_producer;         ///< Producer state.
+};
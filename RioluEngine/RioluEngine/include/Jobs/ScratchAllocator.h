@@ -0,0 +1,200 @@
+#pragma once
+
+/**
+ * @file ScratchAllocator.h
+ * @brief Declares the per-thread linear allocator for temporary job memory.
+ */
+
+#include "../Prerequisites.h"
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @struct ScratchStats
+ * @brief Usage of one thread's scratch allocator.
+ */
+struct ScratchStats {
+    unsigned thread = 0;             ///< JobSystem::getCurrentWorkerIndex() of the owner (0 = non-worker).
+    size_t capacity = 0;             ///< Size of the main buffer in bytes.
+    size_t used = 0;                 ///< Bytes in use right now.
+    size_t peak = 0;                 ///< Highest number of bytes in use at once.
+    size_t overflowAllocations = 0;  ///< Allocations that did not fit in the main buffer.
+};
+
+/**
+ * @class ScratchAllocator
+ * @brief Linear allocator owned by one thread, rewound with markers.
+ *
+ * Allocating bumps an offset in a buffer that belongs to the calling thread, so jobs
+ * get temporary memory without locks, without touching other threads' cache lines
+ * and without freeing anything: a ScratchScope rewinds everything allocated inside it
+ * when it ends. Memory must not outlive the scope and nothing is destructed, so only
+ * trivially destructible types can be allocated.
+ *
+ * When the buffer is full, allocations continue in heap blocks that are released by
+ * the next rewind below them; the overflow count says the buffer should be larger.
+ */
+class ScratchAllocator {
+public:
+    static constexpr size_t DefaultCapacity = 1024 * 1024; ///< Main buffer size of new threads.
+    static constexpr size_t OverflowBlockSize = 64 * 1024;   ///< Minimum size of an overflow block.
+
+    /**
+     * @brief Position to rewind to, returned by getMarker().
+     */
+    struct Marker {
+        size_t offset = 0;         ///< Offset in the main buffer.
+        size_t overflowBlocks = 0; ///< Overflow blocks in use.
+        size_t overflowOffset = 0; ///< Offset in the last overflow block.
+    };
+
+    /**
+     * @brief Returns the calling thread's allocator, created on first use.
+     */
+    static ScratchAllocator& get();
+
+    /**
+     * @brief Returns the usage of every live scratch allocator, in creation order.
+     *
+     * Counters are read while their owners may be allocating, so values are a
+     * snapshot, not a consistent cut.
+     */
+    static std::vector<ScratchStats> getAllStats();
+
+    /**
+     * @brief Resets the peak of every live allocator to its current usage.
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief Creates an allocator with a main buffer of @p capacity bytes.
+     *
+     * The creating thread is recorded as the owner and the allocator is listed by
+     * getAllStats() until destroyed.
+     */
+    explicit ScratchAllocator(size_t capacity = DefaultCapacity);
+
+    /**
+     * @brief Frees the buffer and every overflow block.
+     */
+    ~ScratchAllocator();
+
+    ScratchAllocator(const ScratchAllocator&) = delete;
+    ScratchAllocator& operator=(const ScratchAllocator&) = delete;
+
+    /**
+     * @brief Returns @p size bytes aligned to @p alignment (a power of two).
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        const size_t aligned = alignOffset(m_buffer, m_offset, alignment);
+        if (m_overflow.empty() && aligned + size <= m_capacity) {
+            m_offset = aligned + size;
+            noteUsage();
+            return m_buffer + aligned;
+        }
+        return allocateOverflow(size, alignment);
+    }
+
+    /**
+     * @brief Returns uninitialized storage for @p count objects of type T.
+     */
+    template<typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "Scratch memory is never destructed, use trivially destructible types");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Returns the current position.
+     */
+    Marker getMarker() const {
+        return { m_offset, m_overflow.size(), m_overflowOffset };
+    }
+
+    /**
+     * @brief Releases everything allocated since @p marker was taken.
+     */
+    void rewind(const Marker& marker);
+
+    /**
+     * @brief Returns this allocator's usage.
+     */
+    ScratchStats getStats() const;
+
+private:
+    /**
+     * @brief Heap block used once the main buffer is full.
+     */
+    struct OverflowBlock {
+        unsigned char* data; ///< Block memory.
+        size_t size;         ///< Block size in bytes.
+    };
+
+    /**
+     * @brief Serves an allocation from the overflow blocks.
+     */
+    void* allocateOverflow(size_t size, size_t alignment);
+
+    /**
+     * @brief Returns the first offset >= @p offset whose address is aligned.
+     */
+    static size_t alignOffset(const unsigned char* base, size_t offset, size_t alignment) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+        return offset + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+    }
+
+    /**
+     * @brief Publishes the current usage and updates the peak.
+     *
+     * Only the owner writes these counters; relaxed atomics just let getAllStats()
+     * read them from another thread.
+     */
+    void noteUsage() {
+        const size_t used = m_offset + m_overflowUsed + m_overflowOffset;
+        m_used.store(used, std::memory_order_relaxed);
+        if (used > m_peak.load(std::memory_order_relaxed)) {
+            m_peak.store(used, std::memory_order_relaxed);
+        }
+    }
+
+    unsigned char* m_buffer = nullptr;         ///< Main buffer.
+    size_t m_capacity = 0;                     ///< Size of m_buffer.
+    size_t m_offset = 0;                       ///< Bytes used in m_buffer.
+    std::vector<OverflowBlock> m_overflow;     ///< Overflow blocks in use, oldest first.
+    size_t m_overflowOffset = 0;               ///< Bytes used in the last overflow block.
+    size_t m_overflowUsed = 0;                 ///< Sizes of the overflow blocks before the last one.
+    std::atomic<size_t> m_used{ 0 };           ///< Current usage, read by getAllStats().
+    std::atomic<size_t> m_peak{ 0 };           ///< Highest usage, read by getAllStats().
+    std::atomic<size_t> m_overflowAllocations{ 0 }; ///< Allocations served by overflow blocks.
+    unsigned m_thread = 0;                     ///< Worker index of the owner.
+};
+
+/**
+ * @class ScratchScope
+ * @brief Rewinds a scratch allocator to where it was when the scope started.
+ *
+ * Usage inside a job: `ScratchScope scratch; float* tmp = scratch->allocateArray<float>(n);`
+ */
+class ScratchScope {
+public:
+    /**
+     * @brief Marks the calling thread's allocator (or @p allocator).
+     */
+    explicit ScratchScope(ScratchAllocator& allocator = ScratchAllocator::get())
+        : m_allocator(allocator), m_marker(allocator.getMarker()) {}
+
+    ~ScratchScope() { m_allocator.rewind(m_marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    /**
+     * @brief Accesses the allocator the scope rewinds.
+     */
+    ScratchAllocator* operator->() { return &m_allocator; }
+
+private:
+    ScratchAllocator& m_allocator;     ///< Allocator to rewind.
+    ScratchAllocator::Marker m_marker; ///< Position at construction.
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @file TaskGraph.h
+ * @brief Declares the dependency graph of fine-grained tasks executed within a frame.
+ */
+
+#include "../Prerequisites.h"
+#include "Jobs/JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief Index of a task inside its TaskGraph.
+ */
+using TaskId = uint32_t;
+
+/**
+ * @struct TaskGraphStats
+ * @brief Timings of the last TaskGraph::execute(), in microseconds.
+ */
+struct TaskGraphStats {
+    double frameTime = 0.0;          ///< Wall time of execute().
+    double criticalPathTime = 0.0;   ///< Longest chain of dependent task durations.
+    double workTime = 0.0;           ///< Sum of all task durations.
+    std::vector<TaskId> criticalPath; ///< Tasks of the longest chain, in execution order.
+
+    /**
+     * @brief Average number of tasks running at once (workTime / frameTime).
+     */
+    double getParallelism() const { return frameTime > 0.0 ? workTime / frameTime : 0.0; }
+};
+
+/**
+ * @class TaskGraph
+ * @brief Tasks with explicit dependencies, run on a JobSystem.
+ *
+ * The graph is built once (addTask / addDependency) and executed every frame. Each
+ * task counts its unfinished predecessors; the task that finishes last releases its
+ * successor, which runs on the same thread if it is the only one released and is
+ * queued otherwise. The calling thread runs tasks too until the whole graph is done.
+ *
+ * Every execution records the start, end and thread of each task and computes the
+ * critical path, the chain of dependent tasks that bounds the frame time however many
+ * workers there are. Captured frames can be written as Chrome trace JSON and opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ */
+class TaskGraph {
+public:
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /**
+     * @brief Adds a task.
+     * @param name Label used in stats and traces.
+     * @param function Work of the task; it may run on any thread.
+     * @return Id used to declare dependencies.
+     */
+    TaskId addTask(const std::string& name, std::function<void()> function);
+
+    /**
+     * @brief Makes @p after wait until @p before has finished.
+     */
+    void addDependency(TaskId before, TaskId after);
+
+    /**
+     * @brief Runs every task once, respecting the dependencies, and returns when all
+     * are done. A dependency cycle is a fatal error.
+     */
+    void execute(JobSystem& jobs);
+
+    /**
+     * @brief Removes every task, the stats of the last execute() and the captured trace.
+     *
+     * A running trace stops; call beginTrace() again to trace the new tasks.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of tasks.
+     */
+    size_t getTaskCount() const { return m_tasks.size(); }
+
+    /**
+     * @brief Returns the name given to @p task.
+     */
+    const std::string& getTaskName(TaskId task) const { return m_tasks[task].name; }
+
+    /**
+     * @brief Returns the timings of the last execute().
+     */
+    const TaskGraphStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Starts recording the tasks of every following execute().
+     */
+    void beginTrace();
+
+    /**
+     * @brief Stops recording and writes the captured frames as Chrome trace JSON.
+     * @return false if the file could not be written.
+     */
+    bool endTrace(const std::string& path);
+
+    /**
+     * @brief Writes the captured frames as Chrome trace JSON to @p output.
+     */
+    void writeTrace(std::ostream& output) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Static description of a task.
+     */
+    struct Task {
+        std::string name;               ///< Label.
+        std::function<void()> function; ///< Work.
+        std::vector<TaskId> successors; ///< Tasks waiting for this one.
+        uint32_t predecessorCount = 0;  ///< Number of tasks this one waits for.
+    };
+
+    /**
+     * @brief What one task did during the last execute().
+     */
+    struct TaskRun {
+        int64_t start = 0;   ///< Nanoseconds since the start of execute().
+        int64_t end = 0;     ///< Nanoseconds since the start of execute().
+        unsigned thread = 0; ///< JobSystem::getCurrentWorkerIndex() of the runner.
+    };
+
+    /**
+     * @brief A recorded task for the trace.
+     */
+    struct TraceEvent {
+        TaskId task;       ///< Task that ran.
+        double start;      ///< Microseconds since beginTrace().
+        double duration;   ///< Microseconds.
+        unsigned thread;   ///< Thread that ran it.
+        bool critical;     ///< Whether it was on that frame's critical path.
+    };
+
+    /**
+     * @brief Orders the tasks topologically; fatal error on a cycle.
+     */
+    void validate();
+
+    /**
+     * @brief Queues @p task on the job system.
+     */
+    void submit(TaskId task);
+
+    /**
+     * @brief Runs @p task and then every successor it releases alone.
+     */
+    void run(TaskId task);
+
+    /**
+     * @brief Fills m_stats from m_runs.
+     */
+    void computeStats(double frameTime);
+
+    /**
+     * @brief Appends the last execute() to the trace.
+     */
+    void recordTrace();
+
+    std::vector<Task> m_tasks;                       ///< Tasks in creation order.
+    std::vector<TaskId> m_roots;                     ///< Tasks without predecessors.
+    std::vector<TaskId> m_order;                     ///< Topological order.
+    bool m_validated = false;                        ///< m_roots / m_order are current.
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_pending; ///< Unfinished predecessors per task.
+    std::vector<TaskRun> m_runs;                     ///< Per-task record of the last execute().
+    std::atomic<uint32_t> m_remaining{ 0 };          ///< Tasks not finished yet.
+    JobSystem* m_jobs = nullptr;                     ///< Pool of the running execute().
+    Clock::time_point m_frameStart;                  ///< Start of the running execute().
+
+    TaskGraphStats m_stats;                          ///< Timings of the last execute().
+
+    bool m_tracing = false;                          ///< Set between beginTrace() and endTrace().
+    Clock::time_point m_traceStart;                  ///< Time origin of the trace.
+    std::vector<TraceEvent> m_trace;                 ///< Captured tasks.
+};
@@ -30,6 +30,9 @@
 
 namespace EngineUtilities {
 
+    template<typename T>
+    class TWeakPointer;
+
     /**
      * @brief Shared pointer class for automatic reference counting memory management.
      *
@@ -236,6 +239,12 @@ namespace EngineUtilities {
             return TSharedPointer<U>();
         }
 
+        template<typename U>
+        friend class TSharedPointer;   ///< Converting constructor reads other specializations.
+
+        template<typename U>
+        friend class TWeakPointer;     ///< Weak pointers observe ptr and refCount.
+
     private:
         T* ptr;           ///< Managed object pointer.
         int* refCount;    ///< Reference count pointer.
@@ -0,0 +1,229 @@
+#pragma once
+
+/**
+ * @file BitStream.h
+ * @brief Declares bit-level writer and reader over fixed-size byte buffers.
+ */
+
+#include "Prerequisites.h"
+#include <SFML/Config.hpp>
+#include <cstring>
+
+/**
+ * @class BitWriter
+ * @brief Packs values with an arbitrary number of bits into a caller-owned buffer.
+ *
+ * Bits are written least significant first, which makes the byte layout the same
+ * on every platform. The writer never writes past its capacity: a write that does
+ * not fit sets the overflow flag and every later write is ignored.
+ */
+class BitWriter {
+public:
+    /**
+     * @brief Creates a writer without a buffer; every write overflows.
+     */
+    BitWriter() = default;
+
+    /**
+     * @brief Creates a writer over a buffer.
+     * @param data Destination buffer.
+     * @param capacityBytes Size of the buffer in bytes.
+     */
+    BitWriter(sf::Uint8* data, uint32_t capacityBytes)
+        : m_data(data), m_capacityBits(capacityBytes * 8) {
+    }
+
+    /**
+     * @brief Writes the low @p bits bits of a value.
+     * @param value Value to write.
+     * @param bits Number of bits, 1 to 32.
+     */
+    void writeBits(uint32_t value, int bits) {
+        if (m_overflow || m_bitPosition + bits > m_capacityBits) {
+            m_overflow = true;
+            return;
+        }
+        const uint64_t mask = (bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1ull);
+        m_scratch |= (static_cast<uint64_t>(value) & mask) << m_scratchBits;
+        m_scratchBits += bits;
+        m_bitPosition += bits;
+        while (m_scratchBits >= 8) {
+            m_data[m_byteIndex++] = static_cast<sf::Uint8>(m_scratch);
+            m_scratch >>= 8;
+            m_scratchBits -= 8;
+        }
+    }
+
+    void writeBool(bool value) { writeBits(value ? 1u : 0u, 1); }
+    void writeUint8(sf::Uint8 value) { writeBits(value, 8); }
+    void writeUint16(sf::Uint16 value) { writeBits(value, 16); }
+    void writeUint32(sf::Uint32 value) { writeBits(value, 32); }
+
+    /**
+     * @brief Writes the raw 32 bits of a float.
+     */
+    void writeFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeBits(bits, 32);
+    }
+
+    /**
+     * @brief Writes a float clamped to [min, max] and quantized to @p bits bits.
+     * @param value Value to write.
+     * @param min Lower bound of the range.
+     * @param max Upper bound of the range.
+     * @param bits Precision, 1 to 32 bits.
+     */
+    void writeQuantized(float value, float min, float max, int bits) {
+        const float clamped = value < min ? min : (value > max ? max : value);
+        const double steps = static_cast<double>((bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1ull));
+        const double normalized = (static_cast<double>(clamped) - min) / (static_cast<double>(max) - min);
+        writeBits(static_cast<uint32_t>(normalized * steps + 0.5), bits);
+    }
+
+    /**
+     * @brief Pads with zero bits up to the next byte boundary.
+     */
+    void alignToByte() {
+        const int padding = (8 - static_cast<int>(m_bitPosition % 8)) % 8;
+        if (padding > 0) {
+            writeBits(0, padding);
+        }
+    }
+
+    /**
+     * @brief Stores the pending partial byte, if any.
+     * @return Number of bytes used so far.
+     */
+    uint32_t flush() {
+        if (m_scratchBits > 0 && !m_overflow) {
+            // The partial byte is rewritten by later writes, so flushing more than once is safe.
+            m_data[m_byteIndex] = static_cast<sf::Uint8>(m_scratch);
+        }
+        return getBytesWritten();
+    }
+
+    /**
+     * @brief Returns the number of bytes touched by the written bits.
+     */
+    uint32_t getBytesWritten() const { return (m_bitPosition + 7) / 8; }
+
+    /**
+     * @brief Returns the number of bits written.
+     */
+    uint32_t getBitsWritten() const { return m_bitPosition; }
+
+    /**
+     * @brief Returns true if a write did not fit in the buffer.
+     */
+    bool hasOverflowed() const { return m_overflow; }
+
+private:
+    sf::Uint8* m_data = nullptr; ///< Destination buffer.
+    uint32_t m_capacityBits = 0; ///< Buffer size in bits.
+    uint32_t m_bitPosition = 0;  ///< Bits written so far.
+    uint32_t m_byteIndex = 0;    ///< Next byte to store.
+    uint64_t m_scratch = 0;      ///< Bits not yet stored.
+    int m_scratchBits = 0;       ///< Number of valid bits in m_scratch.
+    bool m_overflow = false;     ///< Set when a write did not fit.
+};
+
+/**
+ * @class BitReader
+ * @brief Reads values written by BitWriter.
+ *
+ * Reading past the end sets the overflow flag and returns zeros, so a truncated
+ * or malicious datagram can be detected after parsing instead of on every field.
+ */
+class BitReader {
+public:
+    /**
+     * @brief Creates a reader without data; every read overflows.
+     */
+    BitReader() = default;
+
+    /**
+     * @brief Creates a reader over a buffer.
+     * @param data Source bytes.
+     * @param sizeBytes Number of valid bytes.
+     */
+    BitReader(const sf::Uint8* data, uint32_t sizeBytes)
+        : m_data(data), m_sizeBits(sizeBytes * 8) {
+    }
+
+    /**
+     * @brief Reads @p bits bits.
+     * @param bits Number of bits, 1 to 32.
+     * @return The value, or 0 on overflow.
+     */
+    uint32_t readBits(int bits) {
+        if (m_overflow || m_bitPosition + bits > m_sizeBits) {
+            m_overflow = true;
+            return 0;
+        }
+        while (m_scratchBits < bits) {
+            m_scratch |= static_cast<uint64_t>(m_data[m_byteIndex++]) << m_scratchBits;
+            m_scratchBits += 8;
+        }
+        const uint64_t mask = (bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1ull);
+        const uint32_t value = static_cast<uint32_t>(m_scratch & mask);
+        m_scratch >>= bits;
+        m_scratchBits -= bits;
+        m_bitPosition += bits;
+        return value;
+    }
+
+    bool readBool() { return readBits(1) != 0; }
+    sf::Uint8 readUint8() { return static_cast<sf::Uint8>(readBits(8)); }
+    sf::Uint16 readUint16() { return static_cast<sf::Uint16>(readBits(16)); }
+    sf::Uint32 readUint32() { return readBits(32); }
+
+    /**
+     * @brief Reads a float written with BitWriter::writeFloat.
+     */
+    float readFloat() {
+        const uint32_t bits = readBits(32);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Reads a float written with BitWriter::writeQuantized using the same range and bits.
+     */
+    float readQuantized(float min, float max, int bits) {
+        const double steps = static_cast<double>((bits == 32) ? 0xFFFFFFFFull : ((1ull << bits) - 1ull));
+        const double normalized = readBits(bits) / steps;
+        return static_cast<float>(min + normalized * (static_cast<double>(max) - min));
+    }
+
+    /**
+     * @brief Skips the padding written by BitWriter::alignToByte.
+     */
+    void alignToByte() {
+        const int padding = (8 - static_cast<int>(m_bitPosition % 8)) % 8;
+        if (padding > 0) {
+            readBits(padding);
+        }
+    }
+
+    /**
+     * @brief Returns the number of bits not read yet.
+     */
+    uint32_t getBitsRemaining() const { return m_sizeBits - m_bitPosition; }
+
+    /**
+     * @brief Returns true if a read went past the end of the data.
+     */
+    bool hasOverflowed() const { return m_overflow; }
+
+private:
+    const sf::Uint8* m_data = nullptr; ///< Source bytes.
+    uint32_t m_sizeBits = 0;           ///< Data size in bits.
+    uint32_t m_bitPosition = 0;        ///< Bits read so far.
+    uint32_t m_byteIndex = 0;          ///< Next byte to load.
+    uint64_t m_scratch = 0;            ///< Loaded bits not returned yet.
+    int m_scratchBits = 0;             ///< Number of valid bits in m_scratch.
+    bool m_overflow = false;           ///< Set when a read went past the end.
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file LocalAuthorityServer.h
+ * @brief Declares a loopback server stand-in that owns the authoritative movement state.
+ */
+
+#include "Prerequisites.h"
+#include "Network/MovementPrediction.h"
+#include <deque>
+
+/**
+ * @class LocalAuthorityServer
+ * @brief Minimal authoritative server for one predicted actor, reached over UDP.
+ *
+ * It applies received MovementCommands in sequence order with the same
+ * MovementSimulation step as the client, and answers with MovementState datagrams.
+ * Answers can be held back a number of ticks to emulate latency, and the position
+ * can be pushed or clamped on the server only, which the client cannot predict.
+ */
+class LocalAuthorityServer {
+public:
+    /**
+     * @brief Creates the server.
+     * @param spawnPosition Initial authoritative position.
+     * @param latencyTicks Server ticks each state waits before being sent.
+     */
+    LocalAuthorityServer(const sf::Vector2f& spawnPosition, unsigned int latencyTicks = 0);
+
+    /**
+     * @brief Binds the server socket on the loopback interface.
+     * @param port Port to bind, AnyPort by default.
+     * @return true if the socket was bound.
+     */
+    bool bind(unsigned short port = sf::Socket::AnyPort);
+
+    /**
+     * @brief Returns the bound port.
+     */
+    unsigned short getPort() const { return m_socket.getLocalPort(); }
+
+    /**
+     * @brief Receives commands, simulates them and sends the states that are due.
+     */
+    void tick();
+
+    /**
+     * @brief Moves the authoritative position (knockback, teleport...).
+     * @param offset Displacement applied on the server only.
+     */
+    void applyImpulse(const sf::Vector2f& offset) { m_position += offset; }
+
+    /**
+     * @brief Returns the authoritative position.
+     */
+    const sf::Vector2f& getPosition() const { return m_position; }
+
+    /**
+     * @brief Returns the last command applied.
+     */
+    sf::Uint32 getLastProcessedSequence() const { return m_lastProcessed; }
+
+private:
+    /**
+     * @brief State waiting for its emulated latency to elapse.
+     */
+    struct DelayedState {
+        unsigned int sendTick; ///< Server tick at which the state is sent.
+        MovementState state;   ///< State to send.
+    };
+
+    sf::UdpSocket m_socket;               ///< Server socket.
+    sf::IpAddress m_clientAddress;        ///< Learnt from the first command packet.
+    unsigned short m_clientPort = 0;      ///< Learnt from the first command packet.
+    sf::Vector2f m_position;              ///< Authoritative position.
+    sf::Uint32 m_lastProcessed = 0;       ///< Last command applied.
+    unsigned int m_latencyTicks = 0;      ///< Emulated one-way latency.
+    unsigned int m_tick = 0;              ///< Server ticks so far.
+    std::deque<DelayedState> m_outgoing;  ///< States waiting for their send tick.
+    sf::Packet m_packet;                  ///< Reused datagram buffer.
+};
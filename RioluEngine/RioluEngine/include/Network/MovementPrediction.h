@@ -0,0 +1,185 @@
+#pragma once
+
+/**
+ * @file MovementPrediction.h
+ * @brief Declares the deterministic movement step and client-side prediction with reconciliation.
+ */
+
+#include "Prerequisites.h"
+#include "ECS/Transform.h"
+#include <SFML/Network.hpp>
+#include <array>
+
+/**
+ * @struct MovementCommand
+ * @brief One fixed-step input of an owned actor: "seek this target".
+ */
+struct MovementCommand {
+    sf::Uint32 sequence = 0; ///< Increasing command number, used for acknowledgement.
+    sf::Vector2f target;     ///< Seek target.
+    float speed = 0.f;       ///< Seek speed in units/second.
+    float range = 0.f;       ///< Distance at which the actor stops.
+};
+
+/**
+ * @struct MovementState
+ * @brief Authoritative state sent by the server.
+ */
+struct MovementState {
+    sf::Uint32 lastProcessedSequence = 0; ///< Last command applied to the position.
+    sf::Vector2f position;                ///< Authoritative position after that command.
+};
+
+sf::Packet& operator<<(sf::Packet& packet, const MovementCommand& command);
+sf::Packet& operator>>(sf::Packet& packet, MovementCommand& command);
+sf::Packet& operator<<(sf::Packet& packet, const MovementState& state);
+sf::Packet& operator>>(sf::Packet& packet, MovementState& state);
+
+/**
+ * @class MovementSimulation
+ * @brief Deterministic simulation step shared by the client and the server.
+ *
+ * Every command advances the simulation by exactly FixedStep seconds through
+ * Transform::seekStep, so replaying the same commands from the same position
+ * always produces the same result.
+ */
+class MovementSimulation {
+public:
+    /**
+     * @brief Duration of one simulation step, in seconds.
+     */
+    static constexpr float FixedStep = 1.f / 60.f;
+
+    /**
+     * @brief Applies one command to a position.
+     * @param position Position before the step.
+     * @param command Command to apply.
+     * @return Position after the step.
+     */
+    static sf::Vector2f step(const sf::Vector2f& position, const MovementCommand& command);
+};
+
+/**
+ * @struct PredictionSettings
+ * @brief Tuning values of ClientPrediction.
+ */
+struct PredictionSettings {
+    static constexpr unsigned int MaxRedundancy = 255; ///< The packet stores the command count in one byte.
+
+    float smoothingRate = 12.f;   ///< Exponential decay rate (1/s) of the visual error.
+    float snapDistance = 150.f;   ///< Errors larger than this are snapped instead of smoothed.
+    unsigned int redundancy = 8;  ///< Unacknowledged commands resent in every packet (at most MaxRedundancy).
+};
+
+/**
+ * @struct PredictionStats
+ * @brief Counters exposed by ClientPrediction.
+ */
+struct PredictionStats {
+    uint64_t commandsIssued = 0;    ///< Commands created and predicted locally.
+    uint64_t statesReceived = 0;    ///< Authoritative states processed.
+    uint64_t corrections = 0;       ///< States that disagreed with the prediction.
+    uint64_t replayedCommands = 0;  ///< Commands re-simulated during reconciliation.
+    uint64_t snaps = 0;             ///< Corrections too large to smooth.
+    float lastError = 0.f;          ///< Size of the last correction.
+    float maxError = 0.f;           ///< Largest correction seen.
+};
+
+/**
+ * @class ClientPrediction
+ * @brief Predicts an owned actor locally and reconciles it with the server.
+ *
+ * Input is sampled at MovementSimulation::FixedStep. Every command is applied to the
+ * predicted position immediately, stored in a fixed-size history and sent to the server.
+ * When an authoritative state arrives, the acknowledged commands are dropped, the
+ * prediction restarts from the server position and the remaining commands are replayed.
+ * The jump between the old and the new prediction becomes a visual offset that decays
+ * over time, so the Transform moves smoothly while the simulation stays exact.
+ */
+class ClientPrediction {
+public:
+    /**
+     * @brief Creates the prediction for an owned actor.
+     * @param transform Transform that receives the smoothed position.
+     * @param settings Tuning values.
+     */
+    ClientPrediction(const EngineUtilities::TSharedPointer<Transform>& transform,
+                     const PredictionSettings& settings = PredictionSettings());
+
+    /**
+     * @brief Advances local time, issuing one command per elapsed fixed step.
+     * @param deltaTime Frame time in seconds.
+     * @param target Current seek target of the player.
+     * @param speed Seek speed.
+     * @param range Stop distance.
+     * @return Number of commands issued this frame.
+     */
+    int update(float deltaTime, const sf::Vector2f& target, float speed, float range);
+
+    /**
+     * @brief Applies an authoritative state: drops acknowledged commands and replays the rest.
+     * @param state State received from the server.
+     */
+    void reconcile(const MovementState& state);
+
+    /**
+     * @brief Sends the unacknowledged commands (up to the redundancy setting).
+     * @param socket Client socket.
+     * @param address Server address.
+     * @param port Server port.
+     */
+    void sendCommands(sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port);
+
+    /**
+     * @brief Reads every pending state from a non-blocking socket and reconciles with each.
+     * @param socket Client socket.
+     * @return Number of states processed.
+     */
+    int receiveStates(sf::UdpSocket& socket);
+
+    /**
+     * @brief Returns the simulated (unsmoothed) position.
+     */
+    const sf::Vector2f& getPredictedPosition() const { return m_predictedPosition; }
+
+    /**
+     * @brief Returns the position written into the Transform (prediction + decaying error).
+     */
+    sf::Vector2f getVisualPosition() const { return m_predictedPosition + m_errorOffset; }
+
+    /**
+     * @brief Returns the number of commands waiting for acknowledgement.
+     */
+    size_t getPendingCount() const { return m_historyCount; }
+
+    /**
+     * @brief Returns the prediction counters.
+     */
+    const PredictionStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Maximum number of unacknowledged commands kept for replay.
+     */
+    static constexpr size_t HistoryCapacity = 256;
+
+private:
+    /**
+     * @brief Returns the i-th oldest command of the history.
+     */
+    const MovementCommand& historyAt(size_t index) const {
+        return m_history[(m_historyStart + index) % HistoryCapacity];
+    }
+
+    EngineUtilities::TSharedPointer<Transform> m_transform;  ///< Transform driven by the prediction.
+    PredictionSettings m_settings;                          ///< Tuning values.
+    std::array<MovementCommand, HistoryCapacity> m_history; ///< Ring of unacknowledged commands.
+    size_t m_historyStart = 0;                              ///< Index of the oldest command.
+    size_t m_historyCount = 0;                              ///< Commands in the ring.
+    sf::Uint32 m_nextSequence = 1;                          ///< Sequence of the next command.
+    sf::Uint32 m_lastAcknowledged = 0;                      ///< Last sequence confirmed by the server.
+    sf::Vector2f m_predictedPosition;                       ///< Exact simulation state.
+    sf::Vector2f m_errorOffset;                             ///< Visual error still being smoothed out.
+    float m_accumulator = 0.f;                              ///< Time not yet consumed by fixed steps.
+    PredictionStats m_stats;                                ///< Counters.
+    sf::Packet m_packet;                                    ///< Reused outgoing packet.
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file PacketBatcher.h
+ * @brief Declares batching of many small messages into pooled datagrams.
+ */
+
+#include "Prerequisites.h"
+#include "Network/PacketPool.h"
+#include "Network/BitStream.h"
+#include <SFML/Network.hpp>
+
+/**
+ * @struct PacketBatcherStats
+ * @brief Counters of a PacketBatcher.
+ */
+struct PacketBatcherStats {
+    uint64_t messages = 0;  ///< Messages committed.
+    uint64_t datagrams = 0; ///< Datagrams handed to the socket.
+    uint64_t bytes = 0;     ///< Bytes handed to the socket.
+    uint64_t dropped = 0;   ///< Messages lost to overflow or pool exhaustion.
+};
+
+/**
+ * @class PacketBatcher
+ * @brief Packs messages for one destination into pooled blocks, one socket send per block.
+ *
+ * Each message is stored as a 16-bit byte length followed by its bit-packed payload.
+ * beginMessage() returns a BitWriter placed directly inside the current block, so
+ * messages are serialized in place without intermediate buffers. When the next
+ * message may not fit, the block is sent and a new one is taken from the pool.
+ *
+ * Usage:
+ * @code
+ * BitWriter writer = batcher.beginMessage(16);
+ * writer.writeUint32(id);
+ * writer.writeFloat(x);
+ * batcher.endMessage(writer);
+ * ...
+ * batcher.flush();
+ * @endcode
+ */
+class PacketBatcher {
+public:
+    /**
+     * @brief Creates a batcher for one destination.
+     * @param pool Pool providing the datagram blocks.
+     * @param socket Socket used to send.
+     * @param address Destination address.
+     * @param port Destination port.
+     */
+    PacketBatcher(PacketPool& pool, sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port);
+
+    /**
+     * @brief Sends what is left and returns the block to the pool.
+     */
+    ~PacketBatcher();
+
+    PacketBatcher(const PacketBatcher&) = delete;
+    PacketBatcher& operator=(const PacketBatcher&) = delete;
+
+    /**
+     * @brief Reserves room for a message and returns a writer over it.
+     * @param maxBytes Upper bound of the payload size.
+     * @return Writer placed inside the current block (overflows if no block is available).
+     */
+    BitWriter beginMessage(uint32_t maxBytes);
+
+    /**
+     * @brief Commits the message written through @p writer.
+     * @param writer Writer returned by the matching beginMessage().
+     * @return false if the message overflowed and was discarded.
+     */
+    bool endMessage(BitWriter& writer);
+
+    /**
+     * @brief Sends the current block if it holds any message.
+     */
+    void flush();
+
+    /**
+     * @brief Returns the counters.
+     */
+    const PacketBatcherStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Receives one datagram into a block taken from @p pool.
+     *
+     * The caller owns the returned block and must release it to the pool.
+     *
+     * @param socket Socket to read from.
+     * @param pool Pool that provides the block.
+     * @param sender Receives the sender address.
+     * @param senderPort Receives the sender port.
+     * @return The filled block, or nullptr if nothing was received or the pool is empty.
+     */
+    static PacketBlock* receive(sf::UdpSocket& socket, PacketPool& pool,
+                                sf::IpAddress& sender, unsigned short& senderPort);
+
+    /**
+     * @brief Bytes of the length prefix stored before every message.
+     */
+    static constexpr uint32_t MessageHeaderSize = 2;
+
+private:
+    PacketPool& m_pool;           ///< Source of datagram blocks.
+    sf::UdpSocket& m_socket;      ///< Socket used to send.
+    sf::IpAddress m_address;      ///< Destination address.
+    unsigned short m_port;        ///< Destination port.
+    PacketBlock* m_block = nullptr; ///< Block being filled.
+    PacketBatcherStats m_stats;   ///< Counters.
+};
+
+/**
+ * @class MessageIterator
+ * @brief Walks the messages of a datagram built by PacketBatcher.
+ */
+class MessageIterator {
+public:
+    /**
+     * @brief Starts iterating a received block.
+     * @param block Block returned by PacketBatcher::receive.
+     */
+    explicit MessageIterator(const PacketBlock& block) : m_block(block) {}
+
+    /**
+     * @brief Moves to the next message.
+     * @param reader Receives a reader limited to the message payload.
+     * @return false when there are no more messages or the framing is corrupt.
+     */
+    bool next(BitReader& reader);
+
+private:
+    const PacketBlock& m_block; ///< Datagram being read.
+    uint32_t m_offset = 0;      ///< Byte offset of the next message header.
+};
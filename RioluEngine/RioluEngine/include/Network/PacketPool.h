@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file PacketPool.h
+ * @brief Declares a pool of fixed-capacity, preallocated datagram buffers.
+ */
+
+#include "Prerequisites.h"
+#include <SFML/Config.hpp>
+
+/**
+ * @struct PacketBlock
+ * @brief One datagram-sized buffer owned by a PacketPool.
+ */
+struct PacketBlock {
+    sf::Uint8* data = nullptr; ///< Start of the block inside the pool storage.
+    uint32_t capacity = 0;     ///< Size of the block in bytes.
+    uint32_t size = 0;         ///< Bytes currently used.
+    uint32_t index = 0;        ///< Position of the block inside its pool.
+};
+
+/**
+ * @struct PacketPoolStats
+ * @brief Usage counters of a PacketPool.
+ */
+struct PacketPoolStats {
+    uint64_t acquired = 0;  ///< Successful acquire() calls.
+    uint64_t exhausted = 0; ///< acquire() calls that found no free block.
+    size_t inUse = 0;       ///< Blocks currently handed out.
+    size_t peakInUse = 0;   ///< Highest inUse value seen.
+};
+
+/**
+ * @class PacketPool
+ * @brief Hands out datagram buffers carved from one allocation made at construction.
+ *
+ * acquire() and release() only move an index on a free list, so sending or
+ * receiving through the pool never touches the heap. The pool does not grow:
+ * when every block is in use acquire() returns nullptr and the caller decides
+ * whether to drop, flush or wait.
+ */
+class PacketPool {
+public:
+    /**
+     * @brief Preallocates the blocks.
+     * @param blockSize Capacity of every block in bytes (1200 stays under common MTUs).
+     * @param blockCount Number of blocks.
+     */
+    PacketPool(uint32_t blockSize = 1200, uint32_t blockCount = 256);
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    /**
+     * @brief Takes a free block, with its size reset to zero.
+     * @return The block, or nullptr if the pool is exhausted.
+     */
+    PacketBlock* acquire();
+
+    /**
+     * @brief Returns a block to the pool.
+     * @param block Block obtained from this pool's acquire().
+     */
+    void release(PacketBlock* block);
+
+    /**
+     * @brief Returns the capacity of each block.
+     */
+    uint32_t getBlockSize() const { return m_blockSize; }
+
+    /**
+     * @brief Returns the number of free blocks.
+     */
+    size_t getAvailable() const { return m_freeList.size(); }
+
+    /**
+     * @brief Returns the usage counters.
+     */
+    const PacketPoolStats& getStats() const { return m_stats; }
+
+private:
+    uint32_t m_blockSize;              ///< Capacity of every block.
+    std::vector<sf::Uint8> m_storage;  ///< Backing memory of all blocks.
+    std::vector<PacketBlock> m_blocks; ///< Block descriptors.
+    std::vector<uint32_t> m_freeList;  ///< Indices of the free blocks (used as a stack).
+    PacketPoolStats m_stats;           ///< Usage counters.
+};
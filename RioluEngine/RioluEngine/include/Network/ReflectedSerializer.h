@@ -0,0 +1,210 @@
+#pragma once
+
+/**
+ * @file ReflectedSerializer.h
+ * @brief Declares bit-stream serializers generated from component reflection.
+ */
+
+#include "Prerequisites.h"
+#include "ECS/Reflection.h"
+#include "Network/BitStream.h"
+
+/**
+ * @class ReflectedSerializer
+ * @brief Writes and reads the fields of a reflected type whose flags match @p Mask.
+ *
+ * Field selection, order and encoding are resolved at compile time: each call
+ * expands to the same straight-line writes a hand-written serializer would do,
+ * through member pointers, without names or type switches at run time.
+ *
+ * The delta functions prefix every selected field with one bit telling whether it
+ * differs from a baseline (both sides must hold the same baseline, e.g. the last
+ * acknowledged state).
+ */
+template<uint32_t Mask>
+class ReflectedSerializer {
+public:
+    /**
+     * @brief Writes the selected fields of @p value.
+     */
+    template<Reflected T>
+    static void
+    write(BitWriter& writer, const T& value) {
+        writeFields(writer, value, std::make_index_sequence<FieldCount<T>>());
+    }
+
+    /**
+     * @brief Reads the selected fields into @p value; other fields are left untouched.
+     */
+    template<Reflected T>
+    static void
+    read(BitReader& reader, T& value) {
+        readFields(reader, value, std::make_index_sequence<FieldCount<T>>());
+    }
+
+    /**
+     * @brief Writes the selected fields of @p value that differ from @p baseline.
+     * @return Number of fields written.
+     */
+    template<Reflected T>
+    static uint32_t
+    writeDelta(BitWriter& writer, const T& baseline, const T& value) {
+        return writeDeltaFields(writer, baseline, value, std::make_index_sequence<FieldCount<T>>());
+    }
+
+    /**
+     * @brief Reads a delta written against @p baseline into @p value.
+     */
+    template<Reflected T>
+    static void
+    readDelta(BitReader& reader, const T& baseline, T& value) {
+        value = baseline;
+        readDeltaFields(reader, value, std::make_index_sequence<FieldCount<T>>());
+    }
+
+    /**
+     * @brief Most bits write() produces for one @p T.
+     */
+    template<Reflected T>
+    static constexpr uint32_t
+    bits() {
+        return serializedBits<T>(Mask);
+    }
+
+private:
+    template<typename T, size_t... I>
+    static void
+    writeFields(BitWriter& writer, const T& value, std::index_sequence<I...>) {
+        (writeField<T, I>(writer, value), ...);
+    }
+
+    template<typename T, size_t... I>
+    static void
+    readFields(BitReader& reader, T& value, std::index_sequence<I...>) {
+        (readField<T, I>(reader, value), ...);
+    }
+
+    template<typename T, size_t... I>
+    static uint32_t
+    writeDeltaFields(BitWriter& writer, const T& baseline, const T& value, std::index_sequence<I...>) {
+        return (0u + ... + writeDeltaField<T, I>(writer, baseline, value));
+    }
+
+    template<typename T, size_t... I>
+    static void
+    readDeltaFields(BitReader& reader, T& value, std::index_sequence<I...>) {
+        (readDeltaField<T, I>(reader, value), ...);
+    }
+
+    template<typename T, size_t I>
+    static void
+    writeField(BitWriter& writer, const T& value) {
+        constexpr auto field = std::get<I>(Reflect<T>::fields);
+        if constexpr ((field.flags & Mask) != 0) {
+            writeValue<field.flags>(writer, field.get(value), field.min, field.max, field.bits);
+        }
+    }
+
+    template<typename T, size_t I>
+    static void
+    readField(BitReader& reader, T& value) {
+        constexpr auto field = std::get<I>(Reflect<T>::fields);
+        if constexpr ((field.flags & Mask) != 0) {
+            readValue<field.flags>(reader, field.get(value), field.min, field.max, field.bits);
+        }
+    }
+
+    template<typename T, size_t I>
+    static uint32_t
+    writeDeltaField(BitWriter& writer, const T& baseline, const T& value) {
+        constexpr auto field = std::get<I>(Reflect<T>::fields);
+        if constexpr ((field.flags & Mask) != 0) {
+            using Value = typename std::remove_cvref_t<decltype(field)>::ValueType;
+            // Bitwise comparison: a NaN or -0 written by the game is still sent once.
+            const bool changed = std::memcmp(&field.get(value), &field.get(baseline), sizeof(Value)) != 0;
+            writer.writeBool(changed);
+            if (changed) {
+                writeValue<field.flags>(writer, field.get(value), field.min, field.max, field.bits);
+            }
+            return changed ? 1u : 0u;
+        }
+        else {
+            return 0u;
+        }
+    }
+
+    template<typename T, size_t I>
+    static void
+    readDeltaField(BitReader& reader, T& value) {
+        constexpr auto field = std::get<I>(Reflect<T>::fields);
+        if constexpr ((field.flags & Mask) != 0) {
+            if (reader.readBool()) {
+                readValue<field.flags>(reader, field.get(value), field.min, field.max, field.bits);
+            }
+        }
+    }
+
+    template<uint32_t Flags>
+    static void
+    writeFloat(BitWriter& writer, float value, float min, float max, uint8_t bits) {
+        if constexpr ((Flags & FieldQuantized) != 0) {
+            writer.writeQuantized(value, min, max, bits);
+        }
+        else {
+            writer.writeFloat(value);
+        }
+    }
+
+    template<uint32_t Flags>
+    static float
+    readFloat(BitReader& reader, float min, float max, uint8_t bits) {
+        if constexpr ((Flags & FieldQuantized) != 0) {
+            return reader.readQuantized(min, max, bits);
+        }
+        else {
+            return reader.readFloat();
+        }
+    }
+
+    template<uint32_t Flags, typename Value>
+    static void
+    writeValue(BitWriter& writer, const Value& value, float min, float max, uint8_t bits) {
+        if constexpr (std::is_same_v<Value, float>) {
+            writeFloat<Flags>(writer, value, min, max, bits);
+        }
+        else if constexpr (std::is_same_v<Value, sf::Vector2f>) {
+            writeFloat<Flags>(writer, value.x, min, max, bits);
+            writeFloat<Flags>(writer, value.y, min, max, bits);
+        }
+        else if constexpr (std::is_same_v<Value, sf::Color>) {
+            writer.writeUint32(value.toInteger());
+        }
+        else if constexpr (std::is_same_v<Value, bool>) {
+            writer.writeBool(value);
+        }
+        else {
+            writer.writeBits(static_cast<uint32_t>(value), FieldTraits<Value>::bits);
+        }
+    }
+
+    template<uint32_t Flags, typename Value>
+    static void
+    readValue(BitReader& reader, Value& value, float min, float max, uint8_t bits) {
+        if constexpr (std::is_same_v<Value, float>) {
+            value = readFloat<Flags>(reader, min, max, bits);
+        }
+        else if constexpr (std::is_same_v<Value, sf::Vector2f>) {
+            value.x = readFloat<Flags>(reader, min, max, bits);
+            value.y = readFloat<Flags>(reader, min, max, bits);
+        }
+        else if constexpr (std::is_same_v<Value, sf::Color>) {
+            value = sf::Color(reader.readUint32());
+        }
+        else if constexpr (std::is_same_v<Value, bool>) {
+            value = reader.readBool();
+        }
+        else {
+            value = static_cast<Value>(reader.readBits(FieldTraits<Value>::bits));
+        }
+    }
+};
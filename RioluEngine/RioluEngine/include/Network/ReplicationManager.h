@@ -0,0 +1,263 @@
+#pragma once
+
+/**
+ * @file ReplicationManager.h
+ * @brief Declares the server-side replication manager with per-client interest management.
+ */
+
+#include "Prerequisites.h"
+#include "ECS/Actor.h"
+#include "Network/ReflectedSerializer.h"
+#include "Utilities/SpatialGrid.h"
+#include <SFML/Network.hpp>
+
+/**
+ * @brief Identifier of a replicated actor, shared by the server and its clients.
+ */
+using NetworkId = uint32_t;
+
+/**
+ * @brief Identifier of a connected client.
+ */
+using ClientId = uint32_t;
+
+/**
+ * @struct ReplicationSettings
+ * @brief Tuning values for relevance, prioritisation and bandwidth.
+ */
+struct ReplicationSettings {
+    float defaultViewRadius = 800.f;      ///< Relevance radius of a client that did not set one.
+    uint32_t bytesPerClientPerTick = 1200; ///< Payload budget of a client packet (about one MTU).
+    float minDistanceFactor = 0.1f;       ///< Priority factor of an actor at the edge of the view.
+    float velocityWeight = 0.01f;         ///< Extra priority per world unit/second of speed.
+    float enterPriority = 1000.f;         ///< Accumulator given to an actor entering a view.
+};
+
+/**
+ * @struct ReplicationStats
+ * @brief Counters of the last call to ReplicationManager::tick / send.
+ */
+struct ReplicationStats {
+    uint64_t relevantPairs = 0;  ///< Sum over clients of relevant actors.
+    uint64_t updatesSent = 0;    ///< Actor states written into client packets.
+    uint64_t updatesDeferred = 0;///< Relevant actors left for a later tick by the byte budget.
+    uint64_t removalsSent = 0;   ///< Actors that left a client's view this tick.
+    uint64_t bytesWritten = 0;   ///< Payload bytes written into client packets.
+    uint64_t bytesSent = 0;      ///< Payload bytes handed to the socket by send().
+    float relevanceMicros = 0.f; ///< Grid rebuild and relevance queries.
+    float priorityMicros = 0.f;  ///< Accumulator update and top-N selection.
+    float serializeMicros = 0.f; ///< Packet writing.
+    float sendMicros = 0.f;      ///< Time spent inside UdpSocket::send.
+};
+
+/**
+ * @struct ReplicatedUpdate
+ * @brief One actor state read from a replication packet.
+ */
+struct ReplicatedUpdate {
+    NetworkId id = 0;   ///< Network id of the actor.
+    TransformData data; ///< FieldReplicated fields as sent; the others are value-initialized.
+};
+
+/**
+ * @struct ReplicationPacket
+ * @brief Contents of a packet written by ReplicationManager, as decoded by a client.
+ */
+struct ReplicationPacket {
+    uint32_t tick = 0;                     ///< Server tick that wrote the packet.
+    std::vector<NetworkId> removals;       ///< Actors that left the client's view.
+    std::vector<ReplicatedUpdate> updates; ///< Actor states.
+};
+
+/**
+ * @class ReplicationManager
+ * @brief Decides, per client and per tick, which actor states are worth sending.
+ *
+ * Each tick the positions of every registered actor are loaded into a SpatialGrid.
+ * A client only considers the actors inside its view circle (its relevance set).
+ * Every relevant actor owns a priority accumulator that grows with time, scaled by
+ * how close it is to the view center and how fast it moves. The actors with the
+ * highest accumulators are written into the client's packet until its byte budget
+ * is full; written actors reset their accumulator, the rest keep growing, so every
+ * relevant actor is eventually refreshed.
+ *
+ * Packet layout: `Uint32 tick, Uint16 removals, Uint16 updates, removals * Uint32 id`
+ * through sf::Packet, then `updates * (Uint32 id, fields)` through a BitWriter, where
+ * the fields are the FieldReplicated fields of TransformData written by
+ * ReflectedSerializer. Flagging another field replicated changes the layout (and
+ * UpdateSize) on both sides; readPacket() decodes it.
+ */
+class ReplicationManager {
+public:
+    /**
+     * @brief Creates a replication manager.
+     * @param worldBounds Area covered by the relevance grid.
+     * @param cellSize Side of a grid cell; about a quarter of the view radius works well.
+     * @param settings Tuning values.
+     */
+    ReplicationManager(const sf::FloatRect& worldBounds,
+                       float cellSize,
+                       const ReplicationSettings& settings = ReplicationSettings());
+
+    /**
+     * @brief Starts replicating an actor.
+     * @param actor Actor to replicate; it must have a Transform component.
+     * @return Network id of the actor.
+     */
+    NetworkId registerActor(const EngineUtilities::TSharedPointer<Actor>& actor);
+
+    /**
+     * @brief Stops replicating an actor. Clients see it as a removal on the next tick.
+     * @param id Network id returned by registerActor.
+     */
+    void unregisterActor(NetworkId id);
+
+    /**
+     * @brief Adds a client reachable at the given address.
+     * @param address Client IP address.
+     * @param port Client UDP port.
+     * @return Id of the new client.
+     */
+    ClientId addClient(const sf::IpAddress& address, unsigned short port);
+
+    /**
+     * @brief Removes a client.
+     * @param id Client id returned by addClient.
+     */
+    void removeClient(ClientId id);
+
+    /**
+     * @brief Moves the view of a client.
+     * @param id Client id.
+     * @param center Center of the view, in world units.
+     * @param radius Relevance radius, in world units.
+     */
+    void setClientView(ClientId id, const sf::Vector2f& center, float radius);
+
+    /**
+     * @brief Computes relevance and priorities and writes the packet of every client.
+     * @param deltaTime Seconds since the previous tick.
+     */
+    void tick(float deltaTime);
+
+    /**
+     * @brief Sends the packets written by the last tick.
+     * @param socket Socket used to reach the clients.
+     */
+    void send(sf::UdpSocket& socket);
+
+    /**
+     * @brief Returns the packet written for a client by the last tick.
+     * @param id Client id.
+     */
+    const sf::Packet& getClientPacket(ClientId id) const;
+
+    /**
+     * @brief Returns the number of actors currently relevant to a client.
+     * @param id Client id.
+     */
+    size_t getRelevantCount(ClientId id) const;
+
+    /**
+     * @brief Returns the counters of the last tick/send.
+     */
+    const ReplicationStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Returns the number of registered actors.
+     */
+    size_t getActorCount() const { return m_actors.size(); }
+
+    /**
+     * @brief Serializer of the replicated Transform fields.
+     */
+    using TransformFields = ReflectedSerializer<FieldReplicated>;
+
+    /**
+     * @brief Bytes used by one actor update inside a packet.
+     */
+    static constexpr uint32_t UpdateSize = 4 + TransformFields::bits<TransformData>() / 8;
+
+    /**
+     * @brief Bytes used by one removal inside a packet.
+     */
+    static constexpr uint32_t RemovalSize = 4;
+
+    /**
+     * @brief Bytes used by the packet header.
+     */
+    static constexpr uint32_t HeaderSize = 8;
+
+    static_assert(TransformFields::bits<TransformData>() % 8 == 0, "Replicated Transform fields must fill whole bytes");
+
+    /**
+     * @brief Decodes a packet written by tick() on the client side.
+     * @return false if the packet is truncated.
+     */
+    static bool readPacket(sf::Packet& packet, ReplicationPacket& contents);
+
+private:
+    /**
+     * @brief Replication state of one actor relevant to one client.
+     */
+    struct RelevantEntry {
+        NetworkId id;       ///< Network id of the actor.
+        uint32_t slot;      ///< Index of the actor in the dense arrays (refreshed every tick).
+        float accumulator;  ///< Priority accumulated since the last send.
+    };
+
+    /**
+     * @brief Per-client replication state.
+     */
+    struct ClientState {
+        ClientId id = 0;                       ///< Client id.
+        sf::IpAddress address;                 ///< Destination address.
+        unsigned short port = 0;               ///< Destination port.
+        sf::Vector2f viewCenter;               ///< Center of the relevance circle.
+        float viewRadius = 0.f;                ///< Radius of the relevance circle.
+        std::vector<RelevantEntry> relevant;   ///< Relevance set, sorted by NetworkId.
+        std::vector<NetworkId> removals;       ///< Actors that left the relevance set this tick.
+        sf::Packet packet;                     ///< Packet written by the last tick.
+    };
+
+    /**
+     * @brief Finds a client by id, or terminates on an unknown id.
+     */
+    ClientState& findClient(ClientId id, const char* method);
+
+    /**
+     * @brief Const overload of findClient.
+     */
+    const ClientState& findClient(ClientId id, const char* method) const;
+
+    /**
+     * @brief Rebuilds the relevance set of a client from the spatial grid.
+     */
+    void updateRelevance(ClientState& client);
+
+    /**
+     * @brief Accumulates priorities, selects the updates that fit and writes the packet.
+     */
+    void writeClientPacket(ClientState& client, float deltaTime);
+
+    ReplicationSettings m_settings;                                  ///< Tuning values.
+    SpatialGrid m_grid;                                              ///< Relevance grid, rebuilt each tick.
+    std::vector<EngineUtilities::TSharedPointer<Actor>> m_actors;    ///< Replicated actors (dense).
+    std::vector<EngineUtilities::TSharedPointer<Transform>> m_transforms; ///< Cached Transform per actor.
+    std::vector<NetworkId> m_networkIds;                             ///< Network id per actor.
+    std::vector<sf::Vector2f> m_positions;                           ///< Position per actor this tick.
+    std::vector<sf::Vector2f> m_previousPositions;                   ///< Position per actor last tick.
+    std::vector<float> m_speeds;                                     ///< Speed per actor (units/second).
+    std::unordered_map<NetworkId, uint32_t> m_slotById;              ///< Network id to dense slot.
+    std::vector<ClientState> m_clients;                              ///< Connected clients.
+    NetworkId m_nextNetworkId = 1;                                   ///< Next id handed out by registerActor.
+    ClientId m_nextClientId = 1;                                     ///< Next id handed out by addClient.
+    uint32_t m_tick = 0;                                             ///< Ticks computed so far.
+    ReplicationStats m_stats;                                        ///< Counters of the last tick.
+
+    // Scratch buffers reused by every client to keep the tick allocation free.
+    std::vector<uint32_t> m_querySlots;                              ///< Grid query output.
+    std::vector<RelevantEntry> m_mergedEntries;                      ///< Next relevance set being built.
+    std::vector<uint32_t> m_selection;                               ///< Entries picked for sending.
+    std::vector<sf::Uint8> m_updateBytes;                            ///< Updates section of a packet.
+};
@@ -22,8 +22,8 @@
 // === Third Party Libraries ===
 #include <SFML/Graphics.hpp> ///< SFML graphics module.
 
-// === ImGui ===
-// Add ImGui headers here if used in the future.
+// === UI ===
+// HUD and debug panels use the retained, batched UI in UI/UiSystem.h (no ImGui dependency).
 
 // === Macros ===
 
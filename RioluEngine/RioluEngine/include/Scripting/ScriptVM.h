@@ -0,0 +1,344 @@
+#pragma once
+
+/**
+ * @file ScriptVM.h
+ * @brief Declares the register-based script bytecode, its assembler and the VM that
+ * runs script loops over whole chunks of component data.
+ */
+
+#include "../Prerequisites.h"
+#include "ECS/ComponentStorage.h"
+#include "ECS/Reflection.h"
+
+/**
+ * @enum ScriptOp
+ * @brief Instruction opcodes. An instruction is 32 bits: opcode, then operands a, b, c
+ * of 8 bits each (b and c form a 16-bit operand where noted).
+ */
+enum class ScriptOp : uint8_t {
+    Halt,       ///< Stops the program.
+    LoadConst,  ///< r[a] = constants[bc].
+    LoadParam,  ///< r[a] = parameters[b].
+    Move,       ///< r[a] = r[b].
+    AddF,       ///< r[a] = r[b] + r[c].
+    SubF,       ///< r[a] = r[b] - r[c].
+    MulF,       ///< r[a] = r[b] * r[c].
+    DivF,       ///< r[a] = r[b] / r[c].
+    MinF,       ///< r[a] = min(r[b], r[c]).
+    MaxF,       ///< r[a] = max(r[b], r[c]).
+    MulAddF,    ///< r[a] += r[b] * r[c].
+    NegF,       ///< r[a] = -r[b].
+    AbsF,       ///< r[a] = |r[b]|.
+    SqrtF,      ///< r[a] = sqrt(r[b]).
+    FloorF,     ///< r[a] = floor(r[b]).
+    LessF,      ///< r[a] = r[b] < r[c] ? -1 : 0 (integer mask).
+    LessEqualF, ///< r[a] = r[b] <= r[c] ? -1 : 0.
+    AddI,       ///< Integer r[a] = r[b] + r[c].
+    SubI,       ///< Integer r[a] = r[b] - r[c].
+    MulI,       ///< Integer r[a] = r[b] * r[c].
+    AndI,       ///< Integer r[a] = r[b] & r[c].
+    OrI,        ///< Integer r[a] = r[b] | r[c].
+    LessI,      ///< r[a] = r[b] < r[c] ? -1 : 0, integers.
+    IntToFloat, ///< r[a] = float(r[b]).
+    FloatToInt, ///< r[a] = int(r[b]), truncated.
+    Select,     ///< r[a] = r[a] != 0 ? r[b] : r[c].
+    Index,      ///< r[a] = row index in the query (0 outside a loop).
+    LoadF32,    ///< r[a] = 32-bit field at byte c of column b's row (float or int).
+    LoadU8,     ///< r[a] = 8-bit unsigned field as an integer.
+    LoadU16,    ///< r[a] = 16-bit unsigned field as an integer.
+    StoreF32,   ///< 32-bit field at byte c of column b's row = r[a].
+    StoreU8,    ///< 8-bit field = integer r[a] (truncated).
+    StoreU16,   ///< 16-bit field = integer r[a] (truncated).
+    CallNative, ///< r[a] = natives[b](r[c]) over every lane.
+    Jump,       ///< Jumps by the signed 16-bit bc (outside loops only).
+    JumpIfZero, ///< Jumps by bc when r[a] is 0 (outside loops only).
+    ForEach,    ///< Runs bc instructions over query a by chunks; the next word masks the registers they write.
+    Count       ///< Number of opcodes.
+};
+
+/**
+ * @union ScriptRegister
+ * @brief One lane of a register: a float or a 32-bit integer.
+ */
+union ScriptRegister {
+    float f;   ///< Float view.
+    int32_t i; ///< Integer view.
+};
+
+/**
+ * @enum ScriptFieldType
+ * @brief Type of a component field seen by scripts.
+ */
+enum class ScriptFieldType : uint8_t {
+    Float,  ///< 32-bit float.
+    Int,    ///< 32-bit signed integer.
+    UInt8,  ///< 8-bit unsigned (colour channels...).
+    UInt16  ///< 16-bit unsigned (ids...).
+};
+
+/**
+ * @struct ScriptField
+ * @brief A field scripts may read and write.
+ */
+struct ScriptField {
+    std::string name;      ///< Name used in scripts ("position.x").
+    ScriptFieldType type;  ///< Storage type.
+    uint32_t offset;       ///< Byte offset in the component data (below 256).
+};
+
+/**
+ * @struct ScriptLayout
+ * @brief Fields of one component data type and its size.
+ */
+struct ScriptLayout {
+    std::string name;                ///< Name used in scripts ("Transform").
+    uint32_t size = 0;               ///< sizeof the component data.
+    std::vector<ScriptField> fields; ///< Fields.
+
+    /**
+     * @brief Returns the field called @p field, or nullptr.
+     */
+    const ScriptField* findField(const std::string& field) const;
+
+    /**
+     * @brief Builds the layout of a reflected type from its FieldScripted fields.
+     * Vectors become "name.x" / "name.y" and colours "name.r" to "name.a".
+     */
+    template<Reflected T>
+    static ScriptLayout
+    fromReflection() {
+        ScriptLayout layout;
+        layout.name = Reflect<T>::name;
+        layout.size = sizeof(T);
+        for (const FieldInfo& field : FieldTable<T>) {
+            if ((field.flags & FieldScripted) == 0) {
+                continue;
+            }
+            const std::string name = field.name;
+            switch (field.type) {
+            case FieldType::Float:
+                layout.fields.push_back({ name, ScriptFieldType::Float, field.offset });
+                break;
+            case FieldType::Int32:
+            case FieldType::UInt32:
+                layout.fields.push_back({ name, ScriptFieldType::Int, field.offset });
+                break;
+            case FieldType::Bool:
+            case FieldType::UInt8:
+                layout.fields.push_back({ name, ScriptFieldType::UInt8, field.offset });
+                break;
+            case FieldType::UInt16:
+                layout.fields.push_back({ name, ScriptFieldType::UInt16, field.offset });
+                break;
+            case FieldType::Vector2f:
+                layout.fields.push_back({ name + ".x", ScriptFieldType::Float, field.offset });
+                layout.fields.push_back({ name + ".y", ScriptFieldType::Float, field.offset + 4 });
+                break;
+            case FieldType::Color:
+                layout.fields.push_back({ name + ".r", ScriptFieldType::UInt8, field.offset });
+                layout.fields.push_back({ name + ".g", ScriptFieldType::UInt8, field.offset + 1 });
+                layout.fields.push_back({ name + ".b", ScriptFieldType::UInt8, field.offset + 2 });
+                layout.fields.push_back({ name + ".a", ScriptFieldType::UInt8, field.offset + 3 });
+                break;
+            }
+        }
+        return layout;
+    }
+};
+
+/**
+ * @brief Batched native function: writes @p count results from @p count arguments.
+ */
+using ScriptNative = void(*)(ScriptRegister* result, const ScriptRegister* argument, size_t count);
+
+/**
+ * @class ScriptEnvironment
+ * @brief Component layouts and native functions visible to scripts.
+ *
+ * Shared by the assembler, which turns names into offsets and indices once, and by
+ * the VM, which only ever sees those numbers.
+ */
+class ScriptEnvironment {
+public:
+    /**
+     * @brief Makes a component layout available to queries.
+     */
+    void addLayout(const ScriptLayout& layout);
+
+    /**
+     * @brief Makes a native function callable with `call`.
+     */
+    void addNative(const std::string& name, ScriptNative function);
+
+    /**
+     * @brief Returns the layout called @p name, or nullptr.
+     */
+    const ScriptLayout* findLayout(const std::string& name) const;
+
+    /**
+     * @brief Returns the index of the native called @p name, or -1.
+     */
+    int findNative(const std::string& name) const;
+
+    /**
+     * @brief Returns the native at @p index (from findNative()).
+     */
+    ScriptNative getNative(size_t index) const { return m_natives[index].second; }
+
+private:
+    std::vector<ScriptLayout> m_layouts;                          ///< Layouts.
+    std::vector<std::pair<std::string, ScriptNative>> m_natives;  ///< Natives by index.
+};
+
+/**
+ * @struct ScriptProgram
+ * @brief Assembled bytecode and what it needs from the host.
+ */
+struct ScriptProgram {
+    /**
+     * @struct Query
+     * @brief Rows a `foreach` walks: one column per component layout.
+     */
+    struct Query {
+        std::string name;                  ///< Name used by ScriptVM::bindQuery().
+        std::vector<std::string> layouts;  ///< Layout of each column.
+        std::vector<uint32_t> sizes;       ///< sizeof each column's data (checked at binding).
+    };
+
+    std::vector<uint32_t> code;               ///< Instructions.
+    std::vector<ScriptRegister> constants;    ///< Constant pool.
+    std::vector<Query> queries;               ///< Queries, indexed by ForEach's a.
+    uint32_t parameterCount = 0;              ///< Highest parameter index used + 1.
+};
+
+/**
+ * @class ScriptAssembler
+ * @brief Turns script text into a ScriptProgram.
+ *
+ * One instruction per line, `#` starts a comment:
+ *
+ *     query movers Mover            # query 0, one column of layout Mover
+ *     param r0 0                    # r0 = parameter 0 (delta time)
+ *     const r1 -1                   # float constant; consti for integers
+ *     foreach movers
+ *         load r2 Mover.x
+ *         load r3 Mover.vx
+ *         madd r2 r3 r0             # r2 += r3 * r0
+ *         store Mover.x r2
+ *     end
+ *     label:  /  jump label  /  jz r4 label
+ *
+ * Arithmetic takes `op rD rA rB` (add sub mul div min max less lesseq addi subi muli
+ * andi ori lessi), unary ops `op rD rA` (move neg abs sqrt floor itof ftoi),
+ * `select rD rA rB` keeps rA where rD is non-zero and rB elsewhere, `index rD`
+ * gives the row index, `call rD native rA` calls a batched native. Loop bodies have
+ * no jumps: conditions become masks and select, so every instruction runs over a
+ * whole chunk.
+ */
+class ScriptAssembler {
+public:
+    /**
+     * @brief Uses the layouts and natives of @p environment.
+     */
+    explicit ScriptAssembler(const ScriptEnvironment& environment) : m_environment(environment) {}
+
+    /**
+     * @brief Assembles @p source into @p program.
+     * @return false with a message in @p error (line number included) on failure.
+     */
+    bool assemble(const std::string& source, ScriptProgram& program, std::string& error) const;
+
+private:
+    const ScriptEnvironment& m_environment; ///< Names visible to scripts.
+};
+
+/**
+ * @struct ScriptColumn
+ * @brief Memory of one query column: rows of @p stride bytes from @p base.
+ */
+struct ScriptColumn {
+    uint8_t* base = nullptr; ///< First row.
+    size_t stride = 0;       ///< Bytes between rows.
+
+    /**
+     * @brief Column over every slot of a component storage (free slots included;
+     * writes to them are overwritten when the slot is reused).
+     */
+    template<typename T>
+    static ScriptColumn fromStorage(TComponentStorage<T>& storage) {
+        return ScriptColumn{ reinterpret_cast<uint8_t*>(storage.editAll()), sizeof(T) };
+    }
+};
+
+/**
+ * @class ScriptVM
+ * @brief Runs ScriptPrograms.
+ *
+ * Every register holds ChunkSize lanes. Outside loops instructions use lane 0; a
+ * `foreach` copies lane 0 of every register to all lanes, then runs each body
+ * instruction over up to ChunkSize rows at once, so decoding and dispatch are paid
+ * once per chunk instead of once per entity. Before every chunk the registers the
+ * body writes are reset to their value before the loop, so each row starts from the
+ * same registers it would see if the program ran once per entity. The register file is allocated with
+ * the VM; running a program allocates nothing.
+ */
+class ScriptVM {
+public:
+    static constexpr size_t RegisterCount = 32; ///< Registers r0 to r31.
+    static constexpr size_t ChunkSize = 64;     ///< Rows per chunk.
+    static constexpr size_t MaxColumns = 8;     ///< Columns per query.
+
+    /**
+     * @brief Creates a VM calling the natives of @p environment.
+     */
+    explicit ScriptVM(const ScriptEnvironment& environment);
+
+    /**
+     * @brief Sets parameter @p index (read with `param`).
+     */
+    void setParameter(size_t index, float value);
+
+    /**
+     * @brief Binds the rows of the query called @p name for the next run().
+     * @param columns One column per layout of the query, in declaration order.
+     * @param count Rows.
+     */
+    void bindQuery(const ScriptProgram& program, const std::string& name,
+                   const std::vector<ScriptColumn>& columns, size_t count);
+
+    /**
+     * @brief Runs @p program to its end (or Halt).
+     */
+    void run(const ScriptProgram& program);
+
+    /**
+     * @brief Returns lane 0 of a register after run().
+     */
+    ScriptRegister getRegister(size_t index) const { return m_registers[index * ChunkSize]; }
+
+private:
+    /**
+     * @struct Binding
+     * @brief Rows bound to a query.
+     */
+    struct Binding {
+        ScriptColumn columns[MaxColumns]; ///< Columns.
+        size_t count = 0;                 ///< Rows.
+        bool bound = false;               ///< Set by bindQuery().
+    };
+
+    /**
+     * @brief Executes code[begin, end) over @p count lanes.
+     * @param columns Row pointers of the chunk (nullptr outside loops).
+     * @param firstRow Row index of lane 0.
+     * @return Index of the instruction after the last executed, or the code size on Halt.
+     */
+    size_t execute(const ScriptProgram& program, size_t begin, size_t end, size_t count,
+                   const ScriptColumn* columns, size_t firstRow);
+
+    const ScriptEnvironment& m_environment; ///< Natives.
+    std::vector<ScriptRegister> m_registers; ///< RegisterCount * ChunkSize lanes.
+    std::vector<float> m_parameters;         ///< Host parameters.
+    std::vector<Binding> m_bindings;         ///< Bound rows, by query index.
+    bool m_halted = false;                   ///< Halt reached.
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * @file UiGlyphCache.h
+ * @brief Declares the glyph cache used to lay out and batch UI text.
+ */
+
+#include "../Prerequisites.h"
+
+/**
+ * @struct UiGlyph
+ * @brief Metrics and texture rectangle of one character.
+ */
+struct UiGlyph {
+    float advance = 0.f;    ///< Horizontal offset to the next character.
+    sf::FloatRect bounds;   ///< Quad relative to the pen position on the baseline.
+    sf::FloatRect texture;  ///< Texture rectangle in pixels.
+};
+
+/**
+ * @class UiGlyphCache
+ * @brief Caches the glyphs of one font at one character size.
+ *
+ * sf::Font::getGlyph() looks glyphs up in a map keyed by size, style and outline on
+ * every call; UI text asks for the same few characters thousands of times per frame,
+ * so ASCII glyphs are kept in a flat array and the rest in a hash map, filled on
+ * first use. Kerning is ignored (UI text is short and mostly digits).
+ *
+ * Without a font the cache serves fixed-width boxes, enough for debug panels in
+ * builds shipped without font files and for headless tests.
+ */
+class UiGlyphCache {
+public:
+    /**
+     * @brief Creates a cache.
+     * @param font Font to read glyphs from (kept by reference), or nullptr for boxes.
+     * @param characterSize Character size in pixels.
+     */
+    UiGlyphCache(const sf::Font* font, unsigned int characterSize);
+
+    /**
+     * @brief Returns the glyph of @p codePoint.
+     */
+    const UiGlyph&
+    getGlyph(uint32_t codePoint) {
+        if (codePoint < 128 && m_asciiLoaded[codePoint]) {
+            return m_ascii[codePoint];
+        }
+        return loadGlyph(codePoint);
+    }
+
+    /**
+     * @brief Returns the width of @p text (UTF-8) on one line.
+     */
+    float measure(const std::string& text);
+
+    /**
+     * @brief Returns the texture holding the glyphs, or nullptr without a font.
+     */
+    const sf::Texture* getTexture() const;
+
+    /**
+     * @brief Returns a texel that is opaque white, for untextured quads drawn in the same batch.
+     */
+    sf::Vector2f getWhiteTexel() const { return sf::Vector2f(1.f, 1.f); }
+
+    /**
+     * @brief Returns the distance between two baselines.
+     */
+    float getLineSpacing() const { return m_lineSpacing; }
+
+    /**
+     * @brief Returns the distance from the top of a line to its baseline.
+     */
+    float getAscent() const { return static_cast<float>(m_characterSize); }
+
+    /**
+     * @brief Returns the number of glyphs read from the font (cache misses).
+     */
+    size_t getLoadCount() const { return m_loads; }
+
+private:
+    /**
+     * @brief Reads a glyph from the font and caches it.
+     */
+    const UiGlyph& loadGlyph(uint32_t codePoint);
+
+    const sf::Font* m_font;                         ///< Source font, or nullptr for boxes.
+    unsigned int m_characterSize;                   ///< Character size in pixels.
+    float m_lineSpacing;                            ///< Distance between baselines.
+    UiGlyph m_ascii[128];                           ///< Cached ASCII glyphs.
+    bool m_asciiLoaded[128] = {};                   ///< Which ASCII glyphs are cached.
+    std::unordered_map<uint32_t, UiGlyph> m_others; ///< Cached non-ASCII glyphs.
+    size_t m_loads = 0;                             ///< Glyphs read from the font.
+};
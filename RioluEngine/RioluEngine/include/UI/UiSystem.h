@@ -0,0 +1,289 @@
+#pragma once
+
+/**
+ * @file UiSystem.h
+ * @brief Declares the retained-mode UI used for HUD and debug panels.
+ */
+
+#include "../Prerequisites.h"
+#include "UI/UiGlyphCache.h"
+
+/**
+ * @brief Index of a UI node inside its UiSystem.
+ */
+using UiNodeId = uint32_t;
+
+/**
+ * @brief Id returned when there is no node (nothing hit, nothing clicked).
+ */
+constexpr UiNodeId InvalidUiNode = 0xFFFFFFFFu;
+
+/**
+ * @enum UiNodeKind
+ * @brief What a node draws and whether it takes input.
+ */
+enum class UiNodeKind : uint8_t {
+    Panel,  ///< Background that lays out its children.
+    Label,  ///< Single line of text.
+    Button  ///< Label that is hit-tested, highlighted on hover and clicked.
+};
+
+/**
+ * @enum UiDirection
+ * @brief How a panel places its children.
+ */
+enum class UiDirection : uint8_t {
+    Column, ///< Top to bottom.
+    Row,    ///< Left to right.
+    Overlay ///< Each child at its own UiStyle::position.
+};
+
+/**
+ * @struct UiStyle
+ * @brief Layout and colours of one node.
+ */
+struct UiStyle {
+    sf::Vector2f size = sf::Vector2f(0.f, 0.f);     ///< Fixed size; 0 on an axis fits the content.
+    sf::Vector2f position = sf::Vector2f(0.f, 0.f); ///< Offset inside an Overlay parent.
+    float padding = 4.f;                            ///< Space between the border and the content.
+    float spacing = 2.f;                            ///< Space between children.
+    UiDirection direction = UiDirection::Column;    ///< Placement of children.
+    sf::Color background = sf::Color::Transparent;  ///< Background colour.
+    sf::Color text = sf::Color::White;              ///< Text colour.
+    sf::Color hover = sf::Color(90, 90, 90);        ///< Button background under the mouse.
+};
+
+/**
+ * @struct UiStats
+ * @brief Work done by the last UiSystem::update().
+ */
+struct UiStats {
+    size_t measured = 0;      ///< Nodes whose size was recomputed.
+    size_t arranged = 0;      ///< Nodes whose rectangle was recomputed.
+    size_t rewritten = 0;     ///< Nodes whose vertices were rewritten.
+    size_t rangeRebuilds = 0; ///< Times the vertex stream was laid out again.
+    size_t gridRebuilds = 0;  ///< Times the hit grid was rebuilt.
+};
+
+/**
+ * @class UiSystem
+ * @brief Tree of panels, labels and buttons drawn in one draw call.
+ *
+ * The tree is retained: widgets are created once and changed through setters that
+ * flag what they invalidate. update() then only
+ * - measures flagged nodes bottom-up (a text change that keeps the size of its node
+ *   stops there, so fixed-width value labels never trigger layout),
+ * - arranges top-down, skipping subtrees whose rectangle did not move,
+ * - rewrites the vertices of nodes whose look changed.
+ *
+ * Every node owns a range of one sf::Triangles vertex array, in tree order, with
+ * room for its text to grow; the ranges are only laid out again when nodes are
+ * added or a text outgrows its range. Text comes from a UiGlyphCache and
+ * backgrounds sample its white texel, so the whole UI is one draw call.
+ *
+ * Buttons are hit-tested through a uniform grid over the viewport, rebuilt only
+ * when a button moved or changed visibility.
+ */
+class UiSystem : public sf::Drawable {
+public:
+    /**
+     * @brief Creates a UI with an empty root covering @p viewport.
+     * @param font Font used for all text (kept by reference), or nullptr for box glyphs.
+     * @param characterSize Character size in pixels.
+     * @param viewport Size of the area covered by the root, in pixels.
+     */
+    UiSystem(const sf::Font* font, unsigned int characterSize, const sf::Vector2f& viewport);
+
+    /**
+     * @brief Returns the root node, an Overlay panel covering the viewport.
+     */
+    UiNodeId getRoot() const { return 0; }
+
+    /**
+     * @brief Adds a panel as last child of @p parent.
+     */
+    UiNodeId addPanel(UiNodeId parent, const UiStyle& style);
+
+    /**
+     * @brief Adds a label as last child of @p parent.
+     */
+    UiNodeId addLabel(UiNodeId parent, const std::string& text, const UiStyle& style);
+
+    /**
+     * @brief Adds a button as last child of @p parent.
+     */
+    UiNodeId addButton(UiNodeId parent, const std::string& text, const UiStyle& style);
+
+    /**
+     * @brief Changes the text of a label or button.
+     */
+    void setText(UiNodeId node, const std::string& text);
+
+    /**
+     * @brief Shows or hides a node and its children; hidden nodes take no space.
+     */
+    void setVisible(UiNodeId node, bool visible);
+
+    /**
+     * @brief Resizes the root.
+     */
+    void setViewport(const sf::Vector2f& viewport);
+
+    /**
+     * @brief Marks every node dirty, so the next update() redoes all the work.
+     */
+    void invalidate();
+
+    /**
+     * @brief Brings layout, vertices and hit grid up to date.
+     */
+    void update();
+
+    /**
+     * @brief Returns the topmost visible button containing @p point, as of the last update().
+     */
+    UiNodeId hitTest(const sf::Vector2f& point) const;
+
+    /**
+     * @brief Updates the hovered button and reports clicks.
+     * @param point Mouse position in UI pixels.
+     * @param pressed Whether the button of the mouse is down.
+     * @return The button pressed by this call, or InvalidUiNode.
+     */
+    UiNodeId handleMouse(const sf::Vector2f& point, bool pressed);
+
+    /**
+     * @brief Returns the rectangle of @p node, as of the last update().
+     */
+    const sf::FloatRect& getRect(UiNodeId node) const { return m_nodes[node].rect; }
+
+    /**
+     * @brief Returns the hovered button, or InvalidUiNode.
+     */
+    UiNodeId getHovered() const { return m_hovered; }
+
+    /**
+     * @brief Returns the number of nodes, root included.
+     */
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+    /**
+     * @brief Returns the batched vertices (sf::Triangles).
+     */
+    const std::vector<sf::Vertex>& getVertices() const { return m_vertices; }
+
+    /**
+     * @brief Returns the work done by the last update().
+     */
+    const UiStats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Returns the glyph cache.
+     */
+    UiGlyphCache& getGlyphs() { return m_glyphs; }
+
+private:
+    /**
+     * @brief Draws the whole UI in one call.
+     */
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    static constexpr uint8_t MeasureDirty = 1; ///< Size must be recomputed.
+    static constexpr uint8_t ArrangeDirty = 2; ///< Children must be placed again.
+    static constexpr uint8_t VisualDirty = 4;  ///< Vertices must be rewritten.
+    static constexpr float GridCellSize = 64.f; ///< Side of a hit grid cell, in pixels.
+
+    /**
+     * @struct Node
+     * @brief One widget.
+     */
+    struct Node {
+        UiNodeKind kind;                     ///< Widget kind.
+        UiStyle style;                       ///< Layout and colours.
+        std::string text;                    ///< Text of labels and buttons.
+        float textWidth = 0.f;               ///< Measured width of text.
+        UiNodeId parent = InvalidUiNode;     ///< Parent node.
+        UiNodeId firstChild = InvalidUiNode; ///< First child.
+        UiNodeId lastChild = InvalidUiNode;  ///< Last child.
+        UiNodeId next = InvalidUiNode;       ///< Next sibling.
+        sf::Vector2f size;                   ///< Measured size.
+        sf::FloatRect rect;                  ///< Arranged rectangle.
+        uint32_t vertexStart = 0;            ///< First vertex of the range (also the draw order).
+        uint32_t vertexCapacity = 0;         ///< Vertices of the range.
+        uint32_t vertexCount = 0;            ///< Vertices written last time (the rest are degenerate).
+        uint8_t flags = MeasureDirty | ArrangeDirty | VisualDirty; ///< Dirty flags.
+        bool visible = true;                 ///< Set by setVisible().
+    };
+
+    /**
+     * @brief Appends a node under @p parent.
+     */
+    UiNodeId addNode(UiNodeId parent, UiNodeKind kind, const std::string& text, const UiStyle& style);
+
+    /**
+     * @brief Calls @p function with @p first and its descendants in tree order.
+     * @param visibleOnly Skip hidden nodes and their subtrees.
+     */
+    template<typename Function>
+    void forEachNode(UiNodeId first, bool visibleOnly, Function&& function) const;
+
+    /**
+     * @brief Flags @p node and its ancestors for measuring.
+     */
+    void markMeasureDirty(UiNodeId node);
+
+    /**
+     * @brief Queues @p node for a vertex rewrite.
+     */
+    void markVisualDirty(UiNodeId node);
+
+    /**
+     * @brief Recomputes the size of a flagged subtree.
+     */
+    void measure(UiNodeId node);
+
+    /**
+     * @brief Places @p node at @p rect and arranges its children if needed.
+     */
+    void arrange(UiNodeId node, const sf::FloatRect& rect);
+
+    /**
+     * @brief Returns whether @p node and all its ancestors are visible.
+     */
+    bool isShown(UiNodeId node) const;
+
+    /**
+     * @brief Returns the vertices a node needs for @p characters characters.
+     */
+    static uint32_t capacityFor(UiNodeKind kind, size_t characters);
+
+    /**
+     * @brief Lays out every range again in tree order and queues every node.
+     */
+    void rebuildRanges();
+
+    /**
+     * @brief Writes the vertices of @p node into its range.
+     */
+    void writeNode(UiNodeId node);
+
+    /**
+     * @brief Rebuilds the hit grid from the visible buttons.
+     */
+    void rebuildGrid();
+
+    UiGlyphCache m_glyphs;                  ///< Glyphs of the UI font.
+    std::vector<Node> m_nodes;              ///< Nodes; index 0 is the root.
+    std::vector<sf::Vertex> m_vertices;     ///< Batched vertices.
+    std::vector<UiNodeId> m_visualQueue;    ///< Nodes waiting for a vertex rewrite.
+    bool m_rangesDirty = true;              ///< Ranges must be laid out again.
+    bool m_gridDirty = true;                ///< Hit grid must be rebuilt.
+    int m_gridColumns = 1;                  ///< Hit grid columns.
+    int m_gridRows = 1;                     ///< Hit grid rows.
+    std::vector<uint32_t> m_gridStart;      ///< Offset of each cell in m_gridItems (cells + 1).
+    std::vector<UiNodeId> m_gridItems;      ///< Buttons packed by cell.
+    std::vector<UiNodeId> m_scratch;        ///< Visible buttons while the grid is rebuilt.
+    UiNodeId m_hovered = InvalidUiNode;     ///< Button under the mouse.
+    bool m_pressed = false;                 ///< Mouse button state at the last handleMouse().
+    UiStats m_stats;                        ///< Work done by the last update().
+};
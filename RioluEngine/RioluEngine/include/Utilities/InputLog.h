@@ -0,0 +1,158 @@
+#pragma once
+
+/**
+ * @file InputLog.h
+ * @brief Declares the compact binary log of per-frame input events and deltaTime.
+ */
+
+#include "../Prerequisites.h"
+#include <cstdint>
+
+/**
+ * @brief Layout shared by InputLogWriter and InputLogReader.
+ *
+ * File = magic "RILG", u8 version, then records. Each record starts with a tag byte:
+ * - Frame: varint deltaTime in microseconds, varint event count, events.
+ * - End: u8 has-hash flag, u64 state hash, varint frame count.
+ *
+ * Integers are LEB128 varints (zigzag for signed values). Common events (keys, mouse,
+ * text, resize) use a few bytes each; rare ones are stored as the raw sf::Event.
+ */
+namespace InputLogFormat {
+    const char Magic[4] = { 'R', 'I', 'L', 'G' }; ///< File signature.
+    const uint8_t Version = 1;                   ///< Format version.
+    const uint8_t FrameTag = 0;                  ///< Tag of a frame record.
+    const uint8_t EndTag = 1;                    ///< Tag of the trailer record.
+}
+
+/**
+ * @class InputLogWriter
+ * @brief Appends frames to an input log file.
+ *
+ * Frames are encoded into a memory buffer that is flushed to disk in large blocks,
+ * so recording does not add a file write per frame.
+ */
+class InputLogWriter {
+public:
+    /**
+     * @brief Default constructor.
+     */
+    InputLogWriter() = default;
+
+    /**
+     * @brief Destructor. Closes the log without a state hash if still open.
+     */
+    ~InputLogWriter();
+
+    InputLogWriter(const InputLogWriter&) = delete;
+    InputLogWriter& operator=(const InputLogWriter&) = delete;
+
+    /**
+     * @brief Creates the log file and writes its header.
+     * @return false if the file could not be opened.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Returns true while the log accepts frames.
+     */
+    bool isOpen() const { return m_file.is_open(); }
+
+    /**
+     * @brief Appends one frame.
+     * @param deltaTime deltaTime of the frame.
+     * @param events Input events polled during the frame.
+     */
+    void writeFrame(sf::Time deltaTime, const std::vector<sf::Event>& events);
+
+    /**
+     * @brief Writes the trailer and closes the file.
+     * @param hasStateHash Whether @p stateHash is meaningful.
+     * @param stateHash Hash of the simulation state after the last frame.
+     */
+    void close(bool hasStateHash = false, uint64_t stateHash = 0);
+
+    /**
+     * @brief Returns the number of frames written.
+     */
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+private:
+    /**
+     * @brief Writes the buffer to the file.
+     */
+    void flush();
+
+    std::ofstream m_file;          ///< Output file.
+    std::vector<uint8_t> m_buffer; ///< Encoded bytes not yet written.
+    uint64_t m_frameCount = 0;     ///< Frames written.
+};
+
+/**
+ * @class InputLogReader
+ * @brief Reads the frames of an input log in order.
+ *
+ * The whole file is loaded on open() and decoded frame by frame, so a replay does
+ * no file IO while it runs.
+ */
+class InputLogReader {
+public:
+    /**
+     * @brief Loads a log file and validates its header.
+     * @return false if the file is missing or is not an input log.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Decodes the next frame.
+     * @param deltaTime Receives the frame's deltaTime.
+     * @param events Receives the frame's events (cleared first).
+     * @return false when there are no frames left or the data is corrupt.
+     */
+    bool nextFrame(sf::Time& deltaTime, std::vector<sf::Event>& events);
+
+    /**
+     * @brief Returns true once every frame has been read.
+     */
+    bool atEnd() const { return m_ended || m_corrupt; }
+
+    /**
+     * @brief Returns true if decoding stopped on malformed data.
+     */
+    bool isCorrupt() const { return m_corrupt; }
+
+    /**
+     * @brief Returns the number of frames read so far.
+     */
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+    /**
+     * @brief Returns the sum of the deltaTimes read so far.
+     */
+    sf::Time getElapsedTime() const { return m_elapsed; }
+
+    /**
+     * @brief Returns true if the trailer holds the recorded state hash.
+     */
+    bool hasStateHash() const { return m_hasStateHash; }
+
+    /**
+     * @brief Returns the state hash stored by the recording.
+     */
+    uint64_t getStateHash() const { return m_stateHash; }
+
+private:
+    /**
+     * @brief Parses the trailer if the cursor reached it.
+     */
+    void readTrailerIfPresent();
+
+    std::vector<uint8_t> m_data;  ///< Whole log file.
+    size_t m_offset = 0;          ///< Read cursor.
+    bool m_ended = true;          ///< True once the trailer (or end of data) is reached.
+    bool m_corrupt = false;       ///< True if the data was malformed.
+    uint64_t m_frameCount = 0;    ///< Frames read.
+    sf::Time m_elapsed;           ///< Sum of the deltaTimes read.
+    bool m_hasStateHash = false;  ///< True if the trailer holds a hash.
+    uint64_t m_stateHash = 0;     ///< Hash stored by the recording.
+};
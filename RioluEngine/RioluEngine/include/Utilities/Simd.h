@@ -0,0 +1,205 @@
+#pragma once
+
+/**
+ * @file Simd.h
+ * @brief Four-lane float vector used by the batch systems (SSE2, or plain floats).
+ *
+ * Both project platforms (Win32 with the default /arch:SSE2, and x64) have SSE2. Other
+ * targets fall back to a scalar implementation with the same interface, so callers
+ * are written once.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RIOLU_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define RIOLU_SIMD_SSE2 0
+#endif
+
+/**
+ * @struct Float4
+ * @brief Four floats processed together. Comparisons return lane masks (all bits set
+ * or clear) meant for select().
+ */
+struct Float4 {
+#if RIOLU_SIMD_SSE2
+    __m128 v; ///< Lanes.
+
+    Float4() = default;
+    Float4(__m128 value) : v(value) {}
+
+    static Float4 splat(float value) { return _mm_set1_ps(value); }
+    static Float4 load(const float* source) { return _mm_loadu_ps(source); }
+    static Float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    static Float4 loadUint16(const uint16_t* source) {
+        const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+    }
+    void store(float* destination) const { _mm_storeu_ps(destination, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+    friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+    friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+    friend Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+    friend Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+    friend Float4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+    friend Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+    friend Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+    friend Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+    friend Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+    friend Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+
+    /**
+     * @brief Lanes of @p a where @p mask is set, of @p b elsewhere.
+     */
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+    }
+
+    /**
+     * @brief Packs the sign bits of a mask: bit i is set if lane i is.
+     */
+    friend int bitmask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+
+    /**
+     * @brief Rounds every lane down to an integer value.
+     */
+    friend Float4 floor(Float4 a) {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        // Truncation rounds negative values up; step those back by one.
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.f)));
+    }
+
+    /**
+     * @brief Multiplies every lane by 2^n, n being integer-valued lanes in [-126, 127].
+     */
+    friend Float4 scaleByPowerOfTwo(Float4 a, Float4 n) {
+        const __m128i exponent = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(a.v, _mm_castsi128_ps(exponent));
+    }
+#else
+    float v[4]; ///< Lanes.
+
+    static Float4 splat(float value) { return { { value, value, value, value } }; }
+    static Float4 load(const float* source) { return { { source[0], source[1], source[2], source[3] } }; }
+    static Float4 set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+    static Float4 loadUint16(const uint16_t* source) {
+        return { { float(source[0]), float(source[1]), float(source[2]), float(source[3]) } };
+    }
+    void store(float* destination) const { for (int i = 0; i < 4; ++i) destination[i] = v[i]; }
+
+    template<typename Op>
+    static Float4 map(Float4 a, Float4 b, Op op) {
+        Float4 result;
+        for (int i = 0; i < 4; ++i) result.v[i] = op(a.v[i], b.v[i]);
+        return result;
+    }
+    static float
+    mask(bool set) {
+        const uint32_t bits = set ? 0xFFFFFFFFu : 0u;
+        float lane;
+        std::memcpy(&lane, &bits, 4);
+        return lane;
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend Float4 operator-(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend Float4 operator*(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x * y; }); }
+    friend Float4 operator/(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x / y; }); }
+    friend Float4 operator>(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return mask(x > y); }); }
+    friend Float4 operator>=(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return mask(x >= y); }); }
+    friend Float4 operator<(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return mask(x < y); }); }
+    friend Float4 operator&(Float4 a, Float4 b) {
+        Float4 result;
+        for (int i = 0; i < 4; ++i) {
+            uint32_t x, y;
+            std::memcpy(&x, &a.v[i], 4);
+            std::memcpy(&y, &b.v[i], 4);
+            x &= y;
+            std::memcpy(&result.v[i], &x, 4);
+        }
+        return result;
+    }
+    friend Float4 min(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return y < x ? y : x; }); }
+    friend Float4 max(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return y > x ? y : x; }); }
+    friend Float4 sqrt(Float4 a) { return map(a, a, [](float x, float) { return std::sqrt(x); }); }
+
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        Float4 result;
+        for (int i = 0; i < 4; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, &mask.v[i], 4);
+            result.v[i] = bits ? a.v[i] : b.v[i];
+        }
+        return result;
+    }
+    friend int bitmask(Float4 mask) {
+        int bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint32_t lane;
+            std::memcpy(&lane, &mask.v[i], 4);
+            bits |= static_cast<int>(lane >> 31) << i;
+        }
+        return bits;
+    }
+    friend Float4 floor(Float4 a) { return map(a, a, [](float x, float) { return std::floor(x); }); }
+    friend Float4 scaleByPowerOfTwo(Float4 a, Float4 n) {
+        return map(a, n, [](float x, float e) { return std::ldexp(x, static_cast<int>(e)); });
+    }
+#endif
+
+    friend Float4 clamp01(Float4 a) { return min(max(a, splat(0.f)), splat(1.f)); }
+
+    /**
+     * @brief e^x per lane (Cephes polynomial; relative error around 2e-7, clamped to
+     * the float range).
+     */
+    friend Float4 exp(Float4 x) {
+        x = min(max(x, splat(-87.3f)), splat(88.3f));
+        const Float4 n = floor(x * splat(1.44269504088896341f) + splat(0.5f));
+        // x - n * ln(2), with ln(2) split in two for precision.
+        x = x - n * splat(0.693359375f) - n * splat(-2.12194440e-4f);
+        Float4 y = splat(1.9875691500e-4f);
+        y = y * x + splat(1.3981999507e-3f);
+        y = y * x + splat(8.3334519073e-3f);
+        y = y * x + splat(4.1665795894e-2f);
+        y = y * x + splat(1.6666665459e-1f);
+        y = y * x + splat(5.0000001201e-1f);
+        y = y * x * x + x + splat(1.f);
+        return scaleByPowerOfTwo(y, n);
+    }
+
+    /**
+     * @brief Sine and cosine per lane, x in radians (Taylor series after folding into
+     * [-pi/2, pi/2]; absolute error below 1e-6 within a few turns, growing with |x|
+     * as the range reduction runs in float).
+     */
+    friend void sincos(Float4 x, Float4& sine, Float4& cosine) {
+        const Float4 pi = splat(3.14159265358979f);
+        const Float4 halfPi = splat(1.57079632679490f);
+        x = x - splat(6.28318530717959f) * floor(x * splat(0.159154943091895f) + splat(0.5f));
+        // sin(pi - x) = sin(x) and cos(pi - x) = -cos(x).
+        const Float4 high = x > halfPi;
+        const Float4 low = x < splat(0.f) - halfPi;
+        const Float4 y = select(high, pi - x, select(low, splat(0.f) - pi - x, x));
+        const Float4 sign = select(high, splat(-1.f), select(low, splat(-1.f), splat(1.f)));
+        const Float4 y2 = y * y;
+        Float4 s = splat(-2.50521084e-8f);
+        s = s * y2 + splat(2.75573192e-6f);
+        s = s * y2 + splat(-1.98412698e-4f);
+        s = s * y2 + splat(8.33333333e-3f);
+        s = s * y2 + splat(-1.66666667e-1f);
+        sine = (s * y2 + splat(1.f)) * y;
+        Float4 c = splat(2.08767570e-9f);
+        c = c * y2 + splat(-2.75573192e-7f);
+        c = c * y2 + splat(2.48015873e-5f);
+        c = c * y2 + splat(-1.38888889e-3f);
+        c = c * y2 + splat(4.16666667e-2f);
+        c = c * y2 + splat(-5.e-1f);
+        cosine = (c * y2 + splat(1.f)) * sign;
+    }
+};
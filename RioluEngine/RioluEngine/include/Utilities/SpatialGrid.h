@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file SpatialGrid.h
+ * @brief Declares a uniform grid used to answer "what is near this point" queries.
+ */
+
+#include "Prerequisites.h"
+
+/**
+ * @class SpatialGrid
+ * @brief Uniform grid over a fixed world rectangle, rebuilt in bulk every tick.
+ *
+ * Items are identified by their index in the position array passed to build().
+ * The grid is stored in compressed rows (cell start offsets + packed item list),
+ * so a rebuild is two linear passes and a query only touches the overlapped cells.
+ * Positions outside the bounds are clamped into the border cells.
+ */
+class SpatialGrid {
+public:
+    /**
+     * @brief Creates a grid covering the given bounds.
+     * @param bounds World rectangle covered by the grid.
+     * @param cellSize Side length of a square cell, in world units.
+     */
+    SpatialGrid(const sf::FloatRect& bounds, float cellSize);
+
+    /**
+     * @brief Rebuilds the grid from a list of positions.
+     * @param positions Item positions; the item id is the index in this array.
+     */
+    void build(const std::vector<sf::Vector2f>& positions);
+
+    /**
+     * @brief Appends the ids of all items inside a circle.
+     * @param center Circle center.
+     * @param radius Circle radius.
+     * @param out Vector that receives the ids (not cleared, not sorted).
+     */
+    void queryCircle(const sf::Vector2f& center, float radius, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Appends the ids of all items inside a rectangle.
+     * @param rect Query rectangle.
+     * @param out Vector that receives the ids (not cleared, not sorted).
+     */
+    void queryRect(const sf::FloatRect& rect, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Returns the number of items stored by the last build().
+     */
+    size_t size() const { return m_items.size(); }
+
+    /**
+     * @brief Returns the number of cells of the grid.
+     */
+    size_t cellCount() const { return static_cast<size_t>(m_columns) * m_rows; }
+
+private:
+    /**
+     * @brief Returns the column containing a world x coordinate, clamped to the grid.
+     */
+    int columnOf(float x) const;
+
+    /**
+     * @brief Returns the row containing a world y coordinate, clamped to the grid.
+     */
+    int rowOf(float y) const;
+
+    sf::FloatRect m_bounds;                ///< World rectangle covered by the grid.
+    float m_cellSize = 1.f;                ///< Side of a cell in world units.
+    float m_invCellSize = 1.f;             ///< 1 / m_cellSize.
+    int m_columns = 1;                     ///< Number of cell columns.
+    int m_rows = 1;                        ///< Number of cell rows.
+    std::vector<uint32_t> m_cellStart;     ///< Offset of each cell in m_items (cellCount + 1 entries).
+    std::vector<uint32_t> m_items;         ///< Item ids packed by cell.
+    std::vector<sf::Vector2f> m_positions; ///< Item positions packed by cell (same order as m_items).
+    std::vector<uint32_t> m_itemCell;      ///< Scratch: cell of each item during build().
+};
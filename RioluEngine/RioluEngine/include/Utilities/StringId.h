@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file StringId.h
+ * @brief Declares 64-bit hashed string ids and the global intern table behind them.
+ */
+
+#include "../Prerequisites.h"
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+/**
+ * @class StringId
+ * @brief Name stored as the 64-bit FNV-1a hash of its text.
+ *
+ * Copies, compares and hashes like an integer. The text is kept once in the global
+ * StringTable by intern(); ids built from literals are hashed at compile time and do
+ * not touch the table, so `StringId("Player")` in a lookup costs nothing at run time.
+ */
+class StringId {
+public:
+    /**
+     * @brief Invalid id (hash 0).
+     */
+    constexpr StringId() = default;
+
+    /**
+     * @brief Id of a string literal, hashed at compile time. Does not intern the text.
+     */
+    template<size_t N>
+    explicit constexpr StringId(const char (&text)[N]) : m_hash(hash(std::string_view(text, N - 1))) {}
+
+    /**
+     * @brief Hash of @p text as used by StringId (never 0).
+     */
+    static constexpr uint64_t
+    hash(std::string_view text) {
+        uint64_t value = 14695981039346656037ull;
+        for (char c : text) {
+            value = (value ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+        }
+        return value != 0 ? value : 1;
+    }
+
+    /**
+     * @brief Id of @p text without interning it (for lookups of runtime strings).
+     */
+    static constexpr StringId
+    fromText(std::string_view text) {
+        StringId id;
+        id.m_hash = hash(text);
+        return id;
+    }
+
+    /**
+     * @brief Id of @p text, storing the text in the StringTable if it is new.
+     */
+    static StringId intern(std::string_view text);
+
+    /**
+     * @brief Returns the hash.
+     */
+    constexpr uint64_t getHash() const { return m_hash; }
+
+    /**
+     * @brief Returns false for the default id.
+     */
+    constexpr bool isValid() const { return m_hash != 0; }
+
+    /**
+     * @brief Returns the interned text, or "" if the id was never interned.
+     * Takes the table lock: meant for logs and tools, not hot paths.
+     */
+    const char* c_str() const;
+
+    friend constexpr bool operator==(StringId a, StringId b) { return a.m_hash == b.m_hash; }
+    friend constexpr bool operator!=(StringId a, StringId b) { return a.m_hash != b.m_hash; }
+
+private:
+    uint64_t m_hash = 0; ///< FNV-1a hash, 0 when invalid.
+};
+
+/**
+ * @brief Lets StringId key standard hash containers.
+ */
+template<>
+struct std::hash<StringId> {
+    size_t operator()(StringId id) const noexcept { return static_cast<size_t>(id.getHash()); }
+};
+
+/**
+ * @class StringTable
+ * @brief Global table of interned strings, keyed by StringId hash.
+ *
+ * Texts are copied once into large blocks that never move, so the pointers returned
+ * by find() stay valid for the program's lifetime. Slots are an open-addressing table
+ * of 16 bytes per string. Two different texts with the same hash are reported as an
+ * error instead of being silently merged. All methods are thread-safe.
+ */
+class StringTable {
+public:
+    /**
+     * @brief Returns the table.
+     */
+    static StringTable& instance();
+
+    /**
+     * @brief Stores @p text if it is new and returns its id.
+     */
+    StringId intern(std::string_view text);
+
+    /**
+     * @brief Returns the text of @p id, or nullptr if it was never interned.
+     */
+    const char* find(StringId id) const;
+
+    /**
+     * @brief Returns the number of interned strings.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the bytes held by the table (text blocks and slots).
+     */
+    size_t getByteSize() const;
+
+private:
+    StringTable();
+
+    /**
+     * @struct Slot
+     * @brief Hash and text of one string; hash 0 marks a free slot.
+     */
+    struct Slot {
+        uint64_t hash;    ///< StringId hash.
+        const char* text; ///< Null-terminated text in a block.
+    };
+
+    static constexpr size_t BlockSize = 64 * 1024; ///< Bytes per text block.
+
+    /**
+     * @brief Returns the slot holding @p hash or the free slot where it belongs.
+     */
+    size_t probe(uint64_t hash) const;
+
+    /**
+     * @brief Doubles the slot count.
+     */
+    void grow();
+
+    /**
+     * @brief Copies @p text into a block and returns the copy.
+     */
+    const char* store(std::string_view text);
+
+    mutable std::mutex m_mutex;                    ///< Guards everything below.
+    std::vector<Slot> m_slots;                     ///< Open-addressing table (power of two).
+    size_t m_count = 0;                            ///< Used slots.
+    std::vector<std::unique_ptr<char[]>> m_blocks; ///< Text storage.
+    char* m_current = nullptr;                     ///< Block receiving short strings.
+    size_t m_blockUsed = 0;                        ///< Bytes used in m_current.
+    size_t m_textBytes = 0;                        ///< Bytes allocated for text.
+};
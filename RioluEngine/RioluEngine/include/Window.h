@@ -1,76 +1,121 @@
-﻿#pragma once
+#pragma once
 
 /**
- * @file BaseApp.h
- * @brief Defines the BaseApp class, which manages the main application loop and rendering.
+ * @file Window.h
+ * @brief Declares the Window class, a wrapper around the SFML render window.
  */
 
 #include "Prerequisites.h"
-#include <Window.h>
-#include "CShape.h" // Agregado para que coincida con el c�digo del profesor
-#include "ECS/Actor.h"
-
-#include <vector>
-
- /**
-  * @class BaseApp
-  * @brief Core application class that controls initialization, the main loop, rendering, and cleanup.
-  */
-class
-	BaseApp {
+#include "Utilities/InputLog.h"
+
+/**
+ * @class Window
+ * @brief Encapsulates an SFML window, handling creation, events, rendering, and destruction.
+ *
+ * Every frame the window produces a list of input events (handleEvents) and a
+ * deltaTime (update). Both can be recorded to an InputLog and played back later.
+ * A headless window creates no SFML window: it takes its events and deltaTime
+ * from a replay log and ignores drawing, so replays run faster than real time.
+ */
+class Window {
 public:
-	/**
-	 * @brief Default constructor.
-	 */
-	BaseApp() = default;
-
-	/**
-	 * @brief Destructor that handles cleanup.
-	 */
-	~BaseApp();
-
-	/**
-	 * @brief Runs the application.
-	 *
-	 * This method initializes the application, enters the main loop, and calls update/render methods.
-	 * @return Exit code of the application.
-	 */
-	int
-		run();
-
-	/**
-	 * @brief Initializes the application window and objects.
-	 * @return True if initialization was successful, false otherwise.
-	 */
-	bool
-		init();
-
-	/**
-	 * @brief Updates the application logic (called every frame).
-	 */
-	void
-		update();
-
-	/**
-	 * @brief Renders all drawable objects to the screen.
-	 */
-	void
-		render();
-
-	/**
-	 * @brief Releases all allocated resources and cleans up.
-	 */
-	void
-		destroy();
+    /**
+     * @brief Default constructor.
+     */
+    Window() = default;
 
-private:
-	EngineUtilities::TSharedPointer<Window> m_windowPtr;   ///< Pointer to custom Window class using smart pointer.
-	EngineUtilities::TSharedPointer<CShape> m_shapePtr;    ///< Pointer to custom shape class using smart pointer.
-	EngineUtilities::TSharedPointer<Actor> m_ACircle;
+    /**
+     * @brief Creates the window.
+     *
+     * @param width Width of the window in pixels.
+     * @param height Height of the window in pixels.
+     * @param title Title of the window.
+     * @param headless If true no SFML window is created (replay only).
+     */
+    Window(int width, int height, const std::string& title, bool headless = false);
+
+    /**
+     * @brief Destructor. Closes the recording if one is active.
+     */
+    ~Window();
+
+    /**
+     * @brief Polls (or replays) the input events of the current frame.
+     */
+    void handleEvents();
+
+    /**
+     * @brief Returns true while the window is open, or while a replay has frames left.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Clears the window with a background color.
+     */
+    void clear(const sf::Color& color = sf::Color(0, 0, 0, 255));
+
+    /**
+     * @brief Draws a drawable object on the window.
+     */
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
 
+    /**
+     * @brief Displays the current frame.
+     */
+    void display();
 
+    /**
+     * @brief Computes (or replays) the deltaTime of the current frame.
+     */
+    void update();
 
+    /**
+     * @brief Destroys the window and releases its resources.
+     */
+    void destroy();
 
-	std::vector<sf::Vector2f> m_waypoints; ///< Lista de posiciones a seguir por el actor.
-	int m_currentWaypointIndex = 0;        ///< �ndice del waypoint actual.
-};
\ No newline at end of file
+    /**
+     * @brief Records the events and deltaTime of every following frame into @p path.
+     * @return false if the file could not be opened.
+     */
+    bool startRecording(const std::string& path);
+
+    /**
+     * @brief Ends the recording, storing @p stateHash so a replay can check it reached the same state.
+     */
+    void stopRecording(uint64_t stateHash);
+
+    /**
+     * @brief Replaces the live events and deltaTime by the ones stored in @p path.
+     * @return false if the log could not be read.
+     */
+    bool startReplay(const std::string& path);
+
+    /**
+     * @brief Returns true while a replay is active.
+     */
+    bool isReplaying() const { return m_replaying; }
+
+    /**
+     * @brief Returns the replay log (valid after startReplay).
+     */
+    const InputLogReader& getReplay() const { return m_replay; }
+
+    /**
+     * @brief Events of the current frame, identical in live and replay runs.
+     */
+    const std::vector<sf::Event>& getFrameEvents() const { return m_frameEvents; }
+
+    sf::Time deltaTime; ///< Duration of the last frame.
+    sf::Clock clock;    ///< Clock used to measure deltaTime.
+
+private:
+    EngineUtilities::TUniquePtr<sf::RenderWindow> m_windowPtr; ///< SFML window, null when headless.
+    bool m_headless = false;                  ///< True if no SFML window exists.
+    bool m_closed = false;                    ///< Set when a replayed Closed event is consumed.
+    std::vector<sf::Event> m_frameEvents;     ///< Events of the current frame.
+    InputLogWriter m_recording;               ///< Active recording, if any.
+    InputLogReader m_replay;                  ///< Active replay, if any.
+    bool m_replaying = false;                 ///< True while frames come from m_replay.
+    sf::Time m_replayDeltaTime;               ///< deltaTime read together with the frame events.
+};
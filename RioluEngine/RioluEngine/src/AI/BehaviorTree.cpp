@@ -0,0 +1,264 @@
+#include "AI/BehaviorTree.h"
+#include "Jobs/ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file BehaviorTree.cpp
+ * @brief Implements the tree builder and the batched, resumable interpreter.
+ */
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::sequence(const std::string& name) {
+    m_open.push_back(addNode(BTNodeType::Sequence, name));
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::selector(const std::string& name) {
+    m_open.push_back(addNode(BTNodeType::Selector, name));
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::inverter(const std::string& name) {
+    m_open.push_back(addNode(BTNodeType::Inverter, name));
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::succeeder(const std::string& name) {
+    m_open.push_back(addNode(BTNodeType::Succeeder, name));
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::action(const std::string& name, BTAction action, float argument) {
+    const uint16_t node = addNode(BTNodeType::Action, name);
+    m_tree->m_nodes[node].action = static_cast<uint16_t>(m_tree->m_actions.size());
+    m_tree->m_nodes[node].argument = argument;
+    m_tree->m_actions.push_back(action);
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::wait(float seconds) {
+    const uint16_t node = addNode(BTNodeType::Wait, "wait");
+    m_tree->m_nodes[node].argument = seconds;
+    return *this;
+}
+
+BehaviorTreeBuilder&
+BehaviorTreeBuilder::end() {
+    if (m_open.empty()) {
+        ERROR("BehaviorTreeBuilder", "end", "end() without an open node");
+        return *this;
+    }
+    const uint16_t node = m_open.back();
+    m_open.pop_back();
+    std::vector<BTNode>& nodes = m_tree->m_nodes;
+    nodes[node].end = static_cast<uint16_t>(nodes.size());
+
+    const BTNodeType type = nodes[node].type;
+    if ((type == BTNodeType::Inverter || type == BTNodeType::Succeeder) &&
+        (nodes.size() == node + 1u || nodes[node + 1].end != nodes.size())) {
+        ERROR("BehaviorTreeBuilder", "end", "A decorator needs exactly one child");
+    }
+    return *this;
+}
+
+std::shared_ptr<const BehaviorTree>
+BehaviorTreeBuilder::build(uint32_t blackboardSize) {
+    if (!m_open.empty() || m_tree->m_nodes.empty()) {
+        ERROR("BehaviorTreeBuilder", "build", "The tree is empty or has unclosed nodes");
+    }
+    m_tree->m_blackboardSize = blackboardSize;
+    std::shared_ptr<const BehaviorTree> tree = m_tree;
+    m_tree = std::make_shared<BehaviorTree>();
+    return tree;
+}
+
+uint16_t
+BehaviorTreeBuilder::addNode(BTNodeType type, const std::string& name) {
+    std::vector<BTNode>& nodes = m_tree->m_nodes;
+    if (nodes.size() >= 0xFFFF) {
+        ERROR("BehaviorTreeBuilder", "addNode", "Too many nodes");
+    }
+    if (m_open.size() >= BehaviorTree::MaxDepth) {
+        ERROR("BehaviorTreeBuilder", "addNode", "The tree is deeper than BehaviorTree::MaxDepth");
+    }
+    if (m_open.empty() && !nodes.empty()) {
+        ERROR("BehaviorTreeBuilder", "addNode", "A tree has a single root");
+    }
+
+    BTNode node;
+    node.type = type;
+    const uint16_t index = static_cast<uint16_t>(nodes.size());
+    // Leaves are closed at once; composites get their end in end().
+    node.end = static_cast<uint16_t>(index + 1);
+    nodes.push_back(node);
+    m_tree->m_names.push_back(name);
+    return index;
+}
+
+BehaviorTreeBatch::BehaviorTreeBatch(std::shared_ptr<const BehaviorTree> tree)
+    : m_tree(std::move(tree)),
+      m_nodes(m_tree->getNodes().data()),
+      m_blackboardSize(m_tree->getBlackboardSize()) {
+}
+
+uint32_t
+BehaviorTreeBatch::addAgent(uint32_t userId) {
+    const uint32_t agent = getAgentCount();
+    m_stacks.resize(m_stacks.size() + BehaviorTree::MaxDepth, 0);
+    m_depths.push_back(0);
+    m_runningTimes.push_back(0.f);
+    m_lastStatus.push_back(BTStatus::Success);
+    m_blackboards.resize(m_blackboards.size() + m_blackboardSize, 0.f);
+    m_userIds.push_back(userId);
+    return agent;
+}
+
+void
+BehaviorTreeBatch::removeAgent(uint32_t agent) {
+    const uint32_t last = getAgentCount() - 1;
+    if (agent != last) {
+        std::copy_n(&m_stacks[static_cast<size_t>(last) * BehaviorTree::MaxDepth], BehaviorTree::MaxDepth,
+                    &m_stacks[static_cast<size_t>(agent) * BehaviorTree::MaxDepth]);
+        std::copy_n(getBlackboard(last), m_blackboardSize, getBlackboard(agent));
+        m_depths[agent] = m_depths[last];
+        m_runningTimes[agent] = m_runningTimes[last];
+        m_lastStatus[agent] = m_lastStatus[last];
+        m_userIds[agent] = m_userIds[last];
+    }
+    m_stacks.resize(m_stacks.size() - BehaviorTree::MaxDepth);
+    m_blackboards.resize(m_blackboards.size() - m_blackboardSize);
+    m_depths.pop_back();
+    m_runningTimes.pop_back();
+    m_lastStatus.pop_back();
+    m_userIds.pop_back();
+}
+
+int
+BehaviorTreeBatch::getRunningNode(uint32_t agent) const {
+    const uint8_t depth = m_depths[agent];
+    return depth == 0 ? -1 : m_stacks[static_cast<size_t>(agent) * BehaviorTree::MaxDepth + depth - 1];
+}
+
+void
+BehaviorTreeBatch::tick(float deltaTime) {
+    tickRange(0, getAgentCount(), deltaTime);
+}
+
+void
+BehaviorTreeBatch::tick(float deltaTime, JobSystem& jobs) {
+    parallelFor(jobs, getAgentCount(), 512, [this, deltaTime](size_t begin, size_t end) {
+        tickRange(begin, end, deltaTime);
+    });
+}
+
+bool
+BehaviorTreeBatch::update(float deltaTime, float rate) {
+    const float interval = 1.f / rate;
+    m_accumulator += deltaTime;
+    if (m_accumulator < interval) {
+        return false;
+    }
+    // Never tick twice in a frame: a long frame just makes the next tick's deltaTime larger.
+    const float tickTime = m_accumulator;
+    m_accumulator = std::fmod(m_accumulator, interval);
+    tick(tickTime - m_accumulator);
+    return true;
+}
+
+size_t
+BehaviorTreeBatch::getBytesPerAgent() const {
+    return BehaviorTree::MaxDepth * sizeof(uint16_t) + sizeof(uint8_t) + sizeof(float) +
+           sizeof(BTStatus) + m_blackboardSize * sizeof(float) + sizeof(uint32_t);
+}
+
+void
+BehaviorTreeBatch::tickRange(size_t begin, size_t end, float deltaTime) {
+    for (size_t agent = begin; agent < end; ++agent) {
+        m_lastStatus[agent] = tickAgent(static_cast<uint32_t>(agent), deltaTime);
+    }
+}
+
+BTStatus
+BehaviorTreeBatch::tickAgent(uint32_t agent, float deltaTime) {
+    uint16_t* stack = &m_stacks[static_cast<size_t>(agent) * BehaviorTree::MaxDepth];
+    uint8_t& depth = m_depths[agent];
+    float& runningTime = m_runningTimes[agent];
+
+    // Enter: the node on top of the stack starts. Resume: the leaf on top continues.
+    // Exit: the node on top finished with `status`; its parent decides what is next.
+    enum class Mode { Enter, Resume, Exit };
+    Mode mode = Mode::Resume;
+    if (depth == 0) {
+        stack[depth++] = 0;
+        mode = Mode::Enter;
+    }
+
+    BTStatus status = BTStatus::Success;
+    for (;;) {
+        const uint16_t index = stack[depth - 1];
+        const BTNode& node = m_nodes[index];
+
+        if (mode == Mode::Enter) {
+            if (node.type == BTNodeType::Action || node.type == BTNodeType::Wait) {
+                runningTime = 0.f;
+                mode = Mode::Resume;
+            }
+            else if (node.end == index + 1) {
+                // Empty composite: a sequence of nothing succeeds, a selector fails.
+                status = node.type == BTNodeType::Selector ? BTStatus::Failure : BTStatus::Success;
+                mode = Mode::Exit;
+            }
+            else {
+                stack[depth++] = static_cast<uint16_t>(index + 1);
+                continue;
+            }
+        }
+
+        if (mode == Mode::Resume) {
+            if (node.type == BTNodeType::Wait) {
+                status = runningTime >= node.argument ? BTStatus::Success : BTStatus::Running;
+            }
+            else {
+                BTContext context{ *this, agent, m_userIds[agent], getBlackboard(agent),
+                                   deltaTime, runningTime, node.argument };
+                status = m_tree->getAction(node.action)(context);
+            }
+            if (status == BTStatus::Running) {
+                runningTime += deltaTime;
+                return status;
+            }
+            mode = Mode::Exit;
+        }
+
+        // Exit: pop the finished node and let its parent react.
+        if (--depth == 0) {
+            return status;
+        }
+        const BTNode& parent = m_nodes[stack[depth - 1]];
+        switch (parent.type) {
+        case BTNodeType::Sequence:
+        case BTNodeType::Selector: {
+            const BTStatus keepGoing = parent.type == BTNodeType::Sequence ? BTStatus::Success : BTStatus::Failure;
+            if (status == keepGoing && node.end < parent.end) {
+                stack[depth++] = node.end;
+                mode = Mode::Enter;
+            }
+            break;
+        }
+        case BTNodeType::Inverter:
+            status = status == BTStatus::Success ? BTStatus::Failure : BTStatus::Success;
+            break;
+        case BTNodeType::Succeeder:
+            status = BTStatus::Success;
+            break;
+        default:
+            break;
+        }
+    }
+}
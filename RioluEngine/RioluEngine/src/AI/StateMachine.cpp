@@ -0,0 +1,164 @@
+#include "AI/StateMachine.h"
+#include <algorithm>
+
+/**
+ * @file StateMachine.cpp
+ * @brief Implements the state tables and the grouped, deferred-transition tick.
+ */
+
+FSMId
+StateMachineDefinition::addState(const std::string& name, FSMStateUpdate update,
+                                 FSMStateHook onEnter, FSMStateHook onExit) {
+    if (m_states.size() >= InvalidFSMId) {
+        ERROR("StateMachineDefinition", "addState", "Too many states");
+    }
+    m_states.push_back({ name, update, onEnter, onExit });
+    m_table.resize(m_states.size() * m_events.size(), InvalidFSMId);
+    return static_cast<FSMId>(m_states.size() - 1);
+}
+
+FSMId
+StateMachineDefinition::addEvent(const std::string& name) {
+    if (m_events.size() >= InvalidFSMId) {
+        ERROR("StateMachineDefinition", "addEvent", "Too many events");
+    }
+    // The table is row-major by state; widen every row by one column.
+    const size_t oldEvents = m_events.size();
+    std::vector<FSMId> table(m_states.size() * (oldEvents + 1), InvalidFSMId);
+    for (size_t state = 0; state < m_states.size(); ++state) {
+        std::copy_n(m_table.begin() + state * oldEvents, oldEvents, table.begin() + state * (oldEvents + 1));
+    }
+    m_table.swap(table);
+    m_events.push_back(name);
+    return static_cast<FSMId>(oldEvents);
+}
+
+void
+StateMachineDefinition::addTransition(FSMId from, FSMId event, FSMId to) {
+    if (from >= m_states.size() || to >= m_states.size() || event >= m_events.size()) {
+        ERROR("StateMachineDefinition", "addTransition", "Unknown state or event");
+    }
+    m_table[static_cast<size_t>(from) * m_events.size() + event] = to;
+}
+
+StateMachine::StateMachine(std::shared_ptr<const StateMachineDefinition> definition)
+    : m_definition(std::move(definition)),
+      m_byState(m_definition->getStateCount()) {
+}
+
+uint32_t
+StateMachine::addAgent(uint32_t userId, FSMId state) {
+    if (m_ticking) {
+        ERROR("StateMachine", "addAgent", "Agents cannot be added during tick()");
+    }
+    if (state >= m_byState.size()) {
+        ERROR("StateMachine", "addAgent", "Unknown state");
+    }
+    uint32_t agent;
+    if (!m_freeAgents.empty()) {
+        agent = m_freeAgents.back();
+        m_freeAgents.pop_back();
+    }
+    else {
+        agent = static_cast<uint32_t>(m_agents.size());
+        m_agents.emplace_back();
+    }
+    m_agents[agent].lastTick = 0;
+    link(agent, state, userId);
+
+    if (FSMStateHook onEnter = m_definition->m_states[state].onEnter) {
+        onEnter(*this, agent);
+    }
+    return agent;
+}
+
+void
+StateMachine::removeAgent(uint32_t agent) {
+    if (m_ticking) {
+        ERROR("StateMachine", "removeAgent", "Agents cannot be removed during tick()");
+    }
+    if (agent >= m_agents.size() || m_agents[agent].state == InvalidFSMId) {
+        ERROR("StateMachine", "removeAgent", "Unknown agent");
+    }
+    if (FSMStateHook onExit = m_definition->m_states[m_agents[agent].state].onExit) {
+        onExit(*this, agent);
+    }
+    unlink(agent);
+    m_agents[agent].state = InvalidFSMId;
+    m_freeAgents.push_back(agent);
+}
+
+void
+StateMachine::tick(float deltaTime) {
+    m_ticking = true;
+    for (size_t state = 0; state < m_byState.size(); ++state) {
+        const FSMStateUpdate update = m_definition->m_states[state].update;
+        const StateList& list = m_byState[state];
+        if (update && !list.agents.empty()) {
+            update({ *this, static_cast<FSMId>(state), list.agents.data(), list.userIds.data(),
+                     list.enteredAt.data(), list.agents.size(), m_time, deltaTime });
+        }
+    }
+    m_time += deltaTime;
+    applyTransitions();
+    ++m_tickCount;
+    m_ticking = false;
+}
+
+void
+StateMachine::link(uint32_t agent, FSMId state, uint32_t userId) {
+    StateList& list = m_byState[state];
+    m_agents[agent].state = state;
+    m_agents[agent].slot = static_cast<uint32_t>(list.agents.size());
+    list.agents.push_back(agent);
+    list.userIds.push_back(userId);
+    list.enteredAt.push_back(m_time);
+}
+
+uint32_t
+StateMachine::unlink(uint32_t agent) {
+    StateList& list = m_byState[m_agents[agent].state];
+    const uint32_t slot = m_agents[agent].slot;
+    const uint32_t userId = list.userIds[slot];
+    list.agents[slot] = list.agents.back();
+    list.userIds[slot] = list.userIds.back();
+    list.enteredAt[slot] = list.enteredAt.back();
+    m_agents[list.agents[slot]].slot = slot;
+    list.agents.pop_back();
+    list.userIds.pop_back();
+    list.enteredAt.pop_back();
+    return userId;
+}
+
+void
+StateMachine::applyTransitions() {
+    // Hooks may raise events; those wait for the next tick.
+    m_applying.swap(m_pending);
+    m_pending.clear();
+
+    size_t transitions = 0;
+    const StateMachineDefinition& definition = *m_definition;
+    for (const PendingEvent& pending : m_applying) {
+        Agent& agent = m_agents[pending.agent];
+        if (agent.state == InvalidFSMId || agent.lastTick == m_tickCount) {
+            continue;
+        }
+        const FSMId from = agent.state;
+        const FSMId to = definition.getTransition(from, pending.event);
+        if (to == InvalidFSMId) {
+            continue;
+        }
+
+        if (FSMStateHook onExit = definition.m_states[from].onExit) {
+            onExit(*this, pending.agent);
+        }
+        link(pending.agent, to, unlink(pending.agent));
+        agent.lastTick = m_tickCount;
+        if (FSMStateHook onEnter = definition.m_states[to].onEnter) {
+            onEnter(*this, pending.agent);
+        }
+        ++transitions;
+    }
+    m_applying.clear();
+    m_lastTransitions = transitions;
+}
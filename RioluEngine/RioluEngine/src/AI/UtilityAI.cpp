@@ -0,0 +1,209 @@
+#include "AI/UtilityAI.h"
+#include "Jobs/ParallelFor.h"
+#include "Utilities/Simd.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file UtilityAI.cpp
+ * @brief Implements the response curves, the model and the four-lane batch scoring.
+ */
+
+namespace {
+    /**
+     * @brief Agents scored together; scores of one block stay in L1.
+     */
+    const size_t BlockSize = 256;
+
+    /**
+     * @brief Multiplies @p scores by the curve of @p Type applied to the normalized
+     * @p raw inputs, four agents at a time. The curve type is a template parameter so
+     * the loop body has no branch.
+     */
+    template<UtilityCurveType Type>
+    void
+    applyCurve(const UtilityCurve& curve, float inputMin, float inputScale,
+               const float* raw, float* scores, size_t count) {
+        const Float4 zero = Float4::splat(0.f);
+        const Float4 one = Float4::splat(1.f);
+        const Float4 minimum = Float4::splat(inputMin);
+        const Float4 scale = Float4::splat(inputScale);
+        const Float4 slope = Float4::splat(curve.slope);
+        const Float4 negativeSlope = Float4::splat(-curve.slope);
+        const Float4 height = Float4::splat(curve.height);
+        const Float4 shift = Float4::splat(curve.shift);
+        const Float4 offset = Float4::splat(curve.offset);
+
+        for (size_t i = 0; i < count; i += 4) {
+            const Float4 x = clamp01((Float4::load(raw + i) - minimum) * scale);
+            const Float4 shifted = x - shift;
+            Float4 y;
+            if constexpr (Type == UtilityCurveType::Linear) {
+                y = slope * shifted + offset;
+            }
+            else if constexpr (Type == UtilityCurveType::Quadratic) {
+                y = slope * shifted * shifted + offset;
+            }
+            else if constexpr (Type == UtilityCurveType::Logistic) {
+                y = height / (one + exp(negativeSlope * shifted)) + offset;
+            }
+            else {
+                y = select(x >= shift, height, zero) + offset;
+            }
+            (Float4::load(scores + i) * clamp01(y)).store(scores + i);
+        }
+    }
+}
+
+float
+UtilityCurve::evaluate(float x) const {
+    const float shifted = x - shift;
+    float y = 0.f;
+    switch (type) {
+    case UtilityCurveType::Linear:
+        y = slope * shifted + offset;
+        break;
+    case UtilityCurveType::Quadratic:
+        y = slope * shifted * shifted + offset;
+        break;
+    case UtilityCurveType::Logistic:
+        y = height / (1.f + std::exp(-slope * shifted)) + offset;
+        break;
+    case UtilityCurveType::Step:
+        y = (x >= shift ? height : 0.f) + offset;
+        break;
+    }
+    return std::min(std::max(y, 0.f), 1.f);
+}
+
+uint32_t
+UtilityModel::addInput(const std::string& name) {
+    m_inputs.push_back(name);
+    return static_cast<uint32_t>(m_inputs.size() - 1);
+}
+
+uint32_t
+UtilityModel::addAction(const std::string& name, float weight) {
+    m_actions.push_back({ name, weight, {} });
+    return static_cast<uint32_t>(m_actions.size() - 1);
+}
+
+void
+UtilityModel::addConsideration(uint32_t action, uint32_t input, float inputMin, float inputMax,
+                               const UtilityCurve& curve) {
+    if (action >= m_actions.size() || input >= m_inputs.size()) {
+        ERROR("UtilityModel", "addConsideration", "Unknown action or input");
+    }
+    if (inputMax == inputMin) {
+        ERROR("UtilityModel", "addConsideration", "Empty input range");
+    }
+    m_actions[action].considerations.push_back({ input, inputMin, 1.f / (inputMax - inputMin), curve });
+}
+
+float
+UtilityModel::score(uint32_t action, const float* inputs) const {
+    const Action& scored = m_actions[action];
+    float score = scored.weight;
+    for (const Consideration& consideration : scored.considerations) {
+        const float x = (inputs[consideration.input] - consideration.inputMin) * consideration.inputScale;
+        score *= consideration.curve.evaluate(std::min(std::max(x, 0.f), 1.f));
+    }
+    return score;
+}
+
+UtilityBatch::UtilityBatch(std::shared_ptr<const UtilityModel> model, size_t keep)
+    : m_model(std::move(model)), m_keep(keep) {
+    if (keep == 0 || keep > MaxKept) {
+        ERROR("UtilityBatch", "UtilityBatch", "keep must be between 1 and MaxKept");
+    }
+}
+
+void
+UtilityBatch::resize(size_t agentCount) {
+    const size_t stride = (agentCount + 3) & ~size_t(3);
+    std::vector<float> inputs(m_model->getInputCount() * stride, 0.f);
+    for (size_t input = 0; input < m_model->getInputCount(); ++input) {
+        std::copy_n(m_inputs.begin() + input * m_stride, std::min(m_agentCount, agentCount),
+                    inputs.begin() + input * stride);
+    }
+    m_inputs.swap(inputs);
+    m_topScores.assign(m_keep * stride, -1.f);
+    m_topActions.assign(m_keep * stride, -1.f);
+    m_agentCount = agentCount;
+    m_stride = stride;
+}
+
+void
+UtilityBatch::evaluate() {
+    evaluateRange(0, m_agentCount);
+}
+
+void
+UtilityBatch::evaluate(JobSystem& jobs) {
+    // A multiple of four, so every chunk starts on a lane group.
+    parallelFor(jobs, m_agentCount, 1024, [this](size_t begin, size_t end) {
+        evaluateRange(begin, end);
+    });
+}
+
+uint32_t
+UtilityBatch::getBestAction(size_t agent, size_t rank) const {
+    const float action = m_topActions[rank * m_stride + agent];
+    return action < 0.f ? InvalidUtilityAction : static_cast<uint32_t>(action);
+}
+
+void
+UtilityBatch::evaluateRange(size_t begin, size_t end) {
+    const std::vector<UtilityModel::Action>& actions = m_model->m_actions;
+    alignas(16) float scores[BlockSize];
+
+    for (size_t block = begin; block < end; block += BlockSize) {
+        // Lanes past m_agentCount are padding; scoring them is harmless.
+        const size_t count = ((std::min(end, block + BlockSize) - block) + 3) & ~size_t(3);
+        for (size_t rank = 0; rank < m_keep; ++rank) {
+            std::fill_n(&m_topScores[rank * m_stride + block], count, -1.f);
+            std::fill_n(&m_topActions[rank * m_stride + block], count, -1.f);
+        }
+
+        for (size_t action = 0; action < actions.size(); ++action) {
+            std::fill_n(scores, count, actions[action].weight);
+            for (const UtilityModel::Consideration& consideration : actions[action].considerations) {
+                const float* raw = &m_inputs[consideration.input * m_stride + block];
+                const UtilityCurve& curve = consideration.curve;
+                switch (curve.type) {
+                case UtilityCurveType::Linear:
+                    applyCurve<UtilityCurveType::Linear>(curve, consideration.inputMin, consideration.inputScale, raw, scores, count);
+                    break;
+                case UtilityCurveType::Quadratic:
+                    applyCurve<UtilityCurveType::Quadratic>(curve, consideration.inputMin, consideration.inputScale, raw, scores, count);
+                    break;
+                case UtilityCurveType::Logistic:
+                    applyCurve<UtilityCurveType::Logistic>(curve, consideration.inputMin, consideration.inputScale, raw, scores, count);
+                    break;
+                case UtilityCurveType::Step:
+                    applyCurve<UtilityCurveType::Step>(curve, consideration.inputMin, consideration.inputScale, raw, scores, count);
+                    break;
+                }
+            }
+
+            // Insert into the ranks: lanes that beat a rank take it and push its old
+            // entry down.
+            const Float4 actionLanes = Float4::splat(static_cast<float>(action));
+            for (size_t i = 0; i < count; i += 4) {
+                Float4 carryScore = Float4::load(scores + i);
+                Float4 carryAction = actionLanes;
+                for (size_t rank = 0; rank < m_keep; ++rank) {
+                    float* topScore = &m_topScores[rank * m_stride + block + i];
+                    float* topAction = &m_topActions[rank * m_stride + block + i];
+                    const Float4 rankScore = Float4::load(topScore);
+                    const Float4 rankAction = Float4::load(topAction);
+                    const Float4 better = carryScore > rankScore;
+                    select(better, carryScore, rankScore).store(topScore);
+                    select(better, carryAction, rankAction).store(topAction);
+                    carryScore = select(better, rankScore, carryScore);
+                    carryAction = select(better, rankAction, carryAction);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,479 @@
+#include "Animation/SkeletalAnimation.h"
+#include "Jobs/ParallelFor.h"
+#include "Jobs/ScratchAllocator.h"
+#include "Utilities/Simd.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file SkeletalAnimation.cpp
+ * @brief Implements clip compression and the batched pose, blend and skinning passes.
+ */
+
+namespace {
+    const float Pi = 3.14159265358979f;
+    const float DegreesToRadians = Pi / 180.f;
+    const float RadiansToDegrees = 180.f / Pi;
+
+    /**
+     * @brief Channel indices of a pose in SkeletalClip layout.
+     */
+    enum PoseChannel : size_t { ChannelX, ChannelY, ChannelRotation, ChannelScaleX, ChannelScaleY };
+
+    /**
+     * @brief Matrix entries in structure-of-arrays buffers.
+     */
+    enum MatrixEntry : size_t { EntryA, EntryB, EntryC, EntryD, EntryTx, EntryTy, EntryCount };
+
+    size_t
+    roundUpToFour(size_t count) {
+        return (count + 3) & ~size_t(3);
+    }
+}
+
+BoneMatrix
+BoneMatrix::fromPose(const BonePose& pose) {
+    const float angle = pose.rotation * DegreesToRadians;
+    const float cosine = std::cos(angle);
+    const float sine = std::sin(angle);
+    return BoneMatrix{ cosine * pose.scaleX, sine * pose.scaleX, -sine * pose.scaleY, cosine * pose.scaleY, pose.x, pose.y };
+}
+
+BoneMatrix
+BoneMatrix::operator*(const BoneMatrix& child) const {
+    return BoneMatrix{ a * child.a + c * child.b,
+                       b * child.a + d * child.b,
+                       a * child.c + c * child.d,
+                       b * child.c + d * child.d,
+                       a * child.tx + c * child.ty + tx,
+                       b * child.tx + d * child.ty + ty };
+}
+
+BoneMatrix
+BoneMatrix::inverse() const {
+    const float determinant = a * d - b * c;
+    const float inv = determinant != 0.f ? 1.f / determinant : 0.f;
+    return BoneMatrix{ d * inv, -b * inv, -c * inv, a * inv,
+                       (c * ty - d * tx) * inv, (b * tx - a * ty) * inv };
+}
+
+uint16_t
+Skeleton::addBone(const std::string& name, uint16_t parent, const BonePose& bindPose) {
+    if (m_parents.size() >= MaxBones) {
+        ERROR("Skeleton", "addBone", "Too many bones");
+    }
+    if (parent != NoParentBone && parent >= m_parents.size()) {
+        ERROR("Skeleton", "addBone", "Parent bone must be added first");
+    }
+    const BoneMatrix local = BoneMatrix::fromPose(bindPose);
+    const BoneMatrix world = parent == NoParentBone ? local : m_bindWorld[parent] * local;
+    m_names.push_back(name);
+    m_parents.push_back(parent);
+    m_bindPoses.push_back(bindPose);
+    m_bindWorld.push_back(world);
+    m_inverseBind.push_back(world.inverse());
+    return static_cast<uint16_t>(m_parents.size() - 1);
+}
+
+uint16_t
+Skeleton::findBone(const std::string& name) const {
+    for (size_t bone = 0; bone < m_names.size(); ++bone) {
+        if (m_names[bone] == name) {
+            return static_cast<uint16_t>(bone);
+        }
+    }
+    return NoParentBone;
+}
+
+std::shared_ptr<const SkeletalClip>
+SkeletalClip::compress(const Skeleton& skeleton, float sampleRate, const std::vector<BonePose>& poses, bool loop) {
+    const size_t bones = skeleton.getBoneCount();
+    if (!(sampleRate > 0.f)) {
+        ERROR("SkeletalClip", "compress", "Sample rate must be positive");
+    }
+    if (bones == 0 || poses.empty() || poses.size() % bones != 0) {
+        ERROR("SkeletalClip", "compress", "Poses must hold whole frames of the skeleton");
+    }
+
+    std::shared_ptr<SkeletalClip> clip = std::make_shared<SkeletalClip>();
+    const size_t sourceFrames = poses.size() / bones;
+    clip->m_boneCount = bones;
+    clip->m_stride = roundUpToFour(bones);
+    clip->m_frameCount = sourceFrames + (loop ? 1 : 0);
+    clip->m_sampleRate = sampleRate;
+    clip->m_duration = static_cast<float>(clip->m_frameCount - 1) / sampleRate;
+    clip->m_loop = loop;
+
+    // Decode to floats first: radians, each rotation unwrapped toward the previous frame.
+    const size_t stride = clip->m_stride;
+    const size_t frameSize = Channels * stride;
+    std::vector<float> values(clip->m_frameCount * frameSize, 0.f);
+    for (size_t frame = 0; frame < clip->m_frameCount; ++frame) {
+        float* channels = &values[frame * frameSize];
+        for (size_t bone = 0; bone < bones; ++bone) {
+            const BonePose& pose = poses[(frame % sourceFrames) * bones + bone];
+            float rotation = pose.rotation * DegreesToRadians;
+            if (frame > 0) {
+                const float previous = values[(frame - 1) * frameSize + ChannelRotation * stride + bone];
+                rotation += 2.f * Pi * std::round((previous - rotation) / (2.f * Pi));
+            }
+            channels[ChannelX * stride + bone] = pose.x;
+            channels[ChannelY * stride + bone] = pose.y;
+            channels[ChannelRotation * stride + bone] = rotation;
+            channels[ChannelScaleX * stride + bone] = pose.scaleX;
+            channels[ChannelScaleY * stride + bone] = pose.scaleY;
+        }
+    }
+
+    clip->m_minimum.assign(frameSize, 0.f);
+    clip->m_step.assign(frameSize, 0.f);
+    for (size_t entry = 0; entry < frameSize; ++entry) {
+        float minimum = values[entry];
+        float maximum = values[entry];
+        for (size_t frame = 1; frame < clip->m_frameCount; ++frame) {
+            minimum = std::min(minimum, values[frame * frameSize + entry]);
+            maximum = std::max(maximum, values[frame * frameSize + entry]);
+        }
+        clip->m_minimum[entry] = minimum;
+        clip->m_step[entry] = (maximum - minimum) / 65535.f;
+    }
+
+    clip->m_keys.assign(values.size(), 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const size_t entry = i % frameSize;
+        if (clip->m_step[entry] > 0.f) {
+            const float key = std::round((values[i] - clip->m_minimum[entry]) / clip->m_step[entry]);
+            clip->m_keys[i] = static_cast<uint16_t>(std::min(std::max(key, 0.f), 65535.f));
+        }
+    }
+    return clip;
+}
+
+size_t
+SkeletalClip::getByteSize() const {
+    return (m_minimum.size() + m_step.size()) * sizeof(float) + m_keys.size() * sizeof(uint16_t);
+}
+
+uint32_t
+SkinnedMesh::addVertex(const SkinnedVertex& vertex) {
+    m_vertices.push_back(vertex);
+    return static_cast<uint32_t>(m_vertices.size() - 1);
+}
+
+void
+SkinnedMesh::addTriangle(uint32_t first, uint32_t second, uint32_t third) {
+    if (first >= m_vertices.size() || second >= m_vertices.size() || third >= m_vertices.size()) {
+        ERROR("SkinnedMesh", "addTriangle", "Vertex index out of range");
+    }
+    m_indices.push_back(first);
+    m_indices.push_back(second);
+    m_indices.push_back(third);
+}
+
+SkeletalAnimationSystem::SkeletalAnimationSystem(std::shared_ptr<const Skeleton> skeleton,
+                                                 std::shared_ptr<const SkinnedMesh> mesh)
+    : m_skeleton(std::move(skeleton)), m_mesh(std::move(mesh)) {
+    const size_t bones = m_skeleton->getBoneCount();
+    if (bones == 0) {
+        ERROR("SkeletalAnimationSystem", "SkeletalAnimationSystem", "Skeleton has no bones");
+    }
+    m_boneStride = roundUpToFour(bones);
+    m_vertexStride = roundUpToFour(m_mesh->getVertexCount());
+
+    m_bindPose.assign(SkeletalClip::Channels * m_boneStride, 0.f);
+    for (size_t bone = 0; bone < bones; ++bone) {
+        const BonePose& pose = m_skeleton->getBindPose(static_cast<uint16_t>(bone));
+        m_bindPose[ChannelX * m_boneStride + bone] = pose.x;
+        m_bindPose[ChannelY * m_boneStride + bone] = pose.y;
+        m_bindPose[ChannelRotation * m_boneStride + bone] = pose.rotation * DegreesToRadians;
+        m_bindPose[ChannelScaleX * m_boneStride + bone] = pose.scaleX;
+        m_bindPose[ChannelScaleY * m_boneStride + bone] = pose.scaleY;
+    }
+
+    // Padding vertices sit at the origin, fully bound to bone 0.
+    m_bindX.assign(m_vertexStride, 0.f);
+    m_bindY.assign(m_vertexStride, 0.f);
+    m_weights.assign(m_vertexStride, 1.f);
+    m_bones.assign(m_vertexStride * 2, 0);
+    for (size_t vertex = 0; vertex < m_mesh->getVertexCount(); ++vertex) {
+        const SkinnedVertex& source = m_mesh->getVertex(static_cast<uint32_t>(vertex));
+        if (source.bones[0] >= bones || source.bones[1] >= bones) {
+            ERROR("SkeletalAnimationSystem", "SkeletalAnimationSystem", "Mesh vertex bound to a missing bone");
+        }
+        m_bindX[vertex] = source.position.x;
+        m_bindY[vertex] = source.position.y;
+        m_weights[vertex] = source.weight;
+        m_bones[vertex * 2] = source.bones[0];
+        m_bones[vertex * 2 + 1] = source.bones[1];
+    }
+}
+
+SkeletalClipId
+SkeletalAnimationSystem::addClip(std::shared_ptr<const SkeletalClip> clip) {
+    if (!clip || clip->getBoneCount() != m_skeleton->getBoneCount()) {
+        ERROR("SkeletalAnimationSystem", "addClip", "Clip does not match the skeleton");
+    }
+    if (m_clips.size() >= InvalidSkeletalClip) {
+        ERROR("SkeletalAnimationSystem", "addClip", "Too many clips");
+    }
+    m_clips.push_back(std::move(clip));
+    return static_cast<SkeletalClipId>(m_clips.size() - 1);
+}
+
+size_t
+SkeletalAnimationSystem::addCharacter(const EngineUtilities::TSharedPointer<Transform>& root) {
+    Character character;
+    character.root = root;
+    m_characters.push_back(character);
+    m_worlds.resize(m_characters.size() * m_skeleton->getBoneCount());
+
+    // Texture coordinates never change; update() only rewrites positions.
+    const std::vector<uint32_t>& indices = m_mesh->getIndices();
+    for (uint32_t index : indices) {
+        const SkinnedVertex& vertex = m_mesh->getVertex(index);
+        m_vertices.push_back(sf::Vertex(vertex.position, sf::Color::White, vertex.texCoords));
+    }
+    return m_characters.size() - 1;
+}
+
+void
+SkeletalAnimationSystem::removeCharacter(size_t character) {
+    const size_t last = m_characters.size() - 1;
+    const size_t bones = m_skeleton->getBoneCount();
+    const size_t corners = getVerticesPerCharacter();
+    if (character != last) {
+        m_characters[character] = m_characters[last];
+        std::copy_n(m_worlds.begin() + last * bones, bones, m_worlds.begin() + character * bones);
+        std::copy_n(m_vertices.begin() + last * corners, corners, m_vertices.begin() + character * corners);
+    }
+    m_characters.pop_back();
+    m_worlds.resize(last * bones);
+    m_vertices.resize(last * corners);
+
+    m_attachments.erase(std::remove_if(m_attachments.begin(), m_attachments.end(),
+                                       [character](const Attachment& attachment) { return attachment.character == character; }),
+                        m_attachments.end());
+    for (Attachment& attachment : m_attachments) {
+        if (attachment.character == last) {
+            attachment.character = character;
+        }
+    }
+}
+
+void
+SkeletalAnimationSystem::play(size_t character, SkeletalClipId clip, float fadeTime) {
+    Character& state = m_characters[character];
+    if (fadeTime > 0.f && state.layers[0].clip != InvalidSkeletalClip) {
+        // The old clip becomes the blended layer and fades out.
+        state.layers[1] = state.layers[0];
+        state.weight = 1.f;
+        state.fadeRate = -1.f / fadeTime;
+    }
+    else {
+        state.layers[1] = Layer();
+        state.weight = 0.f;
+        state.fadeRate = 0.f;
+    }
+    state.layers[0].clip = clip;
+    state.layers[0].time = 0.f;
+}
+
+void
+SkeletalAnimationSystem::setBlend(size_t character, SkeletalClipId clip, float weight) {
+    Character& state = m_characters[character];
+    if (state.layers[1].clip != clip) {
+        state.layers[1].clip = clip;
+        state.layers[1].time = state.layers[0].time;
+    }
+    state.weight = std::min(std::max(weight, 0.f), 1.f);
+    state.fadeRate = 0.f;
+}
+
+void
+SkeletalAnimationSystem::attach(size_t character, uint16_t bone,
+                                const EngineUtilities::TSharedPointer<Transform>& target) {
+    if (bone >= m_skeleton->getBoneCount() || target.isNull()) {
+        ERROR("SkeletalAnimationSystem", "attach", "Invalid bone or target");
+    }
+    m_attachments.push_back(Attachment{ character, bone, target });
+}
+
+void
+SkeletalAnimationSystem::update(float deltaTime) {
+    updateRange(0, m_characters.size(), deltaTime);
+    applyAttachments();
+}
+
+void
+SkeletalAnimationSystem::update(float deltaTime, JobSystem& jobs) {
+    parallelFor(jobs, m_characters.size(), 16, [this, deltaTime](size_t begin, size_t end) {
+        updateRange(begin, end, deltaTime);
+    });
+    applyAttachments();
+}
+
+void
+SkeletalAnimationSystem::sample(const Layer& layer, float* pose) const {
+    const SkeletalClip& clip = *m_clips[layer.clip];
+    const size_t stride = clip.m_stride;
+    const size_t frameSize = SkeletalClip::Channels * stride;
+    const size_t lastFrame = clip.m_frameCount - 1;
+
+    const float position = std::max(layer.time, 0.f) * clip.m_sampleRate;
+    const size_t frame = std::min(static_cast<size_t>(position), lastFrame);
+    const size_t next = std::min(frame + 1, lastFrame);
+    const Float4 t = Float4::splat(frame == lastFrame ? 0.f : position - static_cast<float>(frame));
+
+    const uint16_t* first = &clip.m_keys[frame * frameSize];
+    const uint16_t* second = &clip.m_keys[next * frameSize];
+    for (size_t i = 0; i < frameSize; i += 4) {
+        const Float4 from = Float4::loadUint16(first + i);
+        const Float4 key = from + (Float4::loadUint16(second + i) - from) * t;
+        (Float4::load(&clip.m_minimum[i]) + Float4::load(&clip.m_step[i]) * key).store(pose + i);
+    }
+}
+
+void
+SkeletalAnimationSystem::updateRange(size_t begin, size_t end, float deltaTime) {
+    const size_t bones = m_skeleton->getBoneCount();
+    const size_t boneStride = m_boneStride;
+    const size_t poseSize = SkeletalClip::Channels * boneStride;
+    const uint16_t* parents = m_skeleton->m_parents.data();
+    const BoneMatrix* inverseBind = m_skeleton->m_inverseBind.data();
+    const std::vector<uint32_t>& indices = m_mesh->getIndices();
+    const size_t corners = indices.size();
+
+    ScratchScope scratch;
+    float* pose = scratch->allocateArray<float>(poseSize);
+    float* blend = scratch->allocateArray<float>(poseSize);
+    float* local = scratch->allocateArray<float>(EntryCount * boneStride);
+    float* skin = scratch->allocateArray<float>(EntryCount * boneStride);
+    float* skinnedX = scratch->allocateArray<float>(m_vertexStride);
+    float* skinnedY = scratch->allocateArray<float>(m_vertexStride);
+
+    for (size_t index = begin; index < end; ++index) {
+        Character& character = m_characters[index];
+
+        // Advance the layers and the cross-fade.
+        for (Layer& layer : character.layers) {
+            if (layer.clip == InvalidSkeletalClip) {
+                continue;
+            }
+            const SkeletalClip& clip = *m_clips[layer.clip];
+            layer.time += deltaTime;
+            if (clip.m_loop) {
+                layer.time = clip.m_duration > 0.f ? std::fmod(layer.time, clip.m_duration) : 0.f;
+            }
+            else {
+                layer.time = std::min(layer.time, clip.m_duration);
+            }
+        }
+        if (character.fadeRate != 0.f) {
+            character.weight += character.fadeRate * deltaTime;
+            if (character.weight <= 0.f) {
+                character.weight = 0.f;
+                character.fadeRate = 0.f;
+                character.layers[1] = Layer();
+            }
+        }
+
+        // Local pose: sample, then blend the second layer in four lanes.
+        if (character.layers[0].clip != InvalidSkeletalClip) {
+            sample(character.layers[0], pose);
+        }
+        else {
+            std::copy(m_bindPose.begin(), m_bindPose.end(), pose);
+        }
+        if (character.layers[1].clip != InvalidSkeletalClip && character.weight > 0.f) {
+            sample(character.layers[1], blend);
+            const Float4 weight = Float4::splat(character.weight);
+            const Float4 turn = Float4::splat(2.f * Pi);
+            const Float4 inverseTurn = Float4::splat(1.f / (2.f * Pi));
+            for (size_t channel = 0; channel < SkeletalClip::Channels; ++channel) {
+                float* base = pose + channel * boneStride;
+                const float* target = blend + channel * boneStride;
+                for (size_t bone = 0; bone < boneStride; bone += 4) {
+                    const Float4 from = Float4::load(base + bone);
+                    Float4 delta = Float4::load(target + bone) - from;
+                    if (channel == ChannelRotation) {
+                        // Rotations take the short way round.
+                        delta = delta - turn * floor(delta * inverseTurn + Float4::splat(0.5f));
+                    }
+                    (from + delta * weight).store(base + bone);
+                }
+            }
+        }
+
+        // Local matrices, four bones at a time.
+        for (size_t bone = 0; bone < boneStride; bone += 4) {
+            Float4 sine;
+            Float4 cosine;
+            sincos(Float4::load(pose + ChannelRotation * boneStride + bone), sine, cosine);
+            const Float4 scaleX = Float4::load(pose + ChannelScaleX * boneStride + bone);
+            const Float4 scaleY = Float4::load(pose + ChannelScaleY * boneStride + bone);
+            (cosine * scaleX).store(local + EntryA * boneStride + bone);
+            (sine * scaleX).store(local + EntryB * boneStride + bone);
+            (Float4::splat(0.f) - sine * scaleY).store(local + EntryC * boneStride + bone);
+            (cosine * scaleY).store(local + EntryD * boneStride + bone);
+            Float4::load(pose + ChannelX * boneStride + bone).store(local + EntryTx * boneStride + bone);
+            Float4::load(pose + ChannelY * boneStride + bone).store(local + EntryTy * boneStride + bone);
+        }
+
+        // World matrices (parents first) and skin matrices.
+        BoneMatrix root;
+        if (!character.root.isNull()) {
+            const sf::Vector2f position = character.root->getPosition();
+            const sf::Vector2f scale = character.root->getScale();
+            root = BoneMatrix::fromPose(BonePose{ position.x, position.y, character.root->getRotation().x, scale.x, scale.y });
+        }
+        BoneMatrix* worlds = &m_worlds[index * bones];
+        for (size_t bone = 0; bone < bones; ++bone) {
+            const BoneMatrix matrix{ local[EntryA * boneStride + bone], local[EntryB * boneStride + bone],
+                                     local[EntryC * boneStride + bone], local[EntryD * boneStride + bone],
+                                     local[EntryTx * boneStride + bone], local[EntryTy * boneStride + bone] };
+            worlds[bone] = (parents[bone] == NoParentBone ? root : worlds[parents[bone]]) * matrix;
+            const BoneMatrix skinMatrix = worlds[bone] * inverseBind[bone];
+            skin[EntryA * boneStride + bone] = skinMatrix.a;
+            skin[EntryB * boneStride + bone] = skinMatrix.b;
+            skin[EntryC * boneStride + bone] = skinMatrix.c;
+            skin[EntryD * boneStride + bone] = skinMatrix.d;
+            skin[EntryTx * boneStride + bone] = skinMatrix.tx;
+            skin[EntryTy * boneStride + bone] = skinMatrix.ty;
+        }
+
+        // Skinning: blend the two bone matrices of four vertices, then transform them.
+        for (size_t vertex = 0; vertex < m_vertexStride; vertex += 4) {
+            const uint16_t* vertexBones = &m_bones[vertex * 2];
+            const Float4 weight = Float4::load(&m_weights[vertex]);
+            Float4 matrix[EntryCount];
+            for (size_t entry = 0; entry < EntryCount; ++entry) {
+                const float* values = skin + entry * boneStride;
+                const Float4 first = Float4::set(values[vertexBones[0]], values[vertexBones[2]],
+                                                 values[vertexBones[4]], values[vertexBones[6]]);
+                const Float4 second = Float4::set(values[vertexBones[1]], values[vertexBones[3]],
+                                                  values[vertexBones[5]], values[vertexBones[7]]);
+                matrix[entry] = second + (first - second) * weight;
+            }
+            const Float4 x = Float4::load(&m_bindX[vertex]);
+            const Float4 y = Float4::load(&m_bindY[vertex]);
+            (matrix[EntryA] * x + matrix[EntryC] * y + matrix[EntryTx]).store(skinnedX + vertex);
+            (matrix[EntryB] * x + matrix[EntryD] * y + matrix[EntryTy]).store(skinnedY + vertex);
+        }
+
+        sf::Vertex* out = &m_vertices[index * corners];
+        for (size_t corner = 0; corner < corners; ++corner) {
+            out[corner].position = sf::Vector2f(skinnedX[indices[corner]], skinnedY[indices[corner]]);
+        }
+    }
+}
+
+void
+SkeletalAnimationSystem::applyAttachments() {
+    for (const Attachment& attachment : m_attachments) {
+        const BoneMatrix& world = getBoneWorld(attachment.character, attachment.bone);
+        attachment.target->setPosition(sf::Vector2f(world.tx, world.ty));
+        attachment.target->setRotation(sf::Vector2f(std::atan2(world.b, world.a) * RadiansToDegrees, 0.f));
+        attachment.target->setScale(sf::Vector2f(std::sqrt(world.a * world.a + world.b * world.b),
+                                                 std::sqrt(world.c * world.c + world.d * world.d)));
+    }
+}
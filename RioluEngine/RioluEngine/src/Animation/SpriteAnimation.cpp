@@ -0,0 +1,308 @@
+#include "Animation/SpriteAnimation.h"
+#include <algorithm>
+
+/**
+ * @file SpriteAnimation.cpp
+ * @brief Implements the clip library and the linear animator pass.
+ */
+
+namespace {
+    /**
+     * @brief Appends the events of a clip whose time is in [from, to).
+     */
+    void
+    emitEvents(const float* times, const uint32_t* ids, uint16_t count, float from, float to,
+               SpriteAnimatorId animator, SpriteClipId clip, std::vector<SpriteAnimationEvent>& events) {
+        for (uint16_t i = 0; i < count && times[i] < to; ++i) {
+            if (times[i] >= from) {
+                events.push_back(SpriteAnimationEvent{ animator, clip, ids[i] });
+            }
+        }
+    }
+
+    /**
+     * @brief Animators whose rect is written in one go by advanceAll().
+     */
+    const size_t RectBatch = 256;
+
+    /**
+     * @brief Writes the rect of the current frame into the target of each slot.
+     */
+    void
+    writeRects(const SpriteClipLibrary& library, const uint32_t* slots, size_t count,
+               const SpriteAnimationData* states, sf::Shape* const* targets) {
+        for (size_t i = 0; i < count; ++i) {
+            const SpriteAnimationData& state = states[slots[i]];
+            targets[slots[i]]->setTextureRect(library.getFrameRect(state.clip, state.frame));
+        }
+    }
+}
+
+SpriteClipId
+SpriteClipLibrary::addClip(const SpriteClipDesc& desc) {
+    if (m_clips.size() >= InvalidSpriteClip) {
+        ERROR("SpriteClipLibrary", "addClip", "Too many clips");
+    }
+    if (desc.frames.empty() || desc.frames.size() > 0xFFFF || desc.events.size() > 0xFFFF) {
+        ERROR("SpriteClipLibrary", "addClip", "A clip needs between 1 and 65535 frames and at most 65535 events");
+    }
+
+    Clip clip;
+    clip.name = desc.name;
+    clip.firstFrame = static_cast<uint32_t>(m_frameRects.size());
+    clip.frameCount = static_cast<uint16_t>(desc.frames.size());
+    clip.firstEvent = static_cast<uint32_t>(m_eventTimes.size());
+    clip.eventCount = static_cast<uint16_t>(desc.events.size());
+    clip.loop = desc.loop;
+
+    float end = 0.f;
+    for (const SpriteFrame& frame : desc.frames) {
+        if (!(frame.duration > 0.f)) {
+            ERROR("SpriteClipLibrary", "addClip", "Frame duration must be positive");
+        }
+        end += frame.duration;
+        m_frameRects.push_back(frame.rect);
+        m_frameEnds.push_back(end);
+    }
+    clip.length = end;
+
+    std::vector<SpriteClipEvent> events = desc.events;
+    std::stable_sort(events.begin(), events.end(),
+                     [](const SpriteClipEvent& a, const SpriteClipEvent& b) { return a.time < b.time; });
+    for (const SpriteClipEvent& event : events) {
+        m_eventTimes.push_back(event.time);
+        m_eventIds.push_back(event.event);
+    }
+
+    m_clips.push_back(clip);
+    return static_cast<SpriteClipId>(m_clips.size() - 1);
+}
+
+SpriteClipId
+SpriteClipLibrary::findClip(const std::string& name) const {
+    for (size_t clip = 0; clip < m_clips.size(); ++clip) {
+        if (m_clips[clip].name == name) {
+            return static_cast<SpriteClipId>(clip);
+        }
+    }
+    return InvalidSpriteClip;
+}
+
+size_t
+SpriteClipLibrary::getByteSize() const {
+    size_t bytes = m_clips.size() * sizeof(Clip) + m_frameRects.size() * sizeof(sf::IntRect) +
+                   m_frameEnds.size() * sizeof(float) + m_eventTimes.size() * (sizeof(float) + sizeof(uint32_t));
+    for (const Clip& clip : m_clips) {
+        bytes += clip.name.capacity();
+    }
+    return bytes;
+}
+
+void
+SpriteAnimatorStorage::reserve(size_t count) {
+    m_states.reserve(count);
+    m_targets.reserve(count);
+    m_generations.reserve(count);
+    m_live.reserve(count);
+}
+
+SpriteAnimatorId
+SpriteAnimatorStorage::create(sf::Shape* target) {
+    uint32_t index = 0;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        if (m_states.size() >= MaxAnimators) {
+            ERROR("SpriteAnimatorStorage", "create", "Too many animators");
+        }
+        index = static_cast<uint32_t>(m_states.size());
+        m_states.push_back(SpriteAnimationData{ InvalidSpriteClip, SpriteAnimationData::NotShown, 0.f, 1.f });
+        m_targets.push_back(nullptr);
+        m_generations.push_back(0);
+        m_live.push_back(0);
+        resizePages();
+    }
+
+    m_states[index] = SpriteAnimationData{ InvalidSpriteClip, SpriteAnimationData::NotShown, 0.f, 1.f };
+    m_targets[index] = target;
+    m_live[index] = 1;
+    ++m_liveCount;
+    markDirty(static_cast<size_t>(index) * sizeof(SpriteAnimationData), sizeof(SpriteAnimationData));
+    ComponentStorageRegistry::bumpStructureVersion();
+    return index | (static_cast<uint32_t>(m_generations[index]) << IndexBits);
+}
+
+void
+SpriteAnimatorStorage::destroy(SpriteAnimatorId id) {
+    if (!isAlive(id)) {
+        return;
+    }
+    const uint32_t index = id & IndexMask;
+    // The pass walks free slots too and skips those without a clip.
+    m_states[index].clip = InvalidSpriteClip;
+    markDirty(static_cast<size_t>(index) * sizeof(SpriteAnimationData), sizeof(SpriteAnimationData));
+    m_targets[index] = nullptr;
+    m_live[index] = 0;
+    ++m_generations[index];
+    m_freeSlots.push_back(index);
+    --m_liveCount;
+    ComponentStorageRegistry::bumpStructureVersion();
+}
+
+/**
+ * @brief Moves every animator forward in one pass over the states.
+ *
+ * The frame stored before the advance is the one the target shows, so its rect is
+ * only written when the frame changes (or after play(), setTarget() and
+ * invalidateTargets(), which store NotShown). Those writes land in shapes scattered
+ * over memory; they are queued and done in batches after the states they follow,
+ * so the cache misses overlap instead of stalling the pass one by one.
+ */
+void
+SpriteAnimatorStorage::advanceAll(const SpriteClipLibrary& library, float deltaTime,
+                                  std::vector<SpriteAnimationEvent>& events) {
+    events.clear();
+    if (m_states.empty()) {
+        return;
+    }
+    markDirty(0, m_states.size() * sizeof(SpriteAnimationData));
+    SpriteAnimationData* data = m_states.data();
+    sf::Shape* const* targets = m_targets.data();
+    const size_t count = m_states.size();
+    const SpriteClipLibrary::Clip* clips = library.m_clips.data();
+    const float* frameEnds = library.m_frameEnds.data();
+    const float* eventTimes = library.m_eventTimes.data();
+    const uint32_t* eventIds = library.m_eventIds.data();
+
+    uint32_t changed[RectBatch];
+    size_t changedCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        SpriteAnimationData& state = data[i];
+        const uint16_t shown = state.frame;
+        if (state.clip == InvalidSpriteClip || (state.speed == 0.f && shown != SpriteAnimationData::NotShown)) {
+            continue;
+        }
+        const SpriteClipLibrary::Clip& clip = clips[state.clip];
+        const float* ends = frameEnds + clip.firstFrame;
+        const float* times = eventTimes + clip.firstEvent;
+        const uint32_t* ids = eventIds + clip.firstEvent;
+        const SpriteAnimatorId animator = static_cast<uint32_t>(i) | (static_cast<uint32_t>(m_generations[i]) << IndexBits);
+
+        const float previous = state.time;
+        float time = previous + deltaTime * state.speed;
+        uint16_t frame = shown == SpriteAnimationData::NotShown ? 0 : shown;
+        if (clip.eventCount != 0) {
+            emitEvents(times, ids, clip.eventCount, previous, time, animator, state.clip, events);
+        }
+        if (time >= clip.length) {
+            if (!clip.loop) {
+                if (previous < clip.length) {
+                    events.push_back(SpriteAnimationEvent{ animator, state.clip, SpriteAnimationEvent::Finished });
+                }
+                time = clip.length;
+            }
+            else {
+                // Every wrap replays the clip's events from its start.
+                do {
+                    time -= clip.length;
+                    if (clip.eventCount != 0) {
+                        emitEvents(times, ids, clip.eventCount, 0.f, time, animator, state.clip, events);
+                    }
+                } while (time >= clip.length);
+                frame = 0;
+            }
+        }
+
+        while (frame + 1 < clip.frameCount && time >= ends[frame]) {
+            ++frame;
+        }
+        state.time = time;
+        if (frame != shown) {
+            state.frame = frame;
+            if (targets[i] != nullptr) {
+                changed[changedCount++] = static_cast<uint32_t>(i);
+                if (changedCount == RectBatch) {
+                    writeRects(library, changed, changedCount, data, targets);
+                    changedCount = 0;
+                }
+            }
+        }
+    }
+    writeRects(library, changed, changedCount, data, targets);
+}
+
+void
+SpriteAnimatorStorage::invalidateTargets() {
+    for (SpriteAnimationData& state : m_states) {
+        state.frame = SpriteAnimationData::NotShown;
+    }
+    if (!m_states.empty()) {
+        markDirty(0, m_states.size() * sizeof(SpriteAnimationData));
+    }
+}
+
+void
+SpriteAnimatorStorage::play(SpriteAnimatorId id, SpriteClipId clip, float speed) {
+    if (speed < 0.f) {
+        ERROR("SpriteAnimatorStorage", "play", "Speed must not be negative");
+    }
+    const uint32_t index = slotOf(id, "play");
+    m_states[index] = SpriteAnimationData{ clip, SpriteAnimationData::NotShown, 0.f, speed };
+    markDirty(static_cast<size_t>(index) * sizeof(SpriteAnimationData), sizeof(SpriteAnimationData));
+}
+
+void
+SpriteAnimatorStorage::setSpeed(SpriteAnimatorId id, float speed) {
+    if (speed < 0.f) {
+        ERROR("SpriteAnimatorStorage", "setSpeed", "Speed must not be negative");
+    }
+    const uint32_t index = slotOf(id, "setSpeed");
+    m_states[index].speed = speed;
+    markDirty(static_cast<size_t>(index) * sizeof(SpriteAnimationData), sizeof(SpriteAnimationData));
+}
+
+void
+SpriteAnimatorStorage::setTarget(SpriteAnimatorId id, sf::Shape* target) {
+    const uint32_t index = slotOf(id, "setTarget");
+    m_targets[index] = target;
+    m_states[index].frame = SpriteAnimationData::NotShown;
+    markDirty(static_cast<size_t>(index) * sizeof(SpriteAnimationData), sizeof(SpriteAnimationData));
+}
+
+sf::IntRect
+SpriteAnimatorStorage::getTextureRect(const SpriteClipLibrary& library, SpriteAnimatorId id) const {
+    const SpriteAnimationData& state = m_states[slotOf(id, "getTextureRect")];
+    if (state.clip == InvalidSpriteClip) {
+        return sf::IntRect();
+    }
+    return library.getFrameRect(state.clip, state.frame == SpriteAnimationData::NotShown ? 0 : state.frame);
+}
+
+size_t
+SpriteAnimatorStorage::getAllocatedBytes() const {
+    return m_states.capacity() * sizeof(SpriteAnimationData) + m_targets.capacity() * sizeof(sf::Shape*) +
+           m_generations.capacity() + m_live.capacity() + m_freeSlots.capacity() * sizeof(uint32_t) +
+           getPageCount() * sizeof(uint32_t);
+}
+
+StorageFragmentation
+SpriteAnimatorStorage::getFragmentation() const {
+    StorageFragmentation fragmentation;
+    const size_t slotsPerChunk = PageSize / sizeof(SpriteAnimationData);
+    fragmentation.totalSlots = m_states.size();
+    fragmentation.liveSlots = m_liveCount;
+    for (size_t begin = 0; begin < m_live.size(); begin += slotsPerChunk) {
+        const size_t end = std::min(m_live.size(), begin + slotsPerChunk);
+        size_t holes = 0;
+        for (size_t i = begin; i < end; ++i) {
+            holes += m_live[i] == 0 ? 1 : 0;
+        }
+        ++fragmentation.chunks;
+        fragmentation.fragmentedChunks += holes > 0 ? 1 : 0;
+        fragmentation.holes += holes;
+        fragmentation.maxChunkHoles = std::max(fragmentation.maxChunkHoles, holes);
+    }
+    return fragmentation;
+}
@@ -0,0 +1,572 @@
+#include "Animation/TweenSystem.h"
+#include "Utilities/Simd.h"
+#include <algorithm>
+
+/**
+ * @file TweenSystem.cpp
+ * @brief Implements tween tracks, sequences and the grouped four-lane tween pass.
+ */
+
+namespace {
+    /**
+     * @brief Channels used by each TweenProperty.
+     */
+    const size_t ChannelCount[static_cast<size_t>(TweenProperty::Count)] = { 2, 1, 2, 4 };
+
+    /**
+     * @brief Applies the easing curve @p Easing to normalized times.
+     */
+    template<TweenEasing Easing>
+    Float4
+    ease(Float4 t) {
+        const Float4 one = Float4::splat(1.f);
+        const Float4 u = one - t;
+        if constexpr (Easing == TweenEasing::QuadIn) {
+            return t * t;
+        }
+        else if constexpr (Easing == TweenEasing::QuadOut) {
+            return one - u * u;
+        }
+        else if constexpr (Easing == TweenEasing::QuadInOut) {
+            return select(t < Float4::splat(0.5f), Float4::splat(2.f) * t * t, one - Float4::splat(2.f) * u * u);
+        }
+        else if constexpr (Easing == TweenEasing::CubicIn) {
+            return t * t * t;
+        }
+        else if constexpr (Easing == TweenEasing::CubicOut) {
+            return one - u * u * u;
+        }
+        else if constexpr (Easing == TweenEasing::CubicInOut) {
+            return select(t < Float4::splat(0.5f), Float4::splat(4.f) * t * t * t, one - Float4::splat(4.f) * u * u * u);
+        }
+        else if constexpr (Easing == TweenEasing::SmoothStep) {
+            return t * t * (Float4::splat(3.f) - Float4::splat(2.f) * t);
+        }
+        else {
+            return t;
+        }
+    }
+
+    /**
+     * @brief Loop count of a tween that repeats forever; large enough never to be reached.
+     */
+    const float ForeverCycles = 1e30f;
+
+    /**
+     * @brief Converts a 0-255 channel value to a colour byte.
+     */
+    sf::Uint8
+    toColorByte(float value) {
+        return static_cast<sf::Uint8>(std::min(std::max(value, 0.f), 255.f) + 0.5f);
+    }
+
+    /**
+     * @brief Advances one group by @p deltaTime and fills its values and flags.
+     */
+    template<TweenEasing Easing, size_t Channels>
+    void
+    evaluateGroup(size_t count, float* elapsed, const float* duration, const float* invDuration,
+                  const float* lastCycle, const float* yoyo, const std::vector<float>* from,
+                  const std::vector<float>* delta, std::vector<float>* value, uint8_t* flags, float deltaTime) {
+        const Float4 zero = Float4::splat(0.f);
+        const Float4 half = Float4::splat(0.5f);
+        const Float4 one = Float4::splat(1.f);
+        const Float4 two = Float4::splat(2.f);
+        const Float4 step = Float4::splat(deltaTime);
+        const Float4 forever = Float4::splat(ForeverCycles * 0.5f);
+
+        for (size_t i = 0; i < count; i += 4) {
+            const Float4 time = Float4::load(elapsed + i) + step;
+            const Float4 length = Float4::load(duration + i);
+            const Float4 last = Float4::load(lastCycle + i);
+            const Float4 started = time >= zero;
+            const Float4 clamped = max(time, zero);
+
+            const Float4 cycles = clamped * Float4::load(invDuration + i);
+            const Float4 cycleFloor = floor(min(cycles, last + one));
+            const Float4 finished = cycleFloor > last;
+            const Float4 cycle = min(cycleFloor, last);
+            Float4 t = select(finished, one, cycles - cycle);
+
+            // Odd repetitions of a yoyo tween run backwards.
+            const Float4 odd = cycle - two * floor(cycle * half);
+            t = select(odd * Float4::load(yoyo + i) > half, one - t, t);
+            const Float4 eased = ease<Easing>(t);
+            for (size_t channel = 0; channel < Channels; ++channel) {
+                const Float4 start = Float4::load(from[channel].data() + i);
+                (start + Float4::load(delta[channel].data() + i) * eased).store(value[channel].data() + i);
+            }
+
+            // Endless tweens drop whole pairs of repetitions so their time stays small
+            // and the yoyo direction is kept.
+            const Float4 wrapped = clamped - two * floor(cycle * half) * length;
+            select(last > forever, select(started, wrapped, time), time).store(elapsed + i);
+
+            const int startedBits = bitmask(started);
+            const int finishedBits = bitmask(finished);
+            for (int lane = 0; lane < 4; ++lane) {
+                flags[i + lane] = static_cast<uint8_t>(((startedBits >> lane) & 1) | (((finishedBits >> lane) & 1) << 1));
+            }
+        }
+    }
+
+    /**
+     * @brief Selects the channel count of a property at compile time.
+     */
+    template<TweenEasing Easing>
+    void
+    evaluateEased(size_t channels, size_t count, float* elapsed, const float* duration, const float* invDuration,
+                  const float* lastCycle, const float* yoyo, const std::vector<float>* from,
+                  const std::vector<float>* delta, std::vector<float>* value, uint8_t* flags, float deltaTime) {
+        switch (channels) {
+        case 1:
+            evaluateGroup<Easing, 1>(count, elapsed, duration, invDuration, lastCycle, yoyo, from, delta, value, flags, deltaTime);
+            break;
+        case 2:
+            evaluateGroup<Easing, 2>(count, elapsed, duration, invDuration, lastCycle, yoyo, from, delta, value, flags, deltaTime);
+            break;
+        default:
+            evaluateGroup<Easing, 4>(count, elapsed, duration, invDuration, lastCycle, yoyo, from, delta, value, flags, deltaTime);
+            break;
+        }
+    }
+}
+
+TweenTrack
+TweenTrack::position(const EngineUtilities::TSharedPointer<Transform>& transform,
+                     const sf::Vector2f& from, const sf::Vector2f& to, float duration, TweenEasing easing) {
+    TweenTrack track;
+    track.property = TweenProperty::Position;
+    track.easing = easing;
+    track.duration = duration;
+    track.from[0] = from.x;
+    track.from[1] = from.y;
+    track.to[0] = to.x;
+    track.to[1] = to.y;
+    track.transform = transform;
+    return track;
+}
+
+TweenTrack
+TweenTrack::rotation(const EngineUtilities::TSharedPointer<Transform>& transform,
+                     float from, float to, float duration, TweenEasing easing) {
+    TweenTrack track;
+    track.property = TweenProperty::Rotation;
+    track.easing = easing;
+    track.duration = duration;
+    track.from[0] = from;
+    track.to[0] = to;
+    track.transform = transform;
+    return track;
+}
+
+TweenTrack
+TweenTrack::scale(const EngineUtilities::TSharedPointer<Transform>& transform,
+                  const sf::Vector2f& from, const sf::Vector2f& to, float duration, TweenEasing easing) {
+    TweenTrack track = position(transform, from, to, duration, easing);
+    track.property = TweenProperty::Scale;
+    return track;
+}
+
+TweenTrack
+TweenTrack::color(const EngineUtilities::TSharedPointer<CShape>& shape,
+                  const sf::Color& from, const sf::Color& to, float duration, TweenEasing easing) {
+    TweenTrack track;
+    track.property = TweenProperty::Color;
+    track.easing = easing;
+    track.duration = duration;
+    const sf::Uint8 fromChannels[4] = { from.r, from.g, from.b, from.a };
+    const sf::Uint8 toChannels[4] = { to.r, to.g, to.b, to.a };
+    for (int channel = 0; channel < 4; ++channel) {
+        track.from[channel] = fromChannels[channel];
+        track.to[channel] = toChannels[channel];
+    }
+    track.shape = shape;
+    return track;
+}
+
+TweenSequence&
+TweenSequence::then(const TweenTrack& track) {
+    m_stages.emplace_back();
+    m_stages.back().delay = m_pendingDelay;
+    m_stages.back().tracks.push_back(track);
+    m_pendingDelay = 0.f;
+    return *this;
+}
+
+TweenSequence&
+TweenSequence::with(const TweenTrack& track) {
+    if (m_stages.empty() || m_pendingDelay > 0.f) {
+        return then(track);
+    }
+    m_stages.back().tracks.push_back(track);
+    return *this;
+}
+
+TweenSequence&
+TweenSequence::wait(float seconds) {
+    m_pendingDelay += seconds;
+    return *this;
+}
+
+TweenId
+TweenSystem::play(const TweenTrack& track, int loops, bool yoyo, float delay) {
+    const uint32_t slot = startTween(track, loops, yoyo, -delay, TweenId::InvalidIndex);
+    return TweenId{ slot, m_slots[slot].generation };
+}
+
+TweenId
+TweenSystem::play(const TweenSequence& sequence, int loops) {
+    if (sequence.m_stages.empty()) {
+        return TweenId();
+    }
+
+    uint32_t index;
+    if (!m_freeSequences.empty()) {
+        index = m_freeSequences.back();
+        m_freeSequences.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_sequences.size());
+        m_sequences.emplace_back();
+    }
+    SequenceState& state = m_sequences[index];
+    state.sequence = sequence;
+    // A trailing wait becomes a stage without tracks.
+    if (sequence.m_pendingDelay > 0.f) {
+        state.sequence.m_stages.emplace_back();
+        state.sequence.m_stages.back().delay = sequence.m_pendingDelay;
+    }
+    state.stage = 0;
+    state.loopsLeft = loops;
+    state.running.clear();
+    state.slot = allocateSlot();
+
+    Slot& slot = m_slots[state.slot];
+    slot.isSequence = true;
+    slot.position = index;
+    const TweenId id{ state.slot, slot.generation };
+    startStage(index, 0.f);
+    return id;
+}
+
+void
+TweenSystem::cancel(TweenId id) {
+    if (!isPlaying(id)) {
+        return;
+    }
+    const Slot& slot = m_slots[id.index];
+    if (!slot.isSequence) {
+        removeTween(id.index);
+        return;
+    }
+
+    const uint32_t index = slot.position;
+    SequenceState& state = m_sequences[index];
+    for (uint32_t running : state.running) {
+        removeTween(running);
+    }
+    state.running.clear();
+    m_waits.erase(std::remove_if(m_waits.begin(), m_waits.end(),
+                                 [index](const std::pair<uint32_t, float>& wait) { return wait.first == index; }),
+                  m_waits.end());
+    state.sequence = TweenSequence();
+    freeSlot(state.slot);
+    m_freeSequences.push_back(index);
+}
+
+bool
+TweenSystem::isPlaying(TweenId id) const {
+    return id.index < m_slots.size() && m_slots[id.index].used && m_slots[id.index].generation == id.generation;
+}
+
+void
+TweenSystem::update(float deltaTime) {
+    // Waits that were running before this frame; waits started below already count
+    // their leftover time.
+    std::vector<std::pair<uint32_t, float>> waits;
+    waits.swap(m_waits);
+
+    m_finished.clear();
+    for (size_t property = 0; property < static_cast<size_t>(TweenProperty::Count); ++property) {
+        for (size_t easing = 0; easing < static_cast<size_t>(TweenEasing::Count); ++easing) {
+            Group& group = m_groups[groupIndex(static_cast<TweenProperty>(property), static_cast<TweenEasing>(easing))];
+            if (group.count == 0) {
+                continue;
+            }
+            evaluate(group, static_cast<TweenEasing>(easing), ChannelCount[property], deltaTime);
+            apply(group, static_cast<TweenProperty>(property));
+            for (size_t i = 0; i < group.count; ++i) {
+                if (group.flags[i] & Finished) {
+                    const float overshoot = group.elapsed[i] - (group.lastCycle[i] + 1.f) * group.duration[i];
+                    m_finished.emplace_back(group.ids[i], overshoot);
+                }
+            }
+        }
+    }
+
+    for (const std::pair<uint32_t, float>& finished : m_finished) {
+        const uint32_t sequence = m_slots[finished.first].sequence;
+        removeTween(finished.first);
+        if (sequence != TweenId::InvalidIndex) {
+            onSequenceTweenFinished(sequence, finished.first, finished.second);
+        }
+    }
+
+    for (std::pair<uint32_t, float>& wait : waits) {
+        wait.second -= deltaTime;
+        if (wait.second > 0.f) {
+            m_waits.push_back(wait);
+        }
+        else {
+            finishStage(wait.first, -wait.second);
+        }
+    }
+}
+
+size_t
+TweenSystem::getActiveCount() const {
+    size_t count = 0;
+    for (const Group& group : m_groups) {
+        count += group.count;
+    }
+    return count;
+}
+
+uint32_t
+TweenSystem::allocateSlot() {
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    Slot& entry = m_slots[slot];
+    entry.used = true;
+    entry.isSequence = false;
+    entry.sequence = TweenId::InvalidIndex;
+    return slot;
+}
+
+void
+TweenSystem::freeSlot(uint32_t slot) {
+    m_slots[slot].used = false;
+    ++m_slots[slot].generation;
+    m_freeSlots.push_back(slot);
+}
+
+uint32_t
+TweenSystem::startTween(const TweenTrack& track, int loops, bool yoyo, float elapsed, uint32_t sequence) {
+    if (track.property >= TweenProperty::Count || track.easing >= TweenEasing::Count) {
+        ERROR("TweenSystem", "startTween", "Unknown property or easing");
+    }
+    if (!(track.duration > 0.f)) {
+        ERROR("TweenSystem", "startTween", "Tween duration must be positive");
+    }
+    const bool needsShape = track.property == TweenProperty::Color;
+    if (needsShape ? track.shape.isNull() : track.transform.isNull()) {
+        ERROR("TweenSystem", "startTween", "Tween without a target");
+    }
+
+    const uint16_t groupId = static_cast<uint16_t>(groupIndex(track.property, track.easing));
+    Group& group = m_groups[groupId];
+    const size_t i = group.count;
+    if (i == group.ids.size()) {
+        // Grow every array by one lane group; padding lanes are evaluated but never used.
+        const size_t padded = i + 4;
+        group.ids.resize(padded, 0);
+        group.elapsed.resize(padded, 0.f);
+        group.duration.resize(padded, 1.f);
+        group.invDuration.resize(padded, 1.f);
+        group.lastCycle.resize(padded, 0.f);
+        group.yoyo.resize(padded, 0.f);
+        for (int channel = 0; channel < 4; ++channel) {
+            group.from[channel].resize(padded, 0.f);
+            group.delta[channel].resize(padded, 0.f);
+            group.value[channel].resize(padded, 0.f);
+        }
+        group.flags.resize(padded, 0);
+        group.transforms.resize(padded);
+        group.shapes.resize(padded);
+    }
+
+    const uint32_t slot = allocateSlot();
+    group.ids[i] = slot;
+    group.elapsed[i] = elapsed;
+    group.duration[i] = track.duration;
+    group.invDuration[i] = 1.f / track.duration;
+    group.lastCycle[i] = loops == Forever ? ForeverCycles : static_cast<float>(std::max(loops, 0));
+    group.yoyo[i] = yoyo ? 1.f : 0.f;
+    for (int channel = 0; channel < 4; ++channel) {
+        group.from[channel][i] = track.from[channel];
+        group.delta[channel][i] = track.to[channel] - track.from[channel];
+    }
+    group.flags[i] = 0;
+    group.transforms[i] = track.transform;
+    group.shapes[i] = track.shape;
+    ++group.count;
+
+    Slot& entry = m_slots[slot];
+    entry.group = groupId;
+    entry.position = static_cast<uint32_t>(i);
+    entry.sequence = sequence;
+    return slot;
+}
+
+void
+TweenSystem::removeTween(uint32_t slot) {
+    Group& group = m_groups[m_slots[slot].group];
+    const size_t i = m_slots[slot].position;
+    const size_t last = group.count - 1;
+    if (i != last) {
+        group.ids[i] = group.ids[last];
+        group.elapsed[i] = group.elapsed[last];
+        group.duration[i] = group.duration[last];
+        group.invDuration[i] = group.invDuration[last];
+        group.lastCycle[i] = group.lastCycle[last];
+        group.yoyo[i] = group.yoyo[last];
+        for (int channel = 0; channel < 4; ++channel) {
+            group.from[channel][i] = group.from[channel][last];
+            group.delta[channel][i] = group.delta[channel][last];
+            group.value[channel][i] = group.value[channel][last];
+        }
+        group.flags[i] = group.flags[last];
+        group.transforms[i] = group.transforms[last];
+        group.shapes[i] = group.shapes[last];
+        m_slots[group.ids[i]].position = static_cast<uint32_t>(i);
+    }
+    // Release the targets held by the vacated lane.
+    group.transforms[last] = EngineUtilities::TSharedPointer<Transform>();
+    group.shapes[last] = EngineUtilities::TSharedPointer<CShape>();
+    --group.count;
+    freeSlot(slot);
+}
+
+void
+TweenSystem::startStage(uint32_t sequence, float elapsed) {
+    SequenceState& state = m_sequences[sequence];
+    const TweenSequence::Stage& stage = state.sequence.m_stages[state.stage];
+    const float stageTime = elapsed - stage.delay;
+    if (stage.tracks.empty()) {
+        if (stageTime >= 0.f) {
+            finishStage(sequence, stageTime);
+        }
+        else {
+            m_waits.emplace_back(sequence, -stageTime);
+        }
+        return;
+    }
+    for (const TweenTrack& track : stage.tracks) {
+        state.running.push_back(startTween(track, 0, false, stageTime, sequence));
+    }
+}
+
+void
+TweenSystem::onSequenceTweenFinished(uint32_t sequence, uint32_t slot, float overshoot) {
+    SequenceState& state = m_sequences[sequence];
+    state.running.erase(std::find(state.running.begin(), state.running.end(), slot));
+    if (state.running.empty()) {
+        finishStage(sequence, overshoot);
+    }
+}
+
+void
+TweenSystem::finishStage(uint32_t sequence, float overshoot) {
+    SequenceState& state = m_sequences[sequence];
+    if (++state.stage == state.sequence.m_stages.size()) {
+        if (state.loopsLeft == 0) {
+            state.sequence = TweenSequence();
+            freeSlot(state.slot);
+            m_freeSequences.push_back(sequence);
+            return;
+        }
+        if (state.loopsLeft != Forever) {
+            --state.loopsLeft;
+        }
+        state.stage = 0;
+    }
+    startStage(sequence, overshoot);
+}
+
+void
+TweenSystem::evaluate(Group& group, TweenEasing easing, size_t channels, float deltaTime) {
+    float* elapsed = group.elapsed.data();
+    const float* duration = group.duration.data();
+    const float* invDuration = group.invDuration.data();
+    const float* lastCycle = group.lastCycle.data();
+    const float* yoyo = group.yoyo.data();
+    uint8_t* flags = group.flags.data();
+    const size_t count = group.count;
+
+    switch (easing) {
+    case TweenEasing::QuadIn:
+        evaluateEased<TweenEasing::QuadIn>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::QuadOut:
+        evaluateEased<TweenEasing::QuadOut>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::QuadInOut:
+        evaluateEased<TweenEasing::QuadInOut>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::CubicIn:
+        evaluateEased<TweenEasing::CubicIn>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::CubicOut:
+        evaluateEased<TweenEasing::CubicOut>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::CubicInOut:
+        evaluateEased<TweenEasing::CubicInOut>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    case TweenEasing::SmoothStep:
+        evaluateEased<TweenEasing::SmoothStep>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    default:
+        evaluateEased<TweenEasing::Linear>(channels, count, elapsed, duration, invDuration, lastCycle, yoyo, group.from, group.delta, group.value, flags, deltaTime);
+        break;
+    }
+}
+
+void
+TweenSystem::apply(Group& group, TweenProperty property) {
+    const float* x = group.value[0].data();
+    const float* y = group.value[1].data();
+    switch (property) {
+    case TweenProperty::Position:
+        for (size_t i = 0; i < group.count; ++i) {
+            if (group.flags[i] & Writes) {
+                group.transforms[i]->setPosition(sf::Vector2f(x[i], y[i]));
+            }
+        }
+        break;
+    case TweenProperty::Rotation:
+        for (size_t i = 0; i < group.count; ++i) {
+            if (group.flags[i] & Writes) {
+                group.transforms[i]->setRotation(sf::Vector2f(x[i], group.transforms[i]->getRotation().y));
+            }
+        }
+        break;
+    case TweenProperty::Scale:
+        for (size_t i = 0; i < group.count; ++i) {
+            if (group.flags[i] & Writes) {
+                group.transforms[i]->setScale(sf::Vector2f(x[i], y[i]));
+            }
+        }
+        break;
+    case TweenProperty::Color: {
+        const float* b = group.value[2].data();
+        const float* a = group.value[3].data();
+        for (size_t i = 0; i < group.count; ++i) {
+            if (group.flags[i] & Writes) {
+                group.shapes[i]->setFillColor(sf::Color(toColorByte(x[i]), toColorByte(y[i]),
+                                                        toColorByte(b[i]), toColorByte(a[i])));
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
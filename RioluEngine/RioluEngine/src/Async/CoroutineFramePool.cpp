@@ -0,0 +1,67 @@
+#include "Async/CoroutineFramePool.h"
+
+/**
+ * @file CoroutineFramePool.cpp
+ * @brief Implements the coroutine frame pool.
+ */
+
+CoroutineFramePool&
+CoroutineFramePool::get() {
+    static CoroutineFramePool pool;
+    return pool;
+}
+
+void*
+CoroutineFramePool::allocate(size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.liveFrames;
+    m_stats.peakFrames = std::max(m_stats.peakFrames, m_stats.liveFrames);
+
+    if (size == 0 || size > MaxPooledSize) {
+        ++m_stats.heapFallbacks;
+        return ::operator new(size);
+    }
+
+    const size_t sizeClass = (size - 1) / Granularity;
+    if (FreeFrame* frame = m_freeLists[sizeClass]) {
+        m_freeLists[sizeClass] = frame->next;
+        return frame;
+    }
+
+    const size_t rounded = (sizeClass + 1) * Granularity;
+    if (m_cursor == nullptr || static_cast<size_t>(m_chunkEnd - m_cursor) < rounded) {
+        // The tail of the previous chunk is abandoned; it is smaller than one frame.
+        m_chunks.emplace_back(new sf::Uint8[ChunkSize]);
+        m_cursor = m_chunks.back().get();
+        m_chunkEnd = m_cursor + ChunkSize;
+        ++m_stats.chunks;
+    }
+    void* frame = m_cursor;
+    m_cursor += rounded;
+    return frame;
+}
+
+void
+CoroutineFramePool::deallocate(void* frame, size_t size) {
+    if (frame == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    --m_stats.liveFrames;
+
+    if (size == 0 || size > MaxPooledSize) {
+        ::operator delete(frame);
+        return;
+    }
+
+    const size_t sizeClass = (size - 1) / Granularity;
+    FreeFrame* node = static_cast<FreeFrame*>(frame);
+    node->next = m_freeLists[sizeClass];
+    m_freeLists[sizeClass] = node;
+}
+
+CoroutineFramePoolStats
+CoroutineFramePool::getStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,75 @@
+#include "Async/CoroutineScheduler.h"
+
+/**
+ * @file CoroutineScheduler.cpp
+ * @brief Implements the main-loop coroutine scheduler.
+ */
+
+CoroutineScheduler::~CoroutineScheduler() {
+    // Destroying a root also destroys the child tasks it is awaiting.
+    while (m_roots.head != nullptr) {
+        TaskDetail::PromiseBase* root = m_roots.head;
+        std::coroutine_handle<> handle = root->self;
+        m_roots.unlink(root);
+        handle.destroy();
+    }
+}
+
+void
+CoroutineScheduler::spawn(Task<> task) {
+    Task<>::Handle handle = task.release();
+    if (!handle) {
+        return;
+    }
+    handle.promise().self = handle;
+    m_roots.link(&handle.promise());
+    m_waiting[static_cast<int>(ResumePoint::Update)].push_back(handle);
+}
+
+void
+CoroutineScheduler::resume(ResumePoint point) {
+    // Take the batch first: coroutines that wait again while it runs (nextFrame, a
+    // delay that is already due, a finished job) land in the emptied lists and are
+    // resumed next time instead of looping here.
+    m_resuming.swap(m_waiting[static_cast<int>(point)]);
+
+    if (point == ResumePoint::Update) {
+        m_stats.resumedLastFrame = 0;
+
+        while (!m_timers.empty() && m_timers.top().due <= m_time) {
+            m_resuming.push_back(m_timers.top().handle);
+            m_timers.pop();
+        }
+
+        if (m_hasPosted.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(m_postedMutex);
+            m_resuming.insert(m_resuming.end(), m_posted.begin(), m_posted.end());
+            m_posted.clear();
+            m_hasPosted.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    resumeBatch();
+}
+
+void
+CoroutineScheduler::post(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(m_postedMutex);
+    m_posted.push_back(handle);
+    m_hasPosted.store(true, std::memory_order_release);
+}
+
+void
+CoroutineScheduler::addTimer(float seconds, std::coroutine_handle<> handle) {
+    m_timers.push({ m_time + std::max(0.f, seconds), m_timerSequence++, handle });
+}
+
+void
+CoroutineScheduler::resumeBatch() {
+    for (std::coroutine_handle<>& handle : m_resuming) {
+        handle.resume();
+    }
+    m_stats.resumed += m_resuming.size();
+    m_stats.resumedLastFrame += m_resuming.size();
+    m_resuming.clear();
+}
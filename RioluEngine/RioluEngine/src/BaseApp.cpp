@@ -1,5 +1,6 @@
 #include "BaseApp.h"
 #include <ECS/Actor.h>
+#include <chrono>
 
 /**
  * @file BaseApp.cpp
@@ -14,20 +15,62 @@ BaseApp::~BaseApp() {}
 ///
 /// Inicializa, ejecuta el ciclo de eventos, actualiza y renderiza.
 /// Finalmente libera recursos.
-/// @return int 0 si la ejecucin fue exitosa.
+/// Si se configur recordTo() o replayFrom(), graba o reproduce la entrada y el deltaTime.
+/// @return int 0 si la ejecucin fue exitosa, 1 si la repeticin no reprodujo la grabacin.
 int BaseApp::run() {
     if (!init()) {
-        ERROR("BaseApp", "run", "Initializes result on a false statement", "check method validations");
+        ERROR("BaseApp", "run", "Initializes result on a false statement, check method validations");
     }
 
+    if (!m_recordPath.empty() && !m_windowPtr->startRecording(m_recordPath)) {
+        ERROR("BaseApp", "run", "Could not create the input recording file");
+    }
+    if (!m_replayPath.empty() && !m_windowPtr->startReplay(m_replayPath)) {
+        ERROR("BaseApp", "run", "Could not read the input replay file");
+    }
+    if (!m_recordPath.empty() || !m_replayPath.empty()) {
+        m_actorUpdater.setMode(ActorUpdateMode::Deterministic);
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     while (m_windowPtr->isOpen()) {
         m_windowPtr->handleEvents();
         update();
+        m_events.dispatch();
+        m_scheduler.resume(ResumePoint::LateUpdate);
         render();
+        // Nada guarda referencias a los componentes entre frames. Lo que se compacta
+        // depende del tiempo, as que no se compacta al grabar o reproducir.
+        if (m_recordPath.empty() && m_replayPath.empty()) {
+            ComponentStorageRegistry::compact(CompactionBudgetMicroseconds);
+        }
+    }
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // El hash del estado final permite comprobar que la repeticin reprodujo la grabacin.
+    const uint64_t stateHash = ComponentStorageRegistry::hashState();
+    int result = 0;
+    if (!m_recordPath.empty()) {
+        m_windowPtr->stopRecording(stateHash);
+    }
+    if (!m_replayPath.empty()) {
+        const InputLogReader& replay = m_windowPtr->getReplay();
+        const double simulatedSeconds = replay.getElapsedTime().asSeconds();
+        std::cout << "Replay: " << replay.getFrameCount() << " frames, "
+                  << simulatedSeconds << " s simulated in " << wallSeconds << " s ("
+                  << (wallSeconds > 0.0 ? simulatedSeconds / wallSeconds : 0.0) << "x real time)\n";
+        if (replay.isCorrupt()) {
+            std::cerr << "Replay: log is corrupt, stopped early\n";
+            result = 1;
+        }
+        else if (replay.hasStateHash() && replay.getStateHash() != stateHash) {
+            std::cerr << "Replay: final state differs from the recording\n";
+            result = 1;
+        }
     }
 
     destroy();
-    return 0;
+    return result;
 }
 
 /// Inicializa los recursos de la aplicacin.
@@ -36,7 +79,8 @@ int BaseApp::run() {
 /// @return true si la inicializacin fue exitosa.
 bool BaseApp::init() {
     // Crear ventana
-    m_windowPtr = EngineUtilities::MakeShared<Window>(1920, 1080, "Onigiri Engine");
+    const bool headless = !m_replayPath.empty() && m_replayHeadless;
+    m_windowPtr = EngineUtilities::MakeShared<Window>(1920, 1080, "Onigiri Engine", headless);
     if (!m_windowPtr) {
         ERROR("BaseApp", "init", "Failed to create window pointer, check memory allocation");
         return false;
@@ -59,6 +103,8 @@ bool BaseApp::init() {
         shape->createShape(CIRCLE);
         shape->setFillColor(sf::Color::Red);
         transform->setPosition(sf::Vector2f(100.f, 150.f));
+        m_actors.push_back(m_ACircle);
+        m_actorNames.add(m_ACircle->getName(), m_ACircle.get());
 
         // Waypoints de navegacin
         m_waypoints = {
@@ -78,11 +124,13 @@ bool BaseApp::init() {
 void BaseApp::update() {
     if (!m_windowPtr.isNull()) {
         m_windowPtr->update();
+        m_scheduler.advance(m_windowPtr->deltaTime.asSeconds());
     }
+    m_scheduler.resume(ResumePoint::Update);
 
-    if (!m_ACircle.isNull() && !m_waypoints.empty()) {
-        m_ACircle->update(m_windowPtr->deltaTime.asSeconds());
+    m_actorUpdater.update(m_actors, m_windowPtr->deltaTime.asSeconds());
 
+    if (!m_ACircle.isNull() && !m_waypoints.empty()) {
         sf::Vector2f currentPos = m_ACircle->getComponent<Transform>()->getPosition();
         sf::Vector2f targetPos = m_waypoints[m_currentWaypointIndex];
 
@@ -0,0 +1,57 @@
+#include "Benchmarks/AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @file AllocationCounter.cpp
+ * @brief Replaces the global allocation operators to count heap allocations.
+ *
+ * Only in builds that define RIOLU_COUNT_ALLOCATIONS (the Bench configuration);
+ * elsewhere the counters stay at zero and the default allocator is untouched.
+ */
+
+namespace {
+    std::atomic<bool> g_countingEnabled(false);
+    std::atomic<uint64_t> g_allocations(0);
+    std::atomic<uint64_t> g_bytes(0);
+
+#ifdef RIOLU_COUNT_ALLOCATIONS
+    void*
+    countedAllocate(std::size_t size) {
+        if (g_countingEnabled.load(std::memory_order_relaxed)) {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+            g_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        void* memory = std::malloc(size == 0 ? 1 : size);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+#endif
+}
+
+void
+AllocationCounter::setEnabled(bool enabled) {
+    g_countingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t
+AllocationCounter::getAllocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t
+AllocationCounter::getBytes() {
+    return g_bytes.load(std::memory_order_relaxed);
+}
+
+#ifdef RIOLU_COUNT_ALLOCATIONS
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+#endif
@@ -0,0 +1,276 @@
+#include "Benchmarks/Benchmark.h"
+#include "AI/BehaviorTree.h"
+#include "Jobs/JobSystem.h"
+#include <cmath>
+#include <memory>
+
+/**
+ * @file BehaviorTreeBenchmark.cpp
+ * @brief Ticks 10k guards at 30 Hz with the flat runtime and with per-agent node objects.
+ *
+ * The guard tree chases the player when close enough and otherwise walks to a new
+ * waypoint and waits there. Both runtimes run the same leaves on the same agents; the
+ * node-object version allocates one tree per agent, like a naive implementation
+ * would. Metrics are milliseconds per tick of all agents (the budget is 2 ms).
+ */
+
+namespace {
+    const uint32_t AgentCount = 10000;
+    const int Ticks = 90;
+    const float TickTime = 1.f / 30.f;
+
+    /**
+     * @brief Blackboard layout of the guard tree.
+     */
+    enum Slot : uint32_t { X, Y, TargetX, TargetY, Waypoint, SlotCount };
+
+    float g_playerX = 0.f; ///< Player position, only written between ticks.
+    float g_playerY = 0.f;
+
+    /**
+     * @brief Moves the agent towards (x, y); Success once there.
+     */
+    BTStatus
+    moveTowards(float* board, float x, float y, float speed, float deltaTime) {
+        const float dx = x - board[X];
+        const float dy = y - board[Y];
+        const float distance = std::sqrt(dx * dx + dy * dy);
+        const float step = speed * deltaTime;
+        if (distance <= step) {
+            board[X] = x;
+            board[Y] = y;
+            return BTStatus::Success;
+        }
+        board[X] += dx / distance * step;
+        board[Y] += dy / distance * step;
+        return BTStatus::Running;
+    }
+
+    BTStatus
+    playerInRange(BTContext& context) {
+        const float dx = g_playerX - context.blackboard[X];
+        const float dy = g_playerY - context.blackboard[Y];
+        return dx * dx + dy * dy < context.argument * context.argument ? BTStatus::Success : BTStatus::Failure;
+    }
+
+    BTStatus
+    chasePlayer(BTContext& context) {
+        return moveTowards(context.blackboard, g_playerX, g_playerY, 120.f, context.deltaTime);
+    }
+
+    BTStatus
+    pickWaypoint(BTContext& context) {
+        float* board = context.blackboard;
+        const uint32_t hash = (context.userId * 2654435761u) ^ (static_cast<uint32_t>(board[Waypoint]) * 40503u);
+        board[TargetX] = static_cast<float>(hash % 2000);
+        board[TargetY] = static_cast<float>((hash >> 11) % 2000);
+        board[Waypoint] += 1.f;
+        return BTStatus::Success;
+    }
+
+    BTStatus
+    walkToWaypoint(BTContext& context) {
+        float* board = context.blackboard;
+        return moveTowards(board, board[TargetX], board[TargetY], 80.f, context.deltaTime);
+    }
+
+    std::shared_ptr<const BehaviorTree>
+    buildGuardTree() {
+        BehaviorTreeBuilder builder;
+        builder.selector("guard")
+                   .sequence("hunt")
+                       .action("player in range", &playerInRange, 150.f)
+                       .action("chase player", &chasePlayer)
+                   .end()
+                   .sequence("patrol")
+                       .action("pick waypoint", &pickWaypoint)
+                       .action("walk to waypoint", &walkToWaypoint)
+                       .wait(0.5f)
+                   .end()
+               .end();
+        return builder.build(SlotCount);
+    }
+
+    /**
+     * @brief Node of the per-agent tree: heap-allocated, virtual, remembering its
+     * running child.
+     */
+    class ObjectNode {
+    public:
+        virtual ~ObjectNode() = default;
+        virtual BTStatus tick(BTContext& context) = 0;
+    };
+
+    class ObjectComposite : public ObjectNode {
+    public:
+        ObjectComposite(bool sequence, std::vector<std::unique_ptr<ObjectNode>> children)
+            : m_sequence(sequence), m_children(std::move(children)) {}
+
+        BTStatus
+        tick(BTContext& context) override {
+            const BTStatus keepGoing = m_sequence ? BTStatus::Success : BTStatus::Failure;
+            for (; m_current < m_children.size(); ++m_current) {
+                const BTStatus status = m_children[m_current]->tick(context);
+                if (status != keepGoing) {
+                    if (status != BTStatus::Running) {
+                        m_current = 0;
+                    }
+                    return status;
+                }
+            }
+            m_current = 0;
+            return keepGoing;
+        }
+
+    private:
+        bool m_sequence;
+        std::vector<std::unique_ptr<ObjectNode>> m_children;
+        size_t m_current = 0;
+    };
+
+    class ObjectLeaf : public ObjectNode {
+    public:
+        ObjectLeaf(BTAction action, float argument) : m_action(action), m_argument(argument) {}
+
+        BTStatus
+        tick(BTContext& context) override {
+            context.argument = m_argument;
+            context.runningTime = m_runningTime;
+            const BTStatus status = m_action(context);
+            m_runningTime = status == BTStatus::Running ? m_runningTime + context.deltaTime : 0.f;
+            return status;
+        }
+
+    private:
+        BTAction m_action;
+        float m_argument;
+        float m_runningTime = 0.f;
+    };
+
+    class ObjectWait : public ObjectNode {
+    public:
+        explicit ObjectWait(float seconds) : m_seconds(seconds) {}
+
+        BTStatus
+        tick(BTContext& context) override {
+            if (m_elapsed >= m_seconds) {
+                m_elapsed = 0.f;
+                return BTStatus::Success;
+            }
+            m_elapsed += context.deltaTime;
+            return BTStatus::Running;
+        }
+
+    private:
+        float m_seconds;
+        float m_elapsed = 0.f;
+    };
+
+    std::unique_ptr<ObjectNode>
+    buildObjectGuard() {
+        std::vector<std::unique_ptr<ObjectNode>> hunt;
+        hunt.push_back(std::make_unique<ObjectLeaf>(&playerInRange, 150.f));
+        hunt.push_back(std::make_unique<ObjectLeaf>(&chasePlayer, 0.f));
+        std::vector<std::unique_ptr<ObjectNode>> patrol;
+        patrol.push_back(std::make_unique<ObjectLeaf>(&pickWaypoint, 0.f));
+        patrol.push_back(std::make_unique<ObjectLeaf>(&walkToWaypoint, 0.f));
+        patrol.push_back(std::make_unique<ObjectWait>(0.5f));
+        std::vector<std::unique_ptr<ObjectNode>> guard;
+        guard.push_back(std::make_unique<ObjectComposite>(true, std::move(hunt)));
+        guard.push_back(std::make_unique<ObjectComposite>(true, std::move(patrol)));
+        return std::make_unique<ObjectComposite>(false, std::move(guard));
+    }
+
+    void
+    spawnAgent(float* board, uint32_t i) {
+        board[X] = static_cast<float>(i % 100) * 20.f;
+        board[Y] = static_cast<float>(i / 100) * 20.f;
+        board[TargetX] = board[X];
+        board[TargetY] = board[Y];
+        board[Waypoint] = 0.f;
+    }
+
+    /**
+     * @brief Moves the player along a loop through the level before tick @p tick.
+     */
+    void
+    movePlayer(int tick) {
+        g_playerX = 1000.f + 800.f * std::cos(tick * 0.05f);
+        g_playerY = 1000.f + 800.f * std::sin(tick * 0.05f);
+    }
+
+    /**
+     * @brief Sum of agent positions, to check both runtimes did the same thing.
+     */
+    double
+    checksum(BehaviorTreeBatch& batch) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < batch.getAgentCount(); ++i) {
+            sum += batch.getBlackboard(i)[X] + batch.getBlackboard(i)[Y];
+        }
+        return sum;
+    }
+
+    BehaviorTreeBatch
+    spawnBatch(const std::shared_ptr<const BehaviorTree>& tree) {
+        BehaviorTreeBatch batch(tree);
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            spawnAgent(batch.getBlackboard(batch.addAgent(i)), i);
+        }
+        return batch;
+    }
+}
+
+RIOLU_BENCHMARK(BehaviorTree) {
+    const std::shared_ptr<const BehaviorTree> tree = buildGuardTree();
+
+    // Flat runtime, one thread.
+    double flatChecksum = 0.0;
+    {
+        BehaviorTreeBatch batch = spawnBatch(tree);
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            movePlayer(tick);
+            batch.tick(TickTime);
+        }
+        report.metric("flat_tick", timer.elapsedMilliseconds() / Ticks, "ms");
+        report.metric("flat_bytes_per_agent", static_cast<double>(batch.getBytesPerAgent()), "bytes");
+        report.metric("tree_nodes", static_cast<double>(tree->getNodes().size()), "count");
+        flatChecksum = checksum(batch);
+    }
+
+    // Flat runtime over the job system.
+    for (unsigned threads : { 2u, 4u }) {
+        JobSystem jobs(threads - 1);
+        BehaviorTreeBatch batch = spawnBatch(tree);
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            movePlayer(tick);
+            batch.tick(TickTime, jobs);
+        }
+        const std::string prefix = "flat_threads_" + std::to_string(threads);
+        report.metric(prefix + "_tick", timer.elapsedMilliseconds() / Ticks, "ms");
+        report.metric(prefix + "_matches", checksum(batch) == flatChecksum ? 1.0 : 0.0, "bool");
+    }
+
+    // One heap-allocated node tree per agent.
+    {
+        BehaviorTreeBatch boards(tree);
+        std::vector<std::unique_ptr<ObjectNode>> trees;
+        trees.reserve(AgentCount);
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            spawnAgent(boards.getBlackboard(boards.addAgent(i)), i);
+            trees.push_back(buildObjectGuard());
+        }
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            movePlayer(tick);
+            for (uint32_t i = 0; i < AgentCount; ++i) {
+                BTContext context{ boards, i, i, boards.getBlackboard(i), TickTime, 0.f, 0.f };
+                benchmarkKeep(trees[i]->tick(context));
+            }
+        }
+        report.metric("objects_tick", timer.elapsedMilliseconds() / Ticks, "ms");
+        report.metric("objects_matches", checksum(boards) == flatChecksum ? 1.0 : 0.0, "bool");
+    }
+}
@@ -0,0 +1,79 @@
+#include "Benchmarks/Benchmark.h"
+
+/**
+ * @file Benchmark.cpp
+ * @brief Implements the benchmark registry and its CSV report.
+ */
+
+BenchmarkReport::BenchmarkReport(std::ostream& output) : m_output(output) {
+    m_output << "benchmark,metric,value,unit\n";
+}
+
+void
+BenchmarkReport::setBenchmark(const std::string& name) {
+    m_benchmark = name;
+}
+
+void
+BenchmarkReport::metric(const std::string& metric, double value, const std::string& unit) {
+    m_output << m_benchmark << "," << metric << "," << value << "," << unit << "\n";
+    m_output.flush();
+}
+
+std::vector<BenchmarkRegistry::Entry>&
+BenchmarkRegistry::entries() {
+    static std::vector<Entry> registered;
+    return registered;
+}
+
+void
+BenchmarkRegistry::add(const char* name, BenchmarkFunction function) {
+    entries().push_back({ name, function });
+}
+
+int
+BenchmarkRegistry::run(const std::vector<std::string>& filters, std::ostream& output) {
+    BenchmarkReport report(output);
+    int executed = 0;
+
+    for (const Entry& entry : entries()) {
+        bool selected = filters.empty();
+        for (const std::string& filter : filters) {
+            if (std::string(entry.name).find(filter) != std::string::npos) {
+                selected = true;
+                break;
+            }
+        }
+        if (!selected) {
+            continue;
+        }
+
+        std::cerr << "BenchmarkRegistry::run : " << entry.name << "\n";
+        report.setBenchmark(entry.name);
+        entry.function(report);
+        ++executed;
+    }
+    return executed;
+}
+
+/**
+ * @brief Parses `--bench [filter...]` and runs the selected benchmarks on stdout.
+ *
+ * Progress messages go to stderr, so stdout can be redirected to a CSV file.
+ */
+int
+BenchmarkRegistry::runFromCommandLine(int argc, char* argv[]) {
+    std::vector<std::string> filters;
+    for (int i = 2; i < argc; ++i) {
+        filters.push_back(argv[i]);
+    }
+
+    if (run(filters, std::cout) == 0) {
+        std::cerr << "No benchmark matched the given filters. Available benchmarks:\n";
+        for (const Entry& entry : entries()) {
+            std::cerr << "  " << entry.name << "\n";
+        }
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/ComponentStorage.h"
+#include <random>
+
+/**
+ * @file CompactionBenchmark.cpp
+ * @brief Iterates a particle storage after long spawn/despawn churn, with and without compaction.
+ *
+ * Twenty waves stand in for an hour of play: each spawns up to 600k particles, churns
+ * 2% of them per frame for 30 frames, then despawns back to 150k at random. Two
+ * storages get the same operations; one also calls compact() every frame with a
+ * 200 us budget. Both are then iterated like a particle update (skipping free slots)
+ * and compared with a storage that only ever held the 150k survivors. Every handle
+ * must still reach its own data, and copies taken before the moves must either still
+ * be valid or be reported dead.
+ */
+
+namespace {
+    const size_t BaseCount = 150000;
+    const size_t PeakCount = 600000;
+    const int Waves = 20;
+    const int FramesPerWave = 30;
+    const int SteadyFrames = 120;
+    const double ChurnFraction = 0.02;
+    const double BudgetMicroseconds = 200.0;
+    const int Passes = 200;
+
+    /**
+     * @struct ParticleData
+     * @brief Plain particle state.
+     */
+    struct ParticleData {
+        sf::Vector2f position; ///< Position.
+        sf::Vector2f velocity; ///< Velocity.
+        uint32_t id;           ///< Index of the owning handle.
+        uint32_t alive;        ///< 0 in free slots.
+    };
+
+    /**
+     * @class ParticleWorld
+     * @brief A storage plus the handles of its live particles.
+     */
+    class ParticleWorld {
+    public:
+        explicit ParticleWorld(bool compacting)
+            : m_storage("Particles"), m_handles(PeakCount), m_compacting(compacting) {
+            for (size_t i = PeakCount; i > 0; --i) {
+                m_freeIds.push_back(static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        void
+        spawn(float seed) {
+            const uint32_t id = m_freeIds.back();
+            m_freeIds.pop_back();
+            m_storage.create(&m_handles[id], ParticleData{ sf::Vector2f(seed, 0.f), sf::Vector2f(1.f, seed), id, 1 });
+            m_liveIds.push_back(id);
+        }
+
+        void
+        kill(size_t liveIndex) {
+            const uint32_t id = m_liveIds[liveIndex];
+            m_storage.edit(m_handles[id]).alive = 0;
+            m_storage.destroy(m_handles[id]);
+            m_liveIds[liveIndex] = m_liveIds.back();
+            m_liveIds.pop_back();
+            m_freeIds.push_back(id);
+        }
+
+        /**
+         * @brief Ends a frame; returns the compaction time in microseconds.
+         */
+        double
+        endFrame() {
+            if (!m_compacting) {
+                return 0.0;
+            }
+            BenchmarkTimer timer;
+            const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + std::chrono::nanoseconds(static_cast<int64_t>(BudgetMicroseconds * 1000.0));
+            m_moved += m_storage.compact(deadline);
+            return timer.elapsedMicroseconds();
+        }
+
+        double
+        iterate(float deltaTime) {
+            ParticleData* data = m_storage.editAll();
+            const size_t count = m_storage.getSlotCount();
+            float sum = 0.f;
+            for (size_t i = 0; i < count; ++i) {
+                if (data[i].alive != 0) {
+                    data[i].position += data[i].velocity * deltaTime;
+                    sum += data[i].position.x;
+                }
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Counts handles that do not reach their own data.
+         */
+        size_t
+        verify() {
+            size_t wrong = 0;
+            for (uint32_t id : m_liveIds) {
+                wrong += !m_storage.isAlive(m_handles[id]) || m_storage.get(m_handles[id]).id != id ? 1 : 0;
+            }
+            const ParticleData* data = reinterpret_cast<const ParticleData*>(m_storage.getBytes());
+            size_t aliveSlots = 0;
+            for (size_t i = 0; i < m_storage.getSlotCount(); ++i) {
+                aliveSlots += data[i].alive;
+            }
+            return wrong + (aliveSlots != m_liveIds.size() ? 1 : 0);
+        }
+
+        TComponentStorage<ParticleData>& getStorage() { return m_storage; }
+        const std::vector<ComponentHandle>& getHandles() const { return m_handles; }
+        size_t getLiveCount() const { return m_liveIds.size(); }
+        size_t getMoved() const { return m_moved; }
+
+    private:
+        TComponentStorage<ParticleData> m_storage;
+        std::vector<ComponentHandle> m_handles; ///< Fixed size: the storage keeps pointers to them.
+        std::vector<uint32_t> m_freeIds;
+        std::vector<uint32_t> m_liveIds;
+        bool m_compacting;
+        size_t m_moved = 0;
+    };
+
+    /**
+     * @brief Applies one frame of churn to both worlds with the same random choices.
+     */
+    void
+    churnFrame(ParticleWorld& a, ParticleWorld& b, std::mt19937& random, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const size_t victim = random() % a.getLiveCount();
+            a.kill(victim);
+            b.kill(victim);
+            const float seed = static_cast<float>(random() % 1000);
+            a.spawn(seed);
+            b.spawn(seed);
+        }
+    }
+
+    double
+    passNanoseconds(ParticleWorld& world, double& sink) {
+        BenchmarkTimer timer;
+        for (int pass = 0; pass < Passes; ++pass) {
+            sink += world.iterate(0.016f);
+        }
+        return timer.elapsedNanoseconds() / Passes;
+    }
+
+    /**
+     * @brief Compacts a storage with a single hole and creates into it again; counts
+     * slots and handles that come out wrong.
+     */
+    size_t
+    singleHoleMismatches() {
+        TComponentStorage<ParticleData> storage("Single Hole");
+        std::vector<ComponentHandle> handles(4);
+        for (uint32_t id = 0; id < 3; ++id) {
+            storage.create(&handles[id], ParticleData{ sf::Vector2f(), sf::Vector2f(), id, 1 });
+        }
+        storage.destroy(handles[0]);
+        storage.compact(std::chrono::steady_clock::time_point::max());
+        size_t wrong = storage.getSlotCount() != storage.getLiveCount() ? 1 : 0;
+        storage.create(&handles[3], ParticleData{ sf::Vector2f(), sf::Vector2f(), 3, 1 });
+        wrong += storage.getSlotCount() != storage.getLiveCount() ? 1 : 0;
+        for (uint32_t id = 1; id < 4; ++id) {
+            wrong += !storage.isAlive(handles[id]) || storage.get(handles[id]).id != id ? 1 : 0;
+        }
+        return wrong;
+    }
+
+    void
+    reportFragmentation(BenchmarkReport& report, const std::string& prefix, const StorageFragmentation& fragmentation) {
+        report.metric(prefix + "_live_ratio", fragmentation.getLiveRatio(), "ratio");
+        report.metric(prefix + "_holes_per_chunk", fragmentation.getHolesPerChunk(), "count");
+        report.metric(prefix + "_fragmented_chunks", static_cast<double>(fragmentation.fragmentedChunks), "count");
+    }
+}
+
+RIOLU_BENCHMARK(Compaction) {
+    ParticleWorld compacted(true);
+    ParticleWorld sparse(false);
+    std::mt19937 random(3);
+    double worstCompaction = 0.0;
+    double totalCompaction = 0.0;
+    int frames = 0;
+
+    for (size_t i = 0; i < BaseCount; ++i) {
+        compacted.spawn(static_cast<float>(i % 1000));
+        sparse.spawn(static_cast<float>(i % 1000));
+    }
+    std::vector<ComponentHandle> copies(compacted.getHandles().begin(), compacted.getHandles().begin() + 1000);
+
+    for (int wave = 0; wave < Waves; ++wave) {
+        while (compacted.getLiveCount() < PeakCount) {
+            const float seed = static_cast<float>(random() % 1000);
+            compacted.spawn(seed);
+            sparse.spawn(seed);
+        }
+        for (int frame = 0; frame < FramesPerWave; ++frame) {
+            churnFrame(compacted, sparse, random, static_cast<size_t>(PeakCount * ChurnFraction));
+            const double micros = compacted.endFrame();
+            worstCompaction = std::max(worstCompaction, micros);
+            totalCompaction += micros;
+            ++frames;
+        }
+        while (compacted.getLiveCount() > BaseCount) {
+            const size_t victim = random() % compacted.getLiveCount();
+            compacted.kill(victim);
+            sparse.kill(victim);
+        }
+    }
+    for (int frame = 0; frame < SteadyFrames; ++frame) {
+        churnFrame(compacted, sparse, random, static_cast<size_t>(BaseCount * ChurnFraction / 2));
+        const double micros = compacted.endFrame();
+        worstCompaction = std::max(worstCompaction, micros);
+        totalCompaction += micros;
+        ++frames;
+    }
+    report.metric("compaction_average", totalCompaction / frames, "us");
+    report.metric("compaction_worst", worstCompaction, "us");
+    report.metric("moved", static_cast<double>(compacted.getMoved()), "count");
+
+    ParticleWorld fresh(false);
+    for (size_t i = 0; i < BaseCount; ++i) {
+        fresh.spawn(static_cast<float>(i % 1000));
+    }
+    reportFragmentation(report, "sparse", sparse.getStorage().getFragmentation());
+    reportFragmentation(report, "compacted", compacted.getStorage().getFragmentation());
+    reportFragmentation(report, "fresh", fresh.getStorage().getFragmentation());
+
+    double sink = 0.0;
+    report.metric("sparse_pass", passNanoseconds(sparse, sink), "ns");
+    report.metric("compacted_pass", passNanoseconds(compacted, sink), "ns");
+    report.metric("fresh_pass", passNanoseconds(fresh, sink), "ns");
+    benchmarkKeep(sink);
+
+    size_t wrong = compacted.verify() + sparse.verify();
+    for (size_t i = 0; i < copies.size(); ++i) {
+        const TComponentStorage<ParticleData>& storage = compacted.getStorage();
+        if (storage.isAlive(copies[i])) {
+            wrong += storage.get(copies[i]).id != i ? 1 : 0;
+        }
+    }
+    // Without a budget compaction must leave no free slot behind.
+    compacted.getStorage().compact(std::chrono::steady_clock::time_point::max());
+    wrong += compacted.getStorage().getSlotCount() != compacted.getLiveCount() ? 1 : 0;
+    wrong += compacted.verify() + singleHoleMismatches();
+    report.metric("wrong_handles", static_cast<double>(wrong), "count");
+}
@@ -0,0 +1,143 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/Actor.h"
+#include "ECS/ComponentObserver.h"
+#include <unordered_set>
+
+/**
+ * @file ComponentObserverBenchmark.cpp
+ * @brief Tracks which of 500k actors have a CShape and a Transform while a few change.
+ *
+ * Every frame 1,000 actors lose or regain their CShape and 200 their Transform. A
+ * render system and a physics system keep the set of actors with their component.
+ * The baseline rescans every actor each frame (getComponent() per actor, compared
+ * with a per-actor flag, the cheapest rescan that still finds every change). The
+ * observed systems read their ComponentObserver instead. The churn itself is timed
+ * with and without observers to show what recording costs. Both variants must end
+ * with the same sets, and destroying an actor must be reported.
+ */
+
+namespace {
+    const size_t ActorCount = 500000;
+    const size_t ShapeChurn = 1000;
+    const size_t TransformChurn = 200;
+    const int Frames = 10;
+
+    /**
+     * @brief Toggles the CShape of ShapeChurn actors and the Transform of TransformChurn actors.
+     */
+    void
+    churn(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors, int frame) {
+        for (size_t i = 0; i < ShapeChurn; ++i) {
+            Actor& actor = *actors[(frame * 7919 + i * 499) % ActorCount];
+            if (!actor.removeComponent<CShape>()) {
+                actor.addComponent(EngineUtilities::MakeShared<CShape>());
+            }
+        }
+        for (size_t i = 0; i < TransformChurn; ++i) {
+            Actor& actor = *actors[(frame * 104729 + i * 2477) % ActorCount];
+            if (!actor.removeComponent<Transform>()) {
+                actor.addComponent(EngineUtilities::MakeShared<Transform>());
+            }
+        }
+    }
+
+    /**
+     * @brief Applies the changes of @p observer to @p members.
+     */
+    void
+    applyChanges(ComponentObserver& observer, std::unordered_set<const Entity*>& members) {
+        observer.consume([&members](const ComponentChangeRecord& record) {
+            if (record.change == ComponentChange::Added) {
+                members.insert(record.entity);
+            }
+            else {
+                members.erase(record.entity);
+            }
+        });
+    }
+}
+
+RIOLU_BENCHMARK(ComponentObserver) {
+    std::vector<EngineUtilities::TSharedPointer<Actor>> actors;
+    actors.reserve(ActorCount);
+    const StringId name = StringId::intern("Enemy");
+    for (size_t i = 0; i < ActorCount; ++i) {
+        actors.push_back(EngineUtilities::MakeShared<Actor>(name));
+    }
+
+    // Rescan baseline: per-actor flags, refreshed by visiting every actor each frame.
+    std::vector<uint8_t> hasShape(ActorCount, 1);
+    std::vector<uint8_t> hasTransform(ActorCount, 1);
+    size_t rescanChanges = 0;
+    double churnNanoseconds = 0.0;
+    double rescanNanoseconds = 0.0;
+    for (int frame = 0; frame < Frames; ++frame) {
+        {
+            BenchmarkTimer timer;
+            churn(actors, frame);
+            churnNanoseconds += timer.elapsedNanoseconds();
+        }
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < ActorCount; ++i) {
+            const uint8_t shape = actors[i]->getComponent<CShape>() ? 1 : 0;
+            const uint8_t transform = actors[i]->getComponent<Transform>() ? 1 : 0;
+            rescanChanges += (shape != hasShape[i] ? 1 : 0) + (transform != hasTransform[i] ? 1 : 0);
+            hasShape[i] = shape;
+            hasTransform[i] = transform;
+        }
+        rescanNanoseconds += timer.elapsedNanoseconds();
+    }
+    report.metric("rescan_per_frame", rescanNanoseconds / Frames, "ns");
+    report.metric("churn_unobserved_per_change", churnNanoseconds / (Frames * (ShapeChurn + TransformChurn)), "ns");
+
+    // Observed: same churn, undone first so both runs start from every actor complete.
+    for (int frame = Frames - 1; frame >= 0; --frame) {
+        churn(actors, frame);
+    }
+    ComponentObserver shapes(ComponentType::SHAPE);
+    ComponentObserver transforms(ComponentType::TRANFORM);
+    std::unordered_set<const Entity*> drawn;
+    std::unordered_set<const Entity*> simulated;
+    drawn.reserve(ActorCount);
+    simulated.reserve(ActorCount);
+    for (const EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+        drawn.insert(actor.get());
+        simulated.insert(actor.get());
+    }
+
+    size_t observedChanges = 0;
+    churnNanoseconds = 0.0;
+    double observedNanoseconds = 0.0;
+    for (int frame = 0; frame < Frames; ++frame) {
+        {
+            BenchmarkTimer timer;
+            churn(actors, frame);
+            churnNanoseconds += timer.elapsedNanoseconds();
+        }
+        observedChanges += shapes.getChanges().size() + transforms.getChanges().size();
+        BenchmarkTimer timer;
+        applyChanges(shapes, drawn);
+        applyChanges(transforms, simulated);
+        observedNanoseconds += timer.elapsedNanoseconds();
+    }
+    report.metric("observer_per_frame", observedNanoseconds / Frames, "ns");
+    report.metric("churn_observed_per_change", churnNanoseconds / (Frames * (ShapeChurn + TransformChurn)), "ns");
+    report.metric("changes_per_frame", static_cast<double>(observedChanges) / Frames, "count");
+
+    size_t mismatches = rescanChanges != observedChanges ? 1 : 0;
+    for (size_t i = 0; i < ActorCount; ++i) {
+        mismatches += (drawn.count(actors[i].get()) != 0) != (hasShape[i] != 0) ? 1 : 0;
+        mismatches += (simulated.count(actors[i].get()) != 0) != (hasTransform[i] != 0) ? 1 : 0;
+    }
+
+    // Destroying an actor reports the loss of each of its components.
+    const Entity* destroyed = actors.back().get();
+    const bool hadShape = hasShape.back() != 0;
+    actors.pop_back();
+    mismatches += shapes.getChanges().size() != (hadShape ? 1u : 0u) ? 1 : 0;
+    mismatches += transforms.getChanges().size() != (hasTransform.back() != 0 ? 1u : 0u) ? 1 : 0;
+    for (const ComponentChangeRecord& record : shapes.getChanges()) {
+        mismatches += record.entity != destroyed || record.change != ComponentChange::Removed ? 1 : 0;
+    }
+    report.metric("mismatches", static_cast<double>(mismatches), "count");
+}
@@ -0,0 +1,108 @@
+#include "Benchmarks/Benchmark.h"
+#include "Benchmarks/AllocationCounter.h"
+#include "Async/CoroutineScheduler.h"
+
+/**
+ * @file CoroutineBenchmark.cpp
+ * @brief Measures the per-frame cost of parked coroutines and the cost of resuming them.
+ */
+
+namespace {
+    Task<>
+    parkForever(CoroutineScheduler& scheduler) {
+        for (;;) {
+            co_await scheduler.delay(1.0e9f);
+        }
+    }
+
+    Task<>
+    tickFrames(CoroutineScheduler& scheduler, int frames) {
+        for (int i = 0; i < frames; ++i) {
+            co_await scheduler.nextFrame();
+        }
+    }
+
+    Task<int>
+    childValue(int value) {
+        co_return value + 1;
+    }
+
+    Task<>
+    finishImmediately(int& sink) {
+        sink += co_await childValue(sink);
+    }
+
+    /**
+     * @brief Runs @p frames empty frames and returns the nanoseconds per frame.
+     */
+    double
+    frameCost(CoroutineScheduler& scheduler, int frames) {
+        BenchmarkTimer timer;
+        for (int i = 0; i < frames; ++i) {
+            scheduler.advance(1.f / 60.f);
+            scheduler.resume(ResumePoint::Update);
+            scheduler.resume(ResumePoint::LateUpdate);
+        }
+        return timer.elapsedNanoseconds() / frames;
+    }
+}
+
+RIOLU_BENCHMARK(Coroutines) {
+    const int parkedCount = 10000;
+    const int frames = 10000;
+
+    {
+        CoroutineScheduler scheduler;
+        report.metric("frame_empty", frameCost(scheduler, frames), "ns/frame");
+
+        for (int i = 0; i < parkedCount; ++i) {
+            scheduler.spawn(parkForever(scheduler));
+        }
+        // First frame starts them all; after that they sit in the delay heap.
+        frameCost(scheduler, 1);
+        report.metric("parked", static_cast<double>(scheduler.getLiveCount()), "count");
+        report.metric("frame_with_parked", frameCost(scheduler, frames), "ns/frame");
+    }
+
+    {
+        const int tickingCount = 10000;
+        const int tickingFrames = 100;
+        CoroutineScheduler scheduler;
+        for (int i = 0; i < tickingCount; ++i) {
+            scheduler.spawn(tickFrames(scheduler, tickingFrames));
+        }
+        frameCost(scheduler, 1);
+        const double perFrame = frameCost(scheduler, tickingFrames);
+        report.metric("resume_next_frame", perFrame / tickingCount, "ns/resume");
+    }
+
+    {
+        const int spawnCount = 100000;
+        CoroutineScheduler scheduler;
+        int sink = 0;
+        // Warm the frame pool and the scheduler lists.
+        for (int i = 0; i < 1000; ++i) {
+            scheduler.spawn(finishImmediately(sink));
+        }
+        frameCost(scheduler, 1);
+
+        AllocationScope allocations;
+        BenchmarkTimer timer;
+        for (int i = 0; i < spawnCount; i += 1000) {
+            for (int j = 0; j < 1000; ++j) {
+                scheduler.spawn(finishImmediately(sink));
+            }
+            scheduler.resume(ResumePoint::Update);
+        }
+        report.metric("spawn_run_finish", timer.elapsedNanoseconds() / spawnCount, "ns/coroutine");
+        if (AllocationCounter::Available) {
+            report.metric("heap_allocations_per_coroutine",
+                          static_cast<double>(allocations.getAllocations()) / spawnCount, "count");
+        }
+        benchmarkKeep(sink);
+    }
+
+    const CoroutineFramePoolStats pool = CoroutineFramePool::get().getStats();
+    report.metric("pool_peak_frames", static_cast<double>(pool.peakFrames), "count");
+    report.metric("pool_chunks", static_cast<double>(pool.chunks), "count");
+}
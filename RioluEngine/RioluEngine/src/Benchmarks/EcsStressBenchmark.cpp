@@ -0,0 +1,179 @@
+#include "Benchmarks/Benchmark.h"
+#include "Benchmarks/AllocationCounter.h"
+#include "ECS/Actor.h"
+#include <algorithm>
+#include <random>
+
+/**
+ * @file EcsStressBenchmark.cpp
+ * @brief Scaling benchmark of the Entity / Actor / Component layer on synthetic scenes.
+ *
+ * Every pass is reported as `<mix>_<count>_<pass>` in nanoseconds per entity, so
+ * plotting one pass of one mix against count gives its scaling curve. A jump in time
+ * per entity between two sizes is a cache cliff; a respawn slower than the first
+ * spawn points at allocator fragmentation. Scene layouts are listed in Mixes.
+ */
+
+namespace {
+    /**
+     * @brief Filler component: gives scenes longer component lists.
+     */
+    class StressComponent : public Component {
+    public:
+        StressComponent() : Component(ComponentType::PHYSICS) {}
+
+        void start() override {}
+        void update(float deltaTime) override { m_velocity *= 1.f - deltaTime; }
+        void render(const EngineUtilities::TSharedPointer<Window>& /*window*/) override {}
+        void destroy() override {}
+
+    private:
+        sf::Vector2f m_velocity{ 1.f, 1.f }; ///< Dummy payload.
+    };
+
+    /**
+     * @brief Component layout of the actors of a scene.
+     */
+    struct SceneMix {
+        const char* name;     ///< Metric prefix.
+        bool shape;           ///< Actor(name) with a rectangle CShape and a Transform.
+        int extraComponents;  ///< StressComponents added before the shape and Transform.
+        size_t maxCount;      ///< Largest scene built with this mix (bounded by memory).
+    };
+
+    const SceneMix Mixes[] = {
+        { "transform", false, 0, 1000000 }, // Transform only: the lightest possible actor.
+        { "shape", true, 0, 1000000 },      // What BaseApp spawns: CShape + Transform.
+        { "heavy", true, 4, 100000 },       // Lookups walk past 4 other components first.
+    };
+
+    const size_t SceneCounts[] = { 1000, 10000, 100000, 1000000 };
+
+    /**
+     * @brief Draw command produced by the render-extract pass.
+     */
+    struct DrawItem {
+        sf::Shape* shape;      ///< Shape to draw.
+        sf::Vector2f position; ///< World position.
+    };
+
+    EngineUtilities::TSharedPointer<Actor>
+    spawnActor(const SceneMix& mix, size_t index) {
+        EngineUtilities::TSharedPointer<Actor> actor;
+        if (mix.shape && mix.extraComponents == 0) {
+            actor = EngineUtilities::MakeShared<Actor>("Stress Actor");
+        }
+        else {
+            actor = EngineUtilities::MakeShared<Actor>();
+            for (int i = 0; i < mix.extraComponents; ++i) {
+                actor->addComponent(EngineUtilities::MakeShared<StressComponent>());
+            }
+            if (mix.shape) {
+                actor->addComponent(EngineUtilities::MakeShared<CShape>());
+            }
+            actor->addComponent(EngineUtilities::MakeShared<Transform>());
+        }
+
+        if (mix.shape) {
+            actor->getComponent<CShape>()->createShape(ShapeType::RECTANGLE);
+        }
+        actor->getComponent<Transform>()->setPosition(
+            sf::Vector2f(static_cast<float>(index % 1000), static_cast<float>(index / 1000)));
+        return actor;
+    }
+
+    /**
+     * @brief Spawns @p count actors into @p actors and returns the elapsed nanoseconds.
+     */
+    double
+    spawnScene(const SceneMix& mix, size_t count, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+        actors.reserve(count);
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < count; ++i) {
+            actors.push_back(spawnActor(mix, i));
+        }
+        return timer.elapsedNanoseconds();
+    }
+
+    void
+    runScene(BenchmarkReport& report, const SceneMix& mix, size_t count) {
+        const std::string prefix = std::string(mix.name) + "_" + std::to_string(count) + "_";
+        // Small scenes repeat the read-only passes to get above timer resolution.
+        const int repeats = static_cast<int>(std::max<size_t>(1, 100000 / count));
+        const double entities = static_cast<double>(count);
+
+        std::vector<EngineUtilities::TSharedPointer<Actor>> actors;
+        double spawnNanoseconds = 0.0;
+        {
+            AllocationScope allocations;
+            spawnNanoseconds = spawnScene(mix, count, actors);
+            if (AllocationCounter::Available) {
+                report.metric(prefix + "allocations_per_entity", allocations.getAllocations() / entities, "count");
+                report.metric(prefix + "bytes_per_entity", allocations.getBytes() / entities, "bytes");
+            }
+        }
+        report.metric(prefix + "spawn", spawnNanoseconds / entities, "ns/entity");
+
+        BenchmarkTimer timer;
+        float checksum = 0.f;
+        for (int r = 0; r < repeats; ++r) {
+            for (EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+                checksum += actor->getComponent<Transform>()->getPosition().x;
+            }
+        }
+        benchmarkKeep(checksum);
+        report.metric(prefix + "get_component", timer.elapsedNanoseconds() / (entities * repeats), "ns/entity");
+
+        timer.restart();
+        for (int r = 0; r < repeats; ++r) {
+            for (EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+                actor->update(1.f / 60.f);
+            }
+        }
+        report.metric(prefix + "update", timer.elapsedNanoseconds() / (entities * repeats), "ns/entity");
+
+        std::vector<DrawItem> drawList;
+        drawList.reserve(count);
+        timer.restart();
+        for (int r = 0; r < repeats; ++r) {
+            drawList.clear();
+            for (EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+                EngineUtilities::TSharedPointer<CShape> shape = actor->getComponent<CShape>();
+                if (shape && shape->getShape() != nullptr) {
+                    drawList.push_back({ shape->getShape(), actor->getComponent<Transform>()->getPosition() });
+                }
+            }
+        }
+        benchmarkKeep(drawList.data());
+        report.metric(prefix + "render_extract", timer.elapsedNanoseconds() / (entities * repeats), "ns/entity");
+
+        // Destroy half the scene in random order, then refill it: the refill allocates
+        // into the holes, which is where fragmentation shows up.
+        std::mt19937 random(82);
+        std::shuffle(actors.begin(), actors.end(), random);
+        const size_t half = count / 2;
+        timer.restart();
+        actors.resize(count - half);
+        report.metric(prefix + "destroy_random", timer.elapsedNanoseconds() / half, "ns/entity");
+
+        timer.restart();
+        for (size_t i = 0; i < half; ++i) {
+            actors.push_back(spawnActor(mix, i));
+        }
+        report.metric(prefix + "respawn", timer.elapsedNanoseconds() / half, "ns/entity");
+
+        timer.restart();
+        actors.clear();
+        report.metric(prefix + "destroy_all", timer.elapsedNanoseconds() / entities, "ns/entity");
+    }
+}
+
+RIOLU_BENCHMARK(EcsStress) {
+    for (const SceneMix& mix : Mixes) {
+        for (size_t count : SceneCounts) {
+            if (count <= mix.maxCount) {
+                runScene(report, mix, count);
+            }
+        }
+    }
+}
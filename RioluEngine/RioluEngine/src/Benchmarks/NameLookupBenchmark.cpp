@@ -0,0 +1,146 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/Actor.h"
+#include "ECS/ActorNameIndex.h"
+#include <random>
+
+/**
+ * @file NameLookupBenchmark.cpp
+ * @brief Names 1M actors through the StringTable and finds them by name.
+ *
+ * Every actor gets a unique 18-character name (too long for the small-string buffer,
+ * like most real names). The baselines keep a std::string per actor, as Actor did
+ * before, and find names by scanning every actor or through an
+ * std::unordered_map<std::string, Actor*>. Memory is per actor: the name member plus
+ * its share of the intern table and the index, against the string member plus the
+ * map (estimated from node and bucket sizes). Every lookup result is checked.
+ */
+
+namespace {
+    const size_t ActorCount = 1000000;
+    const size_t QueryCount = 100000;
+    const size_t ScanQueryCount = 20;
+
+    static_assert(StringId("Enemy/Grunt/000042").getHash() == StringId::hash("Enemy/Grunt/000042"),
+                  "literal ids are hashed at compile time");
+
+    std::string
+    nameOf(size_t index) {
+        std::string digits = std::to_string(index);
+        return "Enemy/Grunt/" + std::string(6 - digits.size(), '0') + digits;
+    }
+}
+
+RIOLU_BENCHMARK(NameLookup) {
+    std::vector<std::string> names;
+    names.reserve(ActorCount);
+    size_t stringBytes = 0;
+    for (size_t i = 0; i < ActorCount; ++i) {
+        names.push_back(nameOf(i));
+        // Heap block of names past the small-string buffer (allocator headers not counted).
+        stringBytes += sizeof(std::string) + (names.back().capacity() > 15 ? names.back().capacity() + 1 : 0);
+    }
+    report.metric("string_bytes_per_actor", static_cast<double>(stringBytes) / ActorCount, "bytes");
+
+    const size_t tableBefore = StringTable::instance().getByteSize();
+    std::vector<StringId> ids(ActorCount);
+    {
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < ActorCount; ++i) {
+            ids[i] = StringId::intern(names[i]);
+        }
+        report.metric("intern", timer.elapsedNanoseconds() / ActorCount, "ns");
+    }
+
+    std::vector<EngineUtilities::TSharedPointer<Actor>> actors;
+    actors.reserve(ActorCount);
+    for (size_t i = 0; i < ActorCount; ++i) {
+        actors.push_back(EngineUtilities::MakeShared<Actor>(ids[i]));
+    }
+
+    ActorNameIndex index;
+    {
+        BenchmarkTimer timer;
+        for (const EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+            index.add(actor->getName(), actor.get());
+        }
+        report.metric("index_add", timer.elapsedNanoseconds() / ActorCount, "ns");
+    }
+    const size_t tableBytes = StringTable::instance().getByteSize() - tableBefore;
+    report.metric("interned_bytes_per_actor",
+                  static_cast<double>(sizeof(StringId) + tableBytes + index.getByteSize()) / ActorCount, "bytes");
+    report.metric("intern_table_bytes_per_name", static_cast<double>(tableBytes) / ActorCount, "bytes");
+    report.metric("index_bytes_per_actor", static_cast<double>(index.getByteSize()) / ActorCount, "bytes");
+
+    std::mt19937 random(7);
+    std::vector<size_t> queries(QueryCount);
+    for (size_t& query : queries) {
+        query = random() % ActorCount;
+    }
+    size_t wrong = 0;
+
+    {
+        BenchmarkTimer timer;
+        for (size_t q = 0; q < ScanQueryCount; ++q) {
+            const std::string& wanted = names[queries[q]];
+            size_t found = ActorCount;
+            for (size_t i = 0; i < ActorCount; ++i) {
+                if (names[i] == wanted) {
+                    found = i;
+                    break;
+                }
+            }
+            wrong += found != queries[q] ? 1 : 0;
+        }
+        report.metric("linear_scan_lookup", timer.elapsedNanoseconds() / ScanQueryCount, "ns");
+    }
+
+    {
+        std::unordered_map<std::string, Actor*> byString;
+        byString.reserve(ActorCount);
+        for (size_t i = 0; i < ActorCount; ++i) {
+            byString.emplace(names[i], actors[i].get());
+        }
+        // Node (next pointer, key copy, value, cached hash), bucket, key heap block.
+        const size_t nodeBytes = sizeof(void*) + sizeof(std::pair<const std::string, Actor*>) + sizeof(size_t);
+        report.metric("string_and_map_bytes_per_actor",
+                      static_cast<double>(2 * stringBytes + ActorCount * (nodeBytes - sizeof(std::string)) +
+                                          byString.bucket_count() * sizeof(void*)) / ActorCount, "bytes");
+
+        BenchmarkTimer timer;
+        for (size_t query : queries) {
+            wrong += byString.find(names[query])->second != actors[query].get() ? 1 : 0;
+        }
+        report.metric("string_map_lookup", timer.elapsedNanoseconds() / QueryCount, "ns");
+    }
+
+    {
+        BenchmarkTimer timer;
+        for (size_t query : queries) {
+            wrong += index.find(StringId::fromText(names[query])) != actors[query].get() ? 1 : 0;
+        }
+        report.metric("index_lookup_from_text", timer.elapsedNanoseconds() / QueryCount, "ns");
+    }
+
+    {
+        BenchmarkTimer timer;
+        for (size_t query : queries) {
+            wrong += index.find(ids[query]) != actors[query].get() ? 1 : 0;
+        }
+        report.metric("index_lookup_from_id", timer.elapsedNanoseconds() / QueryCount, "ns");
+    }
+    wrong += index.find(StringId("Enemy/Grunt/000042")) != actors[42].get() ? 1 : 0;
+    wrong += std::string(actors[42]->getName().c_str()) != "Enemy/Grunt/000042" ? 1 : 0;
+
+    // Remove every other actor and check both halves.
+    {
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < ActorCount; i += 2) {
+            wrong += index.remove(ids[i], actors[i].get()) ? 0 : 1;
+        }
+        report.metric("index_remove", timer.elapsedNanoseconds() / (ActorCount / 2), "ns");
+    }
+    for (size_t i = 0; i < ActorCount; ++i) {
+        wrong += index.find(ids[i]) != (i % 2 == 0 ? nullptr : actors[i].get()) ? 1 : 0;
+    }
+    report.metric("wrong_results", static_cast<double>(wrong), "count");
+}
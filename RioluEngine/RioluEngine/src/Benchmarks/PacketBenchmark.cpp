@@ -0,0 +1,155 @@
+#include "Benchmarks/Benchmark.h"
+#include "Benchmarks/AllocationCounter.h"
+#include "Network/PacketBatcher.h"
+
+/**
+ * @file PacketBenchmark.cpp
+ * @brief Compares sf::Packet per message against pooled, batched, bit-packed datagrams on loopback.
+ */
+
+namespace {
+    const int MessageCount = 200000;
+
+    /**
+     * @brief Payload used by both paths: the actor update of the replication layer.
+     */
+    struct ActorUpdate {
+        sf::Uint32 id;
+        float x;
+        float y;
+        float rotation;
+    };
+
+    ActorUpdate
+    makeUpdate(int i) {
+        return { static_cast<sf::Uint32>(i % 20000), static_cast<float>(i % 9973), static_cast<float>(i % 7919), static_cast<float>(i % 360) };
+    }
+
+    void
+    bindPair(sf::UdpSocket& sender, sf::UdpSocket& receiver) {
+        if (receiver.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done ||
+            sender.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done) {
+            ERROR("PacketBenchmark", "bindPair", "Could not bind loopback sockets");
+        }
+        receiver.setBlocking(false);
+    }
+
+    void
+    reportPath(BenchmarkReport& report, const std::string& path, double milliseconds,
+               uint64_t received, uint64_t allocations, uint64_t datagrams, uint64_t bytes) {
+        report.metric(path + "_messages_per_second", received / (milliseconds / 1000.0), "msg/s");
+        report.metric(path + "_messages_received", static_cast<double>(received), "count");
+        if (AllocationCounter::Available) {
+            report.metric(path + "_allocations", static_cast<double>(allocations), "count");
+            report.metric(path + "_allocations_per_message", static_cast<double>(allocations) / MessageCount, "count");
+        }
+        report.metric(path + "_datagrams", static_cast<double>(datagrams), "count");
+        report.metric(path + "_bytes", static_cast<double>(bytes), "bytes");
+    }
+}
+
+RIOLU_BENCHMARK(PacketSerialization) {
+    // --- sf::Packet, one datagram per message ---
+    {
+        sf::UdpSocket sender;
+        sf::UdpSocket receiver;
+        bindPair(sender, receiver);
+        const unsigned short port = receiver.getLocalPort();
+
+        uint64_t received = 0;
+        uint64_t bytes = 0;
+        AllocationScope allocations;
+        BenchmarkTimer timer;
+        for (int i = 0; i < MessageCount; ++i) {
+            const ActorUpdate update = makeUpdate(i);
+            sf::Packet packet;
+            packet << update.id << update.x << update.y << update.rotation;
+            sender.send(packet, sf::IpAddress::LocalHost, port);
+            bytes += packet.getDataSize();
+
+            if (i % 16 == 15 || i == MessageCount - 1) {
+                sf::Packet incoming;
+                sf::IpAddress from;
+                unsigned short fromPort = 0;
+                while (receiver.receive(incoming, from, fromPort) == sf::Socket::Done) {
+                    ActorUpdate decoded;
+                    incoming >> decoded.id >> decoded.x >> decoded.y >> decoded.rotation;
+                    benchmarkKeep(decoded);
+                    ++received;
+                }
+            }
+        }
+        const double milliseconds = timer.elapsedMilliseconds();
+        reportPath(report, "sfpacket", milliseconds, received, allocations.getAllocations(), MessageCount, bytes);
+    }
+
+    // --- Pooled blocks, bit writer, many messages per datagram ---
+    {
+        sf::UdpSocket sender;
+        sf::UdpSocket receiver;
+        bindPair(sender, receiver);
+        PacketPool sendPool(1200, 4);
+        PacketPool receivePool(1200, 64);
+
+        uint64_t received = 0;
+        uint64_t datagrams = 0;
+        uint64_t bytes = 0;
+        AllocationScope allocations;
+        BenchmarkTimer timer;
+        {
+            PacketBatcher batcher(sendPool, sender, sf::IpAddress::LocalHost, receiver.getLocalPort());
+            auto drain = [&]() {
+                sf::IpAddress from;
+                unsigned short fromPort = 0;
+                while (PacketBlock* block = PacketBatcher::receive(receiver, receivePool, from, fromPort)) {
+                    MessageIterator messages(*block);
+                    BitReader reader;
+                    while (messages.next(reader)) {
+                        ActorUpdate decoded;
+                        decoded.id = reader.readUint32();
+                        decoded.x = reader.readFloat();
+                        decoded.y = reader.readFloat();
+                        decoded.rotation = reader.readFloat();
+                        benchmarkKeep(decoded);
+                        ++received;
+                    }
+                    receivePool.release(block);
+                }
+            };
+
+            for (int i = 0; i < MessageCount; ++i) {
+                const ActorUpdate update = makeUpdate(i);
+                const uint64_t datagramsBefore = batcher.getStats().datagrams;
+                BitWriter writer = batcher.beginMessage(16);
+                writer.writeUint32(update.id);
+                writer.writeFloat(update.x);
+                writer.writeFloat(update.y);
+                writer.writeFloat(update.rotation);
+                batcher.endMessage(writer);
+                if (batcher.getStats().datagrams != datagramsBefore) {
+                    drain();
+                }
+            }
+            batcher.flush();
+            drain();
+            datagrams = batcher.getStats().datagrams;
+            bytes = batcher.getStats().bytes;
+        }
+        const double milliseconds = timer.elapsedMilliseconds();
+        reportPath(report, "pooled", milliseconds, received, allocations.getAllocations(), datagrams, bytes);
+        report.metric("pooled_receive_pool_exhausted", static_cast<double>(receivePool.getStats().exhausted), "count");
+    }
+
+    // --- Payload size when the bit writer quantizes the same update ---
+    {
+        sf::Uint8 scratch[64];
+        BitWriter writer(scratch, sizeof(scratch));
+        const ActorUpdate update = makeUpdate(12345);
+        writer.writeBits(update.id, 20);
+        writer.writeQuantized(update.x, 0.f, 10000.f, 18);
+        writer.writeQuantized(update.y, 0.f, 10000.f, 18);
+        writer.writeQuantized(update.rotation, 0.f, 360.f, 9);
+        report.metric("float_payload_per_message", 16.0, "bytes");
+        report.metric("quantized_payload_per_message", writer.flush(), "bytes");
+    }
+}
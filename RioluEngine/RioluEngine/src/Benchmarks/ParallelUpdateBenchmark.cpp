@@ -0,0 +1,178 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/ActorUpdater.h"
+#include <cmath>
+
+/**
+ * @file ParallelUpdateBenchmark.cpp
+ * @brief Measures how ActorUpdater scales with the thread count on 100k actors.
+ *
+ * Every actor is what BaseApp spawns (CShape + Transform) plus a steering component
+ * that moves its Transform; one actor in a hundred also has a serial component. For
+ * each thread count the frame time is reported with its speedup over the
+ * deterministic (single thread) update, and the final positions are compared with
+ * the deterministic run.
+ */
+
+namespace {
+    const size_t ActorCount = 100000;
+    const int Frames = 20;
+    const size_t SerialEvery = 100;
+
+    /**
+     * @brief Steers its actor's Transform around a circle; touches only its actor.
+     */
+    class SteeringComponent : public Component {
+    public:
+        explicit SteeringComponent(Transform* transform, float phase)
+            : Component(ComponentType::PHYSICS), m_transform(transform), m_startPhase(phase), m_phase(phase) {}
+
+        /**
+         * @brief Returns to the spawn state.
+         */
+        void
+        reset(const sf::Vector2f& position) {
+            m_phase = m_startPhase;
+            m_transform->setPosition(position);
+        }
+
+        void start() override {}
+        void render(const EngineUtilities::TSharedPointer<Window>& /*window*/) override {}
+        void destroy() override {}
+
+        void
+        update(float deltaTime) override {
+            m_phase += deltaTime;
+            const sf::Vector2f target(500.f + 400.f * std::cos(m_phase), 500.f + 400.f * std::sin(m_phase));
+            m_transform->seek(target, 200.f, deltaTime, 1.f);
+        }
+
+    private:
+        Transform* m_transform; ///< Transform of the same actor.
+        float m_startPhase;     ///< Phase at spawn.
+        float m_phase;          ///< Position on the circle.
+    };
+
+    /**
+     * @brief Accumulates into shared state, so it must stay on the main thread.
+     */
+    class TallyComponent : public Component {
+    public:
+        TallyComponent(Transform* transform, double& tally)
+            : Component(ComponentType::PHYSICS), m_transform(transform), m_tally(tally) {}
+
+        void start() override {}
+        void render(const EngineUtilities::TSharedPointer<Window>& /*window*/) override {}
+        void destroy() override {}
+        bool isParallelUpdateSafe() const override { return false; }
+
+        void update(float deltaTime) override { m_tally += m_transform->getPosition().x * deltaTime; }
+
+    private:
+        Transform* m_transform; ///< Transform of the same actor.
+        double& m_tally;        ///< Shared accumulator.
+    };
+
+    /**
+     * @brief Spawn position of actor @p i.
+     */
+    sf::Vector2f
+    spawnPosition(size_t i) {
+        return sf::Vector2f(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+    }
+
+    void
+    spawnScene(ActorUpdater::ActorList& actors, std::vector<SteeringComponent*>& steering, double& tally) {
+        actors.reserve(ActorCount);
+        steering.reserve(ActorCount);
+        for (size_t i = 0; i < ActorCount; ++i) {
+            EngineUtilities::TSharedPointer<Actor> actor = EngineUtilities::MakeShared<Actor>("Parallel Actor");
+            actor->getComponent<CShape>()->createShape(ShapeType::RECTANGLE);
+            Transform* transform = actor->getComponent<Transform>().get();
+            EngineUtilities::TSharedPointer<SteeringComponent> steer =
+                EngineUtilities::MakeShared<SteeringComponent>(transform, 0.001f * i);
+            steering.push_back(steer.get());
+            actor->addComponent(steer);
+            if (i % SerialEvery == 0) {
+                actor->addComponent(EngineUtilities::MakeShared<TallyComponent>(transform, tally));
+            }
+            actors.push_back(actor);
+        }
+    }
+
+    /**
+     * @brief Puts every actor back in its spawn state, keeping the memory layout.
+     */
+    void
+    resetScene(std::vector<SteeringComponent*>& steering, double& tally) {
+        for (size_t i = 0; i < steering.size(); ++i) {
+            steering[i]->reset(spawnPosition(i));
+        }
+        tally = 0.0;
+    }
+
+    /**
+     * @brief Sums the actor positions (order-independent of the update schedule).
+     */
+    double
+    positionChecksum(ActorUpdater::ActorList& actors) {
+        double sum = 0.0;
+        for (EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+            const sf::Vector2f position = actor->getComponent<Transform>()->getPosition();
+            sum += position.x * 3.0 + position.y;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Runs Frames updates and returns the milliseconds per frame.
+     */
+    double
+    runFrames(ActorUpdater& updater, ActorUpdater::ActorList& actors) {
+        BenchmarkTimer timer;
+        for (int i = 0; i < Frames; ++i) {
+            updater.update(actors, 1.f / 60.f);
+        }
+        return timer.elapsedMilliseconds() / Frames;
+    }
+}
+
+RIOLU_BENCHMARK(ParallelUpdate) {
+    report.metric("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()), "count");
+
+    double tally = 0.0;
+    ActorUpdater::ActorList actors;
+    std::vector<SteeringComponent*> steering;
+    spawnScene(actors, steering, tally);
+
+    double deterministicFrame = 0.0;
+    double deterministicChecksum = 0.0;
+    double deterministicTally = 0.0;
+    {
+        JobSystem jobs(0);
+        ActorUpdater updater(jobs);
+        updater.setMode(ActorUpdateMode::Deterministic);
+        resetScene(steering, tally);
+        deterministicFrame = runFrames(updater, actors);
+        deterministicChecksum = positionChecksum(actors);
+        deterministicTally = tally;
+        report.metric("deterministic_frame", deterministicFrame, "ms");
+    }
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u, 16u }) {
+        // The thread calling update() takes chunks too, so the pool has one worker less.
+        JobSystem jobs(threads - 1);
+        ActorUpdater updater(jobs);
+        resetScene(steering, tally);
+        const double frame = runFrames(updater, actors);
+
+        const std::string prefix = "threads_" + std::to_string(threads) + "_";
+        report.metric(prefix + "frame", frame, "ms");
+        report.metric(prefix + "speedup", deterministicFrame / frame, "x");
+        report.metric(prefix + "matches_deterministic",
+                      positionChecksum(actors) == deterministicChecksum && tally == deterministicTally ? 1.0 : 0.0,
+                      "bool");
+        if (threads == 1) {
+            report.metric("serial_actors", static_cast<double>(updater.getSerialActorCount()), "count");
+        }
+    }
+}
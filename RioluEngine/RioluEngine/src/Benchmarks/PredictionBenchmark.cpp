@@ -0,0 +1,77 @@
+#include "Benchmarks/Benchmark.h"
+#include "Network/LocalAuthorityServer.h"
+#include "ECS/Actor.h"
+#include <cmath>
+
+/**
+ * @file PredictionBenchmark.cpp
+ * @brief Runs client prediction against the loopback server stand-in with emulated latency.
+ */
+
+RIOLU_BENCHMARK(PredictionLoopback) {
+    const int frameCount = 1200;
+    const unsigned int latencyTicks = 6;
+    const std::vector<sf::Vector2f> waypoints = {
+        { 400.f, 150.f }, { 700.f, 300.f }, { 1000.f, 150.f }, { 1200.f, 500.f }
+    };
+
+    auto actor = EngineUtilities::MakeShared<Actor>("Predicted Actor");
+    auto transform = actor->getComponent<Transform>();
+    transform->setPosition(sf::Vector2f(100.f, 150.f));
+
+    LocalAuthorityServer server(transform->getPosition(), latencyTicks);
+    if (!server.bind()) {
+        ERROR("PredictionBenchmark", "PredictionLoopback", "Could not bind the server socket");
+    }
+
+    sf::UdpSocket clientSocket;
+    clientSocket.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost);
+    clientSocket.setBlocking(false);
+
+    ClientPrediction prediction(transform);
+
+    size_t waypoint = 0;
+    double clientMicros = 0.0;
+    double pendingSum = 0.0;
+    float maxVisualGap = 0.f;
+
+    for (int frame = 0; frame < frameCount; ++frame) {
+        const sf::Vector2f toTarget = waypoints[waypoint] - prediction.getPredictedPosition();
+        if (std::sqrt(toTarget.x * toTarget.x + toTarget.y * toTarget.y) < 10.f) {
+            waypoint = (waypoint + 1) % waypoints.size();
+        }
+
+        BenchmarkTimer timer;
+        prediction.update(MovementSimulation::FixedStep, waypoints[waypoint], 200.f, 10.f);
+        prediction.sendCommands(clientSocket, sf::IpAddress::LocalHost, server.getPort());
+        clientMicros += timer.elapsedMicroseconds();
+
+        // Server-only knockback every two seconds forces a misprediction.
+        if (frame % 120 == 60) {
+            server.applyImpulse(sf::Vector2f(0.f, 40.f));
+        }
+        server.tick();
+
+        timer.restart();
+        prediction.receiveStates(clientSocket);
+        clientMicros += timer.elapsedMicroseconds();
+
+        pendingSum += static_cast<double>(prediction.getPendingCount());
+        const sf::Vector2f gap = prediction.getVisualPosition() - prediction.getPredictedPosition();
+        maxVisualGap = std::max(maxVisualGap, std::sqrt(gap.x * gap.x + gap.y * gap.y));
+    }
+
+    const PredictionStats& stats = prediction.getStats();
+    report.metric("frames", frameCount, "count");
+    report.metric("latency", latencyTicks * MovementSimulation::FixedStep * 1000.f, "ms");
+    report.metric("client_cpu_per_frame", clientMicros / frameCount, "us");
+    report.metric("states_received", static_cast<double>(stats.statesReceived), "count");
+    report.metric("corrections", static_cast<double>(stats.corrections), "count");
+    report.metric("snaps", static_cast<double>(stats.snaps), "count");
+    report.metric("replayed_per_state",
+                  stats.statesReceived ? static_cast<double>(stats.replayedCommands) / stats.statesReceived : 0.0,
+                  "count");
+    report.metric("avg_pending_commands", pendingSum / frameCount, "count");
+    report.metric("max_correction", stats.maxError, "units");
+    report.metric("max_visual_offset", maxVisualGap, "units");
+}
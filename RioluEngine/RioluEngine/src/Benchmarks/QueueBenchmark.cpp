@@ -0,0 +1,235 @@
+#include "Benchmarks/Benchmark.h"
+#include "Jobs/BlockingQueue.h"
+#include "Jobs/MPMCQueue.h"
+#include "Jobs/SPSCQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/**
+ * @file QueueBenchmark.cpp
+ * @brief Compares the lock-free queues with a mutex-guarded std::deque.
+ *
+ * Throughput metrics are nanoseconds per element moved from producers to consumers;
+ * latency metrics are nanoseconds per round trip between two threads. Every run
+ * checks that the consumers received exactly the values that were pushed.
+ */
+
+namespace {
+    const size_t Capacity = 1024;
+    const uint64_t ElementsPerProducer = 1000000;
+    const int RoundTrips = 100000;
+
+    /**
+     * @brief Bounded std::deque behind a mutex, the baseline for the lock-free queues.
+     */
+    class MutexQueue {
+    public:
+        explicit MutexQueue(size_t capacity) : m_capacity(capacity) {}
+
+        bool
+        tryPush(uint64_t value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.size() >= m_capacity) {
+                return false;
+            }
+            m_queue.push_back(value);
+            return true;
+        }
+
+        bool
+        tryPop(uint64_t& value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.empty()) {
+                return false;
+            }
+            value = m_queue.front();
+            m_queue.pop_front();
+            return true;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::deque<uint64_t> m_queue;
+        size_t m_capacity;
+    };
+
+    /**
+     * @brief The same deque with condition variables, the baseline for TBlockingQueue.
+     */
+    class ConditionQueue {
+    public:
+        explicit ConditionQueue(size_t capacity) : m_capacity(capacity) {}
+
+        bool
+        push(uint64_t value) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this] { return m_queue.size() < m_capacity; });
+            m_queue.push_back(value);
+            lock.unlock();
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        bool
+        pop(uint64_t& value) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return !m_queue.empty(); });
+            value = m_queue.front();
+            m_queue.pop_front();
+            lock.unlock();
+            m_notFull.notify_one();
+            return true;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::deque<uint64_t> m_queue;
+        size_t m_capacity;
+    };
+
+    /**
+     * @brief Spinning push/pop for the non-blocking queues.
+     */
+    template<typename Queue>
+    struct Spinning {
+        static void
+        push(Queue& queue, uint64_t value) {
+            while (!queue.tryPush(value)) {
+                std::this_thread::yield();
+            }
+        }
+
+        static void
+        pop(Queue& queue, uint64_t& value) {
+            while (!queue.tryPop(value)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    /**
+     * @brief Blocking push/pop for TBlockingQueue and ConditionQueue.
+     */
+    template<typename Queue>
+    struct Blocking {
+        static void push(Queue& queue, uint64_t value) { queue.push(value); }
+        static void pop(Queue& queue, uint64_t& value) { queue.pop(value); }
+    };
+
+    /**
+     * @brief Moves ElementsPerProducer values from each producer to the consumers.
+     * @return Nanoseconds per element, or a negative value if the checksum is wrong.
+     */
+    template<typename Queue, template<typename> class Access>
+    double
+    throughput(unsigned producers, unsigned consumers) {
+        Queue queue(Capacity);
+        const uint64_t total = ElementsPerProducer * producers;
+        std::atomic<uint64_t> received{ 0 };
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<bool> go{ false };
+
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, &go]() {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (uint64_t i = 1; i <= ElementsPerProducer; ++i) {
+                    Access<Queue>::push(queue, i);
+                }
+            });
+        }
+        // Each consumer takes a fixed share so the blocking variants never wait
+        // for elements that will not come.
+        for (unsigned c = 0; c < consumers; ++c) {
+            const uint64_t share = total / consumers + (c < total % consumers ? 1 : 0);
+            threads.emplace_back([&queue, &go, &received, &sum, share]() {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                uint64_t localSum = 0;
+                uint64_t value = 0;
+                for (uint64_t i = 0; i < share; ++i) {
+                    Access<Queue>::pop(queue, value);
+                    localSum += value;
+                }
+                sum.fetch_add(localSum);
+                received.fetch_add(share);
+            });
+        }
+
+        BenchmarkTimer timer;
+        go.store(true, std::memory_order_release);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const double nanoseconds = timer.elapsedNanoseconds();
+
+        const uint64_t expected = producers * (ElementsPerProducer * (ElementsPerProducer + 1) / 2);
+        if (received.load() != total || sum.load() != expected) {
+            return -1.0;
+        }
+        return nanoseconds / total;
+    }
+
+    /**
+     * @brief Bounces a value between two threads through a pair of queues.
+     * @return Nanoseconds per round trip.
+     */
+    template<typename Queue, template<typename> class Access>
+    double
+    roundTrip() {
+        Queue ping(Capacity);
+        Queue pong(Capacity);
+        std::thread echo([&ping, &pong]() {
+            uint64_t value = 0;
+            for (int i = 0; i < RoundTrips; ++i) {
+                Access<Queue>::pop(ping, value);
+                Access<Queue>::push(pong, value + 1);
+            }
+        });
+
+        uint64_t value = 0;
+        BenchmarkTimer timer;
+        for (int i = 0; i < RoundTrips; ++i) {
+            Access<Queue>::push(ping, value);
+            Access<Queue>::pop(pong, value);
+        }
+        const double nanoseconds = timer.elapsedNanoseconds();
+        echo.join();
+        benchmarkKeep(value);
+        return value == static_cast<uint64_t>(RoundTrips) ? nanoseconds / RoundTrips : -1.0;
+    }
+
+    using Spsc = TSPSCQueue<uint64_t>;
+    using Mpmc = TMPMCQueue<uint64_t>;
+    using BlockingSpsc = TBlockingQueue<Spsc, uint64_t>;
+    using BlockingMpmc = TBlockingQueue<Mpmc, uint64_t>;
+}
+
+RIOLU_BENCHMARK(Queues) {
+    report.metric("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()), "count");
+
+    report.metric("1p1c_spsc", throughput<Spsc, Spinning>(1, 1), "ns/element");
+    report.metric("1p1c_mpmc", throughput<Mpmc, Spinning>(1, 1), "ns/element");
+    report.metric("1p1c_mutex", throughput<MutexQueue, Spinning>(1, 1), "ns/element");
+
+    for (unsigned threads : { 2u, 4u }) {
+        const std::string prefix = std::to_string(threads) + "p" + std::to_string(threads) + "c_";
+        report.metric(prefix + "mpmc", throughput<Mpmc, Spinning>(threads, threads), "ns/element");
+        report.metric(prefix + "mutex", throughput<MutexQueue, Spinning>(threads, threads), "ns/element");
+        report.metric(prefix + "blocking_mpmc", throughput<BlockingMpmc, Blocking>(threads, threads), "ns/element");
+        report.metric(prefix + "condition_variable", throughput<ConditionQueue, Blocking>(threads, threads), "ns/element");
+    }
+
+    report.metric("round_trip_spsc", roundTrip<Spsc, Spinning>(), "ns");
+    report.metric("round_trip_mpmc", roundTrip<Mpmc, Spinning>(), "ns");
+    report.metric("round_trip_mutex", roundTrip<MutexQueue, Spinning>(), "ns");
+    report.metric("round_trip_blocking_spsc", roundTrip<BlockingSpsc, Blocking>(), "ns");
+    report.metric("round_trip_condition_variable", roundTrip<ConditionQueue, Blocking>(), "ns");
+}
@@ -0,0 +1,152 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/Transform.h"
+#include "Network/ReflectedSerializer.h"
+#include <cstring>
+
+/**
+ * @file ReflectionBenchmark.cpp
+ * @brief Serializes 100k TransformData through reflection-generated code and through
+ * hand-written, table-driven and by-name serializers.
+ *
+ * The replicated fields (position and the rotation angle) are written to a bit stream by: a
+ * hand-written function, ReflectedSerializer, a loop over the type-erased field table
+ * switching on type, and a loop looking every field up by name. Every path must
+ * produce the same bytes. Deltas against a baseline where one transform in ten moved
+ * are measured too, with a round trip through readDelta.
+ */
+
+namespace {
+    const size_t TransformCount = 100000;
+    const int Rounds = 20;
+
+    static_assert(ReflectedSerializer<FieldReplicated>::bits<TransformData>() == 96,
+                  "position and the rotation angle are replicated as three raw floats");
+    static_assert(FieldTable<TransformData>[2].offset == offsetof(TransformData, scale));
+
+    void
+    writeHandWritten(BitWriter& writer, const TransformData& data) {
+        writer.writeFloat(data.position.x);
+        writer.writeFloat(data.position.y);
+        writer.writeFloat(data.rotation.x);
+    }
+
+    /**
+     * @brief Writes one field described at run time.
+     */
+    void
+    writeInfo(BitWriter& writer, const FieldInfo& field, const TransformData& data) {
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(&data) + field.offset;
+        float values[2];
+        switch (field.type) {
+        case FieldType::Float:
+            std::memcpy(values, source, sizeof(float));
+            writer.writeFloat(values[0]);
+            break;
+        case FieldType::Vector2f:
+            std::memcpy(values, source, sizeof(values));
+            writer.writeFloat(values[0]);
+            writer.writeFloat(values[1]);
+            break;
+        default:
+            ERROR("ReflectionBenchmark", "writeInfo", "Unexpected field type");
+        }
+    }
+
+    void
+    writeTableDriven(BitWriter& writer, const TransformData& data) {
+        for (const FieldInfo& field : FieldTable<TransformData>) {
+            if ((field.flags & FieldReplicated) != 0) {
+                writeInfo(writer, field, data);
+            }
+        }
+    }
+
+    void
+    writeByName(BitWriter& writer, const TransformData& data) {
+        static const char* const names[] = { "position", "rotation.x" };
+        for (const char* name : names) {
+            writeInfo(writer, *findField<TransformData>(name), data);
+        }
+    }
+
+    /**
+     * @brief Serializes every transform with @p write and reports ns per transform.
+     */
+    template<typename Write>
+    uint32_t
+    measure(BenchmarkReport& report, const char* name, const std::vector<TransformData>& transforms,
+            std::vector<sf::Uint8>& buffer, Write write) {
+        uint32_t bytes = 0;
+        BenchmarkTimer timer;
+        for (int round = 0; round < Rounds; ++round) {
+            BitWriter writer(buffer.data(), static_cast<uint32_t>(buffer.size()));
+            for (const TransformData& data : transforms) {
+                write(writer, data);
+            }
+            bytes = writer.flush();
+            benchmarkClobber();
+        }
+        report.metric(name, timer.elapsedNanoseconds() / (double(Rounds) * TransformCount), "ns");
+        return bytes;
+    }
+}
+
+RIOLU_BENCHMARK(Reflection) {
+    std::vector<TransformData> transforms(TransformCount);
+    for (size_t i = 0; i < TransformCount; ++i) {
+        const float f = static_cast<float>(i);
+        transforms[i] = TransformData{ { f * 0.5f, f * 0.25f }, { f * 0.1f, 0.f }, { 1.f, 1.f } };
+    }
+
+    const size_t capacity = TransformCount * sizeof(TransformData);
+    std::vector<sf::Uint8> hand(capacity), reflected(capacity), table(capacity), byName(capacity);
+
+    const uint32_t handBytes = measure(report, "hand_written", transforms, hand,
+        [](BitWriter& writer, const TransformData& data) { writeHandWritten(writer, data); });
+    const uint32_t reflectedBytes = measure(report, "reflected", transforms, reflected,
+        [](BitWriter& writer, const TransformData& data) { ReflectedSerializer<FieldReplicated>::write(writer, data); });
+    const uint32_t tableBytes = measure(report, "table_driven", transforms, table,
+        [](BitWriter& writer, const TransformData& data) { writeTableDriven(writer, data); });
+    const uint32_t byNameBytes = measure(report, "by_name", transforms, byName,
+        [](BitWriter& writer, const TransformData& data) { writeByName(writer, data); });
+
+    const bool same = handBytes == reflectedBytes && handBytes == tableBytes && handBytes == byNameBytes &&
+                      std::memcmp(hand.data(), reflected.data(), handBytes) == 0 &&
+                      std::memcmp(hand.data(), table.data(), handBytes) == 0 &&
+                      std::memcmp(hand.data(), byName.data(), handBytes) == 0;
+    report.metric("bytes_per_transform", static_cast<double>(reflectedBytes) / TransformCount, "bytes");
+    report.metric("identical_output", same ? 1.0 : 0.0, "bool");
+
+    // Deltas: one transform in ten moved since the baseline.
+    std::vector<TransformData> current = transforms;
+    for (size_t i = 0; i < TransformCount; i += 10) {
+        current[i].position.x += 1.f;
+    }
+    std::vector<sf::Uint8> delta(capacity);
+    uint32_t deltaBytes = 0;
+    uint32_t changed = 0;
+    {
+        BenchmarkTimer timer;
+        for (int round = 0; round < Rounds; ++round) {
+            BitWriter writer(delta.data(), static_cast<uint32_t>(delta.size()));
+            changed = 0;
+            for (size_t i = 0; i < TransformCount; ++i) {
+                changed += ReflectedSerializer<FieldReplicated>::writeDelta(writer, transforms[i], current[i]);
+            }
+            deltaBytes = writer.flush();
+            benchmarkClobber();
+        }
+        report.metric("delta_write", timer.elapsedNanoseconds() / (double(Rounds) * TransformCount), "ns");
+    }
+    report.metric("delta_bytes_per_transform", static_cast<double>(deltaBytes) / TransformCount, "bytes");
+    report.metric("delta_fields_changed", changed, "count");
+
+    BitReader reader(delta.data(), deltaBytes);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < TransformCount; ++i) {
+        TransformData decoded;
+        ReflectedSerializer<FieldReplicated>::readDelta(reader, transforms[i], decoded);
+        mismatches += std::memcmp(&decoded, &current[i], sizeof(TransformData)) != 0 ? 1 : 0;
+    }
+    report.metric("delta_round_trip_mismatches", static_cast<double>(mismatches + (reader.hasOverflowed() ? 1 : 0)), "count");
+}
@@ -0,0 +1,144 @@
+#include "Benchmarks/Benchmark.h"
+#include "Network/ReplicationManager.h"
+#include <random>
+
+/**
+ * @file ReplicationBenchmark.cpp
+ * @brief Measures interest management with 100 clients and 20k actors over loopback UDP.
+ */
+
+RIOLU_BENCHMARK(ReplicationInterest) {
+    const int actorCount = 20000;
+    const int clientCount = 100;
+    const int tickCount = 120;
+    const float tickDelta = 1.f / 30.f;
+    const sf::FloatRect worldBounds(0.f, 0.f, 10000.f, 10000.f);
+
+    std::mt19937 random(76);
+    std::uniform_real_distribution<float> coordinate(0.f, 10000.f);
+    std::uniform_real_distribution<float> velocity(-150.f, 150.f);
+
+    ReplicationManager replication(worldBounds, 200.f);
+
+    std::vector<EngineUtilities::TSharedPointer<Transform>> transforms;
+    std::vector<sf::Vector2f> velocities;
+    std::vector<int> actorById;
+    for (int i = 0; i < actorCount; ++i) {
+        auto actor = EngineUtilities::MakeShared<Actor>("Replicated Actor");
+        auto transform = actor->getComponent<Transform>();
+        transform->setPosition(sf::Vector2f(coordinate(random), coordinate(random)));
+        transforms.push_back(transform);
+        // A third of the world is static scenery.
+        velocities.push_back(i % 3 == 0 ? sf::Vector2f(0.f, 0.f)
+                                        : sf::Vector2f(velocity(random), velocity(random)));
+        const NetworkId id = replication.registerActor(actor);
+        if (actorById.size() <= id) {
+            actorById.resize(id + 1, -1);
+        }
+        actorById[id] = i;
+    }
+
+    // Every client listens on its own loopback socket.
+    std::vector<EngineUtilities::TSharedPointer<sf::UdpSocket>> clientSockets;
+    std::vector<sf::Vector2f> views;
+    for (int i = 0; i < clientCount; ++i) {
+        auto socket = EngineUtilities::MakeShared<sf::UdpSocket>();
+        if (socket->bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done) {
+            ERROR("ReplicationBenchmark", "ReplicationInterest", "Could not bind a loopback client socket");
+        }
+        socket->setBlocking(false);
+        ClientId client = replication.addClient(sf::IpAddress::LocalHost, socket->getLocalPort());
+        views.push_back(sf::Vector2f(coordinate(random), coordinate(random)));
+        replication.setClientView(client, views.back(), 800.f);
+        clientSockets.push_back(socket);
+    }
+
+    sf::UdpSocket serverSocket;
+    serverSocket.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost);
+
+    double tickMicros = 0.0;
+    double relevanceMicros = 0.0;
+    double priorityMicros = 0.0;
+    double serializeMicros = 0.0;
+    double sendMicros = 0.0;
+    uint64_t relevantPairs = 0;
+    uint64_t updatesSent = 0;
+    uint64_t updatesDeferred = 0;
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t packetsReceived = 0;
+    uint64_t updatesDecoded = 0;
+    uint64_t mismatches = 0;
+
+    sf::Packet received;
+    ReplicationPacket contents;
+    for (int tick = 0; tick < tickCount; ++tick) {
+        for (int i = 0; i < actorCount; ++i) {
+            sf::Vector2f position = transforms[i]->getPosition() + velocities[i] * tickDelta;
+            if (position.x < 0.f || position.x > worldBounds.width) velocities[i].x = -velocities[i].x;
+            if (position.y < 0.f || position.y > worldBounds.height) velocities[i].y = -velocities[i].y;
+            transforms[i]->setPosition(position);
+        }
+
+        BenchmarkTimer timer;
+        replication.tick(tickDelta);
+        tickMicros += timer.elapsedMicroseconds();
+        replication.send(serverSocket);
+
+        const ReplicationStats& stats = replication.getStats();
+        relevanceMicros += stats.relevanceMicros;
+        priorityMicros += stats.priorityMicros;
+        serializeMicros += stats.serializeMicros;
+        sendMicros += stats.sendMicros;
+        relevantPairs += stats.relevantPairs;
+        updatesSent += stats.updatesSent;
+        updatesDeferred += stats.updatesDeferred;
+        bytesSent += stats.bytesSent;
+
+        // Clients decode what they got; the transforms have not moved since tick().
+        for (auto& socket : clientSockets) {
+            sf::IpAddress sender;
+            unsigned short senderPort = 0;
+            while (socket->receive(received, sender, senderPort) == sf::Socket::Done) {
+                bytesReceived += received.getDataSize();
+                ++packetsReceived;
+                if (!ReplicationManager::readPacket(received, contents) ||
+                    contents.tick != static_cast<uint32_t>(tick + 1)) {
+                    ++mismatches;
+                    continue;
+                }
+                for (const ReplicatedUpdate& update : contents.updates) {
+                    const int actor = update.id < actorById.size() ? actorById[update.id] : -1;
+                    if (actor < 0 ||
+                        update.data.position != transforms[actor]->getPosition() ||
+                        update.data.rotation.x != transforms[actor]->getRotation().x) {
+                        ++mismatches;
+                    }
+                }
+                updatesDecoded += contents.updates.size();
+            }
+        }
+    }
+
+    const double ticks = static_cast<double>(tickCount);
+    const double naiveBytesPerTick = static_cast<double>(actorCount) * clientCount * ReplicationManager::UpdateSize;
+
+    report.metric("actors", actorCount, "count");
+    report.metric("clients", clientCount, "count");
+    report.metric("tick_cpu", tickMicros / ticks / 1000.0, "ms");
+    report.metric("relevance_cpu", relevanceMicros / ticks / 1000.0, "ms");
+    report.metric("priority_cpu", priorityMicros / ticks / 1000.0, "ms");
+    report.metric("serialize_cpu", serializeMicros / ticks / 1000.0, "ms");
+    report.metric("send_cpu", sendMicros / ticks / 1000.0, "ms");
+    report.metric("relevant_per_client", relevantPairs / ticks / clientCount, "count");
+    report.metric("updates_sent_per_client", updatesSent / ticks / clientCount, "count");
+    report.metric("updates_deferred_per_client", updatesDeferred / ticks / clientCount, "count");
+    report.metric("bytes_per_client_per_tick", bytesSent / ticks / clientCount, "bytes");
+    report.metric("bandwidth_per_client", bytesSent / ticks / clientCount * 30.0 * 8.0 / 1000.0, "kbit/s");
+    report.metric("bandwidth_total", bytesSent / ticks * 30.0 * 8.0 / 1000000.0, "Mbit/s");
+    report.metric("naive_bandwidth_total", naiveBytesPerTick * 30.0 * 8.0 / 1000000.0, "Mbit/s");
+    report.metric("loopback_bytes_received", static_cast<double>(bytesReceived), "bytes");
+    report.metric("loopback_packets_received", static_cast<double>(packetsReceived), "count");
+    report.metric("loopback_updates_decoded", static_cast<double>(updatesDecoded), "count");
+    report.metric("decode_mismatches", static_cast<double>(mismatches), "count");
+}
@@ -0,0 +1,267 @@
+#include "Benchmarks/Benchmark.h"
+#include "Animation/SkeletalAnimation.h"
+#include "Jobs/JobSystem.h"
+#include <cmath>
+
+/**
+ * @file SkeletalAnimationBenchmark.cpp
+ * @brief Animates and skins 1k characters headless, single-threaded and on four threads.
+ *
+ * Characters have 32 bones and a 192-vertex, 128-triangle mesh. Every character blends
+ * a walk and a run clip with its own weight, a tenth of them cross-fade to an attack
+ * every half second, and each drives a weapon Transform from its hand bone. Metrics are
+ * milliseconds per frame and the frame budget left at 60 FPS. A scalar reference (float
+ * keys, std::sin/cos, one vertex at a time) checks the skinned positions, which differ
+ * by the 16-bit key quantization, and gives the per-frame cost of the naive path.
+ */
+
+namespace {
+    const size_t CharacterCount = 1000;
+    const int Frames = 60;
+    const float FrameTime = 1.f / 60.f;
+    const float SampleRate = 30.f;
+    const float Pi = 3.14159265358979f;
+    const float BoneLength = 12.f;
+
+    /**
+     * @brief Builds a root, a six-bone spine, four five-bone limbs and a five-bone tail.
+     */
+    std::shared_ptr<Skeleton>
+    buildSkeleton() {
+        std::shared_ptr<Skeleton> skeleton = std::make_shared<Skeleton>();
+        const uint16_t root = skeleton->addBone("root", NoParentBone, BonePose{ 0.f, 0.f, -90.f, 1.f, 1.f });
+        uint16_t spine = root;
+        for (int bone = 0; bone < 6; ++bone) {
+            spine = skeleton->addBone("spine" + std::to_string(bone), spine, BonePose{ BoneLength, 0.f, 0.f, 1.f, 1.f });
+        }
+        const float limbAngles[4] = { 120.f, -120.f, 160.f, -160.f };
+        for (int limb = 0; limb < 4; ++limb) {
+            uint16_t parent = limb < 2 ? static_cast<uint16_t>(5) : root;
+            for (int bone = 0; bone < 5; ++bone) {
+                parent = skeleton->addBone("limb" + std::to_string(limb) + "_" + std::to_string(bone), parent,
+                                           BonePose{ bone == 0 ? 0.f : BoneLength, 0.f, bone == 0 ? limbAngles[limb] : 0.f, 1.f, 1.f });
+            }
+        }
+        uint16_t tail = root;
+        for (int bone = 0; bone < 5; ++bone) {
+            tail = skeleton->addBone("tail" + std::to_string(bone), tail, BonePose{ bone == 0 ? 0.f : BoneLength, 0.f, bone == 0 ? 180.f : 10.f, 1.f, 1.f });
+        }
+        return skeleton;
+    }
+
+    /**
+     * @brief Six vertices (a 2x3 grid) and four triangles along every bone.
+     */
+    std::shared_ptr<SkinnedMesh>
+    buildMesh(const Skeleton& skeleton) {
+        std::shared_ptr<SkinnedMesh> mesh = std::make_shared<SkinnedMesh>();
+        for (uint16_t bone = 0; bone < skeleton.getBoneCount(); ++bone) {
+            const uint16_t parent = skeleton.getParent(bone) == NoParentBone ? bone : skeleton.getParent(bone);
+            uint32_t first = 0;
+            for (int column = 0; column < 3; ++column) {
+                for (int side = 0; side < 2; ++side) {
+                    SkinnedVertex vertex;
+                    const sf::Vector2f local(BoneLength * 0.5f * column, side == 0 ? -4.f : 4.f);
+                    vertex.position = skeleton.getBindWorld(bone).apply(local);
+                    vertex.texCoords = sf::Vector2f(16.f * column, 8.f * side);
+                    vertex.bones[0] = bone;
+                    vertex.bones[1] = parent;
+                    vertex.weight = column == 0 ? 0.5f : 1.f;
+                    const uint32_t index = mesh->addVertex(vertex);
+                    if (column == 0 && side == 0) {
+                        first = index;
+                    }
+                }
+            }
+            for (uint32_t quad = 0; quad < 2; ++quad) {
+                const uint32_t base = first + quad * 2;
+                mesh->addTriangle(base, base + 1, base + 2);
+                mesh->addTriangle(base + 1, base + 3, base + 2);
+            }
+        }
+        return mesh;
+    }
+
+    /**
+     * @brief Samples a procedural swing of the bind pose, @p frames frames per bone.
+     */
+    std::vector<BonePose>
+    buildPoses(const Skeleton& skeleton, int frames, float amplitude, float phase) {
+        std::vector<BonePose> poses;
+        for (int frame = 0; frame < frames; ++frame) {
+            const float cycle = 2.f * Pi * static_cast<float>(frame) / static_cast<float>(frames);
+            for (uint16_t bone = 0; bone < skeleton.getBoneCount(); ++bone) {
+                BonePose pose = skeleton.getBindPose(bone);
+                pose.rotation += amplitude * std::sin(cycle + phase * bone);
+                pose.scaleX = 1.f + 0.05f * std::sin(cycle * 2.f + bone);
+                if (bone == 0) {
+                    pose.y += 3.f * std::sin(cycle * 2.f);
+                }
+                poses.push_back(pose);
+            }
+        }
+        return poses;
+    }
+
+    /**
+     * @brief Uncompressed clip for the scalar reference.
+     */
+    struct ReferenceClip {
+        std::vector<BonePose> poses; ///< Frames of the skeleton.
+        size_t bones;                ///< Bones per frame.
+        bool loop;                   ///< Looping clip.
+
+        BonePose
+        sample(size_t bone, float time) const {
+            const size_t frames = poses.size() / bones;
+            const float duration = static_cast<float>(loop ? frames : frames - 1) / SampleRate;
+            time = loop ? std::fmod(time, duration) : std::min(time, duration);
+            const float position = time * SampleRate;
+            const size_t frame = std::min(static_cast<size_t>(position), frames - 1);
+            const size_t next = loop ? (frame + 1) % frames : std::min(frame + 1, frames - 1);
+            return blend(poses[frame * bones + bone], poses[next * bones + bone], position - static_cast<float>(frame));
+        }
+
+        static BonePose
+        blend(const BonePose& from, const BonePose& to, float weight) {
+            float turn = to.rotation - from.rotation;
+            turn -= 360.f * std::floor(turn / 360.f + 0.5f);
+            return BonePose{ from.x + (to.x - from.x) * weight, from.y + (to.y - from.y) * weight,
+                             from.rotation + turn * weight, from.scaleX + (to.scaleX - from.scaleX) * weight,
+                             from.scaleY + (to.scaleY - from.scaleY) * weight };
+        }
+    };
+
+    /**
+     * @brief Poses and skins one character one bone and one vertex at a time.
+     * @param worlds Receives the world matrices, then the skin matrices.
+     */
+    void
+    referenceSkin(const Skeleton& skeleton, const SkinnedMesh& mesh, const ReferenceClip& base, const ReferenceClip& blended,
+                  float time, float weight, const BoneMatrix& root, std::vector<BoneMatrix>& worlds,
+                  std::vector<sf::Vector2f>& positions) {
+        const size_t bones = skeleton.getBoneCount();
+        for (uint16_t bone = 0; bone < bones; ++bone) {
+            const BonePose pose = ReferenceClip::blend(base.sample(bone, time), blended.sample(bone, time), weight);
+            const uint16_t parent = skeleton.getParent(bone);
+            worlds[bone] = (parent == NoParentBone ? root : worlds[parent]) * BoneMatrix::fromPose(pose);
+            worlds[bones + bone] = worlds[bone] * skeleton.getBindWorld(bone).inverse();
+        }
+        for (uint32_t vertex = 0; vertex < mesh.getVertexCount(); ++vertex) {
+            const SkinnedVertex& source = mesh.getVertex(vertex);
+            const sf::Vector2f first = worlds[bones + source.bones[0]].apply(source.position);
+            const sf::Vector2f second = worlds[bones + source.bones[1]].apply(source.position);
+            positions[vertex] = second + (first - second) * source.weight;
+        }
+    }
+
+    BoneMatrix
+    rootOf(size_t character) {
+        return BoneMatrix::fromPose(BonePose{ static_cast<float>(character % 40) * 48.f, static_cast<float>(character / 40) * 64.f,
+                                              0.f, 1.f, 1.f });
+    }
+
+    float
+    runWeightOf(size_t character) {
+        return static_cast<float>(character % 11) / 10.f;
+    }
+}
+
+RIOLU_BENCHMARK(SkeletalAnimation) {
+    const std::shared_ptr<Skeleton> skeleton = buildSkeleton();
+    const std::shared_ptr<SkinnedMesh> mesh = buildMesh(*skeleton);
+    const ReferenceClip walkSource{ buildPoses(*skeleton, 30, 20.f, 0.4f), skeleton->getBoneCount(), true };
+    const ReferenceClip runSource{ buildPoses(*skeleton, 18, 35.f, 0.7f), skeleton->getBoneCount(), true };
+    const std::vector<BonePose> attackPoses = buildPoses(*skeleton, 24, 60.f, 0.2f);
+
+    const std::shared_ptr<const SkeletalClip> walkClip = SkeletalClip::compress(*skeleton, SampleRate, walkSource.poses, true);
+    report.metric("bones", static_cast<double>(skeleton->getBoneCount()), "count");
+    report.metric("mesh_vertices", static_cast<double>(mesh->getVertexCount()), "count");
+    report.metric("walk_clip_bytes", static_cast<double>(walkClip->getByteSize()), "bytes");
+    report.metric("walk_clip_float_bytes", static_cast<double>(walkSource.poses.size() * sizeof(BonePose)), "bytes");
+
+    std::vector<EngineUtilities::TSharedPointer<Transform>> roots;
+    std::vector<EngineUtilities::TSharedPointer<Transform>> weapons;
+    SkeletalAnimationSystem system(skeleton, mesh);
+    const SkeletalClipId walk = system.addClip(walkClip);
+    const SkeletalClipId run = system.addClip(SkeletalClip::compress(*skeleton, SampleRate, runSource.poses, true));
+    const SkeletalClipId attack = system.addClip(SkeletalClip::compress(*skeleton, SampleRate, attackPoses, false));
+    const uint16_t hand = skeleton->findBone("limb0_4");
+    for (size_t character = 0; character < CharacterCount; ++character) {
+        roots.push_back(EngineUtilities::MakeShared<Transform>());
+        const BoneMatrix root = rootOf(character);
+        roots.back()->setPosition(sf::Vector2f(root.tx, root.ty));
+        weapons.push_back(EngineUtilities::MakeShared<Transform>());
+        system.addCharacter(roots.back());
+        system.play(character, walk);
+        system.setBlend(character, run, runWeightOf(character));
+        system.attach(character, hand, weapons.back());
+    }
+
+    // Every 30 frames a tenth of the characters cross-fade to the attack and back.
+    auto direct = [&](int frame) {
+        if (frame % 30 != 0) {
+            return;
+        }
+        for (size_t character = (frame / 30) % 10; character < CharacterCount; character += 10) {
+            system.play(character, (frame / 30) % 2 == 0 ? attack : walk, 0.2f);
+        }
+    };
+
+    {
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            direct(frame);
+            system.update(FrameTime);
+        }
+        const double frameTime = timer.elapsedMilliseconds() / Frames;
+        report.metric("frame_1_thread", frameTime, "ms");
+        report.metric("budget_used_1_thread", 100.0 * frameTime / (1000.0 / 60.0), "%");
+    }
+    {
+        JobSystem jobs(3);
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            direct(frame);
+            system.update(FrameTime, jobs);
+        }
+        const double frameTime = timer.elapsedMilliseconds() / Frames;
+        report.metric("frame_4_threads", frameTime, "ms");
+        report.metric("budget_used_4_threads", 100.0 * frameTime / (1000.0 / 60.0), "%");
+    }
+    benchmarkKeep(weapons.back()->getPosition().x);
+
+    // Accuracy: fresh characters playing walk blended with run, compared with the reference.
+    SkeletalAnimationSystem checked(skeleton, mesh);
+    checked.addClip(walkClip);
+    checked.addClip(SkeletalClip::compress(*skeleton, SampleRate, runSource.poses, true));
+    for (size_t character = 0; character < CharacterCount; ++character) {
+        checked.addCharacter(roots[character]);
+        checked.play(character, 0);
+        checked.setBlend(character, 1, runWeightOf(character));
+    }
+    std::vector<BoneMatrix> worlds(skeleton->getBoneCount() * 2);
+    std::vector<sf::Vector2f> positions(mesh->getVertexCount());
+    const std::vector<uint32_t>& indices = mesh->getIndices();
+    float time = 0.f;
+    double maxError = 0.0;
+    double referenceSeconds = 0.0;
+    for (int step = 0; step < 10; ++step) {
+        checked.update(0.037f);
+        time += 0.037f;
+        for (size_t character = 0; character < CharacterCount; ++character) {
+            const sf::Vector2f place = roots[character]->getPosition();
+            BenchmarkTimer timer;
+            referenceSkin(*skeleton, *mesh, walkSource, runSource, time, runWeightOf(character),
+                          BoneMatrix::fromPose(BonePose{ place.x, place.y, 0.f, 1.f, 1.f }), worlds, positions);
+            referenceSeconds += timer.elapsedMilliseconds() / 1000.0;
+            const sf::Vertex* vertices = &checked.getVertices()[character * checked.getVerticesPerCharacter()];
+            for (size_t corner = 0; corner < indices.size(); ++corner) {
+                const sf::Vector2f difference = vertices[corner].position - positions[indices[corner]];
+                maxError = std::max<double>(maxError, std::max(std::abs(difference.x), std::abs(difference.y)));
+            }
+        }
+    }
+    report.metric("scalar_reference_frame", referenceSeconds * 1000.0 / 10.0, "ms");
+    report.metric("max_vertex_error", maxError, "px");
+}
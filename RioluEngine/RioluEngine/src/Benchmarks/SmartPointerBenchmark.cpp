@@ -0,0 +1,245 @@
+#include "Benchmarks/Benchmark.h"
+#include "Memory/TWeakPointer.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * @file SmartPointerBenchmark.cpp
+ * @brief Compares the EngineUtilities smart pointers with their std counterparts.
+ *
+ * Every metric is the average cost of one operation in nanoseconds. Engine and std
+ * variants of the same operation share a metric prefix and end in _engine / _std.
+ */
+
+namespace {
+    /**
+     * @brief Polymorphic payload, so dynamic casts have real work to do.
+     */
+    struct PointerBase {
+        virtual ~PointerBase() = default;
+        int value = 0;
+    };
+
+    struct PointerDerived : PointerBase {
+        int extra = 1;
+    };
+
+    const int SingleThreadIterations = 1000000;
+    const int AllocatingIterations = 200000;
+    const int ThreadIterations = 500000;
+
+    /**
+     * @brief Times @p iterations calls of @p operation and reports ns per call.
+     */
+    template<typename Operation>
+    void
+    measure(BenchmarkReport& report, const std::string& metric, int iterations, Operation operation) {
+        // Warm up caches and the allocator before timing.
+        for (int i = 0; i < iterations / 10; ++i) {
+            operation();
+        }
+        BenchmarkTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            operation();
+            benchmarkClobber();
+        }
+        report.metric(metric, timer.elapsedNanoseconds() / iterations, "ns");
+    }
+
+    /**
+     * @brief Runs @p operation on @p threadCount threads at once and reports ns per call.
+     *
+     * @p makeWorker is called once on each thread and returns the operation that thread
+     * repeats, so per-thread objects are allocated by the thread that uses them.
+     */
+    template<typename MakeWorker>
+    void
+    measureThreads(BenchmarkReport& report, const std::string& metric, unsigned threadCount, MakeWorker makeWorker) {
+        std::atomic<unsigned> ready{ 0 };
+        std::atomic<bool> go{ false };
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&ready, &go, &makeWorker]() {
+                auto worker = makeWorker();
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (int i = 0; i < ThreadIterations; ++i) {
+                    worker();
+                    benchmarkClobber();
+                }
+            });
+        }
+        while (ready.load() != threadCount) {
+            std::this_thread::yield();
+        }
+
+        BenchmarkTimer timer;
+        go.store(true, std::memory_order_release);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        // Wall time per operation of a single thread: grows with contention.
+        report.metric(metric, timer.elapsedNanoseconds() / ThreadIterations, "ns");
+    }
+}
+
+RIOLU_BENCHMARK(SmartPointers) {
+    using namespace EngineUtilities;
+
+    // Construction + destruction. The std::shared_ptr(new T) variant has the same two
+    // allocations as TSharedPointer; make_shared merges them into one.
+    measure(report, "shared_make_engine", AllocatingIterations, [] {
+        TSharedPointer<PointerDerived> pointer = MakeShared<PointerDerived>();
+        benchmarkKeep(*pointer);
+    });
+    measure(report, "shared_make_std", AllocatingIterations, [] {
+        std::shared_ptr<PointerDerived> pointer = std::make_shared<PointerDerived>();
+        benchmarkKeep(*pointer);
+    });
+    measure(report, "shared_new_std", AllocatingIterations, [] {
+        std::shared_ptr<PointerDerived> pointer(new PointerDerived());
+        benchmarkKeep(*pointer);
+    });
+    measure(report, "unique_make_engine", AllocatingIterations, [] {
+        TUniquePtr<PointerDerived> pointer = MakeUnique<PointerDerived>();
+        benchmarkKeep(*pointer);
+    });
+    measure(report, "unique_make_std", AllocatingIterations, [] {
+        std::unique_ptr<PointerDerived> pointer = std::make_unique<PointerDerived>();
+        benchmarkKeep(*pointer);
+    });
+
+    TSharedPointer<PointerDerived> engineShared = MakeShared<PointerDerived>();
+    std::shared_ptr<PointerDerived> stdShared = std::make_shared<PointerDerived>();
+
+    // Copy + destruction: one reference count increment and decrement.
+    measure(report, "shared_copy_engine", SingleThreadIterations, [&engineShared] {
+        TSharedPointer<PointerDerived> copy(engineShared);
+        benchmarkKeep(copy);
+    });
+    measure(report, "shared_copy_std", SingleThreadIterations, [&stdShared] {
+        std::shared_ptr<PointerDerived> copy(stdShared);
+        benchmarkKeep(copy);
+    });
+    measure(report, "shared_upcast_engine", SingleThreadIterations, [&engineShared] {
+        TSharedPointer<PointerBase> base(engineShared);
+        benchmarkKeep(base);
+    });
+    measure(report, "shared_upcast_std", SingleThreadIterations, [&stdShared] {
+        std::shared_ptr<PointerBase> base(stdShared);
+        benchmarkKeep(base);
+    });
+
+    // Move there and back: no reference count traffic.
+    measure(report, "shared_move_engine", SingleThreadIterations, [&engineShared] {
+        TSharedPointer<PointerDerived> moved(std::move(engineShared));
+        engineShared = std::move(moved);
+    });
+    measure(report, "shared_move_std", SingleThreadIterations, [&stdShared] {
+        std::shared_ptr<PointerDerived> moved(std::move(stdShared));
+        stdShared = std::move(moved);
+    });
+
+    TUniquePtr<PointerDerived> engineUnique = MakeUnique<PointerDerived>();
+    std::unique_ptr<PointerDerived> stdUnique = std::make_unique<PointerDerived>();
+    measure(report, "unique_move_engine", SingleThreadIterations, [&engineUnique] {
+        TUniquePtr<PointerDerived> moved(std::move(engineUnique));
+        engineUnique = std::move(moved);
+    });
+    measure(report, "unique_move_std", SingleThreadIterations, [&stdUnique] {
+        std::unique_ptr<PointerDerived> moved(std::move(stdUnique));
+        stdUnique = std::move(moved);
+    });
+
+    // Reset to a new object: frees the old one and allocates.
+    measure(report, "shared_reset_engine", AllocatingIterations, [&engineShared] {
+        engineShared.reset(new PointerDerived());
+    });
+    measure(report, "shared_reset_std", AllocatingIterations, [&stdShared] {
+        stdShared.reset(new PointerDerived());
+    });
+    measure(report, "unique_reset_engine", AllocatingIterations, [&engineUnique] {
+        engineUnique.reset(new PointerDerived());
+    });
+    measure(report, "unique_reset_std", AllocatingIterations, [&stdUnique] {
+        stdUnique.reset(new PointerDerived());
+    });
+
+    // Dynamic cast from the base type, as Entity::getComponent does.
+    TSharedPointer<PointerBase> engineBase(engineShared);
+    std::shared_ptr<PointerBase> stdBase(stdShared);
+    measure(report, "shared_dynamic_cast_engine", SingleThreadIterations, [&engineBase] {
+        TSharedPointer<PointerDerived> derived = engineBase.dynamic_pointer_cast<PointerDerived>();
+        benchmarkKeep(derived);
+    });
+    measure(report, "shared_dynamic_cast_std", SingleThreadIterations, [&stdBase] {
+        std::shared_ptr<PointerDerived> derived = std::dynamic_pointer_cast<PointerDerived>(stdBase);
+        benchmarkKeep(derived);
+    });
+
+    // Lock of a weak pointer to a live object.
+    TWeakPointer<PointerDerived> engineWeak(engineShared);
+    std::weak_ptr<PointerDerived> stdWeak(stdShared);
+    measure(report, "weak_lock_engine", SingleThreadIterations, [&engineWeak] {
+        TSharedPointer<PointerDerived> locked = engineWeak.lock();
+        benchmarkKeep(locked);
+    });
+    measure(report, "weak_lock_std", SingleThreadIterations, [&stdWeak] {
+        std::shared_ptr<PointerDerived> locked = stdWeak.lock();
+        benchmarkKeep(locked);
+    });
+
+    // TStaticPtr has no std equivalent: compare with a function-local static.
+    TStaticPtr<PointerDerived>::reset(new PointerDerived());
+    measure(report, "static_get_engine", SingleThreadIterations, [] {
+        PointerDerived* instance = TStaticPtr<PointerDerived>::get();
+        benchmarkKeep(instance);
+    });
+    measure(report, "static_get_std", SingleThreadIterations, [] {
+        static PointerDerived instance;
+        PointerDerived* pointer = &instance;
+        benchmarkKeep(pointer);
+    });
+    TStaticPtr<PointerDerived>::reset();
+
+    // Multithreaded. Each thread copying its own pointer measures scaling without
+    // sharing. TSharedPointer's reference count is a plain int, so copying one
+    // pointer from several threads is a data race: the contended case only runs
+    // for std::shared_ptr, as the price an atomic count would pay.
+    const unsigned threadCount = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    report.metric("threads", threadCount, "count");
+    report.metric("hardware_threads", std::thread::hardware_concurrency(), "count");
+
+    measureThreads(report, "mt_shared_copy_private_engine", threadCount, [] {
+        return [pointer = MakeShared<PointerDerived>()] {
+            TSharedPointer<PointerDerived> copy(pointer);
+            benchmarkKeep(copy);
+        };
+    });
+    measureThreads(report, "mt_shared_copy_private_std", threadCount, [] {
+        return [pointer = std::make_shared<PointerDerived>()] {
+            std::shared_ptr<PointerDerived> copy(pointer);
+            benchmarkKeep(copy);
+        };
+    });
+    measureThreads(report, "mt_shared_copy_contended_std", threadCount, [&stdShared] {
+        return [&stdShared] {
+            std::shared_ptr<PointerDerived> copy(stdShared);
+            benchmarkKeep(copy);
+        };
+    });
+    measureThreads(report, "mt_shared_make_engine", threadCount, [] {
+        return [] {
+            TSharedPointer<PointerDerived> pointer = MakeShared<PointerDerived>();
+            benchmarkKeep(*pointer);
+        };
+    });
+    measureThreads(report, "mt_shared_make_std", threadCount, [] {
+        return [] {
+            std::shared_ptr<PointerDerived> pointer = std::make_shared<PointerDerived>();
+            benchmarkKeep(*pointer);
+        };
+    });
+}
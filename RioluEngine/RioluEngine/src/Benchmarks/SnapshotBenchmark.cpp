@@ -0,0 +1,106 @@
+#include "Benchmarks/Benchmark.h"
+#include "ECS/Actor.h"
+#include "ECS/WorldSnapshot.h"
+#include <random>
+
+/**
+ * @file SnapshotBenchmark.cpp
+ * @brief Measures save + restore of a 10k-actor world in full and dirty-page modes.
+ *
+ * Every iteration moves some actors and saves a frame, then rolls back to the frame
+ * saved RollbackDepth iterations earlier and checks the positions it brings back.
+ */
+
+namespace {
+    const int RollbackDepth = 4; ///< Frames a rollback goes back, like a late remote input.
+
+    void
+    capturePositions(const std::vector<EngineUtilities::TSharedPointer<Transform>>& transforms,
+                     std::vector<sf::Vector2f>& positions) {
+        positions.resize(transforms.size());
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            positions[i] = transforms[i]->getPosition();
+        }
+    }
+
+    void
+    runSnapshotMode(BenchmarkReport& report, const std::string& prefix, SnapshotMode mode,
+                    std::vector<EngineUtilities::TSharedPointer<Transform>>& transforms, float movingFraction) {
+        const int iterations = 2000;
+        std::mt19937 random(79);
+        std::uniform_int_distribution<size_t> pick(0, transforms.size() - 1);
+        const size_t moving = static_cast<size_t>(transforms.size() * movingFraction);
+
+        WorldSnapshotRing ring(8, mode);
+        ring.save();
+
+        // Positions of the last RollbackDepth + 1 saved frames, to check what restore() brings back.
+        std::vector<std::vector<sf::Vector2f>> history(RollbackDepth + 1);
+        std::vector<uint32_t> frames(iterations);
+
+        double saveMicros = 0.0;
+        double restoreMicros = 0.0;
+        double worstMicros = 0.0;
+        size_t bytes = 0;
+        size_t restoreBytes = 0;
+        size_t mismatches = 0;
+        int rollbacks = 0;
+        std::vector<sf::Vector2f> restored;
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t m = 0; m < moving; ++m) {
+                Transform& transform = *transforms[pick(random)];
+                transform.setPosition(transform.getPosition() + sf::Vector2f(1.f, 0.5f));
+            }
+            capturePositions(transforms, history[i % history.size()]);
+
+            BenchmarkTimer timer;
+            frames[i] = ring.save();
+            const double save = timer.elapsedMicroseconds();
+            saveMicros += save;
+            bytes += ring.getStats().lastSaveBytes;
+            if (i < RollbackDepth) {
+                continue;
+            }
+
+            // A rollback: go back to the frame saved RollbackDepth iterations ago; every
+            // page written since then has to be copied back.
+            timer.restart();
+            const bool ok = ring.restore(frames[i - RollbackDepth]);
+            const double restore = timer.elapsedMicroseconds();
+            restoreMicros += restore;
+            worstMicros = std::max(worstMicros, save + restore);
+            bytes += ring.getStats().lastRestoreBytes;
+            restoreBytes += ring.getStats().lastRestoreBytes;
+            ++rollbacks;
+
+            capturePositions(transforms, restored);
+            mismatches += !ok || restored != history[(i - RollbackDepth) % history.size()] ? 1 : 0;
+        }
+
+        report.metric(prefix + "_save_avg", saveMicros / iterations, "us");
+        report.metric(prefix + "_restore_avg", restoreMicros / rollbacks, "us");
+        report.metric(prefix + "_save_restore_avg", saveMicros / iterations + restoreMicros / rollbacks, "us");
+        report.metric(prefix + "_save_restore_worst", worstMicros, "us");
+        report.metric(prefix + "_bytes_per_iteration", static_cast<double>(bytes) / iterations, "bytes");
+        report.metric(prefix + "_restore_bytes", static_cast<double>(restoreBytes) / rollbacks, "bytes");
+        report.metric(prefix + "_reallocations", static_cast<double>(ring.getStats().reallocations), "count");
+        report.metric(prefix + "_mismatches", static_cast<double>(mismatches), "count");
+    }
+}
+
+RIOLU_BENCHMARK(WorldSnapshot) {
+    const int actorCount = 10000;
+    std::vector<EngineUtilities::TSharedPointer<Actor>> actors;
+    std::vector<EngineUtilities::TSharedPointer<Transform>> transforms;
+    for (int i = 0; i < actorCount; ++i) {
+        actors.push_back(EngineUtilities::MakeShared<Actor>("Snapshot Actor"));
+        transforms.push_back(actors.back()->getComponent<Transform>());
+        transforms.back()->setPosition(sf::Vector2f(static_cast<float>(i % 100), static_cast<float>(i / 100)));
+    }
+
+    report.metric("actors", actorCount, "count");
+    report.metric("transform_bytes", static_cast<double>(Transform::storage().getByteSize()), "bytes");
+    runSnapshotMode(report, "full", SnapshotMode::Full, transforms, 0.1f);
+    runSnapshotMode(report, "dirty_10pct", SnapshotMode::DirtyPages, transforms, 0.1f);
+    runSnapshotMode(report, "dirty_1pct", SnapshotMode::DirtyPages, transforms, 0.01f);
+}
@@ -0,0 +1,196 @@
+#include "Benchmarks/Benchmark.h"
+#include "Animation/SpriteAnimation.h"
+#include <functional>
+
+/**
+ * @file SpriteAnimationBenchmark.cpp
+ * @brief Advances 100k sprite animators through shared clips and through per-sprite clip copies.
+ *
+ * Twelve clips of 4 to 12 frames (some with footstep or hit events, some not looping)
+ * are played at varied speeds by 100k animators of a SpriteAnimatorStorage, each
+ * bound to a shape whose texture rect the pass keeps up to date. The baseline gives
+ * every sprite its own copy of the frames and a std::function called for each event,
+ * the usual shape of a hand-written animated sprite. Metrics are nanoseconds per
+ * sprite per frame, bytes per sprite and the events seen by both paths.
+ */
+
+namespace {
+    const size_t SpriteCount = 100000;
+    const size_t ClipCount = 12;
+    const int Frames = 120;
+    const float FrameTime = 1.f / 60.f;
+    const uint32_t Footstep = 1;
+    const uint32_t Hit = 2;
+
+    /**
+     * @brief Builds clip @p index of the test sheet.
+     */
+    SpriteClipDesc
+    makeClip(size_t index) {
+        SpriteClipDesc desc;
+        desc.name = "clip" + std::to_string(index);
+        const int frameCount = 4 + static_cast<int>(index % 9);
+        for (int frame = 0; frame < frameCount; ++frame) {
+            desc.frames.push_back(SpriteFrame{ sf::IntRect(frame * 32, static_cast<int>(index) * 32, 32, 32),
+                                               0.06f + 0.01f * static_cast<float>(frame % 3) });
+        }
+        if (index % 3 == 0) {
+            desc.events.push_back(SpriteClipEvent{ 0.f, Footstep });
+            desc.events.push_back(SpriteClipEvent{ 0.2f, Footstep });
+        }
+        else if (index % 3 == 1) {
+            desc.events.push_back(SpriteClipEvent{ 0.15f, Hit });
+        }
+        desc.loop = index % 4 != 3;
+        return desc;
+    }
+
+    /**
+     * @brief Hand-written animated sprite owning its clip.
+     */
+    class ObjectAnimator {
+    public:
+        ObjectAnimator(const SpriteClipDesc& clip, float speed, sf::Shape* target, std::function<void(uint32_t)> onEvent)
+            : m_frames(clip.frames), m_events(clip.events), m_loop(clip.loop), m_speed(speed), m_target(target),
+              m_onEvent(std::move(onEvent)) {
+            for (const SpriteFrame& frame : m_frames) {
+                m_length += frame.duration;
+            }
+        }
+
+        void
+        update(float deltaTime) {
+            if (m_done) {
+                return;
+            }
+            const float previous = m_time;
+            m_time += deltaTime * m_speed;
+            fire(previous, m_time);
+            while (m_time >= m_length) {
+                if (!m_loop) {
+                    m_time = m_length;
+                    m_done = true;
+                    m_onEvent(SpriteAnimationEvent::Finished);
+                    break;
+                }
+                m_time -= m_length;
+                fire(0.f, m_time);
+            }
+            float end = 0.f;
+            size_t current = 0;
+            for (size_t frame = 0; frame < m_frames.size(); ++frame) {
+                end += m_frames[frame].duration;
+                current = frame;
+                if (m_time < end) {
+                    break;
+                }
+            }
+            if (current != m_frame || !m_shown) {
+                m_frame = current;
+                m_shown = true;
+                m_target->setTextureRect(m_frames[m_frame].rect);
+            }
+        }
+
+        size_t
+        getBytes() const {
+            return sizeof(*this) + m_frames.capacity() * sizeof(SpriteFrame) +
+                   m_events.capacity() * sizeof(SpriteClipEvent);
+        }
+
+    private:
+        void
+        fire(float from, float to) {
+            for (const SpriteClipEvent& event : m_events) {
+                if (event.time >= from && event.time < to) {
+                    m_onEvent(event.event);
+                }
+            }
+        }
+
+        std::vector<SpriteFrame> m_frames;
+        std::vector<SpriteClipEvent> m_events;
+        bool m_loop;
+        bool m_done = false;
+        float m_speed;
+        float m_time = 0.f;
+        float m_length = 0.f;
+        size_t m_frame = 0;
+        bool m_shown = false;
+        sf::Shape* m_target;
+        std::function<void(uint32_t)> m_onEvent;
+    };
+
+    float
+    speedOf(size_t sprite) {
+        return 0.75f + 0.05f * static_cast<float>(sprite % 11);
+    }
+}
+
+RIOLU_BENCHMARK(SpriteAnimation) {
+    SpriteClipLibrary library;
+    std::vector<SpriteClipDesc> descs;
+    for (size_t clip = 0; clip < ClipCount; ++clip) {
+        descs.push_back(makeClip(clip));
+        library.addClip(descs.back());
+    }
+
+    size_t sharedEvents = 0;
+    {
+        SpriteAnimatorStorage animators;
+        animators.reserve(SpriteCount);
+        std::vector<sf::RectangleShape> shapes(SpriteCount, sf::RectangleShape(sf::Vector2f(32.f, 32.f)));
+        std::vector<SpriteAnimatorId> ids;
+        ids.reserve(SpriteCount);
+        for (size_t sprite = 0; sprite < SpriteCount; ++sprite) {
+            ids.push_back(animators.create(&shapes[sprite]));
+            animators.play(ids.back(), static_cast<SpriteClipId>(sprite % ClipCount), speedOf(sprite));
+        }
+
+        std::vector<SpriteAnimationEvent> events;
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            animators.advanceAll(library, FrameTime, events);
+            sharedEvents += events.size();
+        }
+        report.metric("shared_update", timer.elapsedNanoseconds() / (double(Frames) * SpriteCount), "ns");
+
+        size_t wrongRects = 0;
+        for (size_t sprite = 0; sprite < SpriteCount; ++sprite) {
+            wrongRects += shapes[sprite].getTextureRect() != animators.getTextureRect(library, ids[sprite]) ? 1 : 0;
+        }
+
+        // Whole per-sprite cost: every array of the storage plus the id the game keeps.
+        // The shape is the drawn sprite itself, with or without animation.
+        const size_t bytes = animators.getAllocatedBytes() + ids.capacity() * sizeof(SpriteAnimatorId);
+        report.metric("shared_state_bytes", static_cast<double>(sizeof(SpriteAnimationData)), "bytes");
+        report.metric("shared_bytes_per_sprite", static_cast<double>(bytes) / SpriteCount, "bytes");
+        report.metric("shared_slots", static_cast<double>(animators.getSlotCount()), "count");
+        report.metric("shared_wrong_rects", static_cast<double>(wrongRects), "count");
+        report.metric("clip_library_bytes", static_cast<double>(library.getByteSize()), "bytes");
+    }
+    report.metric("shared_events", static_cast<double>(sharedEvents), "count");
+
+    size_t objectEvents = 0;
+    {
+        std::vector<ObjectAnimator> animators;
+        animators.reserve(SpriteCount);
+        std::vector<sf::RectangleShape> shapes(SpriteCount, sf::RectangleShape(sf::Vector2f(32.f, 32.f)));
+        size_t bytes = 0;
+        for (size_t sprite = 0; sprite < SpriteCount; ++sprite) {
+            animators.emplace_back(descs[sprite % ClipCount], speedOf(sprite), &shapes[sprite],
+                                   [&objectEvents](uint32_t) { ++objectEvents; });
+            bytes += animators.back().getBytes();
+        }
+
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            for (ObjectAnimator& animator : animators) {
+                animator.update(FrameTime);
+            }
+        }
+        report.metric("object_update", timer.elapsedNanoseconds() / (double(Frames) * SpriteCount), "ns");
+        report.metric("object_bytes_per_sprite", static_cast<double>(bytes) / SpriteCount, "bytes");
+    }
+    report.metric("object_events", static_cast<double>(objectEvents), "count");
+}
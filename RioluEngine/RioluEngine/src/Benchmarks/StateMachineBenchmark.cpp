@@ -0,0 +1,327 @@
+#include "Benchmarks/Benchmark.h"
+#include "AI/StateMachine.h"
+#include <cmath>
+#include <memory>
+
+/**
+ * @file StateMachineBenchmark.cpp
+ * @brief Measures the table-driven state machine against virtual state objects.
+ *
+ * 100k guards idle, patrol between waypoints and chase the player when close. The
+ * same logic runs with StateMachine (agents grouped by state, batch updates, deferred
+ * transitions) and with one heap-allocated virtual state object per guard that is
+ * replaced on every transition. The objects are allocated back to back, the best
+ * case for that version; in a running game they would be spread over the heap. A
+ * second pair of runs makes every agent switch state on every tick to isolate the
+ * transition cost.
+ */
+
+namespace {
+    const uint32_t AgentCount = 100000;
+    const int Ticks = 60;
+    const float TickTime = 1.f / 30.f;
+
+    /**
+     * @struct Guards
+     * @brief Guard data, indexed by guard (the state machine's user id).
+     */
+    struct Guards {
+        std::vector<float> x, y, targetX, targetY;
+
+        void
+        spawn() {
+            x.resize(AgentCount);
+            y.resize(AgentCount);
+            targetX.resize(AgentCount);
+            targetY.resize(AgentCount);
+            for (uint32_t i = 0; i < AgentCount; ++i) {
+                x[i] = targetX[i] = static_cast<float>(i % 316) * 6.f;
+                y[i] = targetY[i] = static_cast<float>(i / 316) * 6.f;
+            }
+        }
+    };
+
+    Guards g_guards;          ///< Data the state functions work on.
+    float g_playerX = 0.f;    ///< Player position, only written between ticks.
+    float g_playerY = 0.f;
+    FSMId g_bored, g_arrived, g_spotted, g_lost, g_flip; ///< Event ids.
+
+    const float SightRange = 60.f;
+
+    /**
+     * @brief Moves guard @p i towards (x, y); true once there.
+     */
+    bool
+    moveTowards(uint32_t i, float x, float y, float speed, float deltaTime) {
+        const float dx = x - g_guards.x[i];
+        const float dy = y - g_guards.y[i];
+        const float distance = std::sqrt(dx * dx + dy * dy);
+        const float step = speed * deltaTime;
+        if (distance <= step) {
+            g_guards.x[i] = x;
+            g_guards.y[i] = y;
+            return true;
+        }
+        g_guards.x[i] += dx / distance * step;
+        g_guards.y[i] += dy / distance * step;
+        return false;
+    }
+
+    bool
+    seesPlayer(uint32_t i, float range) {
+        const float dx = g_playerX - g_guards.x[i];
+        const float dy = g_playerY - g_guards.y[i];
+        return dx * dx + dy * dy < range * range;
+    }
+
+    void
+    pickWaypoint(uint32_t i) {
+        const uint32_t hash = i * 2654435761u ^ static_cast<uint32_t>(g_guards.x[i] * 13.f);
+        g_guards.targetX[i] = g_guards.x[i] + static_cast<float>(hash % 64) - 32.f;
+        g_guards.targetY[i] = g_guards.y[i] + static_cast<float>((hash >> 8) % 64) - 32.f;
+    }
+
+    // --- Table-driven states -------------------------------------------------------
+
+    void
+    updateIdle(const FSMUpdate& update) {
+        for (size_t k = 0; k < update.count; ++k) {
+            const uint32_t agent = update.agents[k];
+            const uint32_t i = update.userIds[k];
+            if (seesPlayer(i, SightRange)) {
+                update.machine.raise(agent, g_spotted);
+            }
+            else if (update.getTimeInState(k) >= 1.f) {
+                update.machine.raise(agent, g_bored);
+            }
+        }
+    }
+
+    void
+    enterPatrol(StateMachine& machine, uint32_t agent) {
+        pickWaypoint(machine.getUserId(agent));
+    }
+
+    void
+    updatePatrol(const FSMUpdate& update) {
+        for (size_t k = 0; k < update.count; ++k) {
+            const uint32_t agent = update.agents[k];
+            const uint32_t i = update.userIds[k];
+            if (seesPlayer(i, SightRange)) {
+                update.machine.raise(agent, g_spotted);
+            }
+            else if (moveTowards(i, g_guards.targetX[i], g_guards.targetY[i], 40.f, update.deltaTime)) {
+                update.machine.raise(agent, g_arrived);
+            }
+        }
+    }
+
+    void
+    updateChase(const FSMUpdate& update) {
+        for (size_t k = 0; k < update.count; ++k) {
+            const uint32_t agent = update.agents[k];
+            const uint32_t i = update.userIds[k];
+            if (!seesPlayer(i, SightRange * 1.5f)) {
+                update.machine.raise(agent, g_lost);
+            }
+            else {
+                moveTowards(i, g_playerX, g_playerY, 90.f, update.deltaTime);
+            }
+        }
+    }
+
+    void
+    updateFlip(const FSMUpdate& update) {
+        for (size_t k = 0; k < update.count; ++k) {
+            update.machine.raise(update.agents[k], g_flip);
+        }
+    }
+
+    std::shared_ptr<const StateMachineDefinition>
+    buildGuardMachine(FSMId& idle) {
+        std::shared_ptr<StateMachineDefinition> definition = std::make_shared<StateMachineDefinition>();
+        idle = definition->addState("idle", &updateIdle);
+        const FSMId patrol = definition->addState("patrol", &updatePatrol, &enterPatrol);
+        const FSMId chase = definition->addState("chase", &updateChase);
+        g_bored = definition->addEvent("bored");
+        g_arrived = definition->addEvent("arrived");
+        g_spotted = definition->addEvent("spotted");
+        g_lost = definition->addEvent("lost");
+        definition->addTransition(idle, g_bored, patrol);
+        definition->addTransition(idle, g_spotted, chase);
+        definition->addTransition(patrol, g_arrived, idle);
+        definition->addTransition(patrol, g_spotted, chase);
+        definition->addTransition(chase, g_lost, idle);
+        return definition;
+    }
+
+    std::shared_ptr<const StateMachineDefinition>
+    buildFlipMachine() {
+        std::shared_ptr<StateMachineDefinition> definition = std::make_shared<StateMachineDefinition>();
+        const FSMId a = definition->addState("a", &updateFlip);
+        const FSMId b = definition->addState("b", &updateFlip);
+        g_flip = definition->addEvent("flip");
+        definition->addTransition(a, g_flip, b);
+        definition->addTransition(b, g_flip, a);
+        return definition;
+    }
+
+    // --- Virtual state objects -----------------------------------------------------
+
+    /**
+     * @brief State object owned by one guard; update() returns the next state or null.
+     */
+    class GuardState {
+    public:
+        virtual ~GuardState() = default;
+        virtual std::unique_ptr<GuardState> update(uint32_t i, float deltaTime) = 0;
+    };
+
+    class IdleObject;
+
+    class ChaseObject : public GuardState {
+    public:
+        std::unique_ptr<GuardState> update(uint32_t i, float deltaTime) override;
+    };
+
+    class PatrolObject : public GuardState {
+    public:
+        explicit PatrolObject(uint32_t i) { pickWaypoint(i); }
+
+        std::unique_ptr<GuardState>
+        update(uint32_t i, float deltaTime) override;
+    };
+
+    class IdleObject : public GuardState {
+    public:
+        std::unique_ptr<GuardState>
+        update(uint32_t i, float deltaTime) override {
+            if (seesPlayer(i, SightRange)) {
+                return std::make_unique<ChaseObject>();
+            }
+            if (m_time >= 1.f) {
+                return std::make_unique<PatrolObject>(i);
+            }
+            m_time += deltaTime;
+            return nullptr;
+        }
+
+    private:
+        float m_time = 0.f;
+    };
+
+    std::unique_ptr<GuardState>
+    PatrolObject::update(uint32_t i, float deltaTime) {
+        if (seesPlayer(i, SightRange)) {
+            return std::make_unique<ChaseObject>();
+        }
+        if (moveTowards(i, g_guards.targetX[i], g_guards.targetY[i], 40.f, deltaTime)) {
+            return std::make_unique<IdleObject>();
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<GuardState>
+    ChaseObject::update(uint32_t i, float deltaTime) {
+        if (!seesPlayer(i, SightRange * 1.5f)) {
+            return std::make_unique<IdleObject>();
+        }
+        moveTowards(i, g_playerX, g_playerY, 90.f, deltaTime);
+        return nullptr;
+    }
+
+    class FlipObject : public GuardState {
+    public:
+        std::unique_ptr<GuardState>
+        update(uint32_t /*i*/, float /*deltaTime*/) override { return std::make_unique<FlipObject>(); }
+    };
+
+    void
+    movePlayer(int tick) {
+        g_playerX = 950.f + 700.f * std::cos(tick * 0.1f);
+        g_playerY = 950.f + 700.f * std::sin(tick * 0.1f);
+    }
+
+    /**
+     * @brief Runs @p ticks virtual-object ticks; returns milliseconds per tick.
+     */
+    double
+    runObjects(std::vector<std::unique_ptr<GuardState>>& states, size_t& transitions) {
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            movePlayer(tick);
+            for (uint32_t i = 0; i < AgentCount; ++i) {
+                if (std::unique_ptr<GuardState> next = states[i]->update(i, TickTime)) {
+                    states[i] = std::move(next);
+                    ++transitions;
+                }
+            }
+        }
+        return timer.elapsedMilliseconds() / Ticks;
+    }
+}
+
+RIOLU_BENCHMARK(StateMachine) {
+    // Guards, table-driven.
+    {
+        g_guards.spawn();
+        FSMId idle = 0;
+        StateMachine machine(buildGuardMachine(idle));
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            machine.addAgent(i, idle);
+        }
+        size_t transitions = 0;
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            movePlayer(tick);
+            machine.tick(TickTime);
+            transitions += machine.getLastTransitionCount();
+        }
+        const double tickTime = timer.elapsedMilliseconds() / Ticks;
+        report.metric("table_tick", tickTime, "ms");
+        report.metric("table_ns_per_agent", tickTime * 1e6 / AgentCount, "ns");
+        report.metric("table_transitions_per_tick", static_cast<double>(transitions) / Ticks, "count");
+        for (FSMId state = 0; state < machine.getDefinition().getStateCount(); ++state) {
+            report.metric("table_final_" + machine.getDefinition().getStateName(state),
+                          static_cast<double>(machine.getAgentsInState(state).size()), "count");
+        }
+    }
+
+    // Guards, one virtual state object each.
+    {
+        g_guards.spawn();
+        std::vector<std::unique_ptr<GuardState>> states;
+        states.reserve(AgentCount);
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            states.push_back(std::make_unique<IdleObject>());
+        }
+        size_t transitions = 0;
+        const double tickTime = runObjects(states, transitions);
+        report.metric("objects_tick", tickTime, "ms");
+        report.metric("objects_ns_per_agent", tickTime * 1e6 / AgentCount, "ns");
+        report.metric("objects_transitions_per_tick", static_cast<double>(transitions) / Ticks, "count");
+    }
+
+    // Every agent changes state every tick.
+    {
+        StateMachine machine(buildFlipMachine());
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            machine.addAgent(i, static_cast<FSMId>(i & 1));
+        }
+        BenchmarkTimer timer;
+        for (int tick = 0; tick < Ticks; ++tick) {
+            machine.tick(TickTime);
+        }
+        report.metric("table_transition", timer.elapsedNanoseconds() / (double(Ticks) * AgentCount), "ns");
+    }
+    {
+        std::vector<std::unique_ptr<GuardState>> states;
+        states.reserve(AgentCount);
+        for (uint32_t i = 0; i < AgentCount; ++i) {
+            states.push_back(std::make_unique<FlipObject>());
+        }
+        size_t transitions = 0;
+        const double tickTime = runObjects(states, transitions);
+        report.metric("objects_transition", tickTime * 1e6 / AgentCount, "ns");
+    }
+}
@@ -0,0 +1,198 @@
+#include "Benchmarks/Benchmark.h"
+#include "Jobs/TaskGraph.h"
+#include <algorithm>
+
+/**
+ * @file TaskGraphBenchmark.cpp
+ * @brief Runs an extract / cull / batch / sort / submit frame as a task graph.
+ *
+ * For each thread count the frame time is reported next to the critical path and the
+ * total work of the same frames: with enough cores the frame time should approach the
+ * critical path, with one core it approaches the total work.
+ */
+
+namespace {
+    const size_t SpriteCount = 100000;
+    const size_t ChunkCount = 16;
+    const int TextureCount = 8;
+    const int Frames = 50;
+
+    /**
+     * @brief Simulation-side sprite.
+     */
+    struct SpriteSource {
+        float x, y, vx, vy;
+        float depth;
+        int texture;
+    };
+
+    /**
+     * @brief Render-side copy produced by the extract tasks.
+     */
+    struct SpriteView {
+        float x, y;
+        float depth;
+        int texture;
+    };
+
+    /**
+     * @brief Data shared by the tasks of the frame.
+     */
+    struct FrameData {
+        std::vector<SpriteSource> sources;
+        std::vector<SpriteView> views;
+        std::vector<std::vector<uint32_t>> visible;  ///< Per chunk.
+        std::vector<std::vector<uint32_t>> batches;  ///< Per texture.
+        std::vector<float> vertices;
+        double checksum = 0.0;
+    };
+
+    void
+    extract(FrameData& frame, size_t chunk) {
+        const size_t begin = chunk * SpriteCount / ChunkCount;
+        const size_t end = (chunk + 1) * SpriteCount / ChunkCount;
+        for (size_t i = begin; i < end; ++i) {
+            SpriteSource& source = frame.sources[i];
+            source.x += source.vx * (1.f / 60.f);
+            source.y += source.vy * (1.f / 60.f);
+            if (source.x < 0.f || source.x > 4000.f) source.vx = -source.vx;
+            if (source.y < 0.f || source.y > 4000.f) source.vy = -source.vy;
+            frame.views[i] = { source.x, source.y, source.depth, source.texture };
+        }
+    }
+
+    void
+    cull(FrameData& frame, size_t chunk) {
+        const size_t begin = chunk * SpriteCount / ChunkCount;
+        const size_t end = (chunk + 1) * SpriteCount / ChunkCount;
+        std::vector<uint32_t>& visible = frame.visible[chunk];
+        visible.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const SpriteView& view = frame.views[i];
+            if (view.x > 500.f && view.x < 2420.f && view.y > 500.f && view.y < 1580.f) {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    void
+    batch(FrameData& frame) {
+        for (std::vector<uint32_t>& bucket : frame.batches) {
+            bucket.clear();
+        }
+        for (const std::vector<uint32_t>& visible : frame.visible) {
+            for (uint32_t index : visible) {
+                frame.batches[frame.views[index].texture].push_back(index);
+            }
+        }
+    }
+
+    void
+    sortBatch(FrameData& frame, int texture) {
+        std::vector<uint32_t>& bucket = frame.batches[texture];
+        std::sort(bucket.begin(), bucket.end(), [&frame](uint32_t a, uint32_t b) {
+            return frame.views[a].depth < frame.views[b].depth;
+        });
+    }
+
+    void
+    submit(FrameData& frame) {
+        frame.vertices.clear();
+        for (const std::vector<uint32_t>& bucket : frame.batches) {
+            for (uint32_t index : bucket) {
+                const SpriteView& view = frame.views[index];
+                frame.vertices.insert(frame.vertices.end(), { view.x, view.y, view.x + 16.f, view.y,
+                                                              view.x + 16.f, view.y + 16.f, view.x, view.y + 16.f });
+            }
+        }
+        frame.checksum += static_cast<double>(frame.vertices.size());
+    }
+
+    /**
+     * @brief Builds the frame graph: extract[i] -> cull[i] -> batch -> sort[t] -> submit.
+     */
+    void
+    buildFrame(TaskGraph& graph, FrameData& frame) {
+        const TaskId batchTask = graph.addTask("batch", [&frame]() { batch(frame); });
+        const TaskId submitTask = graph.addTask("submit", [&frame]() { submit(frame); });
+        for (size_t chunk = 0; chunk < ChunkCount; ++chunk) {
+            const TaskId extractTask = graph.addTask("extract " + std::to_string(chunk),
+                                                     [&frame, chunk]() { extract(frame, chunk); });
+            const TaskId cullTask = graph.addTask("cull " + std::to_string(chunk),
+                                                  [&frame, chunk]() { cull(frame, chunk); });
+            graph.addDependency(extractTask, cullTask);
+            graph.addDependency(cullTask, batchTask);
+        }
+        for (int texture = 0; texture < TextureCount; ++texture) {
+            const TaskId sortTask = graph.addTask("sort " + std::to_string(texture),
+                                                  [&frame, texture]() { sortBatch(frame, texture); });
+            graph.addDependency(batchTask, sortTask);
+            graph.addDependency(sortTask, submitTask);
+        }
+    }
+
+    void
+    initFrame(FrameData& frame) {
+        frame.sources.resize(SpriteCount);
+        frame.views.resize(SpriteCount);
+        frame.visible.assign(ChunkCount, {});
+        frame.batches.assign(TextureCount, {});
+        uint32_t seed = 12345;
+        auto random = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 16777216.f;
+        };
+        for (SpriteSource& source : frame.sources) {
+            source = { random() * 4000.f, random() * 4000.f, random() * 200.f - 100.f,
+                       random() * 200.f - 100.f, random(), static_cast<int>(random() * TextureCount) };
+        }
+    }
+}
+
+RIOLU_BENCHMARK(TaskGraph) {
+    report.metric("hardware_threads", static_cast<double>(std::thread::hardware_concurrency()), "count");
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u, 16u }) {
+        // The thread calling execute() takes part, so the pool has one worker less.
+        JobSystem jobs(threads - 1);
+        FrameData frame;
+        initFrame(frame);
+        TaskGraph graph;
+        buildFrame(graph, frame);
+        graph.execute(jobs);
+
+        double frameTime = 0.0;
+        double criticalPath = 0.0;
+        double work = 0.0;
+        for (int i = 0; i < Frames; ++i) {
+            graph.execute(jobs);
+            frameTime += graph.getStats().frameTime;
+            criticalPath += graph.getStats().criticalPathTime;
+            work += graph.getStats().workTime;
+        }
+
+        const std::string prefix = "threads_" + std::to_string(threads) + "_";
+        report.metric(prefix + "frame", frameTime / Frames, "us");
+        report.metric(prefix + "critical_path", criticalPath / Frames, "us");
+        report.metric(prefix + "work", work / Frames, "us");
+        report.metric(prefix + "frame_over_critical_path", frameTime / criticalPath, "ratio");
+        benchmarkKeep(frame.checksum);
+    }
+
+    // Scheduling overhead: many empty tasks fanned out from one root.
+    {
+        const int taskCount = 10000;
+        JobSystem jobs;
+        TaskGraph graph;
+        const TaskId root = graph.addTask("root", []() {});
+        for (int i = 0; i < taskCount; ++i) {
+            graph.addDependency(root, graph.addTask("empty", []() {}));
+        }
+        graph.execute(jobs);
+        BenchmarkTimer timer;
+        for (int i = 0; i < 10; ++i) {
+            graph.execute(jobs);
+        }
+        report.metric("empty_task_overhead", timer.elapsedNanoseconds() / (10.0 * taskCount), "ns/task");
+    }
+}
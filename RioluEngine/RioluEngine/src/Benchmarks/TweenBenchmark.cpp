@@ -0,0 +1,187 @@
+#include "Benchmarks/Benchmark.h"
+#include "Animation/TweenSystem.h"
+#include <cmath>
+
+/**
+ * @file TweenBenchmark.cpp
+ * @brief Plays 100k tweens on Transforms and CShapes and measures one frame.
+ *
+ * Half the tweens move positions back and forth forever (yoyo), a quarter rotate in
+ * loops, a fifth run looping sequences (scale up, wait, scale down) and the rest fade
+ * shape colours; every easing is used, by blocks of 1000 actors. The same Transform tweens are then run as a
+ * per-tween loop that switches on property and easing for each tween, like hand-written
+ * update code, and the final positions and rotations are compared.
+ */
+
+namespace {
+    const size_t TransformCount = 95000;
+    const size_t ShapeCount = 5000;
+    const int Frames = 60;
+    const float FrameTime = 1.f / 60.f;
+
+    /**
+     * @brief Picks an easing for tween @p i; actors spawned together (blocks of 1000)
+     * share one.
+     */
+    TweenEasing
+    easingFor(size_t i) {
+        return static_cast<TweenEasing>((i / 1000) % static_cast<size_t>(TweenEasing::Count));
+    }
+
+    /**
+     * @brief Scalar easing, written like per-actor update code.
+     */
+    float
+    easeScalar(TweenEasing easing, float t) {
+        const float u = 1.f - t;
+        switch (easing) {
+        case TweenEasing::QuadIn: return t * t;
+        case TweenEasing::QuadOut: return 1.f - u * u;
+        case TweenEasing::QuadInOut: return t < 0.5f ? 2.f * t * t : 1.f - 2.f * u * u;
+        case TweenEasing::CubicIn: return t * t * t;
+        case TweenEasing::CubicOut: return 1.f - u * u * u;
+        case TweenEasing::CubicInOut: return t < 0.5f ? 4.f * t * t * t : 1.f - 4.f * u * u * u;
+        case TweenEasing::SmoothStep: return t * t * (3.f - 2.f * t);
+        default: return t;
+        }
+    }
+
+    /**
+     * @brief One tween of the hand-written version.
+     */
+    struct ScalarTween {
+        Transform* target;
+        TweenProperty property;
+        TweenEasing easing;
+        bool yoyo;
+        float elapsed;
+        float duration;
+        float from[2];
+        float to[2];
+    };
+
+    /**
+     * @brief Advances and applies one endless tween.
+     */
+    void
+    updateScalar(ScalarTween& tween, float deltaTime) {
+        tween.elapsed += deltaTime;
+        const float cycles = tween.elapsed / tween.duration;
+        const float cycle = std::floor(cycles);
+        float t = cycles - cycle;
+        if (tween.yoyo && static_cast<long long>(cycle) % 2 == 1) {
+            t = 1.f - t;
+        }
+        const float eased = easeScalar(tween.easing, t);
+        const float x = tween.from[0] + (tween.to[0] - tween.from[0]) * eased;
+        const float y = tween.from[1] + (tween.to[1] - tween.from[1]) * eased;
+        switch (tween.property) {
+        case TweenProperty::Position:
+            tween.target->setPosition(sf::Vector2f(x, y));
+            break;
+        case TweenProperty::Rotation:
+            tween.target->setRotation(sf::Vector2f(x, 0.f));
+            break;
+        default:
+            tween.target->setScale(sf::Vector2f(x, y));
+            break;
+        }
+    }
+
+    sf::Vector2f
+    homeOf(size_t i) {
+        return sf::Vector2f(static_cast<float>(i % 400) * 5.f, static_cast<float>(i / 400) * 5.f);
+    }
+
+    /**
+     * @brief Sum of the positions and rotations of the first @p count transforms.
+     */
+    double
+    checksum(const std::vector<EngineUtilities::TSharedPointer<Transform>>& transforms, size_t count) {
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += transforms[i]->getPosition().x + transforms[i]->getPosition().y + transforms[i]->getRotation().x;
+        }
+        return sum;
+    }
+}
+
+RIOLU_BENCHMARK(Tween) {
+    std::vector<EngineUtilities::TSharedPointer<Transform>> transforms;
+    transforms.reserve(TransformCount);
+    for (size_t i = 0; i < TransformCount; ++i) {
+        transforms.push_back(EngineUtilities::MakeShared<Transform>());
+    }
+    std::vector<EngineUtilities::TSharedPointer<CShape>> shapes;
+    for (size_t i = 0; i < ShapeCount; ++i) {
+        shapes.push_back(EngineUtilities::MakeShared<CShape>());
+        shapes.back()->createShape(ShapeType::RECTANGLE);
+    }
+
+    // Transforms [0, 50k) move, [50k, 75k) rotate, the rest run scale sequences.
+    const size_t moving = 50000;
+    const size_t rotating = 25000;
+    double batchChecksum = 0.0;
+    {
+        TweenSystem tweens;
+        for (size_t i = 0; i < TransformCount; ++i) {
+            const float duration = 0.5f + 0.01f * static_cast<float>(i % 100);
+            if (i < moving) {
+                const sf::Vector2f home = homeOf(i);
+                tweens.play(TweenTrack::position(transforms[i], home, home + sf::Vector2f(40.f, 20.f), duration, easingFor(i)),
+                            TweenSystem::Forever, true);
+            }
+            else if (i < moving + rotating) {
+                tweens.play(TweenTrack::rotation(transforms[i], 0.f, 360.f, duration, easingFor(i)), TweenSystem::Forever);
+            }
+            else {
+                TweenSequence pulse;
+                pulse.then(TweenTrack::scale(transforms[i], sf::Vector2f(1.f, 1.f), sf::Vector2f(1.5f, 1.5f), duration, easingFor(i)))
+                     .wait(0.1f)
+                     .then(TweenTrack::scale(transforms[i], sf::Vector2f(1.5f, 1.5f), sf::Vector2f(1.f, 1.f), duration, easingFor(i)));
+                tweens.play(pulse, TweenSystem::Forever);
+            }
+        }
+        for (size_t i = 0; i < ShapeCount; ++i) {
+            tweens.play(TweenTrack::color(shapes[i], sf::Color::Red, sf::Color::Blue, 1.f, easingFor(i)), TweenSystem::Forever, true);
+        }
+        report.metric("active_tweens", static_cast<double>(tweens.getActiveCount()), "count");
+
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            tweens.update(FrameTime);
+        }
+        report.metric("batch_frame", timer.elapsedMilliseconds() / Frames, "ms");
+        report.metric("batch_per_tween", timer.elapsedNanoseconds() / (double(Frames) * tweens.getActiveCount()), "ns");
+        batchChecksum = checksum(transforms, moving + rotating);
+    }
+
+    // Hand-written loop over the moving and rotating tweens only.
+    {
+        std::vector<ScalarTween> scalar;
+        scalar.reserve(moving + rotating);
+        for (size_t i = 0; i < moving + rotating; ++i) {
+            const float duration = 0.5f + 0.01f * static_cast<float>(i % 100);
+            if (i < moving) {
+                const sf::Vector2f home = homeOf(i);
+                transforms[i]->setPosition(home);
+                scalar.push_back({ transforms[i].get(), TweenProperty::Position, easingFor(i), true, 0.f, duration,
+                                   { home.x, home.y }, { home.x + 40.f, home.y + 20.f } });
+            }
+            else {
+                transforms[i]->setRotation(sf::Vector2f(0.f, 0.f));
+                scalar.push_back({ transforms[i].get(), TweenProperty::Rotation, easingFor(i), false, 0.f, duration,
+                                   { 0.f, 0.f }, { 360.f, 0.f } });
+            }
+        }
+
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            for (ScalarTween& tween : scalar) {
+                updateScalar(tween, FrameTime);
+            }
+        }
+        report.metric("scalar_per_tween", timer.elapsedNanoseconds() / (double(Frames) * scalar.size()), "ns");
+        report.metric("checksum_difference", std::abs(checksum(transforms, moving + rotating) - batchChecksum), "units");
+    }
+}
@@ -0,0 +1,204 @@
+#include "Benchmarks/Benchmark.h"
+#include "UI/UiSystem.h"
+#include <cmath>
+#include <cstdio>
+
+/**
+ * @file UiBenchmark.cpp
+ * @brief Runs a 2,000-widget debug panel through the retained UI for many frames.
+ *
+ * The panel has 200 rows in four columns; a row holds a name, six fixed-width values
+ * and three buttons. Each frame one value per row changes (200 texts), the mouse moves
+ * over the panel, and every 16th frame a row is hidden or shown again, which moves the rows
+ * below it. The baseline redoes all the work every frame, as an immediate-mode UI
+ * does: invalidate() before update(). Hit-testing through the grid is compared with
+ * a scan of every button. The incremental vertices are checked against a full
+ * rebuild and every grid hit against the scan. Glyphs are the built-in boxes, so no
+ * font file is needed; glyph lookups cost the same either way.
+ */
+
+namespace {
+    const int Columns = 4;
+    const int RowsPerColumn = 50;
+    const int ValuesPerRow = 6;
+    const int ButtonsPerRow = 3;
+    const int Frames = 2000;
+    const size_t HitQueries = 100000;
+    const sf::Vector2f Viewport(2560.f, 1440.f);
+
+    /**
+     * @struct DebugPanel
+     * @brief Ids of the widgets the frames touch.
+     */
+    struct DebugPanel {
+        std::vector<UiNodeId> rows;    ///< Row panels.
+        std::vector<UiNodeId> values;  ///< Value labels, ValuesPerRow per row.
+        std::vector<UiNodeId> buttons; ///< Buttons.
+        size_t widgets = 0;            ///< Labels and buttons.
+    };
+
+    DebugPanel
+    buildPanel(UiSystem& ui) {
+        DebugPanel panel;
+        UiStyle frame;
+        frame.direction = UiDirection::Row;
+        frame.position = sf::Vector2f(8.f, 8.f);
+        frame.background = sf::Color(20, 20, 28, 220);
+        const UiNodeId root = ui.addPanel(ui.getRoot(), frame);
+
+        UiStyle column;
+        column.padding = 2.f;
+        column.spacing = 1.f;
+        UiStyle row;
+        row.direction = UiDirection::Row;
+        row.padding = 0.f;
+        UiStyle name;
+        name.padding = 1.f;
+        name.size.x = 90.f;
+        UiStyle value = name;
+        value.size.x = 48.f;
+        value.text = sf::Color(160, 220, 160);
+        UiStyle button;
+        button.padding = 1.f;
+        button.background = sf::Color(50, 50, 70);
+
+        char text[32];
+        for (int c = 0; c < Columns; ++c) {
+            const UiNodeId parent = ui.addPanel(root, column);
+            for (int r = 0; r < RowsPerColumn; ++r) {
+                const UiNodeId line = ui.addPanel(parent, row);
+                panel.rows.push_back(line);
+                std::snprintf(text, sizeof(text), "Entity %04d", c * RowsPerColumn + r);
+                ui.addLabel(line, text, name);
+                for (int v = 0; v < ValuesPerRow; ++v) {
+                    panel.values.push_back(ui.addLabel(line, "0.000", value));
+                }
+                panel.buttons.push_back(ui.addButton(line, "Sel", button));
+                panel.buttons.push_back(ui.addButton(line, "Log", button));
+                panel.buttons.push_back(ui.addButton(line, "X", button));
+                panel.widgets += 1 + ValuesPerRow + ButtonsPerRow;
+            }
+        }
+        return panel;
+    }
+
+    /**
+     * @brief Runs @p Frames frames of changes and returns nanoseconds per frame.
+     */
+    template<bool Immediate>
+    double
+    runFrames(UiSystem& ui, const DebugPanel& panel, const std::vector<std::string>& numbers, UiStats& total) {
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < Frames; ++frame) {
+            for (size_t row = 0; row < panel.rows.size(); ++row) {
+                const size_t value = row * ValuesPerRow + (frame + row) % ValuesPerRow;
+                ui.setText(panel.values[value], numbers[(frame * 31 + row * 7) % numbers.size()]);
+            }
+            if (frame % 16 == 0) {
+                const UiNodeId row = panel.rows[(frame / 32 * 37) % panel.rows.size()];
+                ui.setVisible(row, (frame / 16) % 2 == 1);
+            }
+            const float t = frame * 0.01f;
+            ui.handleMouse(sf::Vector2f(1100.f + 1000.f * std::sin(t), 400.f + 380.f * std::cos(t * 1.3f)),
+                           frame % 30 == 0);
+            if (Immediate) {
+                ui.invalidate();
+            }
+            ui.update();
+
+            const UiStats& stats = ui.getStats();
+            total.measured += stats.measured;
+            total.arranged += stats.arranged;
+            total.rewritten += stats.rewritten;
+            total.rangeRebuilds += stats.rangeRebuilds;
+            total.gridRebuilds += stats.gridRebuilds;
+        }
+        return timer.elapsedNanoseconds() / Frames;
+    }
+}
+
+RIOLU_BENCHMARK(Ui) {
+    std::vector<std::string> numbers;
+    char text[32];
+    for (int i = 0; i < 997; ++i) {
+        std::snprintf(text, sizeof(text), "%5.3f", i * 0.0137f);
+        numbers.push_back(text);
+    }
+
+    UiSystem retained(nullptr, 8, Viewport);
+    UiSystem immediate(nullptr, 8, Viewport);
+    const DebugPanel panel = buildPanel(retained);
+    buildPanel(immediate);
+    retained.update();
+    immediate.update();
+    report.metric("widgets", static_cast<double>(panel.widgets), "count");
+    report.metric("nodes", static_cast<double>(retained.getNodeCount()), "count");
+    report.metric("vertices", static_cast<double>(retained.getVertices().size()), "count");
+    report.metric("draw_calls", 1.0, "count");
+
+    UiStats immediateTotal;
+    report.metric("immediate_frame", runFrames<true>(immediate, panel, numbers, immediateTotal), "ns");
+
+    UiStats retainedTotal;
+    report.metric("retained_frame", runFrames<false>(retained, panel, numbers, retainedTotal), "ns");
+    report.metric("retained_measured_per_frame", static_cast<double>(retainedTotal.measured) / Frames, "nodes");
+    report.metric("retained_arranged_per_frame", static_cast<double>(retainedTotal.arranged) / Frames, "nodes");
+    report.metric("retained_rewritten_per_frame", static_cast<double>(retainedTotal.rewritten) / Frames, "nodes");
+    report.metric("immediate_rewritten_per_frame", static_cast<double>(immediateTotal.rewritten) / Frames, "nodes");
+    report.metric("grid_rebuilds", static_cast<double>(retainedTotal.gridRebuilds), "count");
+    report.metric("range_rebuilds", static_cast<double>(retainedTotal.rangeRebuilds), "count");
+    report.metric("glyph_loads", static_cast<double>(retained.getGlyphs().getLoadCount()), "count");
+
+    // Incremental updates must leave the same vertices as a full rebuild.
+    const std::vector<sf::Vertex> incremental = retained.getVertices();
+    retained.invalidate();
+    retained.update();
+    size_t mismatches = 0;
+    for (size_t i = 0; i < incremental.size(); ++i) {
+        const sf::Vertex& a = incremental[i];
+        const sf::Vertex& b = retained.getVertices()[i];
+        mismatches += a.position != b.position || a.color != b.color || a.texCoords != b.texCoords ? 1 : 0;
+    }
+    for (size_t i = 0; i < incremental.size(); ++i) {
+        const sf::Vertex& a = incremental[i];
+        const sf::Vertex& b = immediate.getVertices()[i];
+        mismatches += a.position != b.position || a.color != b.color ? 1 : 0;
+    }
+    report.metric("vertex_mismatches", static_cast<double>(mismatches), "count");
+
+    // Hidden rows keep stale rectangles, so show every row before comparing with the scan.
+    for (UiNodeId row : panel.rows) {
+        retained.setVisible(row, true);
+    }
+    retained.update();
+    std::vector<sf::Vector2f> points(HitQueries);
+    for (size_t i = 0; i < HitQueries; ++i) {
+        points[i] = sf::Vector2f(static_cast<float>((i * 7919) % 2200), static_cast<float>((i * 104729) % 900));
+    }
+    std::vector<UiNodeId> gridHits(HitQueries);
+    {
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < HitQueries; ++i) {
+            gridHits[i] = retained.hitTest(points[i]);
+        }
+        report.metric("grid_hit_test", timer.elapsedNanoseconds() / HitQueries, "ns");
+    }
+    size_t wrongHits = 0;
+    size_t hits = 0;
+    {
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < HitQueries; ++i) {
+            UiNodeId found = InvalidUiNode;
+            for (UiNodeId button : panel.buttons) {
+                if (retained.getRect(button).contains(points[i])) {
+                    found = button;
+                }
+            }
+            wrongHits += found != gridHits[i] ? 1 : 0;
+            hits += found != InvalidUiNode ? 1 : 0;
+        }
+        report.metric("linear_hit_test", timer.elapsedNanoseconds() / HitQueries, "ns");
+    }
+    report.metric("hit_ratio", static_cast<double>(hits) / HitQueries, "ratio");
+    report.metric("wrong_hits", static_cast<double>(wrongHits), "count");
+}
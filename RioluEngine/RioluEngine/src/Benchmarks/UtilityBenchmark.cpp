@@ -0,0 +1,154 @@
+#include "Benchmarks/Benchmark.h"
+#include "AI/UtilityAI.h"
+#include "Jobs/JobSystem.h"
+
+/**
+ * @file UtilityBenchmark.cpp
+ * @brief Measures utility-AI decision throughput with four-lane and per-agent scoring.
+ *
+ * 100k soldiers choose between eight actions with two to three considerations each
+ * (all curve types). The batch path is compared with a plain per-agent loop calling
+ * UtilityModel::score and keeping the best action. Metrics are nanoseconds per agent
+ * decision, and how often both paths picked the same best action (the four-lane
+ * exponential is an approximation, so near-ties may differ).
+ */
+
+namespace {
+    const size_t AgentCount = 100000;
+    const int Rounds = 20;
+
+    enum Input : uint32_t { Distance, Health, Ammo, Enemies, Cover, Allies, InputCount };
+
+    std::shared_ptr<const UtilityModel>
+    buildSoldierModel() {
+        std::shared_ptr<UtilityModel> model = std::make_shared<UtilityModel>();
+        const char* inputs[InputCount] = { "distance", "health", "ammo", "enemies", "cover", "allies" };
+        for (const char* input : inputs) {
+            model->addInput(input);
+        }
+
+        const UtilityCurve rising{ UtilityCurveType::Linear, 1.f, 1.f, 0.f, 0.f };
+        const UtilityCurve falling{ UtilityCurveType::Linear, -1.f, 1.f, 0.f, 1.f };
+        const UtilityCurve risingSquared{ UtilityCurveType::Quadratic, 1.f, 1.f, 0.f, 0.f };
+        const UtilityCurve fallingSquared{ UtilityCurveType::Quadratic, 1.f, 1.f, 1.f, 0.f };
+        const UtilityCurve close{ UtilityCurveType::Logistic, -12.f, 1.f, 0.3f, 0.f };
+        const UtilityCurve far{ UtilityCurveType::Logistic, 12.f, 1.f, 0.6f, 0.f };
+        const UtilityCurve hasSome{ UtilityCurveType::Step, 1.f, 1.f, 0.1f, 0.f };
+
+        const uint32_t attack = model->addAction("attack");
+        model->addConsideration(attack, Distance, 0.f, 50.f, close);
+        model->addConsideration(attack, Ammo, 0.f, 30.f, hasSome);
+        model->addConsideration(attack, Health, 0.f, 100.f, rising);
+
+        const uint32_t shoot = model->addAction("shoot", 0.9f);
+        model->addConsideration(shoot, Distance, 0.f, 50.f, falling);
+        model->addConsideration(shoot, Ammo, 0.f, 30.f, risingSquared);
+
+        const uint32_t reload = model->addAction("reload", 0.8f);
+        model->addConsideration(reload, Ammo, 0.f, 30.f, fallingSquared);
+        model->addConsideration(reload, Enemies, 0.f, 10.f, falling);
+
+        const uint32_t takeCover = model->addAction("take cover");
+        model->addConsideration(takeCover, Health, 0.f, 100.f, fallingSquared);
+        model->addConsideration(takeCover, Cover, 0.f, 1.f, rising);
+        model->addConsideration(takeCover, Enemies, 0.f, 10.f, risingSquared);
+
+        const uint32_t flee = model->addAction("flee", 0.7f);
+        model->addConsideration(flee, Health, 0.f, 100.f, fallingSquared);
+        model->addConsideration(flee, Allies, 0.f, 10.f, falling);
+
+        const uint32_t regroup = model->addAction("regroup", 0.6f);
+        model->addConsideration(regroup, Allies, 0.f, 10.f, rising);
+        model->addConsideration(regroup, Distance, 0.f, 50.f, far);
+
+        const uint32_t advance = model->addAction("advance", 0.5f);
+        model->addConsideration(advance, Distance, 0.f, 50.f, far);
+        model->addConsideration(advance, Health, 0.f, 100.f, rising);
+
+        const uint32_t idle = model->addAction("idle", 0.1f);
+        model->addConsideration(idle, Enemies, 0.f, 10.f, falling);
+        return model;
+    }
+
+    /**
+     * @brief Fills the inputs with a deterministic spread of situations.
+     */
+    void
+    fillInputs(UtilityBatch& batch) {
+        const float ranges[InputCount] = { 60.f, 100.f, 30.f, 10.f, 1.f, 10.f };
+        uint32_t state = 12345u;
+        for (uint32_t input = 0; input < InputCount; ++input) {
+            float* values = batch.getInputs(input);
+            for (size_t agent = 0; agent < batch.getAgentCount(); ++agent) {
+                state = state * 1664525u + 1013904223u;
+                values[agent] = static_cast<float>(state >> 8) / 16777216.f * ranges[input];
+            }
+        }
+    }
+}
+
+RIOLU_BENCHMARK(Utility) {
+    const std::shared_ptr<const UtilityModel> model = buildSoldierModel();
+    UtilityBatch batch(model, 3);
+    batch.resize(AgentCount);
+    fillInputs(batch);
+    report.metric("actions", static_cast<double>(model->getActionCount()), "count");
+
+    {
+        BenchmarkTimer timer;
+        for (int round = 0; round < Rounds; ++round) {
+            batch.evaluate();
+            benchmarkClobber();
+        }
+        const double perAgent = timer.elapsedNanoseconds() / (double(Rounds) * AgentCount);
+        report.metric("simd_decision", perAgent, "ns");
+        report.metric("simd_decisions_per_second", 1e9 / perAgent, "count");
+    }
+
+    // Per-agent reference: gather the inputs, score each action, keep the best.
+    std::vector<uint32_t> reference(AgentCount);
+    {
+        BenchmarkTimer timer;
+        for (int round = 0; round < Rounds; ++round) {
+            for (size_t agent = 0; agent < AgentCount; ++agent) {
+                float inputs[InputCount];
+                for (uint32_t input = 0; input < InputCount; ++input) {
+                    inputs[input] = batch.getInputs(input)[agent];
+                }
+                float bestScore = -1.f;
+                uint32_t best = InvalidUtilityAction;
+                for (uint32_t action = 0; action < model->getActionCount(); ++action) {
+                    const float score = model->score(action, inputs);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        best = action;
+                    }
+                }
+                reference[agent] = best;
+            }
+            benchmarkClobber();
+        }
+        report.metric("scalar_decision", timer.elapsedNanoseconds() / (double(Rounds) * AgentCount), "ns");
+    }
+
+    size_t agreeing = 0;
+    std::vector<size_t> picks(model->getActionCount(), 0);
+    for (size_t agent = 0; agent < AgentCount; ++agent) {
+        agreeing += batch.getBestAction(agent) == reference[agent];
+        ++picks[batch.getBestAction(agent)];
+    }
+    report.metric("agreement", 100.0 * agreeing / AgentCount, "%");
+    for (uint32_t action = 0; action < model->getActionCount(); ++action) {
+        report.metric("picked_" + model->getActionName(action), static_cast<double>(picks[action]), "count");
+    }
+
+    for (unsigned threads : { 2u, 4u }) {
+        JobSystem jobs(threads - 1);
+        BenchmarkTimer timer;
+        for (int round = 0; round < Rounds; ++round) {
+            batch.evaluate(jobs);
+        }
+        report.metric("simd_threads_" + std::to_string(threads) + "_decision",
+                      timer.elapsedNanoseconds() / (double(Rounds) * AgentCount), "ns");
+    }
+}
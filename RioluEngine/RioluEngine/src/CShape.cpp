@@ -174,7 +174,10 @@ CShape::setScale(const sf::Vector2f& scale) {
     }
 }
 
+/**
+ * @brief Returns the SFML shape, or nullptr if createShape() was not called.
+ */
 sf::Shape* CShape::getShape()
 {
-    return nullptr;
+    return m_shapePtr.get();
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 ﻿#include "ECS/Actor.h"
 
-Actor::Actor(const std::string& actorName) {
-    //Setup Actor Name
-    m_name = actorName;
+Actor::Actor(const std::string& actorName) : Actor(StringId::intern(actorName)) {
+}
 
+Actor::Actor(StringId actorName) : m_name(actorName) {
     //Setup Transform
     EngineUtilities::TSharedPointer<CShape> shape = EngineUtilities::MakeShared<CShape>();
     addComponent(shape);
@@ -13,6 +13,12 @@ Actor::Actor(const std::string& actorName) {
     addComponent(transform);
 }
 
+StringId
+Actor::defaultName() {
+    static const StringId name = StringId::intern("Actor");
+    return name;
+}
+
 void
 Actor::start() {
     // Inicializa el actor aqu� si es necesario
@@ -26,6 +32,28 @@ Actor::destroy() {
 
 void
 Actor::update(float deltaTime) {
+    for (auto& component : components) {
+        component->update(deltaTime);
+    }
+    syncShapeWithTransform();
+}
+
+bool
+Actor::updateComponents(float deltaTime, bool parallelSafe) {
+    bool hasOtherKind = false;
+    for (auto& component : components) {
+        if (component->isParallelUpdateSafe() == parallelSafe) {
+            component->update(deltaTime);
+        }
+        else {
+            hasOtherKind = true;
+        }
+    }
+    return hasOtherKind;
+}
+
+void
+Actor::syncShapeWithTransform() {
     auto transform = getComponent<Transform>();
     auto shape = getComponent<CShape>();
 
@@ -45,4 +73,4 @@ Actor::render(const EngineUtilities::TSharedPointer<Window>& window) {
             shape->render(window);
         }
     }
-}w
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "ECS/ActorNameIndex.h"
+#include <algorithm>
+
+/**
+ * @file ActorNameIndex.cpp
+ * @brief Implements the open-addressing actor name index.
+ */
+
+ActorNameIndex::ActorNameIndex(size_t expected) {
+    size_t slots = 16;
+    while (slots < expected * 2) {
+        slots *= 2;
+    }
+    rehash(slots);
+    m_entries.reserve(expected);
+}
+
+void
+ActorNameIndex::add(StringId name, Actor* actor) {
+    if (!name.isValid() || actor == nullptr) {
+        ERROR("ActorNameIndex", "add", "Invalid name or null actor");
+    }
+    if (m_count >= InvalidEntry) {
+        ERROR("ActorNameIndex", "add", "Too many actors");
+    }
+    if ((m_names + 1) * 2 > m_slots.size()) {
+        rehash(m_slots.size() * 2);
+    }
+
+    size_t slot = probe(name.getHash());
+    if (m_slots[slot].hash == 0) {
+        m_slots[slot].hash = name.getHash();
+        ++m_names;
+    }
+
+    uint32_t entry = m_freeEntry;
+    if (entry != InvalidEntry) {
+        m_freeEntry = m_entries[entry].next;
+    }
+    else {
+        entry = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(Entry{ nullptr, InvalidEntry });
+    }
+    m_entries[entry] = Entry{ actor, m_slots[slot].head };
+    m_slots[slot].head = entry;
+    ++m_count;
+}
+
+bool
+ActorNameIndex::remove(StringId name, const Actor* actor) {
+    const size_t slot = probe(name.getHash());
+    uint32_t* link = &m_slots[slot].head;
+    while (*link != InvalidEntry && m_entries[*link].actor != actor) {
+        link = &m_entries[*link].next;
+    }
+    if (*link == InvalidEntry) {
+        return false;
+    }
+
+    const uint32_t entry = *link;
+    *link = m_entries[entry].next;
+    m_entries[entry] = Entry{ nullptr, m_freeEntry };
+    m_freeEntry = entry;
+    --m_count;
+
+    if (m_slots[slot].head == InvalidEntry) {
+        eraseSlot(slot);
+    }
+    return true;
+}
+
+Actor*
+ActorNameIndex::find(StringId name) const {
+    const uint32_t head = m_slots[probe(name.getHash())].head;
+    return head != InvalidEntry ? m_entries[head].actor : nullptr;
+}
+
+void
+ActorNameIndex::clear() {
+    std::fill(m_slots.begin(), m_slots.end(), Slot{ 0, InvalidEntry });
+    m_entries.clear();
+    m_freeEntry = InvalidEntry;
+    m_names = 0;
+    m_count = 0;
+}
+
+void
+ActorNameIndex::rehash(size_t slots) {
+    std::vector<Slot> old(slots, Slot{ 0, InvalidEntry });
+    old.swap(m_slots);
+    m_mask = slots - 1;
+    for (const Slot& name : old) {
+        if (name.hash != 0) {
+            m_slots[probe(name.hash)] = name;
+        }
+    }
+}
+
+void
+ActorNameIndex::eraseSlot(size_t slot) {
+    // Backward-shift deletion: pull later names of the cluster into the hole when
+    // their home slot is not between the hole and themselves, so no tombstones build up.
+    size_t hole = slot;
+    size_t next = (hole + 1) & m_mask;
+    while (m_slots[next].hash != 0) {
+        const size_t wanted = home(m_slots[next].hash);
+        if (((next - wanted) & m_mask) >= ((next - hole) & m_mask)) {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+        next = (next + 1) & m_mask;
+    }
+    m_slots[hole] = Slot{ 0, InvalidEntry };
+    --m_names;
+}
@@ -0,0 +1,55 @@
+#include "ECS/ActorUpdater.h"
+#include "Jobs/ParallelFor.h"
+
+/**
+ * @file ActorUpdater.cpp
+ * @brief Implements the parallel and deterministic actor update passes.
+ */
+
+void
+ActorUpdater::update(ActorList& actors, float deltaTime) {
+    if (m_mode == ActorUpdateMode::Deterministic) {
+        for (EngineUtilities::TSharedPointer<Actor>& actor : actors) {
+            if (!actor.isNull()) {
+                actor->update(deltaTime);
+            }
+        }
+        m_serialActorCount = 0;
+        return;
+    }
+
+    // A few chunks per thread so threads that finish early can take more.
+    const size_t threads = m_jobs.getWorkerCount() + 1;
+    const size_t grain = m_grain != 0 ? m_grain : std::max(MinimumGrain, actors.size() / (threads * 4));
+    const size_t chunks = (actors.size() + grain - 1) / grain;
+    if (m_serialActors.size() < chunks) {
+        m_serialActors.resize(chunks);
+    }
+
+    parallelFor(m_jobs, actors.size(), grain, [&](size_t begin, size_t end) {
+        std::vector<uint32_t>& serial = m_serialActors[begin / grain];
+        serial.clear();
+        for (size_t i = begin; i < end; ++i) {
+            Actor* actor = actors[i].get();
+            if (actor == nullptr) {
+                continue;
+            }
+            if (actor->updateComponents(deltaTime, true)) {
+                serial.push_back(static_cast<uint32_t>(i));
+            }
+            else {
+                actor->syncShapeWithTransform();
+            }
+        }
+    });
+
+    // Chunk order is list order, so serial components always run in the same order.
+    m_serialActorCount = 0;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        for (uint32_t index : m_serialActors[chunk]) {
+            actors[index]->updateComponents(deltaTime, false);
+            actors[index]->syncShapeWithTransform();
+        }
+        m_serialActorCount += m_serialActors[chunk].size();
+    }
+}
@@ -0,0 +1,38 @@
+#include "ECS/ComponentObserver.h"
+#include <algorithm>
+
+/**
+ * @file ComponentObserver.cpp
+ * @brief Implements the component observers and their registry.
+ */
+
+static_assert(TEXTURE < ComponentObserverRegistry::TypeCount, "Raise TypeCount for the new component types");
+
+ComponentObserver::ComponentObserver(ComponentType type) : m_type(type) {
+    if (static_cast<size_t>(type) >= ComponentObserverRegistry::TypeCount) {
+        ERROR("ComponentObserver", "ComponentObserver", "Component type " << type << " cannot be observed");
+    }
+    ComponentObserverRegistry::getObservers(type).push_back(this);
+}
+
+ComponentObserver::~ComponentObserver() {
+    std::vector<ComponentObserver*>& observers = ComponentObserverRegistry::getObservers(m_type);
+    observers.erase(std::remove(observers.begin(), observers.end(), this), observers.end());
+}
+
+std::vector<ComponentObserver*>&
+ComponentObserverRegistry::getObservers(ComponentType type) {
+    static std::vector<ComponentObserver*> observers[TypeCount];
+    return observers[type];
+}
+
+void
+ComponentObserverRegistry::record(Entity* entity, Component* component, ComponentChange change) {
+    const ComponentType type = component->getType();
+    if (static_cast<size_t>(type) >= TypeCount) {
+        return;
+    }
+    for (ComponentObserver* observer : getObservers(type)) {
+        observer->m_changes.push_back(ComponentChangeRecord{ entity, component, change });
+    }
+}
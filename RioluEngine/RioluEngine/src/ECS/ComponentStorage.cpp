@@ -0,0 +1,78 @@
+#include "ECS/ComponentStorage.h"
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @file ComponentStorage.cpp
+ * @brief Implements page stamping and the component storage registry.
+ */
+
+uint32_t ComponentStorageRegistry::s_epoch = 1;
+uint64_t ComponentStorageRegistry::s_structureVersion = 0;
+
+std::vector<IComponentStorage*>&
+ComponentStorageRegistry::getStorages() {
+    static std::vector<IComponentStorage*> storages;
+    return storages;
+}
+
+uint64_t
+ComponentStorageRegistry::hashState() {
+    uint64_t hash = 14695981039346656037ull;
+    for (IComponentStorage* storage : getStorages()) {
+        const sf::Uint8* bytes = storage->getBytes();
+        for (size_t i = 0; i < storage->getByteSize(); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+size_t
+ComponentStorageRegistry::compact(double budgetMicroseconds) {
+    const std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::nanoseconds(static_cast<int64_t>(budgetMicroseconds * 1000.0));
+    size_t moved = 0;
+    for (IComponentStorage* storage : getStorages()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        moved += storage->compact(deadline);
+    }
+    return moved;
+}
+
+IComponentStorage::IComponentStorage(const char* name) : m_name(name) {
+    ComponentStorageRegistry::getStorages().push_back(this);
+}
+
+IComponentStorage::~IComponentStorage() {
+    std::vector<IComponentStorage*>& storages = ComponentStorageRegistry::getStorages();
+    storages.erase(std::remove(storages.begin(), storages.end(), this), storages.end());
+}
+
+void
+IComponentStorage::stampPage(size_t page) {
+    m_pageStamps[page] = ComponentStorageRegistry::getEpoch();
+}
+
+void
+IComponentStorage::markDirty(size_t offset, size_t size) {
+    // Parallel updates edit different slots that can share a page, so the stamp is
+    // written atomically. Checking first keeps an already stamped page's cache line
+    // shared instead of bouncing it between the writing threads.
+    const uint32_t epoch = ComponentStorageRegistry::getEpoch();
+    const size_t lastPage = (offset + size - 1) / PageSize;
+    for (size_t page = offset / PageSize; page <= lastPage; ++page) {
+        std::atomic_ref<uint32_t> stamp(m_pageStamps[page]);
+        if (stamp.load(std::memory_order_relaxed) != epoch) {
+            stamp.store(epoch, std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+IComponentStorage::resizePages() {
+    const size_t pageCount = (getByteSize() + PageSize - 1) / PageSize;
+    m_pageStamps.resize(pageCount, ComponentStorageRegistry::getEpoch());
+}
@@ -0,0 +1,173 @@
+#include "ECS/WorldSnapshot.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file WorldSnapshot.cpp
+ * @brief Implements full and dirty-page snapshots of the component storages.
+ */
+
+WorldSnapshotRing::WorldSnapshotRing(size_t capacity, SnapshotMode mode, float headroom)
+    : m_mode(mode),
+      m_headroom(headroom),
+      m_slots(capacity) {
+    if (capacity == 0) {
+        ERROR("WorldSnapshotRing", "WorldSnapshotRing", "Capacity must be at least one snapshot");
+    }
+    reserve();
+}
+
+void
+WorldSnapshotRing::reserve() {
+    const std::vector<IComponentStorage*>& storages = ComponentStorageRegistry::getStorages();
+    for (Slot& slot : m_slots) {
+        if (slot.images.size() < storages.size()) {
+            slot.images.resize(storages.size());
+        }
+        for (size_t i = 0; i < storages.size(); ++i) {
+            const size_t wanted = static_cast<size_t>(storages[i]->getByteSize() * (1.f + m_headroom));
+            if (slot.images[i].bytes.size() < wanted) {
+                slot.images[i].bytes.resize(wanted);
+            }
+        }
+    }
+}
+
+void
+WorldSnapshotRing::ensureCapacity(StorageImage& image, size_t size) {
+    if (image.bytes.size() < size) {
+        image.bytes.resize(static_cast<size_t>(size * (1.f + m_headroom)));
+        ++m_stats.reallocations;
+    }
+}
+
+WorldSnapshotRing::Slot*
+WorldSnapshotRing::findSlot(uint32_t frame) {
+    for (Slot& slot : m_slots) {
+        if (slot.valid && slot.frame == frame) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+bool
+WorldSnapshotRing::contains(uint32_t frame) const {
+    return std::any_of(m_slots.begin(), m_slots.end(),
+                       [frame](const Slot& slot) { return slot.valid && slot.frame == frame; });
+}
+
+/**
+ * @brief Writes the current state into the oldest slot.
+ *
+ * In DirtyPages mode the slot still holds the snapshot taken capacity saves ago,
+ * so only the pages stamped after that snapshot's epoch differ and are copied.
+ * The epoch is advanced afterwards: later writes are stamped with a newer epoch
+ * than the one recorded here.
+ */
+uint32_t
+WorldSnapshotRing::save() {
+    const std::vector<IComponentStorage*>& storages = ComponentStorageRegistry::getStorages();
+    Slot& slot = m_slots[m_next];
+    m_next = (m_next + 1) % m_slots.size();
+
+    if (slot.images.size() < storages.size()) {
+        slot.images.resize(storages.size());
+    }
+
+    size_t copied = 0;
+    for (size_t i = 0; i < storages.size(); ++i) {
+        IComponentStorage& storage = *storages[i];
+        StorageImage& image = slot.images[i];
+        const size_t size = storage.getByteSize();
+        ensureCapacity(image, size);
+
+        // Images follow the registration order; a storage that came or went shifts them.
+        const bool fullCopy = m_mode == SnapshotMode::Full || !slot.valid || image.size != size ||
+                              image.storage != &storage;
+        if (fullCopy) {
+            if (size > 0) {
+                std::memcpy(image.bytes.data(), storage.getBytes(), size);
+            }
+            copied += size;
+        }
+        else {
+            for (size_t page = 0; page < storage.getPageCount(); ++page) {
+                if (storage.getPageStamp(page) > slot.epoch) {
+                    const size_t offset = page * IComponentStorage::PageSize;
+                    const size_t length = std::min(IComponentStorage::PageSize, size - offset);
+                    std::memcpy(image.bytes.data() + offset, storage.getBytes() + offset, length);
+                    copied += length;
+                }
+            }
+        }
+        image.storage = &storage;
+        image.size = size;
+    }
+
+    slot.valid = true;
+    slot.frame = m_nextFrame++;
+    slot.epoch = ComponentStorageRegistry::advanceEpoch();
+    slot.structureVersion = ComponentStorageRegistry::getStructureVersion();
+    m_stats.lastSaveBytes = copied;
+    return slot.frame;
+}
+
+/**
+ * @brief Copies a snapshot back into the storages.
+ *
+ * In DirtyPages mode only the pages written after the snapshot's epoch are copied.
+ * Restored pages are stamped with the current epoch because, from the point of view
+ * of every other snapshot, they just changed.
+ */
+bool
+WorldSnapshotRing::restore(uint32_t frame) {
+    Slot* slot = findSlot(frame);
+    if (slot == nullptr) {
+        return false;
+    }
+    if (slot->structureVersion != ComponentStorageRegistry::getStructureVersion()) {
+        ++m_stats.rejectedRestores;
+        return false;
+    }
+
+    // A storage destroyed since the save shifts the registration order of the others.
+    const std::vector<IComponentStorage*>& storages = ComponentStorageRegistry::getStorages();
+    for (size_t i = 0; i < storages.size() && i < slot->images.size(); ++i) {
+        if (slot->images[i].storage != nullptr && slot->images[i].storage != storages[i]) {
+            ++m_stats.rejectedRestores;
+            return false;
+        }
+    }
+
+    size_t copied = 0;
+    for (size_t i = 0; i < storages.size() && i < slot->images.size(); ++i) {
+        IComponentStorage& storage = *storages[i];
+        const StorageImage& image = slot->images[i];
+        const size_t size = std::min(image.size, storage.getByteSize());
+
+        if (m_mode == SnapshotMode::Full && size > 0) {
+            std::memcpy(storage.getBytes(), image.bytes.data(), size);
+            copied += size;
+        }
+
+        for (size_t page = 0; page < storage.getPageCount(); ++page) {
+            const size_t offset = page * IComponentStorage::PageSize;
+            if (offset >= size) {
+                break;
+            }
+            if (storage.getPageStamp(page) <= slot->epoch) {
+                continue;
+            }
+            if (m_mode == SnapshotMode::DirtyPages) {
+                const size_t length = std::min(IComponentStorage::PageSize, size - offset);
+                std::memcpy(storage.getBytes() + offset, image.bytes.data() + offset, length);
+                copied += length;
+            }
+            storage.stampPage(page);
+        }
+    }
+
+    m_stats.lastRestoreBytes = copied;
+    return true;
+}
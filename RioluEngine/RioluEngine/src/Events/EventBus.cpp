@@ -0,0 +1,28 @@
+#include "Events/EventBus.h"
+
+/**
+ * @file EventBus.cpp
+ * @brief Implements the non-template parts of the event bus.
+ */
+
+void
+EventBus::unsubscribe(EventSubscription& subscription) {
+    if (subscription.isValid() && subscription.channel < m_channels.size() && m_channels[subscription.channel]) {
+        m_channels[subscription.channel]->unsubscribe(subscription.index, subscription.generation);
+    }
+    subscription = EventSubscription();
+}
+
+void
+EventBus::dispatch() {
+    // By index: a subscriber may create a channel while its own is dispatched.
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i]->dispatch();
+    }
+}
+
+uint32_t
+EventBus::nextTypeId() {
+    static std::atomic<uint32_t> next{ 0 };
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
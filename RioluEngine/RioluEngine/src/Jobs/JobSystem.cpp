@@ -0,0 +1,127 @@
+#include "Jobs/JobSystem.h"
+
+/**
+ * @file JobSystem.cpp
+ * @brief Implements the worker pool.
+ */
+
+namespace {
+    thread_local unsigned t_workerIndex = 0; ///< Index of the current worker, 0 off the pool.
+}
+
+void
+JobState::onComplete(std::function<void()> callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_done.load(std::memory_order_acquire)) {
+            m_callbacks.push_back(std::move(callback));
+            return;
+        }
+    }
+    callback();
+}
+
+void
+JobState::complete() {
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.store(true, std::memory_order_release);
+        callbacks.swap(m_callbacks);
+    }
+    for (std::function<void()>& callback : callbacks) {
+        callback();
+    }
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+    m_workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem() {
+    // Workers keep popping until the closed queue is empty.
+    m_queue.close();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+    // Without workers (or if they stopped first) the remaining jobs run here.
+    while (runPendingJob()) {
+    }
+}
+
+JobHandle
+JobSystem::schedule(std::function<void()> job) {
+    JobHandle state = std::make_shared<JobState>();
+    push({ std::move(job), state });
+    return state;
+}
+
+void
+JobSystem::submit(std::function<void()> job) {
+    push({ std::move(job), nullptr });
+}
+
+void
+JobSystem::wait(const JobHandle& job) {
+    while (job && !job->isDone()) {
+        if (!runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool
+JobSystem::runPendingJob() {
+    QueuedJob job;
+    if (!m_queue.tryPop(job)) {
+        return false;
+    }
+    execute(job);
+    return true;
+}
+
+unsigned
+JobSystem::getCurrentWorkerIndex() {
+    return t_workerIndex;
+}
+
+unsigned
+JobSystem::getDefaultWorkerCount() {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+void
+JobSystem::workerLoop(unsigned index) {
+    t_workerIndex = index;
+    QueuedJob job;
+    while (m_queue.pop(job)) {
+        execute(job);
+    }
+}
+
+void
+JobSystem::push(QueuedJob job) {
+    while (!m_queue.tryPush(std::move(job))) {
+        if (m_queue.isClosed()) {
+            // Shutting down: a job scheduling follow-up work must not wait for a slot.
+            execute(job);
+            return;
+        }
+        // Full: make room by doing some of the work ourselves.
+        if (!runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void
+JobSystem::execute(QueuedJob& job) {
+    job.function();
+    if (job.state) {
+        job.state->complete();
+    }
+}
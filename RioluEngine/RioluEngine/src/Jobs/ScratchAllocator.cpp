@@ -0,0 +1,121 @@
+#include "Jobs/ScratchAllocator.h"
+#include "Jobs/JobSystem.h"
+#include <algorithm>
+#include <mutex>
+
+/**
+ * @file ScratchAllocator.cpp
+ * @brief Implements the per-thread scratch allocator and its statistics registry.
+ */
+
+namespace {
+    /**
+     * @brief Every live allocator, for getAllStats(). Only touched when an allocator is
+     * created or destroyed and when statistics are collected.
+     */
+    struct ScratchRegistry {
+        std::mutex mutex;                           ///< Guards allocators.
+        std::vector<ScratchAllocator*> allocators;  ///< Live allocators.
+    };
+
+    ScratchRegistry&
+    getRegistry() {
+        static ScratchRegistry registry;
+        return registry;
+    }
+}
+
+ScratchAllocator&
+ScratchAllocator::get() {
+    thread_local ScratchAllocator allocator;
+    return allocator;
+}
+
+std::vector<ScratchStats>
+ScratchAllocator::getAllStats() {
+    ScratchRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<ScratchStats> stats;
+    stats.reserve(registry.allocators.size());
+    for (const ScratchAllocator* allocator : registry.allocators) {
+        stats.push_back(allocator->getStats());
+    }
+    return stats;
+}
+
+void
+ScratchAllocator::resetPeaks() {
+    ScratchRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ScratchAllocator* allocator : registry.allocators) {
+        allocator->m_peak.store(allocator->m_used.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+ScratchAllocator::ScratchAllocator(size_t capacity)
+    : m_buffer(static_cast<unsigned char*>(::operator new(capacity))),
+      m_capacity(capacity),
+      m_thread(JobSystem::getCurrentWorkerIndex()) {
+    ScratchRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.allocators.push_back(this);
+}
+
+ScratchAllocator::~ScratchAllocator() {
+    {
+        ScratchRegistry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.allocators.erase(std::find(registry.allocators.begin(), registry.allocators.end(), this));
+    }
+    rewind(Marker());
+    ::operator delete(m_buffer);
+}
+
+void
+ScratchAllocator::rewind(const Marker& marker) {
+    while (m_overflow.size() > marker.overflowBlocks) {
+        ::operator delete(m_overflow.back().data);
+        m_overflow.pop_back();
+    }
+    m_offset = marker.offset;
+    m_overflowOffset = marker.overflowOffset;
+    m_overflowUsed = 0;
+    for (size_t i = 0; i + 1 < m_overflow.size(); ++i) {
+        m_overflowUsed += m_overflow[i].size;
+    }
+    m_used.store(m_offset + m_overflowUsed + m_overflowOffset, std::memory_order_relaxed);
+}
+
+ScratchStats
+ScratchAllocator::getStats() const {
+    ScratchStats stats;
+    stats.thread = m_thread;
+    stats.capacity = m_capacity;
+    stats.used = m_used.load(std::memory_order_relaxed);
+    stats.peak = m_peak.load(std::memory_order_relaxed);
+    stats.overflowAllocations = m_overflowAllocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void*
+ScratchAllocator::allocateOverflow(size_t size, size_t alignment) {
+    m_overflowAllocations.store(m_overflowAllocations.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+    if (!m_overflow.empty()) {
+        const OverflowBlock& block = m_overflow.back();
+        const size_t aligned = alignOffset(block.data, m_overflowOffset, alignment);
+        if (aligned + size <= block.size) {
+            m_overflowOffset = aligned + size;
+            noteUsage();
+            return block.data + aligned;
+        }
+        m_overflowUsed += block.size;
+    }
+
+    const size_t blockSize = std::max(OverflowBlockSize, size + alignment);
+    m_overflow.push_back({ static_cast<unsigned char*>(::operator new(blockSize)), blockSize });
+    const size_t aligned = alignOffset(m_overflow.back().data, 0, alignment);
+    m_overflowOffset = aligned + size;
+    noteUsage();
+    return m_overflow.back().data + aligned;
+}
@@ -0,0 +1,248 @@
+#include "Jobs/TaskGraph.h"
+#include <algorithm>
+
+/**
+ * @file TaskGraph.cpp
+ * @brief Implements dependency-driven task execution, critical path and trace export.
+ */
+
+namespace {
+    const TaskId NoTask = ~TaskId(0);
+
+    /**
+     * @brief Writes @p text as a JSON string literal.
+     */
+    void
+    writeJsonString(std::ostream& output, const std::string& text) {
+        output << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                output << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                output << ' ';
+            }
+            else {
+                output << c;
+            }
+        }
+        output << '"';
+    }
+}
+
+TaskId
+TaskGraph::addTask(const std::string& name, std::function<void()> function) {
+    m_tasks.push_back({ name, std::move(function), {}, 0 });
+    m_validated = false;
+    return static_cast<TaskId>(m_tasks.size() - 1);
+}
+
+void
+TaskGraph::addDependency(TaskId before, TaskId after) {
+    if (before >= m_tasks.size() || after >= m_tasks.size() || before == after) {
+        ERROR("TaskGraph", "addDependency", "Invalid task id");
+        return;
+    }
+    m_tasks[before].successors.push_back(after);
+    ++m_tasks[after].predecessorCount;
+    m_validated = false;
+}
+
+void
+TaskGraph::clear() {
+    m_tasks.clear();
+    m_validated = false;
+    // Stats and trace events refer to tasks by id.
+    m_runs.clear();
+    m_stats = TaskGraphStats();
+    m_trace.clear();
+    m_tracing = false;
+}
+
+void
+TaskGraph::execute(JobSystem& jobs) {
+    if (!m_validated) {
+        validate();
+    }
+    if (m_tasks.empty()) {
+        m_stats = TaskGraphStats();
+        return;
+    }
+
+    for (size_t i = 0; i < m_tasks.size(); ++i) {
+        m_pending[i].store(m_tasks[i].predecessorCount, std::memory_order_relaxed);
+    }
+    m_remaining.store(static_cast<uint32_t>(m_tasks.size()), std::memory_order_relaxed);
+    m_jobs = &jobs;
+    m_frameStart = Clock::now();
+
+    // Queue every root but the first, which starts on this thread right away.
+    for (size_t i = 1; i < m_roots.size(); ++i) {
+        submit(m_roots[i]);
+    }
+    run(m_roots[0]);
+    while (m_remaining.load(std::memory_order_acquire) != 0) {
+        if (!jobs.runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    const double frameTime = std::chrono::duration<double, std::micro>(Clock::now() - m_frameStart).count();
+    m_jobs = nullptr;
+    computeStats(frameTime);
+    if (m_tracing) {
+        recordTrace();
+    }
+}
+
+void
+TaskGraph::beginTrace() {
+    m_trace.clear();
+    m_tracing = true;
+    m_traceStart = Clock::now();
+}
+
+bool
+TaskGraph::endTrace(const std::string& path) {
+    m_tracing = false;
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    writeTrace(file);
+    return static_cast<bool>(file);
+}
+
+void
+TaskGraph::writeTrace(std::ostream& output) const {
+    output << "{\"traceEvents\":[\n";
+    // Name the rows: 0 is the thread that called execute(), 1..N the workers.
+    unsigned maxThread = 0;
+    for (const TraceEvent& event : m_trace) {
+        maxThread = std::max(maxThread, event.thread);
+    }
+    for (unsigned thread = 0; thread <= maxThread; ++thread) {
+        output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread
+               << ",\"args\":{\"name\":\""
+               << (thread == 0 ? std::string("main") : "worker " + std::to_string(thread))
+               << "\"}},\n";
+    }
+    for (const TraceEvent& event : m_trace) {
+        output << "{\"name\":";
+        writeJsonString(output, m_tasks[event.task].name);
+        output << ",\"cat\":\"" << (event.critical ? "critical" : "task")
+               << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+               << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "},\n";
+    }
+    output << "{\"name\":\"end\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":0}\n]}\n";
+}
+
+void
+TaskGraph::validate() {
+    // Kahn's algorithm: repeatedly take the tasks whose predecessors are all placed.
+    const size_t count = m_tasks.size();
+    std::vector<uint32_t> waiting(count);
+    m_roots.clear();
+    m_order.clear();
+    m_order.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        waiting[i] = m_tasks[i].predecessorCount;
+        if (waiting[i] == 0) {
+            m_roots.push_back(static_cast<TaskId>(i));
+            m_order.push_back(static_cast<TaskId>(i));
+        }
+    }
+    for (size_t next = 0; next < m_order.size(); ++next) {
+        for (TaskId successor : m_tasks[m_order[next]].successors) {
+            if (--waiting[successor] == 0) {
+                m_order.push_back(successor);
+            }
+        }
+    }
+    if (m_order.size() != count) {
+        ERROR("TaskGraph", "validate", "The task dependencies contain a cycle");
+    }
+
+    m_pending.reset(new std::atomic<uint32_t>[count]);
+    m_runs.assign(count, TaskRun());
+    m_validated = true;
+}
+
+void
+TaskGraph::submit(TaskId task) {
+    m_jobs->submit([this, task]() { run(task); });
+}
+
+void
+TaskGraph::run(TaskId task) {
+    while (task != NoTask) {
+        TaskRun& record = m_runs[task];
+        record.thread = JobSystem::getCurrentWorkerIndex();
+        record.start = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_frameStart).count();
+        m_tasks[task].function();
+        record.end = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_frameStart).count();
+
+        // Keep one released successor for this thread and queue the rest.
+        TaskId next = NoTask;
+        for (TaskId successor : m_tasks[task].successors) {
+            if (m_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (next != NoTask) {
+                    submit(next);
+                }
+                next = successor;
+            }
+        }
+        // After the last decrement execute() may return, so nothing of the graph may be
+        // touched past this point unless a successor is still to run.
+        m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+        task = next;
+    }
+}
+
+void
+TaskGraph::computeStats(double frameTime) {
+    const size_t count = m_tasks.size();
+    // Longest chain ending at each task, and the predecessor it came through.
+    std::vector<double> chain(count, 0.0);
+    std::vector<TaskId> previous(count, NoTask);
+    std::vector<double> reach(count, 0.0);
+
+    m_stats.frameTime = frameTime;
+    m_stats.workTime = 0.0;
+    TaskId last = NoTask;
+    for (TaskId task : m_order) {
+        const double duration = (m_runs[task].end - m_runs[task].start) / 1000.0;
+        m_stats.workTime += duration;
+        chain[task] = reach[task] + duration;
+        for (TaskId successor : m_tasks[task].successors) {
+            if (chain[task] > reach[successor] || previous[successor] == NoTask) {
+                reach[successor] = chain[task];
+                previous[successor] = task;
+            }
+        }
+        if (last == NoTask || chain[task] > chain[last]) {
+            last = task;
+        }
+    }
+
+    m_stats.criticalPathTime = chain[last];
+    m_stats.criticalPath.clear();
+    for (TaskId task = last; task != NoTask; task = previous[task]) {
+        m_stats.criticalPath.push_back(task);
+    }
+    std::reverse(m_stats.criticalPath.begin(), m_stats.criticalPath.end());
+}
+
+void
+TaskGraph::recordTrace() {
+    std::vector<bool> critical(m_tasks.size(), false);
+    for (TaskId task : m_stats.criticalPath) {
+        critical[task] = true;
+    }
+    const double offset = std::chrono::duration<double, std::micro>(m_frameStart - m_traceStart).count();
+    for (TaskId task = 0; task < m_tasks.size(); ++task) {
+        const TaskRun& run = m_runs[task];
+        m_trace.push_back({ task, offset + run.start / 1000.0, (run.end - run.start) / 1000.0,
+                            run.thread, critical[task] });
+    }
+}
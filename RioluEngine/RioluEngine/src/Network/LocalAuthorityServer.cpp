@@ -0,0 +1,69 @@
+#include "Network/LocalAuthorityServer.h"
+
+/**
+ * @file LocalAuthorityServer.cpp
+ * @brief Implements the loopback authoritative server stand-in.
+ */
+
+LocalAuthorityServer::LocalAuthorityServer(const sf::Vector2f& spawnPosition, unsigned int latencyTicks)
+    : m_position(spawnPosition),
+      m_latencyTicks(latencyTicks) {
+}
+
+bool
+LocalAuthorityServer::bind(unsigned short port) {
+    if (m_socket.bind(port, sf::IpAddress::LocalHost) != sf::Socket::Done) {
+        return false;
+    }
+    m_socket.setBlocking(false);
+    return true;
+}
+
+/**
+ * @brief One server tick.
+ *
+ * Every datagram carries the last few unacknowledged commands, so duplicates are
+ * skipped by sequence number and a lost datagram is covered by the next one.
+ * One state is queued per tick in which at least one command was applied.
+ */
+void
+LocalAuthorityServer::tick() {
+    ++m_tick;
+    bool simulated = false;
+
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+    while (m_socket.receive(m_packet, sender, senderPort) == sf::Socket::Done) {
+        m_clientAddress = sender;
+        m_clientPort = senderPort;
+
+        sf::Uint8 count = 0;
+        m_packet >> count;
+        for (sf::Uint8 i = 0; i < count; ++i) {
+            MovementCommand command;
+            if (!(m_packet >> command)) {
+                break;
+            }
+            if (command.sequence <= m_lastProcessed) {
+                continue;
+            }
+            m_position = MovementSimulation::step(m_position, command);
+            m_lastProcessed = command.sequence;
+            simulated = true;
+        }
+    }
+
+    if (simulated) {
+        MovementState state;
+        state.lastProcessedSequence = m_lastProcessed;
+        state.position = m_position;
+        m_outgoing.push_back({ m_tick + m_latencyTicks, state });
+    }
+
+    while (!m_outgoing.empty() && m_outgoing.front().sendTick <= m_tick && m_clientPort != 0) {
+        m_packet.clear();
+        m_packet << m_outgoing.front().state;
+        m_socket.send(m_packet, m_clientAddress, m_clientPort);
+        m_outgoing.pop_front();
+    }
+}
@@ -0,0 +1,161 @@
+#include "Network/MovementPrediction.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file MovementPrediction.cpp
+ * @brief Implements the deterministic movement step and client-side reconciliation.
+ */
+
+sf::Packet&
+operator<<(sf::Packet& packet, const MovementCommand& command) {
+    return packet << command.sequence << command.target.x << command.target.y
+                  << command.speed << command.range;
+}
+
+sf::Packet&
+operator>>(sf::Packet& packet, MovementCommand& command) {
+    return packet >> command.sequence >> command.target.x >> command.target.y
+                  >> command.speed >> command.range;
+}
+
+sf::Packet&
+operator<<(sf::Packet& packet, const MovementState& state) {
+    return packet << state.lastProcessedSequence << state.position.x << state.position.y;
+}
+
+sf::Packet&
+operator>>(sf::Packet& packet, MovementState& state) {
+    return packet >> state.lastProcessedSequence >> state.position.x >> state.position.y;
+}
+
+sf::Vector2f
+MovementSimulation::step(const sf::Vector2f& position, const MovementCommand& command) {
+    return Transform::seekStep(position, command.target, command.speed, FixedStep, command.range);
+}
+
+ClientPrediction::ClientPrediction(const EngineUtilities::TSharedPointer<Transform>& transform,
+                                   const PredictionSettings& settings)
+    : m_transform(transform),
+      m_settings(settings) {
+    if (m_transform.isNull()) {
+        ERROR("ClientPrediction", "ClientPrediction", "Transform is null");
+    }
+    if (m_settings.redundancy > PredictionSettings::MaxRedundancy) {
+        ERROR("ClientPrediction", "ClientPrediction",
+              "Redundancy " << m_settings.redundancy << " exceeds " << PredictionSettings::MaxRedundancy);
+    }
+    m_predictedPosition = m_transform->getPosition();
+}
+
+/**
+ * @brief Samples input at the fixed step and predicts each command immediately.
+ *
+ * If the server stops answering and the history fills up, the oldest command is
+ * dropped; the next authoritative state then snaps or smooths the difference.
+ */
+int
+ClientPrediction::update(float deltaTime, const sf::Vector2f& target, float speed, float range) {
+    int issued = 0;
+    m_accumulator += deltaTime;
+
+    while (m_accumulator >= MovementSimulation::FixedStep) {
+        m_accumulator -= MovementSimulation::FixedStep;
+
+        MovementCommand command;
+        command.sequence = m_nextSequence++;
+        command.target = target;
+        command.speed = speed;
+        command.range = range;
+
+        if (m_historyCount == HistoryCapacity) {
+            m_historyStart = (m_historyStart + 1) % HistoryCapacity;
+            --m_historyCount;
+        }
+        m_history[(m_historyStart + m_historyCount) % HistoryCapacity] = command;
+        ++m_historyCount;
+
+        m_predictedPosition = MovementSimulation::step(m_predictedPosition, command);
+        ++m_stats.commandsIssued;
+        ++issued;
+    }
+
+    m_errorOffset *= std::exp(-m_settings.smoothingRate * deltaTime);
+    m_transform->setPosition(getVisualPosition());
+    return issued;
+}
+
+/**
+ * @brief Rewinds to the authoritative state and replays the unacknowledged commands.
+ *
+ * The difference between the old and the replayed prediction is added to the visual
+ * offset instead of being applied at once, unless it is larger than snapDistance.
+ */
+void
+ClientPrediction::reconcile(const MovementState& state) {
+    if (state.lastProcessedSequence < m_lastAcknowledged) {
+        return; // Out of order datagram, a newer state was already applied.
+    }
+    ++m_stats.statesReceived;
+    m_lastAcknowledged = state.lastProcessedSequence;
+
+    while (m_historyCount > 0 && historyAt(0).sequence <= state.lastProcessedSequence) {
+        m_historyStart = (m_historyStart + 1) % HistoryCapacity;
+        --m_historyCount;
+    }
+
+    sf::Vector2f corrected = state.position;
+    for (size_t i = 0; i < m_historyCount; ++i) {
+        corrected = MovementSimulation::step(corrected, historyAt(i));
+    }
+    m_stats.replayedCommands += m_historyCount;
+
+    const sf::Vector2f error = m_predictedPosition - corrected;
+    const float errorLength = std::sqrt(error.x * error.x + error.y * error.y);
+    if (errorLength > 0.0001f) {
+        ++m_stats.corrections;
+        m_stats.lastError = errorLength;
+        m_stats.maxError = std::max(m_stats.maxError, errorLength);
+
+        if (errorLength > m_settings.snapDistance) {
+            m_errorOffset = sf::Vector2f(0.f, 0.f);
+            ++m_stats.snaps;
+        }
+        else {
+            m_errorOffset += error;
+        }
+    }
+    m_predictedPosition = corrected;
+}
+
+void
+ClientPrediction::sendCommands(sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port) {
+    if (m_historyCount == 0) {
+        return;
+    }
+
+    const size_t count = std::min<size_t>(m_historyCount, m_settings.redundancy);
+    m_packet.clear();
+    m_packet << static_cast<sf::Uint8>(count);
+    for (size_t i = m_historyCount - count; i < m_historyCount; ++i) {
+        m_packet << historyAt(i);
+    }
+    socket.send(m_packet, address, port);
+}
+
+int
+ClientPrediction::receiveStates(sf::UdpSocket& socket) {
+    int processed = 0;
+    sf::Packet packet;
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+
+    while (socket.receive(packet, sender, senderPort) == sf::Socket::Done) {
+        MovementState state;
+        if (packet >> state) {
+            reconcile(state);
+            ++processed;
+        }
+    }
+    return processed;
+}
@@ -0,0 +1,106 @@
+#include "Network/PacketBatcher.h"
+
+/**
+ * @file PacketBatcher.cpp
+ * @brief Implements message batching into pooled datagrams.
+ */
+
+PacketBatcher::PacketBatcher(PacketPool& pool, sf::UdpSocket& socket,
+                             const sf::IpAddress& address, unsigned short port)
+    : m_pool(pool),
+      m_socket(socket),
+      m_address(address),
+      m_port(port) {
+}
+
+PacketBatcher::~PacketBatcher() {
+    flush();
+    m_pool.release(m_block);
+}
+
+BitWriter
+PacketBatcher::beginMessage(uint32_t maxBytes) {
+    if (m_block != nullptr && m_block->size + MessageHeaderSize + maxBytes > m_block->capacity) {
+        flush();
+    }
+    if (m_block == nullptr) {
+        m_block = m_pool.acquire();
+        if (m_block == nullptr) {
+            return BitWriter();
+        }
+    }
+
+    const uint32_t payloadOffset = m_block->size + MessageHeaderSize;
+    const uint32_t room = m_block->capacity > payloadOffset ? m_block->capacity - payloadOffset : 0;
+    return BitWriter(m_block->data + payloadOffset, room);
+}
+
+bool
+PacketBatcher::endMessage(BitWriter& writer) {
+    const uint32_t payloadSize = writer.flush();
+    if (writer.hasOverflowed() || m_block == nullptr || payloadSize > 0xFFFF) {
+        ++m_stats.dropped;
+        return false;
+    }
+
+    sf::Uint8* header = m_block->data + m_block->size;
+    header[0] = static_cast<sf::Uint8>(payloadSize & 0xFF);
+    header[1] = static_cast<sf::Uint8>(payloadSize >> 8);
+    m_block->size += MessageHeaderSize + payloadSize;
+    ++m_stats.messages;
+    return true;
+}
+
+/**
+ * @brief Sends the block and keeps it for the next batch.
+ *
+ * UdpSocket::send copies the bytes into the kernel before returning, so the block
+ * can be reused right away instead of going back to the pool.
+ */
+void
+PacketBatcher::flush() {
+    if (m_block == nullptr || m_block->size == 0) {
+        return;
+    }
+
+    if (m_socket.send(m_block->data, m_block->size, m_address, m_port) == sf::Socket::Done) {
+        ++m_stats.datagrams;
+        m_stats.bytes += m_block->size;
+    }
+    m_block->size = 0;
+}
+
+PacketBlock*
+PacketBatcher::receive(sf::UdpSocket& socket, PacketPool& pool,
+                       sf::IpAddress& sender, unsigned short& senderPort) {
+    PacketBlock* block = pool.acquire();
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    std::size_t received = 0;
+    if (socket.receive(block->data, block->capacity, received, sender, senderPort) != sf::Socket::Done) {
+        pool.release(block);
+        return nullptr;
+    }
+    block->size = static_cast<uint32_t>(received);
+    return block;
+}
+
+bool
+MessageIterator::next(BitReader& reader) {
+    if (m_offset + PacketBatcher::MessageHeaderSize > m_block.size) {
+        return false;
+    }
+
+    const sf::Uint8* header = m_block.data + m_offset;
+    const uint32_t payloadSize = static_cast<uint32_t>(header[0]) | (static_cast<uint32_t>(header[1]) << 8);
+    const uint32_t payloadOffset = m_offset + PacketBatcher::MessageHeaderSize;
+    if (payloadOffset + payloadSize > m_block.size) {
+        return false;
+    }
+
+    reader = BitReader(m_block.data + payloadOffset, payloadSize);
+    m_offset = payloadOffset + payloadSize;
+    return true;
+}
@@ -0,0 +1,57 @@
+#include "Network/PacketPool.h"
+
+/**
+ * @file PacketPool.cpp
+ * @brief Implements the preallocated datagram buffer pool.
+ */
+
+PacketPool::PacketPool(uint32_t blockSize, uint32_t blockCount)
+    : m_blockSize(blockSize),
+      m_storage(static_cast<size_t>(blockSize) * blockCount),
+      m_blocks(blockCount) {
+    if (blockSize == 0 || blockCount == 0) {
+        ERROR("PacketPool", "PacketPool", "Block size and block count must be positive");
+    }
+
+    m_freeList.reserve(blockCount);
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        m_blocks[i].data = m_storage.data() + static_cast<size_t>(i) * blockSize;
+        m_blocks[i].capacity = blockSize;
+        m_blocks[i].index = i;
+        // Pushed in reverse so the first acquire() returns block 0.
+        m_freeList.push_back(blockCount - 1 - i);
+    }
+}
+
+PacketBlock*
+PacketPool::acquire() {
+    if (m_freeList.empty()) {
+        ++m_stats.exhausted;
+        return nullptr;
+    }
+
+    PacketBlock* block = &m_blocks[m_freeList.back()];
+    m_freeList.pop_back();
+    block->size = 0;
+
+    ++m_stats.acquired;
+    ++m_stats.inUse;
+    if (m_stats.inUse > m_stats.peakInUse) {
+        m_stats.peakInUse = m_stats.inUse;
+    }
+    return block;
+}
+
+void
+PacketPool::release(PacketBlock* block) {
+    if (block == nullptr) {
+        return;
+    }
+    if (block->index >= m_blocks.size() || &m_blocks[block->index] != block) {
+        ERROR("PacketPool", "release", "Block does not belong to this pool");
+    }
+
+    // The free list was reserved for every block, so this never reallocates.
+    m_freeList.push_back(block->index);
+    --m_stats.inUse;
+}
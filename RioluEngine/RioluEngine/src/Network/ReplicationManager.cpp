@@ -0,0 +1,344 @@
+#include "Network/ReplicationManager.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file ReplicationManager.cpp
+ * @brief Implements relevance sets, priority accumulators and per-client byte budgets.
+ */
+
+namespace {
+    /**
+     * @brief Drops the pending removal of an actor that entered the view again.
+     */
+    void
+    cancelPendingRemoval(std::vector<NetworkId>& removals, NetworkId id) {
+        if (removals.empty()) {
+            return;
+        }
+        auto pending = std::find(removals.begin(), removals.end(), id);
+        if (pending != removals.end()) {
+            removals.erase(pending);
+        }
+    }
+}
+
+ReplicationManager::ReplicationManager(const sf::FloatRect& worldBounds,
+                                       float cellSize,
+                                       const ReplicationSettings& settings)
+    : m_settings(settings),
+      m_grid(worldBounds, cellSize) {
+    if (m_settings.bytesPerClientPerTick < HeaderSize + UpdateSize ||
+        m_settings.bytesPerClientPerTick > sf::UdpSocket::MaxDatagramSize) {
+        ERROR("ReplicationManager", "ReplicationManager", "Byte budget must fit one update and one datagram");
+    }
+}
+
+NetworkId
+ReplicationManager::registerActor(const EngineUtilities::TSharedPointer<Actor>& actor) {
+    if (actor.isNull()) {
+        ERROR("ReplicationManager", "registerActor", "Actor is null");
+    }
+
+    EngineUtilities::TSharedPointer<Transform> transform = actor->getComponent<Transform>();
+    if (transform.isNull()) {
+        ERROR("ReplicationManager", "registerActor", "Actor has no Transform component");
+    }
+
+    const NetworkId id = m_nextNetworkId++;
+    m_slotById[id] = static_cast<uint32_t>(m_actors.size());
+    m_actors.push_back(actor);
+    m_transforms.push_back(transform);
+    m_networkIds.push_back(id);
+    m_positions.push_back(transform->getPosition());
+    m_previousPositions.push_back(transform->getPosition());
+    m_speeds.push_back(0.f);
+    return id;
+}
+
+/**
+ * @brief Swap-removes the actor from the dense arrays.
+ *
+ * Client relevance entries are keyed by NetworkId and get their slot refreshed on
+ * the next tick, so the moved actor does not need any fix-up there. The removed
+ * actor disappears from the grid and therefore shows up as a removal for every
+ * client that had it in view.
+ */
+void
+ReplicationManager::unregisterActor(NetworkId id) {
+    auto it = m_slotById.find(id);
+    if (it == m_slotById.end()) {
+        return;
+    }
+
+    const uint32_t slot = it->second;
+    const uint32_t last = static_cast<uint32_t>(m_actors.size() - 1);
+    m_slotById.erase(it);
+
+    if (slot != last) {
+        m_actors[slot] = m_actors[last];
+        m_transforms[slot] = m_transforms[last];
+        m_networkIds[slot] = m_networkIds[last];
+        m_positions[slot] = m_positions[last];
+        m_previousPositions[slot] = m_previousPositions[last];
+        m_speeds[slot] = m_speeds[last];
+        m_slotById[m_networkIds[slot]] = slot;
+    }
+
+    m_actors.pop_back();
+    m_transforms.pop_back();
+    m_networkIds.pop_back();
+    m_positions.pop_back();
+    m_previousPositions.pop_back();
+    m_speeds.pop_back();
+}
+
+ClientId
+ReplicationManager::addClient(const sf::IpAddress& address, unsigned short port) {
+    ClientState client;
+    client.id = m_nextClientId++;
+    client.address = address;
+    client.port = port;
+    client.viewRadius = m_settings.defaultViewRadius;
+    m_clients.push_back(client);
+    return client.id;
+}
+
+void
+ReplicationManager::removeClient(ClientId id) {
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                   [id](const ClientState& client) { return client.id == id; }),
+                    m_clients.end());
+}
+
+void
+ReplicationManager::setClientView(ClientId id, const sf::Vector2f& center, float radius) {
+    ClientState& client = findClient(id, "setClientView");
+    client.viewCenter = center;
+    client.viewRadius = radius;
+}
+
+ReplicationManager::ClientState&
+ReplicationManager::findClient(ClientId id, const char* method) {
+    for (ClientState& client : m_clients) {
+        if (client.id == id) {
+            return client;
+        }
+    }
+    ERROR("ReplicationManager", method, "Unknown client id");
+}
+
+const ReplicationManager::ClientState&
+ReplicationManager::findClient(ClientId id, const char* method) const {
+    for (const ClientState& client : m_clients) {
+        if (client.id == id) {
+            return client;
+        }
+    }
+    ERROR("ReplicationManager", method, "Unknown client id");
+}
+
+const sf::Packet&
+ReplicationManager::getClientPacket(ClientId id) const {
+    return findClient(id, "getClientPacket").packet;
+}
+
+size_t
+ReplicationManager::getRelevantCount(ClientId id) const {
+    return findClient(id, "getRelevantCount").relevant.size();
+}
+
+void
+ReplicationManager::tick(float deltaTime) {
+    m_stats = ReplicationStats();
+    ++m_tick;
+
+    sf::Clock clock;
+    const float invDeltaTime = deltaTime > 0.f ? 1.f / deltaTime : 0.f;
+    for (size_t i = 0; i < m_actors.size(); ++i) {
+        const sf::Vector2f position = m_transforms[i]->getPosition();
+        const sf::Vector2f delta = position - m_previousPositions[i];
+        m_speeds[i] = std::sqrt(delta.x * delta.x + delta.y * delta.y) * invDeltaTime;
+        m_previousPositions[i] = position;
+        m_positions[i] = position;
+    }
+
+    m_grid.build(m_positions);
+    for (ClientState& client : m_clients) {
+        updateRelevance(client);
+    }
+    m_stats.relevanceMicros = static_cast<float>(clock.getElapsedTime().asMicroseconds());
+
+    for (ClientState& client : m_clients) {
+        writeClientPacket(client, deltaTime);
+    }
+}
+
+/**
+ * @brief Replaces the relevance set of a client with the actors found in its view.
+ *
+ * Both the previous set and the query result are sorted by NetworkId, so a single
+ * merge carries the accumulators of actors that stay relevant and reports the ones
+ * that left as removals. Actors entering the view start with a high accumulator so
+ * they are sent on their first relevant tick.
+ */
+void
+ReplicationManager::updateRelevance(ClientState& client) {
+    m_querySlots.clear();
+    m_grid.queryCircle(client.viewCenter, client.viewRadius, m_querySlots);
+
+    m_mergedEntries.clear();
+    for (uint32_t slot : m_querySlots) {
+        m_mergedEntries.push_back({ m_networkIds[slot], slot, m_settings.enterPriority });
+    }
+    std::sort(m_mergedEntries.begin(), m_mergedEntries.end(),
+              [](const RelevantEntry& a, const RelevantEntry& b) { return a.id < b.id; });
+
+    const std::vector<RelevantEntry>& previous = client.relevant;
+    size_t oldIndex = 0;
+    size_t newIndex = 0;
+    while (oldIndex < previous.size() && newIndex < m_mergedEntries.size()) {
+        if (previous[oldIndex].id == m_mergedEntries[newIndex].id) {
+            m_mergedEntries[newIndex].accumulator = previous[oldIndex].accumulator;
+            ++oldIndex;
+            ++newIndex;
+        }
+        else if (previous[oldIndex].id < m_mergedEntries[newIndex].id) {
+            client.removals.push_back(previous[oldIndex].id);
+            ++oldIndex;
+        }
+        else {
+            // Entering actor. If its removal is still waiting for budget, cancel it.
+            cancelPendingRemoval(client.removals, m_mergedEntries[newIndex].id);
+            ++newIndex;
+        }
+    }
+    for (; oldIndex < previous.size(); ++oldIndex) {
+        client.removals.push_back(previous[oldIndex].id);
+    }
+    for (; newIndex < m_mergedEntries.size(); ++newIndex) {
+        cancelPendingRemoval(client.removals, m_mergedEntries[newIndex].id);
+    }
+
+    // The old buffer becomes the scratch buffer of the next client, keeping its capacity.
+    client.relevant.swap(m_mergedEntries);
+    m_stats.relevantPairs += client.relevant.size();
+}
+
+/**
+ * @brief Fills the packet of a client with the highest-priority updates that fit.
+ *
+ * Accumulators grow by deltaTime scaled by distance (closer is more important) and
+ * speed (fast movers drift from the client's copy sooner). Removals are written first,
+ * then the top-N accumulators are picked with nth_element, N being what is left of the
+ * byte budget. Sent actors reset their accumulator; deferred ones keep growing.
+ */
+void
+ReplicationManager::writeClientPacket(ClientState& client, float deltaTime) {
+    sf::Clock clock;
+
+    const float invRadius = 1.f / std::max(client.viewRadius, 1.f);
+    const float distanceRange = 1.f - m_settings.minDistanceFactor;
+    for (RelevantEntry& entry : client.relevant) {
+        const sf::Vector2f offset = m_positions[entry.slot] - client.viewCenter;
+        const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+        const float distanceFactor = 1.f - std::min(distance * invRadius, 1.f) * distanceRange;
+        const float velocityFactor = 1.f + m_settings.velocityWeight * m_speeds[entry.slot];
+        entry.accumulator += deltaTime * distanceFactor * velocityFactor;
+    }
+
+    uint32_t budget = m_settings.bytesPerClientPerTick - HeaderSize;
+    const uint32_t removalCount = std::min(static_cast<uint32_t>(client.removals.size()),
+                                           budget / RemovalSize);
+    budget -= removalCount * RemovalSize;
+    const uint32_t maxUpdates = budget / UpdateSize;
+
+    m_selection.resize(client.relevant.size());
+    for (uint32_t i = 0; i < m_selection.size(); ++i) {
+        m_selection[i] = i;
+    }
+    if (m_selection.size() > maxUpdates) {
+        const std::vector<RelevantEntry>& relevant = client.relevant;
+        std::nth_element(m_selection.begin(), m_selection.begin() + maxUpdates, m_selection.end(),
+                         [&relevant](uint32_t a, uint32_t b) {
+                             return relevant[a].accumulator > relevant[b].accumulator;
+                         });
+        m_selection.resize(maxUpdates);
+    }
+    m_stats.priorityMicros += static_cast<float>(clock.restart().asMicroseconds());
+
+    sf::Packet& packet = client.packet;
+    packet.clear();
+    packet << static_cast<sf::Uint32>(m_tick)
+           << static_cast<sf::Uint16>(removalCount)
+           << static_cast<sf::Uint16>(m_selection.size());
+
+    for (uint32_t i = 0; i < removalCount; ++i) {
+        packet << static_cast<sf::Uint32>(client.removals[i]);
+    }
+    client.removals.erase(client.removals.begin(), client.removals.begin() + removalCount);
+
+    m_updateBytes.resize(m_selection.size() * UpdateSize);
+    BitWriter writer(m_updateBytes.data(), static_cast<uint32_t>(m_updateBytes.size()));
+    for (uint32_t index : m_selection) {
+        RelevantEntry& entry = client.relevant[index];
+        writer.writeUint32(static_cast<sf::Uint32>(entry.id));
+        TransformFields::write(writer, m_transforms[entry.slot]->getData());
+        entry.accumulator = 0.f;
+    }
+    packet.append(m_updateBytes.data(), writer.flush());
+
+    m_stats.removalsSent += removalCount;
+    m_stats.updatesSent += m_selection.size();
+    m_stats.updatesDeferred += client.relevant.size() - m_selection.size();
+    m_stats.bytesWritten += packet.getDataSize();
+    m_stats.serializeMicros += static_cast<float>(clock.getElapsedTime().asMicroseconds());
+}
+
+bool
+ReplicationManager::readPacket(sf::Packet& packet, ReplicationPacket& contents) {
+    sf::Uint32 tick = 0;
+    sf::Uint16 removalCount = 0;
+    sf::Uint16 updateCount = 0;
+    if (!(packet >> tick >> removalCount >> updateCount)) {
+        return false;
+    }
+    contents.tick = tick;
+
+    contents.removals.resize(removalCount);
+    for (NetworkId& id : contents.removals) {
+        sf::Uint32 value = 0;
+        if (!(packet >> value)) {
+            return false;
+        }
+        id = value;
+    }
+
+    const size_t offset = packet.getReadPosition();
+    if (packet.getDataSize() - offset < static_cast<size_t>(updateCount) * UpdateSize) {
+        return false;
+    }
+    BitReader reader(static_cast<const sf::Uint8*>(packet.getData()) + offset,
+                     static_cast<uint32_t>(packet.getDataSize() - offset));
+    contents.updates.resize(updateCount);
+    for (ReplicatedUpdate& update : contents.updates) {
+        update.id = reader.readUint32();
+        update.data = TransformData();
+        TransformFields::read(reader, update.data);
+    }
+    return !reader.hasOverflowed();
+}
+
+void
+ReplicationManager::send(sf::UdpSocket& socket) {
+    sf::Clock clock;
+    for (ClientState& client : m_clients) {
+        if (client.packet.getDataSize() <= HeaderSize) {
+            continue;
+        }
+        if (socket.send(client.packet, client.address, client.port) == sf::Socket::Done) {
+            m_stats.bytesSent += client.packet.getDataSize();
+        }
+    }
+    m_stats.sendMicros = static_cast<float>(clock.getElapsedTime().asMicroseconds());
+}
@@ -0,0 +1,388 @@
+#include "Scripting/ScriptVM.h"
+#include <cstdlib>
+#include <unordered_map>
+
+/**
+ * @file ScriptAssembler.cpp
+ * @brief Implements the text assembler for script bytecode.
+ *
+ * Errors are returned instead of raised: scripts are content, and a typo in one
+ * should be reported, not end the game.
+ */
+
+namespace {
+    /**
+     * @brief Packs an instruction with 8-bit operands.
+     */
+    uint32_t
+    encode(ScriptOp op, uint32_t a, uint32_t b = 0, uint32_t c = 0) {
+        return static_cast<uint32_t>(op) | (a << 8) | (b << 16) | (c << 24);
+    }
+
+    /**
+     * @brief Packs an instruction with a 16-bit operand.
+     */
+    uint32_t
+    encodeWide(ScriptOp op, uint32_t a, uint32_t bc) {
+        return static_cast<uint32_t>(op) | (a << 8) | ((bc & 0xFFFF) << 16);
+    }
+
+    /**
+     * @brief Returns true if @p op writes its register a.
+     */
+    bool
+    writesRegister(ScriptOp op) {
+        switch (op) {
+        case ScriptOp::Halt:
+        case ScriptOp::StoreF32:
+        case ScriptOp::StoreU8:
+        case ScriptOp::StoreU16:
+        case ScriptOp::Jump:
+        case ScriptOp::JumpIfZero:
+        case ScriptOp::ForEach:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    static_assert(ScriptVM::RegisterCount <= 32, "A foreach masks the registers it writes in one code word");
+
+    /**
+     * @brief Splits a line in whitespace-separated tokens, dropping the comment.
+     */
+    std::vector<std::string>
+    tokenize(const std::string& line) {
+        std::vector<std::string> tokens;
+        std::istringstream stream(line.substr(0, line.find('#')));
+        std::string token;
+        while (stream >> token) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Parses "rN"; returns false if it is not a valid register.
+     */
+    bool
+    parseRegister(const std::string& token, uint32_t& reg) {
+        if (token.size() < 2 || token[0] != 'r') {
+            return false;
+        }
+        char* end = nullptr;
+        const long value = std::strtol(token.c_str() + 1, &end, 10);
+        if (*end != '\0' || value < 0 || value >= static_cast<long>(ScriptVM::RegisterCount)) {
+            return false;
+        }
+        reg = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    /**
+     * @brief Instructions written `op rD rA rB`.
+     */
+    const std::unordered_map<std::string, ScriptOp>&
+    binaryOps() {
+        static const std::unordered_map<std::string, ScriptOp> ops = {
+            { "add", ScriptOp::AddF }, { "sub", ScriptOp::SubF }, { "mul", ScriptOp::MulF },
+            { "div", ScriptOp::DivF }, { "min", ScriptOp::MinF }, { "max", ScriptOp::MaxF },
+            { "madd", ScriptOp::MulAddF }, { "less", ScriptOp::LessF }, { "lesseq", ScriptOp::LessEqualF },
+            { "addi", ScriptOp::AddI }, { "subi", ScriptOp::SubI }, { "muli", ScriptOp::MulI },
+            { "andi", ScriptOp::AndI }, { "ori", ScriptOp::OrI }, { "lessi", ScriptOp::LessI },
+            { "select", ScriptOp::Select }
+        };
+        return ops;
+    }
+
+    /**
+     * @brief Instructions written `op rD rA`.
+     */
+    const std::unordered_map<std::string, ScriptOp>&
+    unaryOps() {
+        static const std::unordered_map<std::string, ScriptOp> ops = {
+            { "move", ScriptOp::Move }, { "neg", ScriptOp::NegF }, { "abs", ScriptOp::AbsF },
+            { "sqrt", ScriptOp::SqrtF }, { "floor", ScriptOp::FloorF },
+            { "itof", ScriptOp::IntToFloat }, { "ftoi", ScriptOp::FloatToInt }
+        };
+        return ops;
+    }
+}
+
+bool
+ScriptAssembler::assemble(const std::string& source, ScriptProgram& program, std::string& error) const {
+    /**
+     * @struct Label
+     * @brief Position of a label and whether it is inside a loop body.
+     */
+    struct Label {
+        size_t position;
+        bool inLoop;
+    };
+
+    /**
+     * @struct Fixup
+     * @brief Jump waiting for its label.
+     */
+    struct Fixup {
+        size_t position;
+        std::string label;
+        int line;
+    };
+
+    ScriptProgram result;
+    std::unordered_map<std::string, Label> labels;
+    std::vector<Fixup> fixups;
+    int loopQuery = -1;        // Query of the open foreach, -1 outside loops.
+    size_t loopStart = 0;      // Index of the open ForEach instruction.
+    int lineNumber = 0;
+
+    auto fail = [&error, &lineNumber](const std::string& message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+    auto reg = [&](const std::string& token, uint32_t& value) {
+        return parseRegister(token, value) || fail("expected a register r0 to r" +
+                                                   std::to_string(ScriptVM::RegisterCount - 1) + ", got '" + token + "'");
+    };
+    // Resolves "Layout.field" against the columns of the open loop.
+    auto field = [&](const std::string& token, uint32_t& column, const ScriptField*& found) {
+        if (loopQuery < 0) {
+            return fail("field access outside foreach");
+        }
+        const size_t dot = token.find('.');
+        if (dot == std::string::npos) {
+            return fail("expected Layout.field, got '" + token + "'");
+        }
+        const std::string layoutName = token.substr(0, dot);
+        const ScriptProgram::Query& query = result.queries[loopQuery];
+        for (column = 0; column < query.layouts.size(); ++column) {
+            if (query.layouts[column] == layoutName) {
+                found = m_environment.findLayout(layoutName)->findField(token.substr(dot + 1));
+                return found != nullptr || fail("unknown field '" + token + "'");
+            }
+        }
+        return fail("layout '" + layoutName + "' is not a column of query '" + query.name + "'");
+    };
+
+    std::istringstream stream(source);
+    std::string line;
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        std::vector<std::string> tokens = tokenize(line);
+        if (tokens.empty()) {
+            continue;
+        }
+        const std::string& name = tokens[0];
+        const size_t argumentCount = tokens.size() - 1;
+        auto arguments = [&](size_t expected) {
+            return argumentCount == expected ||
+                   fail("'" + name + "' takes " + std::to_string(expected) + " operands");
+        };
+
+        if (name.back() == ':' && tokens.size() == 1) {
+            const std::string label = name.substr(0, name.size() - 1);
+            if (label.empty() || !labels.emplace(label, Label{ result.code.size(), loopQuery >= 0 }).second) {
+                return fail("empty or duplicate label '" + label + "'");
+            }
+        }
+        else if (name == "query") {
+            if (argumentCount < 2 || argumentCount - 1 > ScriptVM::MaxColumns || result.queries.size() > 0xFF) {
+                return fail("'query' takes a name and 1 to " + std::to_string(ScriptVM::MaxColumns) + " layouts");
+            }
+            ScriptProgram::Query query;
+            query.name = tokens[1];
+            for (const ScriptProgram::Query& other : result.queries) {
+                if (other.name == query.name) {
+                    return fail("duplicate query '" + query.name + "'");
+                }
+            }
+            for (size_t token = 2; token < tokens.size(); ++token) {
+                const ScriptLayout* layout = m_environment.findLayout(tokens[token]);
+                if (layout == nullptr) {
+                    return fail("unknown layout '" + tokens[token] + "'");
+                }
+                query.layouts.push_back(layout->name);
+                query.sizes.push_back(layout->size);
+            }
+            result.queries.push_back(query);
+        }
+        else if (name == "const" || name == "consti") {
+            uint32_t d;
+            if (!arguments(2) || !reg(tokens[1], d)) {
+                return false;
+            }
+            char* end = nullptr;
+            ScriptRegister value;
+            if (name == "const") {
+                value.f = std::strtof(tokens[2].c_str(), &end);
+            }
+            else {
+                value.i = static_cast<int32_t>(std::strtol(tokens[2].c_str(), &end, 0));
+            }
+            if (*end != '\0') {
+                return fail("invalid number '" + tokens[2] + "'");
+            }
+            size_t index = 0;
+            while (index < result.constants.size() && result.constants[index].i != value.i) {
+                ++index;
+            }
+            if (index == result.constants.size()) {
+                if (index > 0xFFFF) {
+                    return fail("too many constants");
+                }
+                result.constants.push_back(value);
+            }
+            result.code.push_back(encodeWide(ScriptOp::LoadConst, d, static_cast<uint32_t>(index)));
+        }
+        else if (name == "param") {
+            uint32_t d;
+            if (!arguments(2) || !reg(tokens[1], d)) {
+                return false;
+            }
+            const long index = std::strtol(tokens[2].c_str(), nullptr, 10);
+            if (index < 0 || index > 0xFF) {
+                return fail("parameter index must be 0 to 255");
+            }
+            result.parameterCount = std::max(result.parameterCount, static_cast<uint32_t>(index) + 1);
+            result.code.push_back(encode(ScriptOp::LoadParam, d, static_cast<uint32_t>(index)));
+        }
+        else if (binaryOps().count(name) != 0) {
+            uint32_t d, x, y;
+            if (!arguments(3) || !reg(tokens[1], d) || !reg(tokens[2], x) || !reg(tokens[3], y)) {
+                return false;
+            }
+            result.code.push_back(encode(binaryOps().at(name), d, x, y));
+        }
+        else if (unaryOps().count(name) != 0) {
+            uint32_t d, x;
+            if (!arguments(2) || !reg(tokens[1], d) || !reg(tokens[2], x)) {
+                return false;
+            }
+            result.code.push_back(encode(unaryOps().at(name), d, x));
+        }
+        else if (name == "index") {
+            uint32_t d;
+            if (!arguments(1) || !reg(tokens[1], d)) {
+                return false;
+            }
+            result.code.push_back(encode(ScriptOp::Index, d));
+        }
+        else if (name == "load" || name == "store") {
+            const bool load = name == "load";
+            uint32_t r, column;
+            const ScriptField* found = nullptr;
+            if (!arguments(2) || !reg(tokens[load ? 1 : 2], r) || !field(tokens[load ? 2 : 1], column, found)) {
+                return false;
+            }
+            ScriptOp op;
+            switch (found->type) {
+            case ScriptFieldType::UInt8:
+                op = load ? ScriptOp::LoadU8 : ScriptOp::StoreU8;
+                break;
+            case ScriptFieldType::UInt16:
+                op = load ? ScriptOp::LoadU16 : ScriptOp::StoreU16;
+                break;
+            default:
+                op = load ? ScriptOp::LoadF32 : ScriptOp::StoreF32;
+                break;
+            }
+            result.code.push_back(encode(op, r, column, found->offset));
+        }
+        else if (name == "call") {
+            uint32_t d, x;
+            if (!arguments(3) || !reg(tokens[1], d) || !reg(tokens[3], x)) {
+                return false;
+            }
+            const int native = m_environment.findNative(tokens[2]);
+            if (native < 0) {
+                return fail("unknown native '" + tokens[2] + "'");
+            }
+            result.code.push_back(encode(ScriptOp::CallNative, d, static_cast<uint32_t>(native), x));
+        }
+        else if (name == "jump" || name == "jz") {
+            const bool conditional = name == "jz";
+            uint32_t r = 0;
+            if (!arguments(conditional ? 2 : 1) || (conditional && !reg(tokens[1], r))) {
+                return false;
+            }
+            if (loopQuery >= 0) {
+                return fail("jumps are not allowed in foreach bodies; use less and select");
+            }
+            fixups.push_back(Fixup{ result.code.size(), tokens.back(), lineNumber });
+            result.code.push_back(encode(conditional ? ScriptOp::JumpIfZero : ScriptOp::Jump, r));
+        }
+        else if (name == "foreach") {
+            if (!arguments(1)) {
+                return false;
+            }
+            if (loopQuery >= 0) {
+                return fail("foreach cannot be nested");
+            }
+            for (size_t query = 0; query < result.queries.size(); ++query) {
+                if (result.queries[query].name == tokens[1]) {
+                    loopQuery = static_cast<int>(query);
+                }
+            }
+            if (loopQuery < 0) {
+                return fail("unknown query '" + tokens[1] + "'");
+            }
+            loopStart = result.code.size();
+            result.code.push_back(encode(ScriptOp::ForEach, static_cast<uint32_t>(loopQuery)));
+            result.code.push_back(0); // Registers the body writes, filled in by 'end'.
+        }
+        else if (name == "end") {
+            if (!arguments(0)) {
+                return false;
+            }
+            if (loopQuery < 0) {
+                return fail("'end' without foreach");
+            }
+            const size_t body = result.code.size() - loopStart - 2;
+            if (body > 0xFFFF) {
+                return fail("foreach body is too long");
+            }
+            uint32_t written = 0;
+            for (size_t pc = loopStart + 2; pc < result.code.size(); ++pc) {
+                const uint32_t instruction = result.code[pc];
+                if (writesRegister(static_cast<ScriptOp>(instruction & 0xFF))) {
+                    written |= 1u << ((instruction >> 8) & 0xFF);
+                }
+            }
+            result.code[loopStart + 1] = written;
+            result.code[loopStart] = encodeWide(ScriptOp::ForEach, static_cast<uint32_t>(loopQuery),
+                                                static_cast<uint32_t>(body));
+            loopQuery = -1;
+        }
+        else if (name == "halt") {
+            if (!arguments(0)) {
+                return false;
+            }
+            result.code.push_back(encode(ScriptOp::Halt, 0));
+        }
+        else {
+            return fail("unknown instruction '" + name + "'");
+        }
+    }
+
+    ++lineNumber;
+    if (loopQuery >= 0) {
+        return fail("foreach without 'end'");
+    }
+    for (const Fixup& fixup : fixups) {
+        lineNumber = fixup.line;
+        auto label = labels.find(fixup.label);
+        if (label == labels.end() || label->second.inLoop) {
+            return fail("unknown label '" + fixup.label + "' (or label inside a foreach body)");
+        }
+        const long offset = static_cast<long>(label->second.position) - static_cast<long>(fixup.position + 1);
+        if (offset < -0x8000 || offset > 0x7FFF) {
+            return fail("jump is too far");
+        }
+        result.code[fixup.position] |= (static_cast<uint32_t>(offset) & 0xFFFF) << 16;
+    }
+
+    program = std::move(result);
+    error.clear();
+    return true;
+}
@@ -0,0 +1,355 @@
+#include "Scripting/ScriptVM.h"
+#include "Utilities/Simd.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file ScriptVM.cpp
+ * @brief Implements the script environment and the chunked interpreter.
+ */
+
+namespace {
+    /**
+     * @brief Runs @p function over @p count lanes of float registers, four at a time.
+     * Registers hold ChunkSize lanes, so rounding @p count up only touches unused lanes.
+     */
+    template<typename Function>
+    inline void
+    floatLanes(ScriptRegister* result, const ScriptRegister* x, const ScriptRegister* y, size_t count,
+               Function function) {
+        for (size_t lane = 0; lane < count; lane += 4) {
+            function(Float4::load(&x[lane].f), Float4::load(&y[lane].f)).store(&result[lane].f);
+        }
+    }
+
+    /**
+     * @brief Runs @p function over @p count lanes of integer registers.
+     */
+    template<typename Function>
+    inline void
+    intLanes(ScriptRegister* result, const ScriptRegister* x, const ScriptRegister* y, size_t count,
+             Function function) {
+        for (size_t lane = 0; lane < count; ++lane) {
+            result[lane].i = function(x[lane].i, y[lane].i);
+        }
+    }
+}
+
+const ScriptField*
+ScriptLayout::findField(const std::string& field) const {
+    for (const ScriptField& candidate : fields) {
+        if (candidate.name == field) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+void
+ScriptEnvironment::addLayout(const ScriptLayout& layout) {
+    if (findLayout(layout.name) != nullptr) {
+        ERROR("ScriptEnvironment", "addLayout", "Layout already registered");
+    }
+    for (const ScriptField& field : layout.fields) {
+        if (field.offset > 0xFF || field.offset >= layout.size) {
+            ERROR("ScriptEnvironment", "addLayout", "Field offsets must be below 256 and inside the layout");
+        }
+    }
+    m_layouts.push_back(layout);
+}
+
+void
+ScriptEnvironment::addNative(const std::string& name, ScriptNative function) {
+    if (findNative(name) >= 0 || m_natives.size() > 0xFF) {
+        ERROR("ScriptEnvironment", "addNative", "Native already registered or too many natives");
+    }
+    m_natives.emplace_back(name, function);
+}
+
+const ScriptLayout*
+ScriptEnvironment::findLayout(const std::string& name) const {
+    for (const ScriptLayout& layout : m_layouts) {
+        if (layout.name == name) {
+            return &layout;
+        }
+    }
+    return nullptr;
+}
+
+int
+ScriptEnvironment::findNative(const std::string& name) const {
+    for (size_t native = 0; native < m_natives.size(); ++native) {
+        if (m_natives[native].first == name) {
+            return static_cast<int>(native);
+        }
+    }
+    return -1;
+}
+
+ScriptVM::ScriptVM(const ScriptEnvironment& environment)
+    : m_environment(environment), m_registers(RegisterCount * ChunkSize) {
+    std::memset(m_registers.data(), 0, m_registers.size() * sizeof(ScriptRegister));
+}
+
+void
+ScriptVM::setParameter(size_t index, float value) {
+    if (index > 0xFF) {
+        ERROR("ScriptVM", "setParameter", "Parameter index must be below 256");
+    }
+    if (index >= m_parameters.size()) {
+        m_parameters.resize(index + 1, 0.f);
+    }
+    m_parameters[index] = value;
+}
+
+void
+ScriptVM::bindQuery(const ScriptProgram& program, const std::string& name,
+                    const std::vector<ScriptColumn>& columns, size_t count) {
+    for (size_t query = 0; query < program.queries.size(); ++query) {
+        const ScriptProgram::Query& declared = program.queries[query];
+        if (declared.name != name) {
+            continue;
+        }
+        if (columns.size() != declared.layouts.size()) {
+            ERROR("ScriptVM", "bindQuery", "Column count does not match the query");
+        }
+        if (m_bindings.size() < program.queries.size()) {
+            m_bindings.resize(program.queries.size());
+        }
+        Binding& binding = m_bindings[query];
+        for (size_t column = 0; column < columns.size(); ++column) {
+            if (count > 0 && (columns[column].base == nullptr || columns[column].stride < declared.sizes[column])) {
+                ERROR("ScriptVM", "bindQuery", "Column is null or its stride is smaller than its layout");
+            }
+            binding.columns[column] = columns[column];
+        }
+        binding.count = count;
+        binding.bound = true;
+        return;
+    }
+    ERROR("ScriptVM", "bindQuery", "Unknown query");
+}
+
+void
+ScriptVM::run(const ScriptProgram& program) {
+    if (m_parameters.size() < program.parameterCount) {
+        m_parameters.resize(program.parameterCount, 0.f);
+    }
+    for (size_t query = 0; query < program.queries.size(); ++query) {
+        if (query >= m_bindings.size() || !m_bindings[query].bound) {
+            ERROR("ScriptVM", "run", "Every query must be bound before running");
+        }
+    }
+    m_halted = false;
+    execute(program, 0, program.code.size(), 1, nullptr, 0);
+}
+
+size_t
+ScriptVM::execute(const ScriptProgram& program, size_t begin, size_t end, size_t count,
+                  const ScriptColumn* columns, size_t firstRow) {
+    ScriptRegister* registers = m_registers.data();
+    const uint32_t* code = program.code.data();
+
+    size_t pc = begin;
+    while (pc < end) {
+        const uint32_t instruction = code[pc++];
+        const ScriptOp op = static_cast<ScriptOp>(instruction & 0xFF);
+        const uint32_t a = (instruction >> 8) & 0xFF;
+        const uint32_t b = (instruction >> 16) & 0xFF;
+        const uint32_t c = instruction >> 24;
+        const uint32_t bc = instruction >> 16;
+
+        ScriptRegister* ra = registers + a * ChunkSize;
+        const ScriptRegister* rb = registers + b * ChunkSize;
+        const ScriptRegister* rc = registers + c * ChunkSize;
+
+        switch (op) {
+        case ScriptOp::Halt:
+            m_halted = true;
+            return program.code.size();
+        case ScriptOp::LoadConst:
+            std::fill(ra, ra + count, program.constants[bc]);
+            break;
+        case ScriptOp::LoadParam:
+            for (size_t lane = 0; lane < count; ++lane) {
+                ra[lane].f = m_parameters[b];
+            }
+            break;
+        case ScriptOp::Move:
+            std::memmove(ra, rb, count * sizeof(ScriptRegister));
+            break;
+        case ScriptOp::AddF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return x + y; });
+            break;
+        case ScriptOp::SubF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return x - y; });
+            break;
+        case ScriptOp::MulF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return x * y; });
+            break;
+        case ScriptOp::DivF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return x / y; });
+            break;
+        case ScriptOp::MinF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return min(x, y); });
+            break;
+        case ScriptOp::MaxF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return max(x, y); });
+            break;
+        case ScriptOp::MulAddF:
+            for (size_t lane = 0; lane < count; lane += 4) {
+                (Float4::load(&ra[lane].f) + Float4::load(&rb[lane].f) * Float4::load(&rc[lane].f)).store(&ra[lane].f);
+            }
+            break;
+        case ScriptOp::NegF:
+            floatLanes(ra, rb, rb, count, [](Float4 x, Float4) { return x * Float4::splat(-1.f); });
+            break;
+        case ScriptOp::AbsF:
+            floatLanes(ra, rb, rb, count, [](Float4 x, Float4) { return max(x, x * Float4::splat(-1.f)); });
+            break;
+        case ScriptOp::SqrtF:
+            floatLanes(ra, rb, rb, count, [](Float4 x, Float4) { return sqrt(x); });
+            break;
+        case ScriptOp::FloorF:
+            floatLanes(ra, rb, rb, count, [](Float4 x, Float4) { return floor(x); });
+            break;
+        case ScriptOp::LessF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return x < y; });
+            break;
+        case ScriptOp::LessEqualF:
+            floatLanes(ra, rb, rc, count, [](Float4 x, Float4 y) { return y >= x; });
+            break;
+        case ScriptOp::AddI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) {
+                return static_cast<int32_t>(static_cast<uint32_t>(x) + static_cast<uint32_t>(y)); });
+            break;
+        case ScriptOp::SubI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) {
+                return static_cast<int32_t>(static_cast<uint32_t>(x) - static_cast<uint32_t>(y)); });
+            break;
+        case ScriptOp::MulI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) {
+                return static_cast<int32_t>(static_cast<uint32_t>(x) * static_cast<uint32_t>(y)); });
+            break;
+        case ScriptOp::AndI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) { return x & y; });
+            break;
+        case ScriptOp::OrI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) { return x | y; });
+            break;
+        case ScriptOp::LessI:
+            intLanes(ra, rb, rc, count, [](int32_t x, int32_t y) { return x < y ? -1 : 0; });
+            break;
+        case ScriptOp::IntToFloat:
+            for (size_t lane = 0; lane < count; ++lane) {
+                ra[lane].f = static_cast<float>(rb[lane].i);
+            }
+            break;
+        case ScriptOp::FloatToInt:
+            for (size_t lane = 0; lane < count; ++lane) {
+                const float value = rb[lane].f;
+                ra[lane].i = value > -2147483648.f && value < 2147483648.f ? static_cast<int32_t>(value) : 0;
+            }
+            break;
+        case ScriptOp::Select:
+            for (size_t lane = 0; lane < count; ++lane) {
+                ra[lane] = ra[lane].i != 0 ? rb[lane] : rc[lane];
+            }
+            break;
+        case ScriptOp::Index:
+            for (size_t lane = 0; lane < count; ++lane) {
+                ra[lane].i = static_cast<int32_t>(firstRow + lane);
+            }
+            break;
+        case ScriptOp::LoadF32:
+        case ScriptOp::LoadU8:
+        case ScriptOp::LoadU16:
+        case ScriptOp::StoreF32:
+        case ScriptOp::StoreU8:
+        case ScriptOp::StoreU16: {
+            // The assembler only emits field access inside loops, where columns is set.
+            const size_t stride = columns[b].stride;
+            uint8_t* field = columns[b].base + firstRow * stride + c;
+            switch (op) {
+            case ScriptOp::LoadF32:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    std::memcpy(&ra[lane], field, sizeof(ScriptRegister));
+                }
+                break;
+            case ScriptOp::LoadU8:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    ra[lane].i = *field;
+                }
+                break;
+            case ScriptOp::LoadU16:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    uint16_t value;
+                    std::memcpy(&value, field, sizeof(value));
+                    ra[lane].i = value;
+                }
+                break;
+            case ScriptOp::StoreF32:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    std::memcpy(field, &ra[lane], sizeof(ScriptRegister));
+                }
+                break;
+            case ScriptOp::StoreU8:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    *field = static_cast<uint8_t>(ra[lane].i);
+                }
+                break;
+            default:
+                for (size_t lane = 0; lane < count; ++lane, field += stride) {
+                    const uint16_t value = static_cast<uint16_t>(ra[lane].i);
+                    std::memcpy(field, &value, sizeof(value));
+                }
+                break;
+            }
+            break;
+        }
+        case ScriptOp::CallNative:
+            m_environment.getNative(b)(ra, rc, count);
+            break;
+        case ScriptOp::Jump:
+            pc = static_cast<size_t>(static_cast<ptrdiff_t>(pc) + static_cast<int16_t>(bc));
+            break;
+        case ScriptOp::JumpIfZero:
+            if (ra[0].i == 0) {
+                pc = static_cast<size_t>(static_cast<ptrdiff_t>(pc) + static_cast<int16_t>(bc));
+            }
+            break;
+        case ScriptOp::ForEach: {
+            const Binding& binding = m_bindings[a];
+            const uint32_t written = code[pc];
+            const size_t bodyBegin = pc + 1;
+            const size_t bodyEnd = bodyBegin + bc;
+            // Values set before the loop are the same in every lane of every chunk: they
+            // are spread once, and the registers the body writes get them back per chunk.
+            const size_t lanes = std::min(ChunkSize, std::max<size_t>(binding.count, 1));
+            ScriptRegister before[RegisterCount];
+            for (size_t reg = 0; reg < RegisterCount; ++reg) {
+                before[reg] = registers[reg * ChunkSize];
+                std::fill(registers + reg * ChunkSize + 1, registers + reg * ChunkSize + lanes, before[reg]);
+            }
+            for (size_t row = 0; row < binding.count && !m_halted; row += ChunkSize) {
+                if (row > 0) {
+                    for (size_t reg = 0; reg < RegisterCount; ++reg) {
+                        if (written & (1u << reg)) {
+                            std::fill(registers + reg * ChunkSize, registers + reg * ChunkSize + lanes, before[reg]);
+                        }
+                    }
+                }
+                execute(program, bodyBegin, bodyEnd, std::min(ChunkSize, binding.count - row), binding.columns, row);
+            }
+            if (m_halted) {
+                return program.code.size();
+            }
+            pc = bodyEnd;
+            break;
+        }
+        default:
+            ERROR("ScriptVM", "execute", "Invalid opcode");
+        }
+    }
+    return pc;
+}
@@ -1,5 +1,9 @@
 #include <ECS/Transform.h>
 
+/**
+ * @brief Initialization logic for the Transform component.
+ * Currently empty but can be extended later.
+ */
 void
 Transform::start() {
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "UI/UiGlyphCache.h"
+
+/**
+ * @file UiGlyphCache.cpp
+ * @brief Implements the UI glyph cache.
+ */
+
+UiGlyphCache::UiGlyphCache(const sf::Font* font, unsigned int characterSize)
+    : m_font(font), m_characterSize(characterSize) {
+    if (characterSize == 0) {
+        ERROR("UiGlyphCache", "UiGlyphCache", "Character size must be positive");
+    }
+    m_lineSpacing = font != nullptr ? font->getLineSpacing(characterSize) : characterSize * 1.25f;
+}
+
+float
+UiGlyphCache::measure(const std::string& text) {
+    float width = 0.f;
+    for (std::string::const_iterator it = text.begin(); it != text.end();) {
+        sf::Uint32 codePoint = 0;
+        it = sf::Utf8::decode(it, text.end(), codePoint, '?');
+        width += getGlyph(codePoint).advance;
+    }
+    return width;
+}
+
+const sf::Texture*
+UiGlyphCache::getTexture() const {
+    return m_font != nullptr ? &m_font->getTexture(m_characterSize) : nullptr;
+}
+
+const UiGlyph&
+UiGlyphCache::loadGlyph(uint32_t codePoint) {
+    UiGlyph glyph;
+    if (m_font != nullptr) {
+        const sf::Glyph& source = m_font->getGlyph(codePoint, m_characterSize, false);
+        glyph.advance = source.advance;
+        glyph.bounds = source.bounds;
+        glyph.texture = sf::FloatRect(source.textureRect);
+    }
+    else {
+        // Fixed-width box sitting on the baseline; spaces stay empty.
+        const float size = static_cast<float>(m_characterSize);
+        glyph.advance = size * 0.6f;
+        if (codePoint != ' ') {
+            glyph.bounds = sf::FloatRect(size * 0.05f, -size * 0.7f, size * 0.5f, size * 0.7f);
+            glyph.texture = sf::FloatRect(getWhiteTexel(), sf::Vector2f(0.f, 0.f));
+        }
+    }
+    ++m_loads;
+
+    if (codePoint < 128) {
+        m_ascii[codePoint] = glyph;
+        m_asciiLoaded[codePoint] = true;
+        return m_ascii[codePoint];
+    }
+    return m_others[codePoint] = glyph;
+}
@@ -0,0 +1,483 @@
+#include "UI/UiSystem.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file UiSystem.cpp
+ * @brief Implements the retained-mode UI: dirty layout, batched vertices and hit grid.
+ */
+
+namespace {
+    const sf::Vertex DegenerateVertex(sf::Vector2f(0.f, 0.f), sf::Color::Transparent);
+
+    /**
+     * @brief Writes the two triangles of a quad.
+     */
+    void
+    writeQuad(sf::Vertex* out, const sf::FloatRect& quad, const sf::FloatRect& uv, const sf::Color& color) {
+        const float left = quad.left;
+        const float top = quad.top;
+        const float right = quad.left + quad.width;
+        const float bottom = quad.top + quad.height;
+        const float u0 = uv.left;
+        const float v0 = uv.top;
+        const float u1 = uv.left + uv.width;
+        const float v1 = uv.top + uv.height;
+        out[0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0));
+        out[1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        out[2] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
+        out[3] = out[2];
+        out[4] = out[1];
+        out[5] = sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1));
+    }
+}
+
+template<typename Function>
+void
+UiSystem::forEachNode(UiNodeId first, bool visibleOnly, Function&& function) const {
+    // Preorder walk through the sibling links; hidden subtrees are skipped when asked.
+    UiNodeId id = first;
+    while (true) {
+        const Node& node = m_nodes[id];
+        const bool enter = !visibleOnly || node.visible;
+        if (enter) {
+            function(id);
+            if (node.firstChild != InvalidUiNode) {
+                id = node.firstChild;
+                continue;
+            }
+        }
+        while (id != first && m_nodes[id].next == InvalidUiNode) {
+            id = m_nodes[id].parent;
+        }
+        if (id == first) {
+            return;
+        }
+        id = m_nodes[id].next;
+    }
+}
+
+UiSystem::UiSystem(const sf::Font* font, unsigned int characterSize, const sf::Vector2f& viewport)
+    : m_glyphs(font, characterSize) {
+    Node root;
+    root.kind = UiNodeKind::Panel;
+    root.style.size = viewport;
+    root.style.padding = 0.f;
+    root.style.spacing = 0.f;
+    root.style.direction = UiDirection::Overlay;
+    m_nodes.push_back(root);
+}
+
+UiNodeId
+UiSystem::addPanel(UiNodeId parent, const UiStyle& style) {
+    return addNode(parent, UiNodeKind::Panel, std::string(), style);
+}
+
+UiNodeId
+UiSystem::addLabel(UiNodeId parent, const std::string& text, const UiStyle& style) {
+    return addNode(parent, UiNodeKind::Label, text, style);
+}
+
+UiNodeId
+UiSystem::addButton(UiNodeId parent, const std::string& text, const UiStyle& style) {
+    return addNode(parent, UiNodeKind::Button, text, style);
+}
+
+UiNodeId
+UiSystem::addNode(UiNodeId parent, UiNodeKind kind, const std::string& text, const UiStyle& style) {
+    if (parent >= m_nodes.size() || m_nodes[parent].kind != UiNodeKind::Panel) {
+        ERROR("UiSystem", "addNode", "Parent " << parent << " is not a panel");
+    }
+    if (m_nodes.size() >= InvalidUiNode) {
+        ERROR("UiSystem", "addNode", "Too many nodes");
+    }
+
+    const UiNodeId id = static_cast<UiNodeId>(m_nodes.size());
+    Node node;
+    node.kind = kind;
+    node.style = style;
+    node.text = text;
+    node.textWidth = m_glyphs.measure(text);
+    node.parent = parent;
+    m_nodes.push_back(node);
+
+    Node& owner = m_nodes[parent];
+    if (owner.lastChild != InvalidUiNode) {
+        m_nodes[owner.lastChild].next = id;
+    }
+    else {
+        owner.firstChild = id;
+    }
+    owner.lastChild = id;
+
+    markMeasureDirty(parent);
+    m_rangesDirty = true;
+    m_gridDirty = m_gridDirty || kind == UiNodeKind::Button;
+    return id;
+}
+
+void
+UiSystem::setText(UiNodeId node, const std::string& text) {
+    Node& target = m_nodes[node];
+    if (target.kind == UiNodeKind::Panel) {
+        ERROR("UiSystem", "setText", "Panels have no text");
+    }
+    if (target.text == text) {
+        return;
+    }
+    target.text = text;
+
+    // Only a change of size needs layout; fixed-width value labels just get new vertices.
+    const float width = m_glyphs.measure(text);
+    if (width != target.textWidth && target.style.size.x <= 0.f) {
+        markMeasureDirty(node);
+    }
+    target.textWidth = width;
+    if (capacityFor(target.kind, text.size()) > target.vertexCapacity) {
+        m_rangesDirty = true;
+    }
+    markVisualDirty(node);
+}
+
+void
+UiSystem::setVisible(UiNodeId node, bool visible) {
+    Node& target = m_nodes[node];
+    if (target.visible == visible) {
+        return;
+    }
+    target.visible = visible;
+    target.flags |= ArrangeDirty;
+    markMeasureDirty(target.parent != InvalidUiNode ? target.parent : node);
+    forEachNode(node, false, [this](UiNodeId id) { markVisualDirty(id); });
+    m_gridDirty = true;
+}
+
+void
+UiSystem::setViewport(const sf::Vector2f& viewport) {
+    m_nodes[0].style.size = viewport;
+    markMeasureDirty(0);
+    m_gridDirty = true;
+}
+
+void
+UiSystem::invalidate() {
+    for (UiNodeId id = 0; id < m_nodes.size(); ++id) {
+        m_nodes[id].flags |= MeasureDirty | ArrangeDirty;
+        markVisualDirty(id);
+    }
+    m_gridDirty = true;
+}
+
+void
+UiSystem::update() {
+    m_stats = UiStats();
+    measure(0);
+    const Node& root = m_nodes[0];
+    arrange(0, sf::FloatRect(0.f, 0.f, root.size.x, root.size.y));
+
+    if (m_rangesDirty) {
+        rebuildRanges();
+    }
+    for (UiNodeId id : m_visualQueue) {
+        writeNode(id);
+        m_nodes[id].flags &= ~VisualDirty;
+    }
+    m_stats.rewritten = m_visualQueue.size();
+    m_visualQueue.clear();
+
+    if (m_gridDirty) {
+        rebuildGrid();
+    }
+}
+
+UiNodeId
+UiSystem::hitTest(const sf::Vector2f& point) const {
+    const sf::Vector2f viewport = m_nodes[0].rect.getSize();
+    if (m_gridStart.empty() || point.x < 0.f || point.y < 0.f || point.x >= viewport.x || point.y >= viewport.y) {
+        return InvalidUiNode;
+    }
+    const int column = std::min(static_cast<int>(point.x / GridCellSize), m_gridColumns - 1);
+    const int row = std::min(static_cast<int>(point.y / GridCellSize), m_gridRows - 1);
+    const size_t cell = static_cast<size_t>(row) * m_gridColumns + column;
+
+    // Later vertices are drawn on top, so the hit with the largest range start wins.
+    UiNodeId best = InvalidUiNode;
+    for (uint32_t i = m_gridStart[cell]; i < m_gridStart[cell + 1]; ++i) {
+        const Node& node = m_nodes[m_gridItems[i]];
+        if (node.rect.contains(point) && (best == InvalidUiNode || node.vertexStart > m_nodes[best].vertexStart)) {
+            best = m_gridItems[i];
+        }
+    }
+    return best;
+}
+
+UiNodeId
+UiSystem::handleMouse(const sf::Vector2f& point, bool pressed) {
+    const UiNodeId hit = hitTest(point);
+    if (hit != m_hovered) {
+        if (m_hovered != InvalidUiNode) {
+            markVisualDirty(m_hovered);
+        }
+        if (hit != InvalidUiNode) {
+            markVisualDirty(hit);
+        }
+        m_hovered = hit;
+    }
+    const UiNodeId clicked = pressed && !m_pressed ? hit : InvalidUiNode;
+    m_pressed = pressed;
+    return clicked;
+}
+
+void
+UiSystem::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (m_vertices.empty()) {
+        return;
+    }
+    states.texture = m_glyphs.getTexture();
+    target.draw(m_vertices.data(), m_vertices.size(), sf::Triangles, states);
+}
+
+void
+UiSystem::markMeasureDirty(UiNodeId node) {
+    // A dirty node already has dirty ancestors, unless it sits in a hidden subtree,
+    // which takes no space; setVisible() flags the path again when it is shown.
+    m_nodes[node].flags |= MeasureDirty;
+    for (UiNodeId id = m_nodes[node].parent; id != InvalidUiNode && !(m_nodes[id].flags & MeasureDirty);
+         id = m_nodes[id].parent) {
+        m_nodes[id].flags |= MeasureDirty;
+    }
+}
+
+void
+UiSystem::markVisualDirty(UiNodeId node) {
+    if (!(m_nodes[node].flags & VisualDirty)) {
+        m_nodes[node].flags |= VisualDirty;
+        m_visualQueue.push_back(node);
+    }
+}
+
+void
+UiSystem::measure(UiNodeId node) {
+    Node& target = m_nodes[node];
+    if (!(target.flags & MeasureDirty)) {
+        return;
+    }
+
+    sf::Vector2f content(0.f, 0.f);
+    if (target.kind == UiNodeKind::Panel) {
+        size_t shown = 0;
+        for (UiNodeId child = target.firstChild; child != InvalidUiNode; child = m_nodes[child].next) {
+            if (!m_nodes[child].visible) {
+                continue;
+            }
+            measure(child);
+            const Node& item = m_nodes[child];
+            switch (target.style.direction) {
+            case UiDirection::Column:
+                content.x = std::max(content.x, item.size.x);
+                content.y += item.size.y;
+                break;
+            case UiDirection::Row:
+                content.x += item.size.x;
+                content.y = std::max(content.y, item.size.y);
+                break;
+            case UiDirection::Overlay:
+                content.x = std::max(content.x, item.style.position.x + item.size.x);
+                content.y = std::max(content.y, item.style.position.y + item.size.y);
+                break;
+            }
+            ++shown;
+        }
+        if (shown > 1 && target.style.direction == UiDirection::Column) {
+            content.y += target.style.spacing * (shown - 1);
+        }
+        else if (shown > 1 && target.style.direction == UiDirection::Row) {
+            content.x += target.style.spacing * (shown - 1);
+        }
+    }
+    else {
+        content = sf::Vector2f(target.textWidth, m_glyphs.getLineSpacing());
+    }
+
+    const float padding = target.style.padding * 2.f;
+    target.size.x = target.style.size.x > 0.f ? target.style.size.x : content.x + padding;
+    target.size.y = target.style.size.y > 0.f ? target.style.size.y : content.y + padding;
+    target.flags = static_cast<uint8_t>((target.flags & ~MeasureDirty) | ArrangeDirty);
+    ++m_stats.measured;
+}
+
+void
+UiSystem::arrange(UiNodeId node, const sf::FloatRect& rect) {
+    Node& target = m_nodes[node];
+    if (!(target.flags & ArrangeDirty) && target.rect == rect) {
+        return;
+    }
+    ++m_stats.arranged;
+    if (target.rect != rect) {
+        target.rect = rect;
+        markVisualDirty(node);
+        m_gridDirty = m_gridDirty || target.kind == UiNodeKind::Button;
+    }
+    target.flags &= ~ArrangeDirty;
+    if (target.kind != UiNodeKind::Panel) {
+        return;
+    }
+
+    const UiStyle& style = target.style;
+    sf::Vector2f pen(rect.left + style.padding, rect.top + style.padding);
+    for (UiNodeId child = target.firstChild; child != InvalidUiNode; child = m_nodes[child].next) {
+        const Node& item = m_nodes[child];
+        if (!item.visible) {
+            continue;
+        }
+        const sf::Vector2f size = item.size;
+        switch (style.direction) {
+        case UiDirection::Column:
+            arrange(child, sf::FloatRect(pen, size));
+            pen.y += size.y + style.spacing;
+            break;
+        case UiDirection::Row:
+            arrange(child, sf::FloatRect(pen, size));
+            pen.x += size.x + style.spacing;
+            break;
+        case UiDirection::Overlay:
+            arrange(child, sf::FloatRect(pen + item.style.position, size));
+            break;
+        }
+    }
+}
+
+bool
+UiSystem::isShown(UiNodeId node) const {
+    for (UiNodeId id = node; id != InvalidUiNode; id = m_nodes[id].parent) {
+        if (!m_nodes[id].visible) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t
+UiSystem::capacityFor(UiNodeKind kind, size_t characters) {
+    // One quad for the background, one per character of text.
+    return static_cast<uint32_t>(kind == UiNodeKind::Panel ? 6 : 6 * (characters + 1));
+}
+
+void
+UiSystem::rebuildRanges() {
+    // Tree order keeps parents under their children; text gets half again its length
+    // of headroom so counters and timers can grow without another rebuild.
+    uint32_t total = 0;
+    m_visualQueue.clear();
+    forEachNode(0, false, [this, &total](UiNodeId id) {
+        Node& node = m_nodes[id];
+        const size_t characters = node.text.size();
+        node.vertexStart = total;
+        node.vertexCapacity = capacityFor(node.kind, node.kind == UiNodeKind::Panel ? 0 : characters + characters / 2 + 4);
+        node.vertexCount = 0;
+        node.flags |= VisualDirty;
+        m_visualQueue.push_back(id);
+        total += node.vertexCapacity;
+    });
+    m_vertices.assign(total, DegenerateVertex);
+    m_rangesDirty = false;
+    ++m_stats.rangeRebuilds;
+}
+
+void
+UiSystem::writeNode(UiNodeId node) {
+    Node& target = m_nodes[node];
+    sf::Vertex* out = m_vertices.data() + target.vertexStart;
+    uint32_t count = 0;
+
+    if (isShown(node)) {
+        const UiStyle& style = target.style;
+        const sf::Color& background = node == m_hovered ? style.hover : style.background;
+        if (background.a > 0) {
+            writeQuad(out, target.rect, sf::FloatRect(m_glyphs.getWhiteTexel(), sf::Vector2f(0.f, 0.f)), background);
+            count += 6;
+        }
+
+        // Glyphs past the right edge are clipped whole rather than cut.
+        const float right = target.rect.left + target.rect.width - style.padding;
+        const float baseline = target.rect.top + style.padding + m_glyphs.getAscent();
+        float pen = target.rect.left + style.padding;
+        const std::string& text = target.text;
+        for (std::string::const_iterator it = text.begin(); it != text.end();) {
+            sf::Uint32 codePoint = 0;
+            it = sf::Utf8::decode(it, text.end(), codePoint, '?');
+            const UiGlyph& glyph = m_glyphs.getGlyph(codePoint);
+            if (pen + glyph.bounds.left + glyph.bounds.width > right) {
+                break;
+            }
+            if (glyph.bounds.width > 0.f) {
+                const sf::FloatRect quad(pen + glyph.bounds.left, baseline + glyph.bounds.top,
+                                         glyph.bounds.width, glyph.bounds.height);
+                writeQuad(out + count, quad, glyph.texture, style.text);
+                count += 6;
+            }
+            pen += glyph.advance;
+        }
+    }
+
+    if (count < target.vertexCount) {
+        std::fill(out + count, out + target.vertexCount, DegenerateVertex);
+    }
+    target.vertexCount = count;
+}
+
+void
+UiSystem::rebuildGrid() {
+    const sf::Vector2f viewport = m_nodes[0].rect.getSize();
+    m_gridColumns = std::max(1, static_cast<int>(std::ceil(viewport.x / GridCellSize)));
+    m_gridRows = std::max(1, static_cast<int>(std::ceil(viewport.y / GridCellSize)));
+    const size_t cells = static_cast<size_t>(m_gridColumns) * m_gridRows;
+
+    m_scratch.clear();
+    forEachNode(0, true, [this](UiNodeId id) {
+        const sf::FloatRect& rect = m_nodes[id].rect;
+        if (m_nodes[id].kind == UiNodeKind::Button && rect.width > 0.f && rect.height > 0.f) {
+            m_scratch.push_back(id);
+        }
+    });
+
+    // Two passes over the cells each button overlaps: count, then fill (compressed rows).
+    m_gridStart.assign(cells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (UiNodeId id : m_scratch) {
+            const sf::FloatRect& rect = m_nodes[id].rect;
+            if (rect.left >= viewport.x || rect.top >= viewport.y || rect.left + rect.width <= 0.f ||
+                rect.top + rect.height <= 0.f) {
+                continue;
+            }
+            const int column0 = std::max(0, static_cast<int>(rect.left / GridCellSize));
+            const int row0 = std::max(0, static_cast<int>(rect.top / GridCellSize));
+            const int column1 = std::min(m_gridColumns - 1, static_cast<int>((rect.left + rect.width) / GridCellSize));
+            const int row1 = std::min(m_gridRows - 1, static_cast<int>((rect.top + rect.height) / GridCellSize));
+            for (int row = row0; row <= row1; ++row) {
+                for (int column = column0; column <= column1; ++column) {
+                    const size_t cell = static_cast<size_t>(row) * m_gridColumns + column;
+                    if (pass == 0) {
+                        ++m_gridStart[cell + 1];
+                    }
+                    else {
+                        m_gridItems[m_gridStart[cell]++] = id;
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            for (size_t cell = 0; cell < cells; ++cell) {
+                m_gridStart[cell + 1] += m_gridStart[cell];
+            }
+            m_gridItems.resize(m_gridStart[cells]);
+        }
+    }
+    // The fill pass advanced every start to the next cell's start; shift back.
+    for (size_t cell = cells; cell > 0; --cell) {
+        m_gridStart[cell] = m_gridStart[cell - 1];
+    }
+    m_gridStart[0] = 0;
+    m_gridDirty = false;
+    ++m_stats.gridRebuilds;
+}
@@ -0,0 +1,327 @@
+#include "Utilities/InputLog.h"
+#include <cstring>
+#include <iterator>
+
+/**
+ * @file InputLog.cpp
+ * @brief Implements encoding and decoding of the input log.
+ */
+
+namespace {
+    void
+    putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void
+    putSigned(std::vector<uint8_t>& out, int64_t value) {
+        putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void
+    putRaw(std::vector<uint8_t>& out, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    /**
+     * @brief Bounds-checked cursor over the loaded log.
+     */
+    struct Cursor {
+        const std::vector<uint8_t>& data;
+        size_t& offset;
+        bool ok = true;
+
+        uint8_t
+        byte() {
+            if (offset >= data.size()) {
+                ok = false;
+                return 0;
+            }
+            return data[offset++];
+        }
+
+        uint64_t
+        varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t b = byte();
+                value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if ((b & 0x80) == 0) {
+                    return value;
+                }
+            }
+            ok = false;
+            return 0;
+        }
+
+        int64_t
+        signedVarint() {
+            const uint64_t value = varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        void
+        raw(void* out, size_t size) {
+            if (offset > data.size() || data.size() - offset < size) {
+                ok = false;
+                return;
+            }
+            std::memcpy(out, data.data() + offset, size);
+            offset += size;
+        }
+    };
+
+    void
+    encodeEvent(std::vector<uint8_t>& out, const sf::Event& event) {
+        out.push_back(static_cast<uint8_t>(event.type));
+        switch (event.type) {
+        case sf::Event::Closed:
+        case sf::Event::LostFocus:
+        case sf::Event::GainedFocus:
+        case sf::Event::MouseEntered:
+        case sf::Event::MouseLeft:
+            break;
+        case sf::Event::Resized:
+            putVarint(out, event.size.width);
+            putVarint(out, event.size.height);
+            break;
+        case sf::Event::TextEntered:
+            putVarint(out, event.text.unicode);
+            break;
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            putSigned(out, event.key.code);
+            putSigned(out, event.key.scancode);
+            out.push_back(static_cast<uint8_t>((event.key.alt ? 1 : 0) | (event.key.control ? 2 : 0) |
+                                               (event.key.shift ? 4 : 0) | (event.key.system ? 8 : 0)));
+            break;
+        case sf::Event::MouseWheelScrolled:
+            out.push_back(static_cast<uint8_t>(event.mouseWheelScroll.wheel));
+            putRaw(out, &event.mouseWheelScroll.delta, sizeof(float));
+            putSigned(out, event.mouseWheelScroll.x);
+            putSigned(out, event.mouseWheelScroll.y);
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            out.push_back(static_cast<uint8_t>(event.mouseButton.button));
+            putSigned(out, event.mouseButton.x);
+            putSigned(out, event.mouseButton.y);
+            break;
+        case sf::Event::MouseMoved:
+            putSigned(out, event.mouseMove.x);
+            putSigned(out, event.mouseMove.y);
+            break;
+        default:
+            // Joystick, touch and sensor events are rare: keep them verbatim.
+            putRaw(out, &event, sizeof(sf::Event));
+            break;
+        }
+    }
+
+    void
+    decodeEvent(Cursor& in, sf::Event& event) {
+        const sf::Event::EventType type = static_cast<sf::Event::EventType>(in.byte());
+        if (type >= sf::Event::Count) {
+            in.ok = false;
+            return;
+        }
+        event = sf::Event();
+        event.type = type;
+        switch (type) {
+        case sf::Event::Closed:
+        case sf::Event::LostFocus:
+        case sf::Event::GainedFocus:
+        case sf::Event::MouseEntered:
+        case sf::Event::MouseLeft:
+            break;
+        case sf::Event::Resized:
+            event.size.width = static_cast<unsigned int>(in.varint());
+            event.size.height = static_cast<unsigned int>(in.varint());
+            break;
+        case sf::Event::TextEntered:
+            event.text.unicode = static_cast<sf::Uint32>(in.varint());
+            break;
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased: {
+            event.key.code = static_cast<sf::Keyboard::Key>(in.signedVarint());
+            event.key.scancode = static_cast<sf::Keyboard::Scancode>(in.signedVarint());
+            const uint8_t modifiers = in.byte();
+            event.key.alt = (modifiers & 1) != 0;
+            event.key.control = (modifiers & 2) != 0;
+            event.key.shift = (modifiers & 4) != 0;
+            event.key.system = (modifiers & 8) != 0;
+            break;
+        }
+        case sf::Event::MouseWheelScrolled:
+            event.mouseWheelScroll.wheel = static_cast<sf::Mouse::Wheel>(in.byte());
+            in.raw(&event.mouseWheelScroll.delta, sizeof(float));
+            event.mouseWheelScroll.x = static_cast<int>(in.signedVarint());
+            event.mouseWheelScroll.y = static_cast<int>(in.signedVarint());
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            event.mouseButton.button = static_cast<sf::Mouse::Button>(in.byte());
+            event.mouseButton.x = static_cast<int>(in.signedVarint());
+            event.mouseButton.y = static_cast<int>(in.signedVarint());
+            break;
+        case sf::Event::MouseMoved:
+            event.mouseMove.x = static_cast<int>(in.signedVarint());
+            event.mouseMove.y = static_cast<int>(in.signedVarint());
+            break;
+        default:
+            in.raw(&event, sizeof(sf::Event));
+            break;
+        }
+    }
+
+    const size_t FlushThreshold = 64 * 1024; ///< Buffered bytes before the writer hits the disk.
+}
+
+InputLogWriter::~InputLogWriter() {
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool
+InputLogWriter::open(const std::string& path) {
+    if (isOpen()) {
+        close();
+    }
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        return false;
+    }
+    m_frameCount = 0;
+    m_buffer.clear();
+    m_buffer.reserve(FlushThreshold * 2);
+    putRaw(m_buffer, InputLogFormat::Magic, sizeof(InputLogFormat::Magic));
+    m_buffer.push_back(InputLogFormat::Version);
+    return true;
+}
+
+void
+InputLogWriter::writeFrame(sf::Time deltaTime, const std::vector<sf::Event>& events) {
+    if (!isOpen()) {
+        return;
+    }
+    m_buffer.push_back(InputLogFormat::FrameTag);
+    putVarint(m_buffer, static_cast<uint64_t>(std::max<sf::Int64>(0, deltaTime.asMicroseconds())));
+    putVarint(m_buffer, events.size());
+    for (const sf::Event& event : events) {
+        encodeEvent(m_buffer, event);
+    }
+    ++m_frameCount;
+
+    if (m_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+void
+InputLogWriter::close(bool hasStateHash, uint64_t stateHash) {
+    if (!isOpen()) {
+        return;
+    }
+    m_buffer.push_back(InputLogFormat::EndTag);
+    m_buffer.push_back(hasStateHash ? 1 : 0);
+    for (int i = 0; i < 8; ++i) {
+        m_buffer.push_back(static_cast<uint8_t>(stateHash >> (i * 8)));
+    }
+    putVarint(m_buffer, m_frameCount);
+    flush();
+    m_file.close();
+}
+
+void
+InputLogWriter::flush() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+bool
+InputLogReader::open(const std::string& path) {
+    *this = InputLogReader();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    const size_t headerSize = sizeof(InputLogFormat::Magic) + 1;
+    if (m_data.size() < headerSize ||
+        std::memcmp(m_data.data(), InputLogFormat::Magic, sizeof(InputLogFormat::Magic)) != 0 ||
+        m_data[sizeof(InputLogFormat::Magic)] != InputLogFormat::Version) {
+        m_corrupt = true;
+        return false;
+    }
+
+    m_offset = headerSize;
+    m_ended = false;
+    readTrailerIfPresent();
+    return true;
+}
+
+bool
+InputLogReader::nextFrame(sf::Time& deltaTime, std::vector<sf::Event>& events) {
+    events.clear();
+    if (atEnd()) {
+        return false;
+    }
+
+    Cursor in{ m_data, m_offset };
+    if (in.byte() != InputLogFormat::FrameTag) {
+        m_corrupt = true;
+        return false;
+    }
+    deltaTime = sf::microseconds(static_cast<sf::Int64>(in.varint()));
+    const uint64_t count = in.varint();
+    // Each event takes at least one byte: reject counts the remaining data cannot hold.
+    if (!in.ok || count > m_data.size() - m_offset) {
+        m_corrupt = true;
+        return false;
+    }
+    events.resize(static_cast<size_t>(count));
+    for (sf::Event& event : events) {
+        decodeEvent(in, event);
+    }
+    if (!in.ok) {
+        events.clear();
+        m_corrupt = true;
+        return false;
+    }
+
+    ++m_frameCount;
+    m_elapsed += deltaTime;
+    readTrailerIfPresent();
+    return true;
+}
+
+void
+InputLogReader::readTrailerIfPresent() {
+    if (m_offset >= m_data.size()) {
+        // A recording that was cut short (crash, killed process) still replays up to here.
+        m_ended = true;
+        return;
+    }
+    if (m_data[m_offset] != InputLogFormat::EndTag) {
+        return;
+    }
+
+    Cursor in{ m_data, m_offset };
+    in.byte();
+    m_hasStateHash = in.byte() != 0;
+    m_stateHash = 0;
+    for (int i = 0; i < 8; ++i) {
+        m_stateHash |= static_cast<uint64_t>(in.byte()) << (i * 8);
+    }
+    in.varint();
+    m_ended = true;
+    m_corrupt = !in.ok;
+}
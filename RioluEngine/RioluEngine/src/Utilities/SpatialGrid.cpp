@@ -0,0 +1,113 @@
+#include "Utilities/SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file SpatialGrid.cpp
+ * @brief Implements the uniform spatial grid.
+ */
+
+SpatialGrid::SpatialGrid(const sf::FloatRect& bounds, float cellSize)
+    : m_bounds(bounds) {
+    if (cellSize <= 0.f || bounds.width <= 0.f || bounds.height <= 0.f) {
+        ERROR("SpatialGrid", "SpatialGrid", "Bounds and cell size must be positive");
+    }
+
+    m_cellSize = cellSize;
+    m_invCellSize = 1.f / cellSize;
+    m_columns = std::max(1, static_cast<int>(std::ceil(bounds.width * m_invCellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(bounds.height * m_invCellSize)));
+    m_cellStart.assign(cellCount() + 1, 0);
+}
+
+int
+SpatialGrid::columnOf(float x) const {
+    int column = static_cast<int>((x - m_bounds.left) * m_invCellSize);
+    return std::min(std::max(column, 0), m_columns - 1);
+}
+
+int
+SpatialGrid::rowOf(float y) const {
+    int row = static_cast<int>((y - m_bounds.top) * m_invCellSize);
+    return std::min(std::max(row, 0), m_rows - 1);
+}
+
+/**
+ * @brief Counting sort of the items by cell.
+ *
+ * The first pass counts the items per cell, the prefix sum turns the counts into
+ * offsets and the second pass scatters ids and positions into place. Buffers keep
+ * their capacity between builds, so a steady-state rebuild does not allocate.
+ */
+void
+SpatialGrid::build(const std::vector<sf::Vector2f>& positions) {
+    const size_t count = positions.size();
+    m_itemCell.resize(count);
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t cell = static_cast<uint32_t>(rowOf(positions[i].y) * m_columns + columnOf(positions[i].x));
+        m_itemCell[i] = cell;
+        ++m_cellStart[cell + 1];
+    }
+
+    for (size_t cell = 1; cell < m_cellStart.size(); ++cell) {
+        m_cellStart[cell] += m_cellStart[cell - 1];
+    }
+
+    m_items.resize(count);
+    m_positions.resize(count);
+    // m_cellStart[cell] is used as the write cursor and ends up at the next cell's start,
+    // so the offsets are shifted back afterwards.
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = m_cellStart[m_itemCell[i]]++;
+        m_items[slot] = static_cast<uint32_t>(i);
+        m_positions[slot] = positions[i];
+    }
+    for (size_t cell = m_cellStart.size() - 1; cell > 0; --cell) {
+        m_cellStart[cell] = m_cellStart[cell - 1];
+    }
+    m_cellStart[0] = 0;
+}
+
+void
+SpatialGrid::queryCircle(const sf::Vector2f& center, float radius, std::vector<uint32_t>& out) const {
+    const float radiusSq = radius * radius;
+    const int minColumn = columnOf(center.x - radius);
+    const int maxColumn = columnOf(center.x + radius);
+    const int minRow = rowOf(center.y - radius);
+    const int maxRow = rowOf(center.y + radius);
+
+    for (int row = minRow; row <= maxRow; ++row) {
+        // Cells of a row are contiguous, so the whole column span is one range.
+        const uint32_t begin = m_cellStart[row * m_columns + minColumn];
+        const uint32_t end = m_cellStart[row * m_columns + maxColumn + 1];
+        for (uint32_t i = begin; i < end; ++i) {
+            const float dx = m_positions[i].x - center.x;
+            const float dy = m_positions[i].y - center.y;
+            if (dx * dx + dy * dy <= radiusSq) {
+                out.push_back(m_items[i]);
+            }
+        }
+    }
+}
+
+void
+SpatialGrid::queryRect(const sf::FloatRect& rect, std::vector<uint32_t>& out) const {
+    const int minColumn = columnOf(rect.left);
+    const int maxColumn = columnOf(rect.left + rect.width);
+    const int minRow = rowOf(rect.top);
+    const int maxRow = rowOf(rect.top + rect.height);
+
+    for (int row = minRow; row <= maxRow; ++row) {
+        const uint32_t begin = m_cellStart[row * m_columns + minColumn];
+        const uint32_t end = m_cellStart[row * m_columns + maxColumn + 1];
+        for (uint32_t i = begin; i < end; ++i) {
+            const sf::Vector2f& p = m_positions[i];
+            if (p.x >= rect.left && p.x <= rect.left + rect.width &&
+                p.y >= rect.top && p.y <= rect.top + rect.height) {
+                out.push_back(m_items[i]);
+            }
+        }
+    }
+}
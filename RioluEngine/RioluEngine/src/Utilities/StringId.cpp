@@ -0,0 +1,126 @@
+#include "Utilities/StringId.h"
+#include <cstring>
+
+/**
+ * @file StringId.cpp
+ * @brief Implements the global string intern table.
+ */
+
+namespace {
+    /**
+     * @brief Spreads a 64-bit hash over the table (Fibonacci hashing).
+     */
+    inline size_t
+    slotOf(uint64_t hash, size_t mask) {
+        return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+}
+
+StringId
+StringId::intern(std::string_view text) {
+    return StringTable::instance().intern(text);
+}
+
+const char*
+StringId::c_str() const {
+    const char* text = StringTable::instance().find(*this);
+    return text != nullptr ? text : "";
+}
+
+StringTable&
+StringTable::instance() {
+    static StringTable table;
+    return table;
+}
+
+StringTable::StringTable() : m_slots(1024, Slot{ 0, nullptr }) {
+}
+
+StringId
+StringTable::intern(std::string_view text) {
+    const StringId id = StringId::fromText(text);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t slot = probe(id.getHash());
+    if (m_slots[slot].hash == id.getHash()) {
+        const char* stored = m_slots[slot].text;
+        if (std::strlen(stored) != text.size() || std::memcmp(stored, text.data(), text.size()) != 0) {
+            ERROR("StringTable", "intern", "Two names share a 64-bit hash: " << stored << " / " << text);
+        }
+        return id;
+    }
+    if ((m_count + 1) * 2 > m_slots.size()) {
+        grow();
+        slot = probe(id.getHash());
+    }
+    m_slots[slot] = Slot{ id.getHash(), store(text) };
+    ++m_count;
+    return id;
+}
+
+const char*
+StringTable::find(StringId id) const {
+    if (!id.isValid()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Slot& slot = m_slots[probe(id.getHash())];
+    return slot.hash == id.getHash() ? slot.text : nullptr;
+}
+
+size_t
+StringTable::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+size_t
+StringTable::getByteSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_textBytes + m_slots.capacity() * sizeof(Slot) + m_blocks.capacity() * sizeof(m_blocks[0]);
+}
+
+size_t
+StringTable::probe(uint64_t hash) const {
+    const size_t mask = m_slots.size() - 1;
+    size_t slot = slotOf(hash, mask);
+    while (m_slots[slot].hash != 0 && m_slots[slot].hash != hash) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void
+StringTable::grow() {
+    std::vector<Slot> old(m_slots.size() * 2, Slot{ 0, nullptr });
+    old.swap(m_slots);
+    for (const Slot& slot : old) {
+        if (slot.hash != 0) {
+            m_slots[probe(slot.hash)] = slot;
+        }
+    }
+}
+
+const char*
+StringTable::store(std::string_view text) {
+    const size_t bytes = text.size() + 1;
+    char* destination;
+    if (bytes > BlockSize / 4) {
+        // Long strings get their own block so they do not waste the current one.
+        m_blocks.push_back(std::make_unique<char[]>(bytes));
+        destination = m_blocks.back().get();
+        m_textBytes += bytes;
+    }
+    else {
+        if (m_current == nullptr || m_blockUsed + bytes > BlockSize) {
+            m_blocks.push_back(std::make_unique<char[]>(BlockSize));
+            m_current = m_blocks.back().get();
+            m_blockUsed = 0;
+            m_textBytes += BlockSize;
+        }
+        destination = m_current + m_blockUsed;
+        m_blockUsed += bytes;
+    }
+    std::memcpy(destination, text.data(), text.size());
+    destination[text.size()] = '\0';
+    return destination;
+}
@@ -16,8 +16,15 @@
   * @param width Width of the window in pixels.
   * @param height Height of the window in pixels.
   * @param title Title of the window.
+  * @param headless If true no SFML window is created; the window is then only usable for replays.
   */
-Window::Window(int width, int height, const std::string& title) {
+Window::Window(int width, int height, const std::string& title, bool headless)
+    : m_headless(headless) {
+    if (m_headless) {
+        MESSAGE("Window", "Window", "Headless window created");
+        return;
+    }
+
     m_windowPtr = EngineUtilities::MakeUnique<sf::RenderWindow>(
         sf::VideoMode(width, height), title);
 
@@ -34,6 +41,7 @@ Window::Window(int width, int height, const std::string& title) {
  * @brief Destroys the Window object and safely releases its resources.
  */
 Window::~Window() {
+    m_recording.close();
     m_windowPtr.release();
 }
 
@@ -41,11 +49,40 @@ Window::~Window() {
  * @brief Handles window events such as closing.
  *
  * Processes the event queue to detect and handle user actions like closing the window.
+ * The events are kept in getFrameEvents() for the rest of the frame. During a replay
+ * they come from the log (together with the frame's deltaTime) instead of SFML.
  */
 void
 Window::handleEvents() {
+    m_frameEvents.clear();
+
+    if (m_replaying) {
+        if (!m_replay.nextFrame(m_replayDeltaTime, m_frameEvents)) {
+            m_replaying = false;
+            m_closed = true;
+            return;
+        }
+        for (const sf::Event& event : m_frameEvents) {
+            if (event.type == sf::Event::Closed) {
+                m_closed = true;
+                if (!m_windowPtr.isNull()) {
+                    m_windowPtr->close();
+                }
+            }
+        }
+        // Drain the live queue so the OS does not consider a visible replay window hung.
+        sf::Event ignored;
+        while (!m_windowPtr.isNull() && m_windowPtr->pollEvent(ignored)) {
+        }
+        return;
+    }
+
+    if (m_windowPtr.isNull()) {
+        return;
+    }
     sf::Event event;
     while (m_windowPtr->pollEvent(event)) {
+        m_frameEvents.push_back(event);
         if (event.type == sf::Event::Closed) {
             m_windowPtr->close();
         }
@@ -59,6 +96,9 @@ Window::handleEvents() {
  */
 bool
 Window::isOpen() const {
+    if (m_replaying || m_headless) {
+        return m_replaying && !m_closed && !m_replay.atEnd();
+    }
     if (!m_windowPtr.isNull()) {
         return m_windowPtr->isOpen();
     }
@@ -75,6 +115,9 @@ Window::isOpen() const {
  */
 void
 Window::clear(const sf::Color& color) {
+    if (m_headless) {
+        return;
+    }
     if (!m_windowPtr.isNull()) {
         m_windowPtr->clear(color);
     }
@@ -91,6 +134,9 @@ Window::clear(const sf::Color& color) {
  */
 void
 Window::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
+    if (m_headless) {
+        return;
+    }
     if (!m_windowPtr.isNull()) {
         m_windowPtr->draw(drawable, states);
     }
@@ -104,6 +150,9 @@ Window::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
  */
 void
 Window::display() {
+    if (m_headless) {
+        return;
+    }
     if (!m_windowPtr.isNull()) {
         m_windowPtr->display();
     }
@@ -112,10 +161,57 @@ Window::display() {
     }
 }
 
+/**
+ * @brief Stores the deltaTime of the current frame.
+ *
+ * Live runs measure it with the clock; replays use the recorded value so the
+ * simulation sees exactly the same timing. When recording, the frame (events and
+ * deltaTime) is appended to the log here.
+ */
 void
 Window::update() {
     //Almacenar el deltaTime una sola vez
     deltaTime = clock.restart();
+    if (m_replaying) {
+        deltaTime = m_replayDeltaTime;
+    }
+    else if (m_recording.isOpen()) {
+        m_recording.writeFrame(deltaTime, m_frameEvents);
+    }
+}
+
+/**
+ * @brief Starts recording the events and deltaTime of every following frame.
+ *
+ * @param path File that receives the log.
+ * @return false if the file could not be created.
+ */
+bool
+Window::startRecording(const std::string& path) {
+    return m_recording.open(path);
+}
+
+/**
+ * @brief Ends the recording.
+ *
+ * @param stateHash Hash of the simulation state, compared by replays of this log.
+ */
+void
+Window::stopRecording(uint64_t stateHash) {
+    m_recording.close(true, stateHash);
+}
+
+/**
+ * @brief Takes the events and deltaTime of the next frames from a log.
+ *
+ * @param path Log written by startRecording().
+ * @return false if the log could not be read.
+ */
+bool
+Window::startReplay(const std::string& path) {
+    m_replaying = m_replay.open(path);
+    m_closed = false;
+    return m_replaying;
 }
 
 
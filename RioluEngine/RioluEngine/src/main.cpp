@@ -1,4 +1,5 @@
 #include "BaseApp.h"
+#include "Benchmarks/Benchmark.h"
 
 /**
  * @file main.cpp
@@ -9,11 +10,30 @@
   * @brief Main function that initializes and runs the application.
   *
   * Creates an instance of the BaseApp class and calls its run method to start the application loop.
+  * When launched as `RioluEngine --bench [filter...]` it runs the registered benchmarks instead
+  * and prints their results as CSV. Heap allocation counts are only reported by the Bench
+  * configuration, which defines RIOLU_COUNT_ALLOCATIONS.
+  * `--record <file>` saves the input and frame times of the session, and
+  * `--replay <file>` (or `--replay-visible <file>`) plays such a recording back headless
+  * (or in a window) with identical timing.
   *
   * @return int Exit status of the application. Returns 0 on successful execution.
   */
 int
-main() {
+main(int argc, char* argv[]) {
+	if (argc > 1 && std::string(argv[1]) == "--bench") {
+		return BenchmarkRegistry::runFromCommandLine(argc, argv);
+	}
+
 	BaseApp app;
+	if (argc > 2 && std::string(argv[1]) == "--record") {
+		app.recordTo(argv[2]);
+	}
+	else if (argc > 2 && std::string(argv[1]) == "--replay") {
+		app.replayFrom(argv[2]);
+	}
+	else if (argc > 2 && std::string(argv[1]) == "--replay-visible") {
+		app.replayFrom(argv[2], false);
+	}
 	return app.run();
 }
\ No newline at end of file